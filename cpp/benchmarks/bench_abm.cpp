@@ -0,0 +1,100 @@
+/* 
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "abm/abm.h"
+#include "abm/household.h"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+/**
+ * create a synthetic world.
+ * Persons live in households of 4 and are assigned to schools or workplaces, shops, and social events.
+ * @param num_persons number of persons in the world.
+ * @param event_driven if the world runs in event driven mode.
+ */
+mio::World make_world(size_t num_persons, bool event_driven)
+{
+    auto world = mio::World();
+    world.set_rng_seed(42);
+    world.set_event_driven(event_driven);
+    world.reserve_persons(num_persons);
+    world.reserve_locations(mio::LocationType::Home, num_persons / 4 + 1);
+
+    const mio::AbmAgeGroup ages[] = {mio::AbmAgeGroup::Age5to14,  mio::AbmAgeGroup::Age15to34,
+                                     mio::AbmAgeGroup::Age35to59, mio::AbmAgeGroup::Age35to59,
+                                     mio::AbmAgeGroup::Age60to79, mio::AbmAgeGroup::Age80plus};
+    auto home = mio::LocationId{};
+    for (size_t i = 0; i < num_persons; ++i) {
+        if (i % 4 == 0) {
+            home = world.add_location(mio::LocationType::Home);
+        }
+        //0.1% of the population is infected at the start
+        auto state = i % 1000 == 0 ? mio::InfectionState::Carrier : mio::InfectionState::Susceptible;
+        auto& person = world.add_person(home, state, ages[i % 6]);
+        person.set_assigned_location(home);
+    }
+
+    mio::add_and_assign_locations(world, mio::LocationType::School, {mio::AbmAgeGroup::Age5to14}, 500);
+    mio::add_and_assign_locations(world, mio::LocationType::Work,
+                                  {mio::AbmAgeGroup::Age15to34, mio::AbmAgeGroup::Age35to59}, 50);
+    mio::add_and_assign_locations(world, mio::LocationType::BasicsShop,
+                                  {mio::AbmAgeGroup::Age5to14, mio::AbmAgeGroup::Age15to34,
+                                   mio::AbmAgeGroup::Age35to59, mio::AbmAgeGroup::Age60to79,
+                                   mio::AbmAgeGroup::Age80plus},
+                                  2000);
+    mio::add_and_assign_locations(world, mio::LocationType::SocialEvent,
+                                  {mio::AbmAgeGroup::Age5to14, mio::AbmAgeGroup::Age15to34,
+                                   mio::AbmAgeGroup::Age35to59, mio::AbmAgeGroup::Age60to79,
+                                   mio::AbmAgeGroup::Age80plus},
+                                  100);
+    return world;
+}
+
+} // namespace
+
+/**
+ * evolve the world by one hour.
+ * The simulation continues in each iteration for one day, so both modes are compared over the same time.
+ * The first step is not measured, it schedules the events of all persons in the event driven mode.
+ * arguments: number of persons, event driven mode.
+ */
+static void BM_World_evolve(benchmark::State& state)
+{
+    auto world = make_world(size_t(state.range(0)), state.range(1) != 0);
+    auto t     = mio::TimePoint(0);
+    auto dt    = mio::hours(1);
+    world.evolve(t, dt);
+    t += dt;
+    for (auto _ : state) {
+        world.evolve(t, dt);
+        t += dt;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_World_evolve)
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Args({100000, 0})
+    ->Args({100000, 1})
+    ->Args({1000000, 0})
+    ->Args({1000000, 1})
+    ->Iterations(24)
+    ->Unit(benchmark::kMillisecond);
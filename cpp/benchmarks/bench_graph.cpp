@@ -0,0 +1,95 @@
+/* 
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "secir_setup.h"
+#include "secir/analyze_result.h"
+#include <benchmark/benchmark.h>
+
+/**
+ * simulate one day on a synthetic graph with daily migration.
+ * arguments: number of nodes, number of age groups.
+ */
+static void BM_GraphSimulation_advance(benchmark::State& state)
+{
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto sim = mio::make_migration_sim(
+            0.0, 0.5, mio::bench::make_migration_graph(int(state.range(0)), int(state.range(1))));
+        state.ResumeTiming();
+        sim.advance(1.0);
+        benchmark::DoNotOptimize(sim.get_graph().nodes()[0].property.get_result().get_last_value().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphSimulation_advance)
+    ->Args({100, 1})
+    ->Args({100, 6})
+    ->Args({400, 1})
+    ->Args({400, 6})
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * migration to another node and back on a single edge.
+ * argument: number of age groups.
+ */
+static void BM_MigrationEdge_apply_migration(benchmark::State& state)
+{
+    auto num_groups = int(state.range(0));
+    auto node_from  = mio::SimulationNode<mio::SecirSimulation<>>(mio::bench::make_secir_model(num_groups), 0.0);
+    auto node_to    = mio::SimulationNode<mio::SecirSimulation<>>(mio::bench::make_secir_model(num_groups), 0.0);
+    auto edge       = mio::MigrationEdge(
+        Eigen::VectorXd::Constant(num_groups * Eigen::Index(mio::InfectionState::Count), 0.01));
+    for (auto _ : state) {
+        //nodes are not evolved, so the state stays the same in every iteration
+        edge.apply_migration(0.0, 0.5, node_from, node_to);
+        edge.apply_migration(0.5, 0.5, node_from, node_to);
+        benchmark::DoNotOptimize(node_to.get_result().get_last_value().data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MigrationEdge_apply_migration)->Arg(1)->Arg(6)->Arg(16);
+
+/**
+ * percentiles of an ensemble of graph simulation results.
+ * arguments: number of runs, number of nodes.
+ */
+static void BM_ensemble_percentile(benchmark::State& state)
+{
+    auto num_runs  = size_t(state.range(0));
+    auto num_nodes = size_t(state.range(1));
+    //result of 6 age groups for 100 days
+    auto num_elements = Eigen::Index(6 * Eigen::Index(mio::InfectionState::Count));
+    std::vector<std::vector<mio::TimeSeries<double>>> ensemble(
+        num_runs, std::vector<mio::TimeSeries<double>>(num_nodes, mio::TimeSeries<double>(num_elements)));
+    for (size_t run = 0; run < num_runs; ++run) {
+        for (size_t node = 0; node < num_nodes; ++node) {
+            auto& ts = ensemble[run][node];
+            ts.reserve(101);
+            for (int t = 0; t <= 100; ++t) {
+                ts.add_time_point(t, Eigen::VectorXd::Constant(num_elements, double((run * 7919 + node + t) % 1000)));
+            }
+        }
+    }
+    for (auto _ : state) {
+        auto percentile = mio::ensemble_percentile(ensemble, 0.05);
+        benchmark::DoNotOptimize(percentile.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_runs * num_nodes);
+}
+BENCHMARK(BM_ensemble_percentile)->Args({100, 10})->Args({100, 100})->Unit(benchmark::kMillisecond);
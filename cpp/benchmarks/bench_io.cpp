@@ -0,0 +1,236 @@
+/* 
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/config.h"
+#include "secir_setup.h"
+#include "secir/secir_result_io.h"
+#include "memilio/io/json_serializer.h"
+#include "memilio/io/mobility_io.h"
+#include "memilio/io/binary_serializer.h"
+#include "boost/filesystem.hpp"
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+namespace
+{
+
+std::string get_temp_path(const std::string& model = "memilio-bench-%%%%-%%%%.h5")
+{
+    boost::system::error_code ec;
+    auto path = boost::filesystem::temp_directory_path(ec);
+    if (ec) {
+        path = boost::filesystem::current_path();
+    }
+    return (path / boost::filesystem::unique_path(model)).string();
+}
+
+} // namespace
+
+/**
+ * read a mobility matrix from a text file.
+ * argument: number of regions.
+ */
+static void BM_Mobility_read_plain(benchmark::State& state)
+{
+    auto path = get_temp_path("memilio-bench-%%%%-%%%%.txt");
+    {
+        std::ofstream file(path);
+        for (int i = 0; i < state.range(0); ++i) {
+            for (int j = 0; j < state.range(0); ++j) {
+                file << (j > 0 ? " " : "") << 1e-3 * (i + 1) * (j + 1);
+            }
+            file << "\n";
+        }
+    }
+    //second argument: read from a binary cache
+    auto cache_dir = state.range(1) ? get_temp_path("memilio-bench-cache-%%%%-%%%%") : std::string("");
+    for (auto _ : state) {
+        auto matrix = mio::read_mobility_plain(path, cache_dir);
+        if (!matrix) {
+            state.SkipWithError(matrix.error().formatted_message().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(matrix.value().data());
+    }
+    boost::filesystem::remove(path);
+    if (!cache_dir.empty()) {
+        boost::filesystem::remove_all(cache_dir);
+    }
+}
+BENCHMARK(BM_Mobility_read_plain)->Args({400, 0})->Args({400, 1})->Unit(benchmark::kMillisecond);
+
+/**
+ * serialize a secir model to a binary buffer.
+ * argument: number of age groups.
+ */
+static void BM_Binary_serialize_model(benchmark::State& state)
+{
+    auto model = mio::bench::make_secir_model(int(state.range(0)), 10000, 10);
+    for (auto _ : state) {
+        auto stream = mio::serialize_binary(model);
+        if (!stream) {
+            state.SkipWithError(stream.error().formatted_message().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(stream.value().data());
+    }
+}
+BENCHMARK(BM_Binary_serialize_model)->Arg(1)->Arg(6);
+
+/**
+ * deserialize a secir model from a binary buffer.
+ * argument: number of age groups.
+ */
+static void BM_Binary_deserialize_model(benchmark::State& state)
+{
+    auto model  = mio::bench::make_secir_model(int(state.range(0)), 10000, 10);
+    auto stream = mio::serialize_binary(model).value();
+    for (auto _ : state) {
+        auto restored = mio::deserialize_binary(stream, mio::Tag<mio::SecirModel>{});
+        if (!restored) {
+            state.SkipWithError(restored.error().formatted_message().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(restored.value().populations.array().data());
+    }
+}
+BENCHMARK(BM_Binary_deserialize_model)->Arg(1)->Arg(6);
+
+#ifdef MEMILIO_HAS_JSONCPP
+
+/**
+ * serialize a secir model to a json string.
+ * argument: number of age groups.
+ */
+static void BM_Json_serialize_model(benchmark::State& state)
+{
+    auto model = mio::bench::make_secir_model(int(state.range(0)), 10000, 10);
+    Json::StreamWriterBuilder swb;
+    for (auto _ : state) {
+        auto js = mio::serialize_json(model);
+        if (!js) {
+            state.SkipWithError(js.error().formatted_message().c_str());
+            break;
+        }
+        auto str = Json::writeString(swb, js.value());
+        benchmark::DoNotOptimize(str.data());
+    }
+}
+BENCHMARK(BM_Json_serialize_model)->Arg(1)->Arg(6);
+
+/**
+ * parse a json string and deserialize a secir model.
+ * argument: number of age groups.
+ */
+static void BM_Json_deserialize_model(benchmark::State& state)
+{
+    auto model = mio::bench::make_secir_model(int(state.range(0)), 10000, 10);
+    auto str   = Json::writeString(Json::StreamWriterBuilder{}, mio::serialize_json(model).value());
+    Json::CharReaderBuilder crb;
+    for (auto _ : state) {
+        std::istringstream stream(str);
+        Json::Value js;
+        std::string err_msg;
+        Json::parseFromStream(crb, stream, &js, &err_msg);
+        auto restored = mio::deserialize_json(js, mio::Tag<mio::SecirModel>{});
+        if (!restored) {
+            state.SkipWithError(restored.error().formatted_message().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(restored.value().populations.array().data());
+    }
+}
+BENCHMARK(BM_Json_deserialize_model)->Arg(1)->Arg(6);
+
+#endif // MEMILIO_HAS_JSONCPP
+
+#ifdef MEMILIO_HAS_HDF5
+
+namespace
+{
+
+/**
+ * results of a graph simulation with 6 age groups for 100 days.
+ */
+std::vector<mio::TimeSeries<double>> make_graph_result(size_t num_nodes)
+{
+    auto num_elements = Eigen::Index(6 * Eigen::Index(mio::InfectionState::Count));
+    std::vector<mio::TimeSeries<double>> result(num_nodes, mio::TimeSeries<double>(num_elements));
+    for (size_t node = 0; node < num_nodes; ++node) {
+        result[node].reserve(101);
+        for (int t = 0; t <= 100; ++t) {
+            result[node].add_time_point(t, Eigen::VectorXd::Constant(num_elements, double(node + t)));
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+/**
+ * write the results of a graph simulation to a h5 file.
+ * argument: number of nodes.
+ */
+static void BM_Hdf5_save_result(benchmark::State& state)
+{
+    auto result = make_graph_result(size_t(state.range(0)));
+    std::vector<int> ids(result.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    auto path = get_temp_path();
+    for (auto _ : state) {
+        auto status = mio::save_result(result, ids, path);
+        if (!status) {
+            state.SkipWithError(status.error().formatted_message().c_str());
+            break;
+        }
+    }
+    boost::filesystem::remove(path);
+}
+BENCHMARK(BM_Hdf5_save_result)->Arg(10)->Arg(400)->Unit(benchmark::kMillisecond);
+
+/**
+ * read the results of a graph simulation from a h5 file.
+ * argument: number of nodes.
+ */
+static void BM_Hdf5_read_result(benchmark::State& state)
+{
+    auto result = make_graph_result(size_t(state.range(0)));
+    std::vector<int> ids(result.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    auto path = get_temp_path();
+    auto status = mio::save_result(result, ids, path);
+    if (!status) {
+        state.SkipWithError(status.error().formatted_message().c_str());
+        return;
+    }
+    for (auto _ : state) {
+        auto restored = mio::read_result(path, 6);
+        if (!restored) {
+            state.SkipWithError(restored.error().formatted_message().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(restored.value().data());
+    }
+    boost::filesystem::remove(path);
+}
+BENCHMARK(BM_Hdf5_read_result)->Arg(10)->Arg(400)->Unit(benchmark::kMillisecond);
+
+#endif // MEMILIO_HAS_HDF5
@@ -0,0 +1,94 @@
+/* 
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "secir_setup.h"
+#include "memilio/math/adapt_rk.h"
+#include <benchmark/benchmark.h>
+
+/**
+ * right hand side of the secir model.
+ * argument: number of age groups.
+ */
+static void BM_SecirModel_get_derivatives(benchmark::State& state)
+{
+    auto num_groups = int(state.range(0));
+    auto model      = mio::bench::make_secir_model(num_groups);
+    Eigen::VectorXd y = model.get_initial_values();
+    Eigen::VectorXd dydt(y.size());
+    for (auto _ : state) {
+        model.get_derivatives(y, y, 1.0, dydt);
+        benchmark::DoNotOptimize(dydt.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SecirModel_get_derivatives)->Arg(1)->Arg(2)->Arg(6)->Arg(16);
+
+/**
+ * one adaptive runge kutta step of the secir model.
+ * argument: number of age groups.
+ */
+static void BM_RKIntegratorCore_step(benchmark::State& state)
+{
+    auto num_groups = int(state.range(0));
+    auto model      = mio::bench::make_secir_model(num_groups);
+    Eigen::VectorXd y0 = model.get_initial_values();
+    Eigen::VectorXd y1(y0.size());
+    auto f = [&model, &y0](Eigen::Ref<const Eigen::VectorXd> y, double t, Eigen::Ref<Eigen::VectorXd> dydt) {
+        model.eval_right_hand_side(y0, y, t, dydt);
+    };
+    mio::RKIntegratorCore integrator;
+    for (auto _ : state) {
+        //the step size is adapted in every step, always start from the same
+        auto t  = 0.0;
+        auto dt = 0.5;
+        benchmark::DoNotOptimize(integrator.step(f, y0, t, dt, y1));
+        benchmark::DoNotOptimize(y1.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RKIntegratorCore_step)->Arg(1)->Arg(6)->Arg(16);
+
+/**
+ * evaluating the contact matrix with multiple dampings at some point in time.
+ * argument: number of age groups.
+ */
+static void BM_ContactMatrixGroup_get_matrix_at(benchmark::State& state)
+{
+    auto num_groups = Eigen::Index(state.range(0));
+    //e.g. contacts at home, school, work, and other locations
+    mio::ContactMatrixGroup contacts(4, num_groups);
+    for (auto& matrix : contacts) {
+        matrix.get_baseline().setConstant(5.0);
+        matrix.get_minimum().setConstant(1.0);
+    }
+    for (int d = 0; d < 10; ++d) {
+        contacts.add_damping(0.05 * d, mio::DampingLevel(d % 3), mio::DampingType(d % 2),
+                             mio::SimulationTime(2.0 * d));
+    }
+    auto t = 0.0;
+    for (auto _ : state) {
+        Eigen::MatrixXd m = contacts.get_matrix_at(t);
+        benchmark::DoNotOptimize(m.data());
+        t = t < 30.0 ? t + 0.1 : 0.0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ContactMatrixGroup_get_matrix_at)->Arg(1)->Arg(6)->Arg(16);
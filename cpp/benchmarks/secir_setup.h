@@ -0,0 +1,110 @@
+/* 
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MIO_BENCH_SECIR_SETUP_H
+#define MIO_BENCH_SECIR_SETUP_H
+
+#include "secir/secir.h"
+#include "memilio/mobility/mobility.h"
+
+namespace mio
+{
+namespace bench
+{
+
+/**
+ * create a secir model with realistic parameters and an ongoing outbreak.
+ * @param num_groups number of age groups.
+ * @param total_population total population of the model, distributed evenly over the groups.
+ * @param num_dampings number of dampings of the contacts.
+ */
+inline SecirModel make_secir_model(int num_groups, double total_population = 10000, int num_dampings = 2)
+{
+    SecirModel model(num_groups);
+    auto& params = model.parameters;
+    auto fact    = 1.0 / num_groups;
+
+    params.set<ICUCapacity>(std::numeric_limits<double>::max());
+    for (auto i = AgeGroup(0); i < AgeGroup(num_groups); ++i) {
+        params.get<IncubationTime>()[i]                  = 5.2;
+        params.get<InfectiousTimeMild>()[i]              = 6;
+        params.get<SerialInterval>()[i]                  = 4.2;
+        params.get<HospitalizedToHomeTime>()[i]          = 12;
+        params.get<HomeToHospitalizedTime>()[i]          = 5;
+        params.get<HospitalizedToICUTime>()[i]           = 2;
+        params.get<ICUToHomeTime>()[i]                   = 8;
+        params.get<ICUToDeathTime>()[i]                  = 5;
+        params.get<InfectionProbabilityFromContact>()[i] = 0.05;
+        params.get<RelativeCarrierInfectability>()[i]    = 0.67;
+        params.get<AsymptoticCasesPerInfectious>()[i]    = 0.09;
+        params.get<RiskOfInfectionFromSympomatic>()[i]   = 0.25;
+        params.get<HospitalizedCasesPerInfectious>()[i]  = 0.2;
+        params.get<ICUCasesPerHospitalized>()[i]         = 0.25;
+        params.get<DeathsPerICU>()[i]                    = 0.3;
+
+        model.populations[{i, InfectionState::Exposed}]      = fact * 0.01 * total_population;
+        model.populations[{i, InfectionState::Carrier}]      = fact * 0.005 * total_population;
+        model.populations[{i, InfectionState::Infected}]     = fact * 0.005 * total_population;
+        model.populations[{i, InfectionState::Hospitalized}] = fact * 0.002 * total_population;
+        model.populations[{i, InfectionState::ICU}]          = fact * 0.001 * total_population;
+        model.populations[{i, InfectionState::Recovered}]    = fact * 0.001 * total_population;
+        model.populations.set_difference_from_group_total<AgeGroup>({i, InfectionState::Susceptible},
+                                                                     fact * total_population);
+    }
+
+    ContactMatrixGroup& contacts = params.get<ContactPatterns>();
+    contacts[0] = ContactMatrix(Eigen::MatrixXd::Constant(num_groups, num_groups, fact * 10));
+    for (int d = 0; d < num_dampings; ++d) {
+        contacts.add_damping(Eigen::MatrixXd::Constant(num_groups, num_groups, 0.3 + 0.1 * d),
+                             DampingLevel(d), DampingType(0), SimulationTime(5.0 * (d + 1)));
+    }
+
+    model.apply_constraints();
+    return model;
+}
+
+/**
+ * create a synthetic migration graph.
+ * Each node is connected to its nearest neighbors in both directions.
+ * @param num_nodes number of nodes.
+ * @param num_groups number of age groups in each node.
+ * @param num_neighbors number of outgoing edges of each node.
+ */
+inline Graph<SimulationNode<SecirSimulation<>>, MigrationEdge> make_migration_graph(int num_nodes, int num_groups,
+                                                                                   int num_neighbors = 8)
+{
+    Graph<SimulationNode<SecirSimulation<>>, MigrationEdge> graph;
+    for (int n = 0; n < num_nodes; ++n) {
+        //population sizes of the nodes vary like the counties in germany
+        graph.add_node(n, make_secir_model(num_groups, 50000 + 10000 * (n % 20)), 0.0);
+    }
+    auto coeffs = Eigen::VectorXd::Constant(num_groups * Eigen::Index(InfectionState::Count), 0.01);
+    for (int n = 0; n < num_nodes; ++n) {
+        for (int k = 1; k <= num_neighbors / 2; ++k) {
+            graph.add_edge(n, (n + k) % num_nodes, coeffs);
+            graph.add_edge(n, (n - k + num_nodes) % num_nodes, coeffs);
+        }
+    }
+    return graph;
+}
+
+} // namespace bench
+} // namespace mio
+
+#endif //MIO_BENCH_SECIR_SETUP_H
@@ -290,54 +290,33 @@ void create_assign_locations(mio::World& world)
     // At every workplace work 100 people (needs to be varified), maximum contacts are 40.
     // People can get tested at work (and do this with 0.5 probability).
     // Add one supermarked per 15.000 people, maximum constacts are assumed to be 20.
-    auto shop = world.add_location(mio::LocationType::BasicsShop);
-    world.get_individualized_location(shop).get_infection_parameters().set<mio::MaximumContacts>(20);
-
-    auto school = world.add_location(mio::LocationType::School);
-    world.get_individualized_location(school).get_infection_parameters().set<mio::MaximumContacts>(40);
-    world.get_individualized_location(school).set_testing_scheme(mio::days(7), 1);
-
-    auto work = world.add_location(mio::LocationType::Work);
-    world.get_individualized_location(work).get_infection_parameters().set<mio::MaximumContacts>(40);
-    world.get_individualized_location(work).set_testing_scheme(mio::days(7), 0.5);
-    int counter_school = 0;
-    int counter_work   = 0;
-    int counter_shop   = 0;
-    //Assign locations to the people
-    auto persons = world.get_persons();
-    for (auto& person : persons) {
-        //assign shop and event
+    auto shops = mio::add_and_assign_locations(world, mio::LocationType::BasicsShop,
+                                               {mio::AbmAgeGroup::Age0to4, mio::AbmAgeGroup::Age5to14,
+                                                mio::AbmAgeGroup::Age15to34, mio::AbmAgeGroup::Age35to59,
+                                                mio::AbmAgeGroup::Age60to79, mio::AbmAgeGroup::Age80plus},
+                                               15000);
+    for (auto& shop : shops) {
+        world.get_individualized_location(shop).get_infection_parameters().set<mio::MaximumContacts>(20);
+    }
+
+    auto schools = mio::add_and_assign_locations(world, mio::LocationType::School, {mio::AbmAgeGroup::Age5to14}, 600);
+    for (auto& school : schools) {
+        world.get_individualized_location(school).get_infection_parameters().set<mio::MaximumContacts>(40);
+        world.get_individualized_location(school).set_testing_scheme(mio::days(7), 1);
+    }
+
+    auto works = mio::add_and_assign_locations(world, mio::LocationType::Work,
+                                               {mio::AbmAgeGroup::Age15to34, mio::AbmAgeGroup::Age35to59}, 100);
+    for (auto& work : works) {
+        world.get_individualized_location(work).get_infection_parameters().set<mio::MaximumContacts>(40);
+        world.get_individualized_location(work).set_testing_scheme(mio::days(7), 0.5);
+    }
+
+    //Assign event, hospital and ICU to all people
+    for (auto& person : world.get_persons()) {
         person.set_assigned_location(event);
-        person.set_assigned_location(shop);
-        counter_shop++;
-        //assign hospital and ICU
         person.set_assigned_location(hospital);
         person.set_assigned_location(icu);
-        //assign work/school to people depending on their age
-        if (person.get_age() == mio::AbmAgeGroup::Age5to14) {
-            person.set_assigned_location(school);
-            counter_school++;
-        }
-        if (person.get_age() == mio::AbmAgeGroup::Age15to34 || person.get_age() == mio::AbmAgeGroup::Age35to59) {
-            person.set_assigned_location(work);
-            counter_work++;
-        }
-        //add new school/work/shop if needed
-        if (counter_school == 600) {
-            counter_school = 0;
-            school         = world.add_location(mio::LocationType::School);
-            world.get_individualized_location(school).get_infection_parameters().set<mio::MaximumContacts>(40);
-        }
-        if (counter_work == 100) {
-            counter_work = 0;
-            work         = world.add_location(mio::LocationType::Work);
-            world.get_individualized_location(work).get_infection_parameters().set<mio::MaximumContacts>(40);
-        }
-        if (counter_shop == 15000) {
-            counter_shop = 0;
-            shop         = world.add_location(mio::LocationType::BasicsShop);
-            world.get_individualized_location(shop).get_infection_parameters().set<mio::MaximumContacts>(20);
-        }
     }
 }
 
@@ -23,6 +23,7 @@
 #include "memilio/config.h"
 #include "memilio/math/eigen.h"
 #include "memilio/utils/metaprogramming.h"
+#include "memilio/utils/instrumentation.h"
 #include <vector>
 #include <functional>
 
@@ -138,6 +139,7 @@ public:
      */
     void eval_right_hand_side(Eigen::Ref<const Eigen::VectorXd> pop, Eigen::Ref<const Eigen::VectorXd> y, double t, Eigen::Ref<Eigen::VectorXd> dydt) const
     {
+        MIO_COUNTER("CompartmentalModel::eval_right_hand_side", 1);
         dydt.setZero();
 
 #if USE_DERIV_FUNC
@@ -87,6 +87,33 @@ public:
     }
 
 
+    /**
+     * @brief store the result only on an equidistant output grid, e.g. daily, instead of at every integration step.
+     * @see OdeIntegrator::set_output_step_size
+     * @param dt_output distance between output points. 0 stores every integration step.
+     */
+    void set_output_step_size(double dt_output)
+    {
+        m_integrator.set_output_step_size(dt_output);
+    }
+
+    /**
+     * @brief statistics of the integration, e.g. number of evaluations of the right hand side and rejected steps.
+     * @see OdeIntegrator::get_stats
+     */
+    const IntegratorStats& get_integrator_stats() const
+    {
+        return m_integrator.get_stats();
+    }
+
+    /**
+     * @brief set all statistics of the integration to zero.
+     */
+    void reset_integrator_stats()
+    {
+        m_integrator.reset_stats();
+    }
+
     /**
      * @brief advance simulation to tmax
      * tmax must be greater than get_result().get_last_time_point()
@@ -131,6 +158,27 @@ public:
         return *m_model;
     }
 
+    /**
+     * @brief write the state of the integration to a checkpoint.
+     * The model is not written, it is not changed by the simulation.
+     * @see CheckpointWriter
+     */
+    template <class Writer>
+    void write_checkpoint(Writer& writer) const
+    {
+        writer.write(m_integrator);
+    }
+
+    /**
+     * @brief restore the state of the integration from a checkpoint.
+     * @see CheckpointReader
+     */
+    template <class Reader>
+    IOResult<void> read_checkpoint(Reader& reader)
+    {
+        return reader.read(m_integrator);
+    }
+
 private:
 
     std::shared_ptr<IntegratorCore> m_integratorCore;
@@ -24,9 +24,12 @@
 #include "memilio/epidemiology/damping.h"
 #include "memilio/utils/stl_util.h"
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <numeric>
 #include <ostream>
+#include <utility>
 
 namespace mio
 {
@@ -36,6 +39,15 @@ namespace mio
  * where B is a baseline, M is a minimum and D is some time dependent complex damping factor.
  * Base class for e.g. time dependent contact matrices.
  * Coefficient wise expression, so B, D, M matrices must have the same shape.
+ * By default, every object owns its baseline and minimum like any other member, copies are deep copies.
+ * Baseline and minimum usually don't change after setup but are copied, e.g., into every node of a graph
+ * and every run of a parameter study. To save memory, sharing can be enabled explicitly with
+ * share_baseline_and_minimum. Then copies share baseline and minimum until one of them is modified
+ * (copy on write). This changes the semantics of references: a non-const getter of a shared object
+ * replaces the matrix by a private copy, so references obtained before from any of the objects that shared the
+ * matrix no longer see the modification and must not be used after the object that owns the new matrix is gone.
+ * Modifying ends the sharing for the modified object, later copies of it are deep copies again.
+ * Objects that share matrices can be used and copied on different threads.
  * @see Damping
  * @see ContactMatrix
  * @tparam D instance of Dampings or compatible type
@@ -56,11 +68,12 @@ public:
      */
     template <class M, class K>
     DampingMatrixExpression(const Eigen::MatrixBase<M>& baseline, const Eigen::MatrixBase<K>& minimum)
-        : m_baseline(baseline)
-        , m_minimum(minimum)
-        , m_dampings(Shape::get_shape_of(m_baseline))
+        : m_baseline(std::make_shared<Matrix>(baseline))
+        , m_minimum(std::make_shared<Matrix>(minimum))
+        , m_dampings(Shape::get_shape_of(*m_baseline))
+        , m_is_shared(false)
     {
-        assert(Shape::get_shape_of(m_minimum) == Shape::get_shape_of(m_baseline));
+        assert(Shape::get_shape_of(*m_minimum) == Shape::get_shape_of(*m_baseline));
         m_dampings.finalize();
     }
 
@@ -88,6 +101,57 @@ public:
     {
     }
 
+    /**
+     * copy constructor.
+     * Baseline and minimum are only shared with the copy if sharing is enabled, see share_baseline_and_minimum.
+     */
+    DampingMatrixExpression(const DampingMatrixExpression& other)
+        : m_baseline(other.m_is_shared ? other.m_baseline : std::make_shared<Matrix>(*other.m_baseline))
+        , m_minimum(other.m_is_shared ? other.m_minimum : std::make_shared<Matrix>(*other.m_minimum))
+        , m_dampings(other.m_dampings)
+        , m_is_shared(other.m_is_shared)
+    {
+    }
+
+    /**
+     * copy assignment.
+     * Baseline and minimum are only shared with the copy if sharing is enabled, see share_baseline_and_minimum.
+     */
+    DampingMatrixExpression& operator=(const DampingMatrixExpression& other)
+    {
+        if (this != &other) {
+            *this = DampingMatrixExpression(other);
+        }
+        return *this;
+    }
+
+    /**
+     * move constructor.
+     * The moved-from object keeps valid empty baseline and minimum.
+     */
+    DampingMatrixExpression(DampingMatrixExpression&& other)
+        : m_baseline(std::exchange(other.m_baseline, get_empty_matrix()))
+        , m_minimum(std::exchange(other.m_minimum, get_empty_matrix()))
+        , m_dampings(std::move(other.m_dampings))
+        , m_is_shared(std::exchange(other.m_is_shared, true))
+    {
+    }
+
+    /**
+     * move assignment.
+     * The moved-from object keeps valid empty baseline and minimum.
+     */
+    DampingMatrixExpression& operator=(DampingMatrixExpression&& other)
+    {
+        if (this != &other) {
+            m_baseline  = std::exchange(other.m_baseline, get_empty_matrix());
+            m_minimum   = std::exchange(other.m_minimum, get_empty_matrix());
+            m_dampings  = std::move(other.m_dampings);
+            m_is_shared = std::exchange(other.m_is_shared, true);
+        }
+        return *this;
+    }
+
     /**
      * adds a damping.
      * @see Dampings::add
@@ -129,26 +193,89 @@ public:
 
     /**
      * get the baseline matrix.
+     * The non-const overload makes a private copy if the baseline is shared and ends sharing,
+     * see share_baseline_and_minimum.
      */
     const Matrix& get_baseline() const
     {
-        return m_baseline;
+        return *m_baseline;
     }
     Matrix& get_baseline()
     {
-        return m_baseline;
+        make_unique();
+        return *m_baseline;
     }
 
     /**
      * get the minimum matrix.
+     * The non-const overload makes a private copy if the minimum is shared and ends sharing,
+     * see share_baseline_and_minimum.
      */
     const Matrix& get_minimum() const
     {
-        return m_minimum;
+        return *m_minimum;
     }
     Matrix& get_minimum()
     {
-        return m_minimum;
+        make_unique();
+        return *m_minimum;
+    }
+
+    /**
+     * enable sharing of baseline and minimum with all copies that are made from now on.
+     * Sharing ends when baseline or minimum are modified, see the class description.
+     */
+    void share_baseline_and_minimum()
+    {
+        m_is_shared = true;
+    }
+
+    /**
+     * share baseline and minimum with another object if they are equal and enable sharing for both.
+     * Reduces memory if many objects with the same baseline and minimum have been created independently,
+     * e.g. read from files.
+     * @param other object whose baseline and minimum are shared.
+     * @return true if baseline and minimum are shared after the call.
+     */
+    bool share_baseline_and_minimum(DampingMatrixExpression& other)
+    {
+        if (m_baseline != other.m_baseline &&
+            (get_shape() != other.get_shape() || *m_baseline != *other.m_baseline)) {
+            return false;
+        }
+        if (m_minimum != other.m_minimum &&
+            (get_shape() != other.get_shape() || *m_minimum != *other.m_minimum)) {
+            return false;
+        }
+        other.m_is_shared = true;
+        m_is_shared       = true;
+        m_baseline        = other.m_baseline;
+        m_minimum         = other.m_minimum;
+        return true;
+    }
+
+    /**
+     * true if baseline and minimum are shared with copies, see share_baseline_and_minimum.
+     */
+    bool is_shared() const
+    {
+        return m_is_shared;
+    }
+
+    /**
+     * number of objects that share the baseline, including this.
+     */
+    long get_baseline_use_count() const
+    {
+        return m_baseline.use_count();
+    }
+
+    /**
+     * number of objects that share the minimum, including this.
+     */
+    long get_minimum_use_count() const
+    {
+        return m_minimum.use_count();
     }
 
     /**
@@ -156,7 +283,7 @@ public:
      */
     Shape get_shape() const
     {
-        return Shape::get_shape_of(m_baseline);
+        return Shape::get_shape_of(*m_baseline);
     }
 
     /**
@@ -164,7 +291,8 @@ public:
      */
     bool operator==(const DampingMatrixExpression& other) const
     {
-        return m_baseline == other.m_baseline && m_minimum == other.m_minimum && m_dampings == other.m_dampings;
+        return get_baseline() == other.get_baseline() && get_minimum() == other.get_minimum() &&
+               m_dampings == other.m_dampings;
     }
     bool operator!=(const DampingMatrixExpression& other) const
     {
@@ -187,7 +315,8 @@ public:
      */
     auto get_matrix_at(SimulationTime t) const
     {
-        return m_baseline - (m_dampings.get_matrix_at(t).array() * (m_baseline - m_minimum).array()).matrix();
+        return get_baseline() -
+               (m_dampings.get_matrix_at(t).array() * (get_baseline() - get_minimum()).array()).matrix();
     }
     auto get_matrix_at(double t) const
     {
@@ -199,8 +328,8 @@ public:
      */
     friend void PrintTo(const DampingMatrixExpression& self, std::ostream* os)
     {
-        *os << '\n' << self.m_baseline;
-        *os << '\n' << self.m_minimum;
+        *os << '\n' << self.get_baseline();
+        *os << '\n' << self.get_minimum();
         PrintTo(self.m_dampings, os);
     }
 
@@ -254,10 +383,64 @@ public:
         return deserialize(io, Tag<DampingMatrixExpression>{});
     }
 
+    /**
+     * write the dampings to a checkpoint.
+     * Baseline and minimum are not written, they don't change during a simulation.
+     * @see CheckpointWriter
+     */
+    template <class Writer>
+    void write_checkpoint(Writer& writer) const
+    {
+        writer.write(m_dampings);
+    }
+
+    /**
+     * replace the dampings by the dampings in a checkpoint.
+     * @see CheckpointReader
+     */
+    template <class Reader>
+    IOResult<void> read_checkpoint(Reader& reader)
+    {
+        return reader.read(m_dampings);
+    }
+
 private:
-    Matrix m_baseline;
-    Matrix m_minimum;
+    /**
+     * make private copies of shared matrices before they are modified and end sharing.
+     */
+    void make_unique()
+    {
+        if (m_is_shared) {
+            make_unique(m_baseline);
+            make_unique(m_minimum);
+            m_is_shared = false;
+        }
+    }
+    /**
+     * empty matrix that is shared by all moved-from objects, never modified because it is always shared.
+     */
+    static const std::shared_ptr<Matrix>& get_empty_matrix()
+    {
+        static const auto empty = std::make_shared<Matrix>();
+        return empty;
+    }
+
+    static void make_unique(std::shared_ptr<Matrix>& m)
+    {
+        if (m.use_count() > 1) {
+            m = std::make_shared<Matrix>(*m);
+        }
+        else {
+            //the last other owner may have released the matrix on another thread,
+            //synchronize with its release so its reads happen before the modification
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+    }
+
+    std::shared_ptr<Matrix> m_baseline;
+    std::shared_ptr<Matrix> m_minimum;
     DampingsType m_dampings;
+    bool m_is_shared; ///< baseline and minimum are shared with copies.
 };
 
 /**
@@ -477,6 +660,30 @@ public:
         return deserialize(io, Tag<DampingMatrixExpressionGroup>{});
     }
 
+    /**
+     * write the dampings of all matrices to a checkpoint.
+     * @see CheckpointWriter
+     */
+    template <class Writer>
+    void write_checkpoint(Writer& writer) const
+    {
+        writer.write(m_matrices);
+    }
+
+    /**
+     * replace the dampings of all matrices by the dampings in a checkpoint.
+     * @see CheckpointReader
+     */
+    template <class Reader>
+    IOResult<void> read_checkpoint(Reader& reader)
+    {
+        BOOST_OUTCOME_TRY(reader.expect_size(m_matrices.size(), "matrices"));
+        for (auto& m : m_matrices) {
+            BOOST_OUTCOME_TRY(reader.read(m));
+        }
+        return success();
+    }
+
 private:
     std::vector<value_type> m_matrices;
 };
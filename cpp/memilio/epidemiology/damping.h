@@ -388,6 +388,54 @@ public:
         return m_dampings.size();
     }
 
+    /**
+     * write the dampings to a checkpoint.
+     * Dampings can be added during a simulation, e.g. by dynamic NPIs.
+     * @see CheckpointWriter
+     */
+    template <class Writer>
+    void write_checkpoint(Writer& writer) const
+    {
+        writer.write(uint64_t(m_dampings.size()));
+        for (auto& d : m_dampings) {
+            writer.write(d.get_level().get());
+            writer.write(d.get_type().get());
+            writer.write(d.get_time().get());
+            writer.write(d.get_coeffs());
+        }
+    }
+
+    /**
+     * replace the dampings by the dampings in a checkpoint.
+     * @see CheckpointReader
+     */
+    template <class Reader>
+    IOResult<void> read_checkpoint(Reader& reader)
+    {
+        uint64_t n;
+        BOOST_OUTCOME_TRY(reader.read(n));
+        std::vector<value_type> dampings;
+        dampings.reserve(size_t(n));
+        for (auto i = uint64_t(0); i < n; ++i) {
+            int level, type;
+            double t;
+            Matrix coeffs;
+            BOOST_OUTCOME_TRY(reader.read(level));
+            BOOST_OUTCOME_TRY(reader.read(type));
+            BOOST_OUTCOME_TRY(reader.read(t));
+            BOOST_OUTCOME_TRY(reader.read(coeffs));
+            if (Shape::get_shape_of(coeffs) != m_shape) {
+                return failure(StatusCode::InvalidValue,
+                               "Checkpoint doesn't match the simulation: damping has a different shape.");
+            }
+            //already sorted when they were written
+            dampings.emplace_back(coeffs, DampingLevel(level), DampingType(type), SimulationTime(t));
+        }
+        m_dampings = std::move(dampings);
+        m_accumulated_dampings_cached.clear();
+        return success();
+    }
+
     /**
      * dimensions of the damping matrix.
      */
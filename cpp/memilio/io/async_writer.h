@@ -0,0 +1,206 @@
+/* 
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef EPI_IO_ASYNC_WRITER_H
+#define EPI_IO_ASYNC_WRITER_H
+
+#include "memilio/io/io.h"
+#include "memilio/utils/compiler_diagnostics.h"
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <cassert>
+
+namespace mio
+{
+
+/**
+ * Writes items on a separate thread, e.g., results of parameter study runs.
+ * Producers hand off items with an index and continue while the items are written in the background.
+ * Items are always written in the order of their indices, regardless of the order in which they are added,
+ * so the output is deterministic even if the items are produced in parallel.
+ * The number of items waiting to be written is bounded, adding items blocks while the queue is full.
+ * The item with the next index to be written is always accepted so that waiting producers can't block each other.
+ * To avoid deadlocks, each producer must add its items in increasing order of their indices.
+ * After the first error, the remaining items are discarded and the error is returned by finish().
+ * If a producer fails and an index will never be added, cancel the writer so the other producers don't wait forever.
+ * @tparam T type of the written items.
+ */
+template <class T>
+class AsyncWriter
+{
+public:
+    /**
+     * Function that writes an item.
+     * Receives the index and the item, returns any errors during writing.
+     */
+    using WriteFunction = std::function<IOResult<void>(size_t, T&&)>;
+
+    /**
+     * Create a writer and start the thread that writes the items.
+     * @param write function that writes the items.
+     * @param max_queued maximum number of items that wait to be written, at least 1.
+     * @param first_idx index of the first item to be written.
+     */
+    AsyncWriter(WriteFunction write, size_t max_queued, size_t first_idx = 0)
+        : m_write(std::move(write))
+        , m_max_queued(max_queued)
+        , m_next_idx(first_idx)
+        , m_is_finished(false)
+        , m_is_cancelled(false)
+        , m_status(success())
+    {
+        assert(max_queued > 0);
+        m_thread = std::thread([this] {
+            process();
+        });
+    }
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    /**
+     * Waits until all items are written.
+     * Call finish() before to check for errors.
+     */
+    ~AsyncWriter()
+    {
+        unused(finish());
+    }
+
+    /**
+     * Add an item to be written.
+     * Blocks while the queue is full unless the item is the next to be written.
+     * The item is discarded if the writer is cancelled.
+     * Thread safe, can be called by multiple producers.
+     * @param idx index of the item, determines the order of writing. Each index must be added exactly once.
+     * @param item the item.
+     */
+    void add(size_t idx, T item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        assert((m_is_cancelled || (idx >= m_next_idx && m_queue.count(idx) == 0)) &&
+               "Each index must be added only once.");
+        m_cv_not_full.wait(lock, [this, idx] {
+            return m_is_cancelled || m_queue.size() < m_max_queued || idx == m_next_idx;
+        });
+        if (m_is_cancelled) {
+            return;
+        }
+        m_queue.emplace(idx, std::move(item));
+        m_cv_not_empty.notify_one();
+    }
+
+    /**
+     * Wait until all items are written and stop the writing thread.
+     * Items must not be added after calling this function.
+     * Items with indices after a missing index are not written.
+     * @return the first error that occured during writing, if any, or an error if the writer was cancelled.
+     */
+    IOResult<void> finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_is_finished = true;
+        }
+        m_cv_not_empty.notify_one();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_status && m_is_cancelled) {
+            return failure(StatusCode::UnknownError, "Writing was cancelled.");
+        }
+        return m_status;
+    }
+
+    /**
+     * Stop writing, e.g., if a producer failed and an index will never be added.
+     * Items that wait to be written or are added later are discarded and waiting producers continue.
+     * The item that is currently written is completed.
+     * Thread safe.
+     */
+    void cancel()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_is_cancelled = true;
+            m_queue.clear();
+        }
+        m_cv_not_full.notify_all();
+        m_cv_not_empty.notify_one();
+    }
+
+    /**
+     * Index of the next item to be written.
+     * All items with smaller indices have been written or discarded.
+     */
+    size_t get_next_index() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_next_idx;
+    }
+
+private:
+    void process()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cv_not_empty.wait(lock, [this] {
+                return m_is_finished || m_is_cancelled ||
+                       (!m_queue.empty() && m_queue.begin()->first == m_next_idx);
+            });
+            if (m_queue.empty() || m_queue.begin()->first != m_next_idx) {
+                //finished or cancelled and no more items in order
+                return;
+            }
+            auto item = std::move(m_queue.begin()->second);
+            m_queue.erase(m_queue.begin());
+
+            //write without lock so producers can continue
+            lock.unlock();
+            if (m_status) {
+                m_status = m_write(m_next_idx, std::move(item));
+            }
+            lock.lock();
+
+            ++m_next_idx;
+            m_cv_not_full.notify_all();
+        }
+    }
+
+    WriteFunction m_write;
+    size_t m_max_queued;
+    size_t m_next_idx;
+    bool m_is_finished;
+    bool m_is_cancelled;
+    IOResult<void> m_status;
+    std::map<size_t, T> m_queue;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv_not_full;
+    std::condition_variable m_cv_not_empty;
+    std::thread m_thread;
+};
+
+} // namespace mio
+
+#endif //EPI_IO_ASYNC_WRITER_H
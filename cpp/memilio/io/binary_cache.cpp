@@ -0,0 +1,115 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/io/binary_cache.h"
+#include "memilio/utils/stl_util.h"
+
+#include <ctime>
+#include <limits>
+
+namespace mio
+{
+
+namespace details
+{
+
+namespace
+{
+//increase if the content of any cache changes
+const uint64_t binary_cache_version = 1;
+
+//64 bit FNV-1a hash
+uint64_t hash_bytes(const char* data, size_t num_bytes, uint64_t hash = 14695981039346656037ull)
+{
+    for (size_t i = 0; i < num_bytes; ++i) {
+        hash = (hash ^ uint64_t(static_cast<unsigned char>(data[i]))) * 1099511628211ull;
+    }
+    return hash;
+}
+} // namespace
+
+IOResult<uint64_t> hash_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return failure(StatusCode::FileNotFound, path);
+    }
+    auto hash = hash_bytes(nullptr, 0);
+    std::vector<char> buffer(size_t(1) << 20);
+    while (file) {
+        file.read(buffer.data(), std::streamsize(buffer.size()));
+        hash = hash_bytes(buffer.data(), size_t(file.gcount()), hash);
+    }
+    return success(hash);
+}
+
+BinaryCacheHeader make_binary_cache_header(const std::string& path, const std::vector<std::string>& config)
+{
+    auto config_hash = hash_bytes(reinterpret_cast<const char*>(&binary_cache_version), sizeof(binary_cache_version));
+    for (auto& str : config) {
+        //include the terminating zero so the boundaries between strings are part of the hash
+        config_hash = hash_bytes(str.c_str(), str.size() + 1, config_hash);
+    }
+
+    //source files with the same name in different directories get different caches
+    boost::system::error_code ec;
+    auto source_path = boost::filesystem::canonical(path, ec);
+    if (ec) {
+        source_path = boost::filesystem::absolute(path);
+    }
+    auto source_path_str = source_path.string();
+    config_hash          = hash_bytes(source_path_str.c_str(), source_path_str.size() + 1, config_hash);
+
+    BinaryCacheHeader header;
+    header.config_hash = config_hash;
+    header.file_size   = uint64_t(boost::filesystem::file_size(path, ec));
+    header.file_time   = int64_t(boost::filesystem::last_write_time(path, ec));
+    header.file_hash   = 0;
+    return header;
+}
+
+IOResult<void> finalize_binary_cache_header(const std::string& path, BinaryCacheHeader& header)
+{
+    if (header.file_hash == 0) {
+        BOOST_OUTCOME_TRY(file_hash, hash_file(path));
+        header.file_hash = file_hash;
+    }
+    if (header.file_time + 1 >= int64_t(std::time(nullptr))) {
+        header.file_time = std::numeric_limits<int64_t>::min();
+    }
+    return success();
+}
+
+std::string get_binary_cache_path(const std::string& path, const std::string& cache_dir,
+                                  const BinaryCacheHeader& header)
+{
+    //one cache per source file and configuration, the hash of the configuration includes the full source path
+    return path_join(cache_dir, boost::filesystem::path(path).filename().string() + "." +
+                                    std::to_string(header.config_hash) + ".cache");
+}
+
+void create_binary_cache_directory(const std::string& cache_dir)
+{
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(cache_dir, ec);
+}
+
+} // namespace details
+
+} // namespace mio
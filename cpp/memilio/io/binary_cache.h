@@ -0,0 +1,198 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef EPI_IO_BINARY_CACHE_H
+#define EPI_IO_BINARY_CACHE_H
+
+#include "memilio/io/io.h"
+#include "memilio/io/checkpoint.h"
+#include "memilio/utils/logging.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mio
+{
+
+namespace details
+{
+/**
+ * identifies the state of a source file and the configuration of the reader that a cache was made from.
+ */
+struct BinaryCacheHeader {
+    uint64_t config_hash;
+    uint64_t file_size;
+    int64_t file_time;
+    uint64_t file_hash;
+};
+
+/**
+ * header of a cache for the current state of the source file.
+ * The hash of the file content is not computed yet.
+ * @param path source file.
+ * @param config names that identify how the data is read from the source file.
+ * The hash of the configuration also includes the canonical path of the source file.
+ */
+BinaryCacheHeader make_binary_cache_header(const std::string& path, const std::vector<std::string>& config);
+
+/**
+ * path of the cache of a source file in the cache directory.
+ */
+std::string get_binary_cache_path(const std::string& path, const std::string& cache_dir,
+                                  const BinaryCacheHeader& header);
+
+/**
+ * hash of the content of a file.
+ */
+IOResult<uint64_t> hash_file(const std::string& path);
+
+/**
+ * create the cache directory if it doesn't exist.
+ */
+void create_binary_cache_directory(const std::string& cache_dir);
+
+/**
+ * reads the data from a cache if the cache exists and was made from the same source file.
+ * If the file was touched but the content is the same, the cache is still valid.
+ * @param cache_path path of the cache.
+ * @param path source file.
+ * @param header header for the current state of the source file, the hash of the content is set if it was computed.
+ * @param hashed set to true if the content of the file had to be compared.
+ */
+template <class T>
+IOResult<T> load_binary_cache(const std::string& cache_path, const std::string& path, BinaryCacheHeader& header,
+                              bool& hashed)
+{
+    hashed = false;
+    CheckpointInputFile file(cache_path);
+    BOOST_OUTCOME_TRY(file.get_status());
+    CheckpointReader reader(file.get_stream());
+    BinaryCacheHeader cached_header;
+    BOOST_OUTCOME_TRY(reader.read(cached_header));
+    if (cached_header.config_hash != header.config_hash || cached_header.file_size != header.file_size) {
+        return failure(StatusCode::InvalidValue, "Cache " + cache_path + " is outdated.");
+    }
+    if (cached_header.file_time != header.file_time) {
+        hashed = true;
+        BOOST_OUTCOME_TRY(file_hash, hash_file(path));
+        header.file_hash = file_hash;
+        if (cached_header.file_hash != file_hash) {
+            return failure(StatusCode::InvalidValue, "Cache " + cache_path + " is outdated.");
+        }
+    }
+    else {
+        header.file_hash = cached_header.file_hash;
+    }
+    T data;
+    BOOST_OUTCOME_TRY(reader.read(data));
+    return success(std::move(data));
+}
+
+/**
+ * prepare the header to be written to a cache.
+ * Computes the hash of the content if necessary. The modification time has a resolution of one second,
+ * so it is not stored if the file was modified less than a second ago and could be modified again without
+ * changing the time. The content is compared when the cache is read the next time.
+ */
+IOResult<void> finalize_binary_cache_header(const std::string& path, BinaryCacheHeader& header);
+
+/**
+ * writes the data to a cache.
+ * @param cache_path path of the cache.
+ * @param path source file.
+ * @param header header for the current state of the source file.
+ * @param data data read from the source file.
+ */
+template <class T>
+IOResult<void> save_binary_cache(const std::string& cache_path, const std::string& path, BinaryCacheHeader header,
+                                 const T& data)
+{
+    BOOST_OUTCOME_TRY(finalize_binary_cache_header(path, header));
+    CheckpointOutputFile file(cache_path);
+    BOOST_OUTCOME_TRY(file.get_status());
+    CheckpointWriter writer(file.get_stream());
+    writer.write(header);
+    writer.write(data);
+    BOOST_OUTCOME_TRY(writer.get_status());
+    return file.commit();
+}
+
+/**
+ * writes the data to a cache, only logs a warning if the cache can't be written.
+ */
+template <class T>
+void try_save_binary_cache(const std::string& cache_path, const std::string& path, const BinaryCacheHeader& header,
+                           const T& data)
+{
+    auto saved = save_binary_cache(cache_path, path, header, data);
+    if (!saved) {
+        log_warning("Could not write cache {:s}: {:s}", cache_path, saved.error().formatted_message());
+    }
+}
+} // namespace details
+
+/**
+ * reads data that was read from a source file before from a binary cache.
+ * The cache is created when the file is read the first time and is replaced when the content of the file changes.
+ * A cache is valid if it was made with the same configuration from a file with the same size and either the same
+ * modification time or, if the file was touched, the same content.
+ * If the cache can't be written, a warning is logged and the data is returned anyway.
+ * The cache uses the binary format of checkpoints, so it is only meant to be used on the same kind of machine.
+ * @param path source file.
+ * @param cache_dir directory of the cache, the source file is always read if empty.
+ * @param config names that identify how the data is read from the source file, e.g. names of columns.
+ * @param read_file function that reads the source file and returns IOResult<T>.
+ * T must be supported by CheckpointWriter and CheckpointReader.
+ * @return the data or any error that occurs while reading the source file.
+ */
+template <class T, class F>
+IOResult<T> read_cached(const std::string& path, const std::string& cache_dir, const std::vector<std::string>& config,
+                        F read_file)
+{
+    if (cache_dir.empty() || !boost::filesystem::exists(path)) {
+        return read_file();
+    }
+
+    auto header     = details::make_binary_cache_header(path, config);
+    auto cache_path = details::get_binary_cache_path(path, cache_dir, header);
+    auto hashed     = false;
+    auto cached     = details::load_binary_cache<T>(cache_path, path, header, hashed);
+    if (cached) {
+        if (hashed) {
+            //store the new modification time, so the content doesn't need to be compared again
+            details::try_save_binary_cache(cache_path, path, header, cached.value());
+        }
+        return cached;
+    }
+    log_info("Reading {:s}, cache is not available: {:s}", path, cached.error().formatted_message());
+
+    BOOST_OUTCOME_TRY(data, read_file());
+    details::create_binary_cache_directory(cache_dir);
+    details::try_save_binary_cache(cache_path, path, header, data);
+    return success(std::move(data));
+}
+
+} // namespace mio
+
+#endif //EPI_IO_BINARY_CACHE_H
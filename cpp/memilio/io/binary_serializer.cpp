@@ -0,0 +1,66 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/io/binary_serializer.h"
+
+namespace mio
+{
+
+void ByteStream::write_bytes(const void* data, size_t num_bytes)
+{
+    if (num_bytes > 0) {
+        std::memcpy(append(num_bytes), data, num_bytes);
+    }
+}
+
+unsigned char* ByteStream::append(size_t num_bytes)
+{
+    auto pos = m_bytes.size();
+    m_bytes.resize(pos + num_bytes);
+    return m_bytes.data() + pos;
+}
+
+void ByteStream::overwrite_bytes(size_t pos, const void* data, size_t num_bytes)
+{
+    assert(pos + num_bytes <= m_bytes.size());
+    std::memcpy(m_bytes.data() + pos, data, num_bytes);
+}
+
+IOResult<void> ByteStream::read_bytes(size_t& pos, size_t end, void* data, size_t num_bytes) const
+{
+    assert(end <= m_bytes.size());
+    if (pos > end || num_bytes > end - pos) {
+        return failure(StatusCode::InvalidFileFormat, "Unexpected end of binary data.");
+    }
+    if (num_bytes > 0) {
+        std::memcpy(data, m_bytes.data() + pos, num_bytes);
+    }
+    pos += num_bytes;
+    return success();
+}
+
+IOStatus BinarySerializerObject::annotate_error(const IOStatus& error, const std::string& name)
+{
+    //the position in the buffer is undefined after an error, so all following operations must fail as well
+    auto annotated = IOStatus{error.code(), error.message() + " (" + name + ")"};
+    set_error(annotated);
+    return annotated;
+}
+
+} // namespace mio
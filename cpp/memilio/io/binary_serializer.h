@@ -0,0 +1,911 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef EPI_IO_BINARY_SERIALIZER_H
+#define EPI_IO_BINARY_SERIALIZER_H
+
+#include "memilio/io/io.h"
+#include "memilio/math/eigen.h"
+#include "boost/optional.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mio
+{
+
+/**
+ * Buffer of bytes that contains data in the binary serialization format.
+ * The data can be sent to other processes or stored and restored with deserialize_binary.
+ * All values are stored in little endian byte order, independent of the machine.
+ * @see serialize_binary, deserialize_binary
+ */
+class ByteStream
+{
+public:
+    /**
+     * create an empty buffer.
+     */
+    ByteStream() = default;
+
+    /**
+     * create a buffer that contains serialized data, e.g. received from another process.
+     * @param bytes serialized data.
+     */
+    explicit ByteStream(std::vector<unsigned char> bytes)
+        : m_bytes(std::move(bytes))
+    {
+    }
+
+    /**
+     * pointer to the first byte.
+     */
+    const unsigned char* data() const
+    {
+        return m_bytes.data();
+    }
+
+    /**
+     * number of bytes.
+     */
+    size_t size() const
+    {
+        return m_bytes.size();
+    }
+
+    /**
+     * the serialized data.
+     * @{
+     */
+    const std::vector<unsigned char>& bytes() const&
+    {
+        return m_bytes;
+    }
+    std::vector<unsigned char>&& bytes() &&
+    {
+        return std::move(m_bytes);
+    }
+    /**@}*/
+
+    /**
+     * append bytes to the end of the buffer.
+     * @param data pointer to the first byte.
+     * @param num_bytes number of bytes.
+     */
+    void write_bytes(const void* data, size_t num_bytes);
+
+    /**
+     * append uninitialized bytes to the end of the buffer.
+     * @param num_bytes number of bytes.
+     * @return pointer to the first appended byte, valid until the buffer is modified again.
+     */
+    unsigned char* append(size_t num_bytes);
+
+    /**
+     * overwrite bytes that have already been written.
+     * @param pos position of the first byte to overwrite.
+     * @param data pointer to the first new byte.
+     * @param num_bytes number of bytes.
+     */
+    void overwrite_bytes(size_t pos, const void* data, size_t num_bytes);
+
+    /**
+     * read bytes and advance the read position.
+     * @param pos read position, advanced by num_bytes if successful.
+     * @param end position after the last byte that may be read.
+     * @param data pointer to the storage of the bytes.
+     * @param num_bytes number of bytes.
+     * @return success or an error if not enough bytes are available.
+     */
+    IOResult<void> read_bytes(size_t& pos, size_t end, void* data, size_t num_bytes) const;
+
+private:
+    std::vector<unsigned char> m_bytes;
+};
+
+namespace details
+{
+    /**
+     * check if the machine stores numbers in little endian byte order.
+     */
+    inline bool is_little_endian()
+    {
+        const uint16_t one = 1;
+        unsigned char first_byte;
+        std::memcpy(&first_byte, &one, 1);
+        return first_byte == 1;
+    }
+
+    /**
+     * copy a value from or to little endian byte order.
+     * @param dst storage of the copy.
+     * @param src value to be copied.
+     * @param size number of bytes of the value.
+     */
+    inline void copy_little_endian(void* dst, const void* src, size_t size)
+    {
+        if (is_little_endian()) {
+            std::memcpy(dst, src, size);
+        }
+        else {
+            auto d = reinterpret_cast<unsigned char*>(dst);
+            auto s = reinterpret_cast<const unsigned char*>(src);
+            std::reverse_copy(s, s + size, d);
+        }
+    }
+
+    /**
+     * write a number in little endian byte order.
+     */
+    template <class T>
+    void write_binary_value(ByteStream& stream, T t)
+    {
+        copy_little_endian(stream.append(sizeof(T)), &t, sizeof(T));
+    }
+
+    /**
+     * read a number in little endian byte order.
+     */
+    template <class T>
+    IOResult<T> read_binary_value(const ByteStream& stream, size_t& pos, size_t end)
+    {
+        unsigned char bytes[sizeof(T)];
+        BOOST_OUTCOME_TRY(stream.read_bytes(pos, end, bytes, sizeof(T)));
+        T t;
+        copy_little_endian(&t, bytes, sizeof(T));
+        return success(t);
+    }
+} // namespace details
+
+/**
+ * BinaryType allows the conversion of basic types for serialization.
+ * All types that are directly handled by the binary serializer inherit
+ * from std::true_type. They also define the functions that write and read them.
+ * All others inherit from std::false_type, external serialization functions need to be available.
+ * Numbers are stored with the size of their type, so the same types must be used for
+ * serialization and deserialization.
+ * @tparam T the type to be serialized.
+ * @{
+ */
+template <class T, class = void>
+struct BinaryType : std::false_type {
+};
+//integers and floating point
+template <class T>
+struct BinaryType<T, std::enable_if_t<std::is_arithmetic<T>::value>> : std::true_type {
+    static void write(ByteStream& stream, T t)
+    {
+        details::write_binary_value(stream, t);
+    }
+    static IOResult<T> read(const ByteStream& stream, size_t& pos, size_t end)
+    {
+        return details::read_binary_value<T>(stream, pos, end);
+    }
+};
+//bool, stored as a single byte
+template <>
+struct BinaryType<bool> : std::true_type {
+    static void write(ByteStream& stream, bool b)
+    {
+        details::write_binary_value(stream, uint8_t(b ? 1 : 0));
+    }
+    static IOResult<bool> read(const ByteStream& stream, size_t& pos, size_t end)
+    {
+        BOOST_OUTCOME_TRY(b, details::read_binary_value<uint8_t>(stream, pos, end));
+        if (b > 1) {
+            return failure(StatusCode::InvalidType, "Binary value is not a bool.");
+        }
+        return success(b == 1);
+    }
+};
+//string, stored with its length
+template <>
+struct BinaryType<std::string> : std::true_type {
+    static void write(ByteStream& stream, const std::string& s)
+    {
+        details::write_binary_value(stream, uint64_t(s.size()));
+        stream.write_bytes(s.data(), s.size());
+    }
+    static IOResult<std::string> read(const ByteStream& stream, size_t& pos, size_t end)
+    {
+        BOOST_OUTCOME_TRY(n, details::read_binary_value<uint64_t>(stream, pos, end));
+        if (n > end - pos) {
+            return failure(StatusCode::InvalidFileFormat, "Binary string exceeds the available data.");
+        }
+        std::string s(size_t(n), '\0');
+        BOOST_OUTCOME_TRY(stream.read_bytes(pos, end, &s[0], s.size()));
+        return success(std::move(s));
+    }
+};
+//string literals, can only be written
+template <>
+struct BinaryType<const char*> : std::true_type {
+    static void write(ByteStream& stream, const char* s)
+    {
+        BinaryType<std::string>::write(stream, std::string(s));
+    }
+};
+/**@}*/
+
+/**
+ * Base class for implementations of serialization framework concepts.
+ * Stores status, flags and the buffer that contains the data.
+ */
+class BinarySerializerBase
+{
+public:
+    /**
+     * Constructor that sets status, flags and buffer.
+     */
+    BinarySerializerBase(ByteStream& stream, std::shared_ptr<IOStatus> status, int flags)
+        : m_stream(stream)
+        , m_status(status)
+        , m_flags(flags)
+    {
+        assert(status && "Status must not be null.");
+    }
+
+    /**
+     * Flags that determine the behavior of serialization.
+     * @see mio::IOFlags
+     */
+    int flags() const
+    {
+        return m_flags;
+    }
+
+    /**
+     * Set flags that determine the behavior of serialization.
+     * @see mio::IOFlags
+     */
+    void set_flags(int f)
+    {
+        m_flags = f;
+    }
+
+    /**
+     * The current status of serialization.
+     * Contains errors that occurred.
+     */
+    const IOStatus& status() const
+    {
+        return *m_status;
+    }
+
+    /**
+     * Set the current status of serialization.
+     */
+    void set_error(const IOStatus& status)
+    {
+        if (*m_status) {
+            *m_status = status;
+        }
+    }
+
+protected:
+    ByteStream& m_stream;
+    std::shared_ptr<IOStatus> m_status;
+    int m_flags;
+};
+
+/**
+ * Implementation of the IOObject concept for the binary format.
+ * The names of the elements are not stored, elements must be retrieved in the same order as they were added.
+ * Elements that are not of basic type are stored with their size, so each of them can be read independently.
+ */
+class BinarySerializerObject : public BinarySerializerBase
+{
+public:
+    /**
+     * Constructor to set the status, flags, and the part of the buffer that contains the object.
+     * @param stream buffer that contains the data.
+     * @param begin position of the first byte of the object.
+     * @param end position after the last byte of the object, only used for deserialization.
+     * @param status status, shared with the parent IO context and objects.
+     * @param flags flags to determine the behavior of serialization.
+     */
+    BinarySerializerObject(ByteStream& stream, size_t begin, size_t end, const std::shared_ptr<IOStatus>& status,
+                           int flags)
+        : BinarySerializerBase(stream, status, flags)
+        , m_position(begin)
+        , m_end(end)
+    {
+    }
+
+    /**
+     * add element to the buffer.
+     * @tparam T the type of the value to be serialized.
+     * @param name name of the element, not stored.
+     * @param value value of the element.
+     */
+    template <class T>
+    void add_element(const std::string& name, const T& value);
+
+    /**
+     * add optional element to the buffer.
+     * @tparam T the type of the value to be serialized.
+     * @param name name of the element, not stored.
+     * @param value pointer to value of the element, may be null.
+     */
+    template <class T>
+    void add_optional(const std::string& name, const T* value);
+
+    /**
+     * add list of elements to the buffer.
+     * Lists of numbers are stored in one block.
+     * @tparam Iter type of the iterators that represent the list.
+     * @param name name of the list, not stored.
+     * @param b iterator to first element in the list.
+     * @param e iterator to end of the list.
+     */
+    template <class Iter>
+    void add_list(const std::string& name, Iter b, Iter e);
+
+    /**
+     * add contiguous array of numbers to the buffer in one block.
+     * Stored in the same format as a list.
+     * @tparam T the type of the numbers.
+     * @param name name of the array, not stored.
+     * @param data pointer to the first number.
+     * @param n number of numbers.
+     */
+    template <class T>
+    void add_array(const std::string& name, const T* data, size_t n);
+
+    /**
+     * retrieve the next element from the buffer.
+     * @tparam T the type of value to be deserialized.
+     * @param name name of the element, used for error messages.
+     * @param tag define type of the element for overload resolution.
+     * @return retrieved element if succesful, error otherwise.
+     */
+    template <class T>
+    IOResult<T> expect_element(const std::string& name, Tag<T> tag);
+
+    /**
+     * retrieve the next optional element from the buffer.
+     * @tparam T the type of value to be deserialized.
+     * @param name name of the element, used for error messages.
+     * @param tag define type of the element for overload resolution.
+     * @return retrieved element if it was stored, empty optional if it wasn't stored, error otherwise.
+     */
+    template <class T>
+    IOResult<boost::optional<T>> expect_optional(const std::string& name, Tag<T> tag);
+
+    /**
+     * retrieve the next list of elements from the buffer.
+     * @tparam T the type of the elements in the list to be deserialized.
+     * @param name name of the list, used for error messages.
+     * @param tag define type of the list elements for overload resolution.
+     * @param return vector of deserialized elements if succesful, error otherwise.
+     */
+    template <class T>
+    IOResult<std::vector<T>> expect_list(const std::string& name, Tag<T> tag);
+
+    /**
+     * retrieve the next contiguous array of numbers from the buffer, copied in one block.
+     * @tparam T the type of the numbers.
+     * @param name name of the array, used for error messages.
+     * @param data pointer to the storage of the numbers.
+     * @param n expected number of numbers.
+     * @return success if the array has the expected size, error otherwise.
+     */
+    template <class T>
+    IOResult<void> expect_array(const std::string& name, T* data, size_t n);
+
+private:
+    //write a basic value or a value with its size
+    template <class T, std::enable_if_t<BinaryType<T>::value, void*> = nullptr>
+    void write_element(const T& value);
+    template <class T, std::enable_if_t<!BinaryType<T>::value, void*> = nullptr>
+    void write_element(const T& value);
+
+    //read the next basic value or value with its size
+    template <class T, std::enable_if_t<BinaryType<T>::value, void*> = nullptr>
+    IOResult<T> read_element(Tag<T> tag);
+    template <class T, std::enable_if_t<!BinaryType<T>::value, void*> = nullptr>
+    IOResult<T> read_element(Tag<T> tag);
+
+    //lists of numbers are copied in one block
+    template <class T, class Iter>
+    std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value> write_list(Iter b, size_t n);
+    template <class T, class Iter>
+    std::enable_if_t<!std::is_arithmetic<T>::value || std::is_same<T, bool>::value> write_list(Iter b, size_t n);
+    template <class T>
+    std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, IOResult<std::vector<T>>>
+    read_list(size_t n);
+    template <class T>
+    std::enable_if_t<!std::is_arithmetic<T>::value || std::is_same<T, bool>::value, IOResult<std::vector<T>>>
+    read_list(size_t n);
+
+    //set the error of this object and annotate it with the name of the element
+    IOStatus annotate_error(const IOStatus& error, const std::string& name);
+
+    size_t m_position;
+    size_t m_end;
+};
+
+/**
+ * Implemenetation of IOContext concept for the binary format.
+ */
+class BinarySerializerContext : public BinarySerializerBase
+{
+public:
+    /**
+     * Create context for serialization or deserialization.
+     * @param stream buffer that contains the data.
+     * @param begin position of the first byte of the serialized value.
+     * @param end position after the last byte of the serialized value, only used for deserialization.
+     * @param status status of serialization, shared with parent IO contexts and objects.
+     * @param flags flags to determine behavior of serialization.
+     */
+    BinarySerializerContext(ByteStream& stream, size_t begin, size_t end, const std::shared_ptr<IOStatus>& status,
+                            int flags)
+        : BinarySerializerBase(stream, status, flags)
+        , m_begin(begin)
+        , m_end(end)
+    {
+    }
+
+    /**
+     * Create a BinarySerializerObject that accepts serialization data.
+     * The type of the object is not stored.
+     * @param type name of the type of the object.
+     * @return new BinarySerializerObject for serialization.
+     */
+    BinarySerializerObject create_object(const std::string& type)
+    {
+        mio::unused(type);
+        return BinarySerializerObject(m_stream, m_stream.size(), m_stream.size(), m_status, m_flags);
+    }
+
+    /**
+     * Create a BinarySerializerObject that contains serialized data.
+     * Each call starts reading at the beginning of the object again,
+     * so e.g. the type of a polymorphic object can be inspected before the object is read.
+     * @param type name of the type of the object.
+     * @return new BinarySerializerObject for deserialization.
+     */
+    BinarySerializerObject expect_object(const std::string& type)
+    {
+        mio::unused(type);
+        return BinarySerializerObject(m_stream, m_begin, m_end, m_status, m_flags);
+    }
+
+    /**
+     * Serialize objects of basic types on their own.
+     * Used to write e.g. a single integer if it is not a member of an object or container.
+     * @tparam T the type of value to be serialized.
+     * @param io reference to the BinarySerializerContext.
+     * @param t value to be serialized.
+     */
+    template <class T, std::enable_if_t<BinaryType<T>::value, void*> = nullptr>
+    friend void serialize_internal(BinarySerializerContext& io, const T& t)
+    {
+        if (io.m_status->is_ok()) {
+            BinaryType<T>::write(io.m_stream, t);
+        }
+    }
+
+    /**
+     * Deserialize objects of basic types on their own.
+     * Used to restore e.g. a single integer if it is not a member of an object or container.
+     * @tparam T the type of value to be deserialized.
+     * @param io reference to the BinarySerializerContext.
+     * @param tag defines the type of the value for overload resolution.
+     */
+    template <class T, std::enable_if_t<BinaryType<T>::value, void*> = nullptr>
+    friend IOResult<T> deserialize_internal(BinarySerializerContext& io, Tag<T>)
+    {
+        if (io.m_status->is_error()) {
+            return failure(*io.m_status);
+        }
+        auto pos = io.m_begin;
+        auto r   = BinaryType<T>::read(io.m_stream, pos, io.m_end);
+        if (!r) {
+            io.set_error(r.error());
+        }
+        return r;
+    }
+
+    /**
+     * Serialize a dense Eigen matrix or array of numbers.
+     * The elements are copied in one block in the storage order of the matrix.
+     * @param io reference to the BinarySerializerContext.
+     * @param m matrix to be serialized.
+     * @{
+     */
+    template <class S, int R, int C, int O, int MR, int MC,
+              std::enable_if_t<std::is_arithmetic<S>::value, void*> = nullptr>
+    friend void serialize_internal(BinarySerializerContext& io, const Eigen::Matrix<S, R, C, O, MR, MC>& m)
+    {
+        io.write_dense(m);
+    }
+    template <class S, int R, int C, int O, int MR, int MC,
+              std::enable_if_t<std::is_arithmetic<S>::value, void*> = nullptr>
+    friend void serialize_internal(BinarySerializerContext& io, const Eigen::Array<S, R, C, O, MR, MC>& m)
+    {
+        io.write_dense(m);
+    }
+    /**@}*/
+
+    /**
+     * Deserialize a dense Eigen matrix or array of numbers.
+     * @param io reference to the BinarySerializerContext.
+     * @param tag defines the type of the matrix for overload resolution.
+     * @{
+     */
+    template <class S, int R, int C, int O, int MR, int MC,
+              std::enable_if_t<std::is_arithmetic<S>::value, void*> = nullptr>
+    friend IOResult<Eigen::Matrix<S, R, C, O, MR, MC>>
+    deserialize_internal(BinarySerializerContext& io, Tag<Eigen::Matrix<S, R, C, O, MR, MC>> tag)
+    {
+        return io.read_dense(tag);
+    }
+    template <class S, int R, int C, int O, int MR, int MC,
+              std::enable_if_t<std::is_arithmetic<S>::value, void*> = nullptr>
+    friend IOResult<Eigen::Array<S, R, C, O, MR, MC>>
+    deserialize_internal(BinarySerializerContext& io, Tag<Eigen::Array<S, R, C, O, MR, MC>> tag)
+    {
+        return io.read_dense(tag);
+    }
+    /**@}*/
+
+private:
+    template <class M>
+    void write_dense(const M& m);
+
+    template <class M>
+    IOResult<M> read_dense(Tag<M> tag);
+
+    size_t m_begin;
+    size_t m_end;
+};
+
+/**
+ * serialize an object into the binary format.
+ * @param t object to serialize.
+ * @param flags flags that determine the behavior of serialization; see mio::IOFlags.
+ * @return buffer that contains the serialized data if successful, error otherwise.
+ */
+template <class T>
+IOResult<ByteStream> serialize_binary(const T& t, int flags = IOF_None)
+{
+    ByteStream stream;
+    auto status = std::make_shared<IOStatus>();
+    BinarySerializerContext ctxt(stream, 0, 0, status, flags);
+    mio::serialize(ctxt, t);
+    if (status->is_error()) {
+        return failure(*status);
+    }
+    return success(std::move(stream));
+}
+
+/**
+ * deserialize an object from the binary format.
+ * @param stream buffer that contains the serialized data.
+ * @param tag defines the type of the object to be deserialized.
+ * @param flags flags that determine the behavior of serialization; see mio::IOFlags.
+ *              must be the same flags that were used for serialization.
+ * @return deserialized object if successful, error otherwise.
+ */
+template <class T>
+IOResult<T> deserialize_binary(const ByteStream& stream, Tag<T> tag, int flags = IOF_None)
+{
+    //reading doesn't modify the buffer, the context only needs a mutable reference for writing
+    BinarySerializerContext ctxt(const_cast<ByteStream&>(stream), 0, stream.size(), std::make_shared<IOStatus>(),
+                                 flags);
+    return mio::deserialize(ctxt, tag);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//Implementations for BinarySerializerContext/Object member functions below//
+/////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+void BinarySerializerObject::add_element(const std::string& name, const T& value)
+{
+    mio::unused(name);
+    if (m_status->is_ok()) {
+        write_element(value);
+    }
+}
+
+template <class T>
+void BinarySerializerObject::add_optional(const std::string& name, const T* value)
+{
+    mio::unused(name);
+    if (m_status->is_ok()) {
+        BinaryType<bool>::write(m_stream, value != nullptr);
+        if (value) {
+            write_element(*value);
+        }
+    }
+}
+
+template <class Iter>
+void BinarySerializerObject::add_list(const std::string& name, Iter b, Iter e)
+{
+    mio::unused(name);
+    if (m_status->is_ok()) {
+        //not all iterators used for lists support std::distance
+        size_t n = 0;
+        for (auto it = b; it < e; ++it) {
+            ++n;
+        }
+        details::write_binary_value(m_stream, uint64_t(n));
+        write_list<std::decay_t<decltype(*b)>>(b, n);
+    }
+}
+
+template <class T>
+void BinarySerializerObject::add_array(const std::string& name, const T* data, size_t n)
+{
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, "Arrays must contain numbers.");
+    mio::unused(name);
+    if (m_status->is_ok()) {
+        details::write_binary_value(m_stream, uint64_t(n));
+        if (details::is_little_endian()) {
+            m_stream.write_bytes(data, n * sizeof(T));
+        }
+        else {
+            write_list<T>(data, n);
+        }
+    }
+}
+
+template <class T>
+IOResult<T> BinarySerializerObject::expect_element(const std::string& name, Tag<T> tag)
+{
+    if (m_status->is_error()) {
+        return failure(*m_status);
+    }
+    auto r = read_element(tag);
+    if (r) {
+        return r;
+    }
+    return failure(annotate_error(r.error(), name));
+}
+
+template <class T>
+IOResult<boost::optional<T>> BinarySerializerObject::expect_optional(const std::string& name, Tag<T> tag)
+{
+    if (m_status->is_error()) {
+        return failure(*m_status);
+    }
+    auto has_value = BinaryType<bool>::read(m_stream, m_position, m_end);
+    if (!has_value) {
+        return failure(annotate_error(has_value.error(), name));
+    }
+    if (!has_value.value()) {
+        return success(boost::optional<T>{});
+    }
+    auto r = read_element(tag);
+    if (r) {
+        return success(std::move(r).value());
+    }
+    return failure(annotate_error(r.error(), name));
+}
+
+template <class T>
+IOResult<std::vector<T>> BinarySerializerObject::expect_list(const std::string& name, Tag<T> /*tag*/)
+{
+    if (m_status->is_error()) {
+        return failure(*m_status);
+    }
+    auto n = details::read_binary_value<uint64_t>(m_stream, m_position, m_end);
+    if (!n) {
+        return failure(annotate_error(n.error(), name));
+    }
+    //every element needs at least one byte, protects against allocating huge lists from corrupted data
+    if (n.value() > m_end - m_position) {
+        return failure(annotate_error(
+            IOStatus{StatusCode::InvalidFileFormat, "Binary list exceeds the available data."}, name));
+    }
+    auto r = read_list<T>(size_t(n.value()));
+    if (r) {
+        return r;
+    }
+    return failure(annotate_error(r.error(), name));
+}
+
+template <class T>
+IOResult<void> BinarySerializerObject::expect_array(const std::string& name, T* data, size_t n)
+{
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, "Arrays must contain numbers.");
+    if (m_status->is_error()) {
+        return failure(*m_status);
+    }
+    auto result = [&]() -> IOResult<void> {
+        BOOST_OUTCOME_TRY(size, details::read_binary_value<uint64_t>(m_stream, m_position, m_end));
+        if (size != n) {
+            return failure(StatusCode::InvalidValue, "Binary array has the wrong number of elements.");
+        }
+        if (details::is_little_endian()) {
+            return m_stream.read_bytes(m_position, m_end, data, n * sizeof(T));
+        }
+        for (size_t i = 0; i < n; ++i) {
+            BOOST_OUTCOME_TRY(t, details::read_binary_value<T>(m_stream, m_position, m_end));
+            data[i] = t;
+        }
+        return success();
+    }();
+    if (result) {
+        return result;
+    }
+    return failure(annotate_error(result.error(), name));
+}
+
+template <class T, std::enable_if_t<BinaryType<T>::value, void*>>
+void BinarySerializerObject::write_element(const T& value)
+{
+    BinaryType<T>::write(m_stream, value);
+}
+
+template <class T, std::enable_if_t<!BinaryType<T>::value, void*>>
+void BinarySerializerObject::write_element(const T& value)
+{
+    //reserve space for the size, which is known after the value has been written
+    auto size_pos = m_stream.size();
+    details::write_binary_value(m_stream, uint64_t(0));
+    auto begin = m_stream.size();
+    auto ctxt  = BinarySerializerContext(m_stream, begin, begin, m_status, m_flags);
+    mio::serialize(ctxt, value);
+    unsigned char size[sizeof(uint64_t)];
+    auto n = uint64_t(m_stream.size() - begin);
+    details::copy_little_endian(size, &n, sizeof(n));
+    m_stream.overwrite_bytes(size_pos, size, sizeof(size));
+}
+
+template <class T, std::enable_if_t<BinaryType<T>::value, void*>>
+IOResult<T> BinarySerializerObject::read_element(Tag<T> /*tag*/)
+{
+    return BinaryType<T>::read(m_stream, m_position, m_end);
+}
+
+template <class T, std::enable_if_t<!BinaryType<T>::value, void*>>
+IOResult<T> BinarySerializerObject::read_element(Tag<T> tag)
+{
+    BOOST_OUTCOME_TRY(n, details::read_binary_value<uint64_t>(m_stream, m_position, m_end));
+    if (n > m_end - m_position) {
+        return failure(StatusCode::InvalidFileFormat, "Binary element exceeds the available data.");
+    }
+    auto begin = m_position;
+    m_position += size_t(n);
+    auto ctxt = BinarySerializerContext(m_stream, begin, m_position, m_status, m_flags);
+    return mio::deserialize(ctxt, tag);
+}
+
+template <class T, class Iter>
+std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>
+BinarySerializerObject::write_list(Iter b, size_t n)
+{
+    auto bytes = m_stream.append(n * sizeof(T));
+    for (size_t i = 0; i < n; ++i, ++b) {
+        const T t = *b;
+        details::copy_little_endian(bytes + i * sizeof(T), &t, sizeof(T));
+    }
+}
+
+template <class T, class Iter>
+std::enable_if_t<!std::is_arithmetic<T>::value || std::is_same<T, bool>::value>
+BinarySerializerObject::write_list(Iter b, size_t n)
+{
+    for (size_t i = 0; i < n; ++i, ++b) {
+        write_element<T>(*b);
+    }
+}
+
+template <class T>
+std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, IOResult<std::vector<T>>>
+BinarySerializerObject::read_list(size_t n)
+{
+    if (n > (m_end - m_position) / sizeof(T)) {
+        return failure(StatusCode::InvalidFileFormat, "Binary list exceeds the available data.");
+    }
+    std::vector<T> v(n);
+    if (details::is_little_endian()) {
+        BOOST_OUTCOME_TRY(m_stream.read_bytes(m_position, m_end, v.data(), n * sizeof(T)));
+    }
+    else {
+        for (auto& t : v) {
+            BOOST_OUTCOME_TRY(t_, details::read_binary_value<T>(m_stream, m_position, m_end));
+            t = t_;
+        }
+    }
+    return success(std::move(v));
+}
+
+template <class T>
+std::enable_if_t<!std::is_arithmetic<T>::value || std::is_same<T, bool>::value, IOResult<std::vector<T>>>
+BinarySerializerObject::read_list(size_t n)
+{
+    std::vector<T> v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        BOOST_OUTCOME_TRY(t, read_element(Tag<T>{}));
+        v.emplace_back(std::move(t));
+    }
+    return success(std::move(v));
+}
+
+template <class M>
+void BinarySerializerContext::write_dense(const M& m)
+{
+    using Scalar = typename M::Scalar;
+    if (m_status->is_ok()) {
+        details::write_binary_value(m_stream, int64_t(m.rows()));
+        details::write_binary_value(m_stream, int64_t(m.cols()));
+        auto n = size_t(m.size());
+        if (details::is_little_endian()) {
+            m_stream.write_bytes(m.data(), n * sizeof(Scalar));
+        }
+        else {
+            for (size_t i = 0; i < n; ++i) {
+                details::write_binary_value(m_stream, m.data()[i]);
+            }
+        }
+    }
+}
+
+template <class M>
+IOResult<M> BinarySerializerContext::read_dense(Tag<M> /*tag*/)
+{
+    using Scalar = typename M::Scalar;
+    if (m_status->is_error()) {
+        return failure(*m_status);
+    }
+    auto pos    = m_begin;
+    auto result = [&]() -> IOResult<M> {
+        BOOST_OUTCOME_TRY(rows, details::read_binary_value<int64_t>(m_stream, pos, m_end));
+        BOOST_OUTCOME_TRY(cols, details::read_binary_value<int64_t>(m_stream, pos, m_end));
+        if (rows < 0 || cols < 0 || (M::RowsAtCompileTime != Eigen::Dynamic && rows != M::RowsAtCompileTime) ||
+            (M::ColsAtCompileTime != Eigen::Dynamic && cols != M::ColsAtCompileTime)) {
+            return failure(StatusCode::InvalidValue, "Invalid dimensions of binary matrix.");
+        }
+        if (cols > 0 && uint64_t(rows) > (m_end - pos) / sizeof(Scalar) / uint64_t(cols)) {
+            return failure(StatusCode::InvalidFileFormat, "Binary matrix exceeds the available data.");
+        }
+        M m;
+        m.resize(Eigen::Index(rows), Eigen::Index(cols));
+        if (details::is_little_endian()) {
+            BOOST_OUTCOME_TRY(m_stream.read_bytes(pos, m_end, m.data(), size_t(m.size()) * sizeof(Scalar)));
+        }
+        else {
+            for (Eigen::Index i = 0; i < m.size(); ++i) {
+                BOOST_OUTCOME_TRY(s, details::read_binary_value<Scalar>(m_stream, pos, m_end));
+                m.data()[i] = s;
+            }
+        }
+        return success(std::move(m));
+    }();
+    if (!result) {
+        set_error(result.error());
+    }
+    return result;
+}
+
+} // namespace mio
+
+#endif //EPI_IO_BINARY_SERIALIZER_H
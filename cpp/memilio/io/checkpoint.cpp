@@ -0,0 +1,135 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/io/checkpoint.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace mio
+{
+
+namespace details
+{
+
+namespace
+{
+//identifies checkpoint files
+const char checkpoint_magic[8] = {'M', 'I', 'O', 'C', 'H', 'K', 'P', 'T'};
+
+//increase if the format of any checkpoint changes
+const uint32_t checkpoint_version = 3;
+
+//larger buffer than the default so large arrays are written and read in few system calls
+const size_t checkpoint_buffer_size = size_t(1) << 20;
+
+/**
+ * name of a temporary file that is unique even if several processes write the same file.
+ */
+std::string unique_temporary_checkpoint_name(const std::string& filename)
+{
+    return filename + "." + boost::filesystem::unique_path("%%%%-%%%%-%%%%-%%%%").string() + ".tmp";
+}
+
+IOResult<void> check_checkpoint_header(const std::string& filename, std::istream& file)
+{
+    char magic[sizeof(checkpoint_magic)];
+    uint32_t version;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!file || std::memcmp(magic, checkpoint_magic, sizeof(magic)) != 0) {
+        return failure(StatusCode::InvalidFileFormat, filename + " is not a checkpoint.");
+    }
+    if (version != checkpoint_version) {
+        return failure(StatusCode::InvalidFileFormat, "Checkpoint " + filename + " has version " +
+                                                          std::to_string(version) + ", expected " +
+                                                          std::to_string(checkpoint_version) + ".");
+    }
+    return success();
+}
+} // namespace
+
+CheckpointOutputFile::CheckpointOutputFile(const std::string& filename)
+    : m_filename(filename)
+    , m_temporary_filename(unique_temporary_checkpoint_name(filename))
+    , m_buffer(checkpoint_buffer_size)
+    , m_is_committed(false)
+{
+    m_file.rdbuf()->pubsetbuf(m_buffer.data(), std::streamsize(m_buffer.size()));
+    m_file.open(m_temporary_filename, std::ios::binary | std::ios::trunc);
+    if (m_file.is_open()) {
+        m_file.write(checkpoint_magic, sizeof(checkpoint_magic));
+        m_file.write(reinterpret_cast<const char*>(&checkpoint_version), sizeof(checkpoint_version));
+    }
+}
+
+CheckpointOutputFile::~CheckpointOutputFile()
+{
+    if (!m_is_committed && m_file.is_open()) {
+        m_file.close();
+        std::remove(m_temporary_filename.c_str());
+    }
+}
+
+IOResult<void> CheckpointOutputFile::get_status() const
+{
+    if (!m_file.is_open()) {
+        return failure(StatusCode::FileNotFound, m_temporary_filename);
+    }
+    return success();
+}
+
+IOResult<void> CheckpointOutputFile::commit()
+{
+    assert(!m_is_committed);
+    m_file.close();
+    m_is_committed = true;
+    if (!m_file) {
+        std::remove(m_temporary_filename.c_str());
+        return failure(StatusCode::UnknownError, "Writing checkpoint " + m_filename + " failed.");
+    }
+    if (std::rename(m_temporary_filename.c_str(), m_filename.c_str()) != 0) {
+        auto error = std::error_code(errno, std::generic_category());
+        std::remove(m_temporary_filename.c_str());
+        return failure(error, m_filename);
+    }
+    return success();
+}
+
+CheckpointInputFile::CheckpointInputFile(const std::string& filename)
+    : m_buffer(checkpoint_buffer_size)
+    , m_status(success())
+{
+    m_file.rdbuf()->pubsetbuf(m_buffer.data(), std::streamsize(m_buffer.size()));
+    m_file.open(filename, std::ios::binary);
+    if (!m_file.is_open()) {
+        m_status = failure(StatusCode::FileNotFound, filename);
+    }
+    else {
+        m_status = check_checkpoint_header(filename, m_file);
+    }
+}
+
+} // namespace details
+
+} // namespace mio
@@ -0,0 +1,491 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef EPI_IO_CHECKPOINT_H
+#define EPI_IO_CHECKPOINT_H
+
+#include "memilio/io/io.h"
+#include "memilio/math/eigen.h"
+#include "memilio/utils/time_series.h"
+
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mio
+{
+
+/**
+ * Writes the state of a running simulation in a binary format, so the simulation can be resumed later.
+ * A checkpoint only contains the state that changes during the simulation, e.g. the current time and
+ * the compartments or the persons, but not the parameters that are set up before the simulation starts.
+ * The values are written in the memory layout of the machine without any conversion, so large arrays can
+ * be written as fast as the stream allows. Checkpoints are meant to restart a simulation with the same
+ * build on the same kind of machine, not to exchange data.
+ * Types that are not trivially copyable are written by a member function `write_checkpoint(CheckpointWriter&) const`.
+ * @see CheckpointReader, save_checkpoint
+ */
+class CheckpointWriter
+{
+public:
+    /**
+     * create a writer.
+     * @param stream binary output stream, must be valid while the writer is used.
+     */
+    explicit CheckpointWriter(std::ostream& stream)
+        : m_stream(stream)
+    {
+    }
+
+    /**
+     * write raw bytes.
+     * @param data pointer to the first byte.
+     * @param num_bytes number of bytes.
+     */
+    void write_bytes(const void* data, size_t num_bytes)
+    {
+        m_stream.write(reinterpret_cast<const char*>(data), std::streamsize(num_bytes));
+    }
+
+    /**
+     * write a trivially copyable value, e.g. a number or an enum, as it is stored in memory.
+     */
+    template <class T, std::enable_if_t<std::is_trivially_copyable<T>::value, void*> = nullptr>
+    void write(const T& t)
+    {
+        write_bytes(&t, sizeof(T));
+    }
+
+    /**
+     * write any other value with its member function `write_checkpoint(CheckpointWriter&) const`.
+     */
+    template <class T, std::enable_if_t<!std::is_trivially_copyable<T>::value, void*> = nullptr>
+    void write(const T& t)
+    {
+        t.write_checkpoint(*this);
+    }
+
+    /**
+     * write a contiguous array of trivially copyable values in one block.
+     * The size is not written.
+     */
+    template <class T>
+    void write_array(const T* data, size_t n)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written in a block.");
+        write_bytes(data, n * sizeof(T));
+    }
+
+    /**
+     * write a vector with its size.
+     */
+    template <class T>
+    void write(const std::vector<T>& v)
+    {
+        write(uint64_t(v.size()));
+        write_elements(v);
+    }
+
+    /**
+     * write a dense Eigen matrix or vector with its size.
+     */
+    template <class S, int R, int C, int O, int MR, int MC>
+    void write(const Eigen::Matrix<S, R, C, O, MR, MC>& m)
+    {
+        write(int64_t(m.rows()));
+        write(int64_t(m.cols()));
+        write_array(m.data(), size_t(m.size()));
+    }
+
+    /**
+     * write a time series with its size.
+     */
+    template <class FP>
+    void write(const TimeSeries<FP>& ts)
+    {
+        write(int64_t(ts.get_num_elements()));
+        write(int64_t(ts.get_num_time_points()));
+        write_array(ts.data(), size_t(ts.get_num_rows() * ts.get_num_time_points()));
+    }
+
+    /**
+     * check if all values have been written successfully so far.
+     * @return success or an error if writing to the stream failed.
+     */
+    IOResult<void> get_status() const
+    {
+        if (!m_stream) {
+            return failure(StatusCode::UnknownError, "Writing the checkpoint failed.");
+        }
+        return success();
+    }
+
+private:
+    template <class T, std::enable_if_t<std::is_trivially_copyable<T>::value, void*> = nullptr>
+    void write_elements(const std::vector<T>& v)
+    {
+        write_array(v.data(), v.size());
+    }
+    template <class T, std::enable_if_t<!std::is_trivially_copyable<T>::value, void*> = nullptr>
+    void write_elements(const std::vector<T>& v)
+    {
+        for (auto& t : v) {
+            write(t);
+        }
+    }
+
+    std::ostream& m_stream;
+};
+
+/**
+ * Reads the state of a simulation from a checkpoint written by CheckpointWriter.
+ * The state is read into existing objects that were set up with the same parameters as the objects
+ * that were written, so only the state that changes during the simulation must be read.
+ * Types that are not trivially copyable are read by a member function
+ * `IOResult<void> read_checkpoint(CheckpointReader&)`.
+ * @see CheckpointWriter, load_checkpoint
+ */
+class CheckpointReader
+{
+public:
+    /**
+     * create a reader.
+     * @param stream binary input stream, must be valid while the reader is used.
+     */
+    explicit CheckpointReader(std::istream& stream)
+        : m_stream(stream)
+    {
+    }
+
+    /**
+     * read raw bytes.
+     * @param data pointer to memory for at least num_bytes bytes.
+     * @param num_bytes number of bytes.
+     * @return an error if the stream ended before all bytes were read.
+     */
+    IOResult<void> read_bytes(void* data, size_t num_bytes)
+    {
+        m_stream.read(reinterpret_cast<char*>(data), std::streamsize(num_bytes));
+        if (!m_stream) {
+            return failure(StatusCode::InvalidFileFormat, "Unexpected end of checkpoint.");
+        }
+        return success();
+    }
+
+    /**
+     * read a trivially copyable value.
+     */
+    template <class T, std::enable_if_t<std::is_trivially_copyable<T>::value, void*> = nullptr>
+    IOResult<void> read(T& t)
+    {
+        return read_bytes(&t, sizeof(T));
+    }
+
+    /**
+     * read any other value with its member function `IOResult<void> read_checkpoint(CheckpointReader&)`.
+     */
+    template <class T, std::enable_if_t<!std::is_trivially_copyable<T>::value, void*> = nullptr>
+    IOResult<void> read(T& t)
+    {
+        return t.read_checkpoint(*this);
+    }
+
+    /**
+     * read a contiguous array of trivially copyable values.
+     * @param data pointer to memory for at least n values.
+     * @param n number of values.
+     */
+    template <class T>
+    IOResult<void> read_array(T* data, size_t n)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read in a block.");
+        return read_bytes(data, n * sizeof(T));
+    }
+
+    /**
+     * read a size and check that it matches the size of an existing object.
+     * @param expected the expected size.
+     * @param what description of the object for the error message.
+     * @return an error if the size is different, e.g. if the checkpoint belongs to a different simulation.
+     */
+    IOResult<void> expect_size(size_t expected, const std::string& what)
+    {
+        uint64_t n;
+        BOOST_OUTCOME_TRY(read(n));
+        if (n != expected) {
+            return failure(StatusCode::InvalidValue, "Checkpoint doesn't match the simulation: expected " +
+                                                         std::to_string(expected) + " " + what + ", got " +
+                                                         std::to_string(n) + ".");
+        }
+        return success();
+    }
+
+    /**
+     * read a vector with its size.
+     */
+    template <class T>
+    IOResult<void> read(std::vector<T>& v)
+    {
+        uint64_t n;
+        BOOST_OUTCOME_TRY(read(n));
+        //every element needs at least one byte, protects against allocating huge vectors from corrupted data
+        BOOST_OUTCOME_TRY(expect_available(n, std::is_trivially_copyable<T>::value ? sizeof(T) : 1, "Vector"));
+        return read_elements(v, size_t(n));
+    }
+
+    /**
+     * read a dense Eigen matrix or vector with its size.
+     */
+    template <class S, int R, int C, int O, int MR, int MC>
+    IOResult<void> read(Eigen::Matrix<S, R, C, O, MR, MC>& m)
+    {
+        int64_t rows, cols;
+        BOOST_OUTCOME_TRY(read(rows));
+        BOOST_OUTCOME_TRY(read(cols));
+        if (rows < 0 || cols < 0 || (R != Eigen::Dynamic && rows != R) || (C != Eigen::Dynamic && cols != C)) {
+            return failure(StatusCode::InvalidFileFormat, "Invalid matrix size in checkpoint.");
+        }
+        if (rows > 0 && cols > 0) {
+            BOOST_OUTCOME_TRY(expect_available(uint64_t(cols), sizeof(S), "Matrix"));
+            BOOST_OUTCOME_TRY(expect_available(uint64_t(rows), sizeof(S) * size_t(cols), "Matrix"));
+        }
+        m.resize(Eigen::Index(rows), Eigen::Index(cols));
+        return read_array(m.data(), size_t(m.size()));
+    }
+
+    /**
+     * read a time series.
+     * The number of elements must be the same as in the existing time series, the time points are replaced.
+     */
+    template <class FP>
+    IOResult<void> read(TimeSeries<FP>& ts)
+    {
+        int64_t num_elements, num_time_points;
+        BOOST_OUTCOME_TRY(read(num_elements));
+        BOOST_OUTCOME_TRY(read(num_time_points));
+        if (num_elements != ts.get_num_elements() || num_time_points < 0) {
+            return failure(StatusCode::InvalidValue, "Checkpoint doesn't match the simulation: time series with " +
+                                                         std::to_string(num_elements) + " elements, expected " +
+                                                         std::to_string(ts.get_num_elements()) + ".");
+        }
+        BOOST_OUTCOME_TRY(
+            expect_available(uint64_t(num_time_points), sizeof(FP) * size_t(num_elements + 1), "Time series"));
+        auto restored = TimeSeries<FP>(Eigen::Index(num_elements));
+        restored.reserve(Eigen::Index(num_time_points));
+        for (auto i = int64_t(0); i < num_time_points; ++i) {
+            restored.add_time_point();
+        }
+        BOOST_OUTCOME_TRY(read_array(restored.data(), size_t(restored.get_num_rows() * num_time_points)));
+        ts = std::move(restored);
+        return success();
+    }
+
+private:
+    /**
+     * check that the rest of the stream can contain a number of values before memory is allocated for them.
+     * Streams that can't report their size are not checked, reading fails when they end.
+     * @param n number of values.
+     * @param num_bytes_per_value minimum number of bytes of each value.
+     * @param what description of the values for the error message.
+     * @return an error if the stream is too short.
+     */
+    IOResult<void> expect_available(uint64_t n, size_t num_bytes_per_value, const std::string& what)
+    {
+        auto position = m_stream.tellg();
+        if (position < 0) {
+            return success();
+        }
+        m_stream.seekg(0, std::ios::end);
+        auto end = m_stream.tellg();
+        m_stream.clear();
+        m_stream.seekg(position);
+        if (end < position) {
+            return success();
+        }
+        if (n > uint64_t(end - position) / num_bytes_per_value) {
+            return failure(StatusCode::InvalidFileFormat, what + " exceeds the available data of the checkpoint.");
+        }
+        return success();
+    }
+
+    template <class T, std::enable_if_t<std::is_trivially_copyable<T>::value, void*> = nullptr>
+    IOResult<void> read_elements(std::vector<T>& v, size_t n)
+    {
+        v.resize(n);
+        return read_array(v.data(), n);
+    }
+    template <class T, std::enable_if_t<!std::is_trivially_copyable<T>::value, void*> = nullptr>
+    IOResult<void> read_elements(std::vector<T>& v, size_t n)
+    {
+        v.resize(n);
+        for (auto& t : v) {
+            BOOST_OUTCOME_TRY(read(t));
+        }
+        return success();
+    }
+
+    std::istream& m_stream;
+};
+
+namespace details
+{
+/**
+ * output file of a checkpoint.
+ * The file is written under a unique temporary name in the same directory and replaces the target
+ * only when it is committed, so an existing file is only replaced by a complete one, even if several
+ * processes write the same file. The temporary file is removed if the object is destroyed before commit,
+ * e.g. on an error. Owns the stream buffer, which must outlive the stream.
+ */
+class CheckpointOutputFile
+{
+public:
+    /**
+     * @brief create the temporary file and write the header.
+     * @param filename name of the target file.
+     */
+    explicit CheckpointOutputFile(const std::string& filename);
+
+    /**
+     * closes and removes the temporary file if it was not committed.
+     */
+    ~CheckpointOutputFile();
+
+    CheckpointOutputFile(const CheckpointOutputFile&) = delete;
+    CheckpointOutputFile& operator=(const CheckpointOutputFile&) = delete;
+
+    /**
+     * @brief check if the temporary file was created.
+     * @return success or an error if the file could not be opened.
+     */
+    IOResult<void> get_status() const;
+
+    /**
+     * the stream to write the content after the header.
+     */
+    std::ostream& get_stream()
+    {
+        return m_file;
+    }
+
+    /**
+     * @brief close the temporary file and rename it to the target.
+     * @return success or an error if writing or renaming failed, the temporary file is removed in that case.
+     */
+    IOResult<void> commit();
+
+private:
+    std::string m_filename;
+    std::string m_temporary_filename;
+    std::vector<char> m_buffer; //declared before the stream, so it is destroyed after the stream flushes
+    std::ofstream m_file;
+    bool m_is_committed;
+};
+
+/**
+ * input file of a checkpoint.
+ * Owns the stream buffer, which must outlive the stream.
+ */
+class CheckpointInputFile
+{
+public:
+    /**
+     * @brief open the file and check the header.
+     * @param filename name of the file.
+     */
+    explicit CheckpointInputFile(const std::string& filename);
+
+    CheckpointInputFile(const CheckpointInputFile&) = delete;
+    CheckpointInputFile& operator=(const CheckpointInputFile&) = delete;
+
+    /**
+     * @brief check if the file was opened and has a valid header.
+     * @return success or an error if the file could not be opened or is not a checkpoint of the current version.
+     */
+    IOResult<void> get_status() const
+    {
+        return m_status;
+    }
+
+    /**
+     * the stream to read the content after the header.
+     */
+    std::istream& get_stream()
+    {
+        return m_file;
+    }
+
+private:
+    std::vector<char> m_buffer; //declared before the stream, so it is destroyed after the stream
+    std::ifstream m_file;
+    IOResult<void> m_status;
+};
+
+} // namespace details
+
+/**
+ * save the state of a simulation in a checkpoint file.
+ * The file is first written under a temporary name and replaces an existing file only after it is complete,
+ * so there is always a usable checkpoint, even if the program is aborted while writing.
+ * @param filename name of the checkpoint file.
+ * @param sim the simulation, e.g. AbmSimulation or GraphSimulation. Must have a member function
+ * `write_checkpoint(CheckpointWriter&) const`.
+ * @return success or an error if the file could not be written.
+ */
+template <class Sim>
+IOResult<void> save_checkpoint(const std::string& filename, const Sim& sim)
+{
+    details::CheckpointOutputFile file(filename);
+    BOOST_OUTCOME_TRY(file.get_status());
+    CheckpointWriter writer(file.get_stream());
+    writer.write(sim);
+    BOOST_OUTCOME_TRY(writer.get_status());
+    return file.commit();
+}
+
+/**
+ * restore the state of a simulation from a checkpoint file.
+ * The simulation must be set up the same way as the simulation that was saved, then the state is replaced
+ * by the state in the checkpoint. Advancing the restored simulation gives the same results as advancing
+ * the saved simulation.
+ * If an error occurs, the simulation may be partially restored and should not be used.
+ * @param filename name of the checkpoint file.
+ * @param sim the simulation, e.g. AbmSimulation or GraphSimulation. Must have a member function
+ * `IOResult<void> read_checkpoint(CheckpointReader&)`.
+ * @return success or an error if the file could not be read or doesn't match the simulation.
+ */
+template <class Sim>
+IOResult<void> load_checkpoint(const std::string& filename, Sim& sim)
+{
+    details::CheckpointInputFile file(filename);
+    BOOST_OUTCOME_TRY(file.get_status());
+    CheckpointReader reader(file.get_stream());
+    BOOST_OUTCOME_TRY(reader.read(sim));
+    //check that the whole file was consumed
+    if (file.get_stream().peek() != std::char_traits<char>::eof()) {
+        return failure(StatusCode::InvalidFileFormat, "Checkpoint " + filename + " contains more data than expected.");
+    }
+    return success();
+}
+
+} // namespace mio
+
+#endif //EPI_IO_CHECKPOINT_H
@@ -79,6 +79,35 @@ struct H5DataSet {
     }
 };
 
+/**
+ * RAII for HDF5 property list handles.
+ */
+struct H5PropertyList {
+    hid_t id;
+    ~H5PropertyList()
+    {
+        H5Pclose(id);
+    }
+};
+
+/**
+ * native HDF5 data type of a floating point type.
+ * @tparam FP float or double.
+ * @return id of the HDF5 data type.
+ */
+template <class FP>
+hid_t h5_native_type();
+template <>
+inline hid_t h5_native_type<double>()
+{
+    return H5T_NATIVE_DOUBLE;
+}
+template <>
+inline hid_t h5_native_type<float>()
+{
+    return H5T_NATIVE_FLOAT;
+}
+
 /**
  * Verifies a return value from the HDF5 C API.
  * Uses mio::failure to report an error if the value (the first macro argument) is negative,
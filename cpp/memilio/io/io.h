@@ -579,6 +579,91 @@ IOResult<Tup> deserialize_internal(IOContext& io, Tag<Tup> tag)
     return details::deserialize_tuple_element(obj, tag);
 }
 
+//utilities for (de-)serializing the elements of Eigen matrices
+namespace details
+{
+    //matrices of numbers that are stored row by row without gaps can be written in one block
+    template <class M>
+    using is_row_major_block =
+        std::integral_constant<bool, (std::is_base_of<Eigen::PlainObjectBase<M>, M>::value &&
+                                      (bool(M::IsRowMajor) || M::RowsAtCompileTime == 1 || M::ColsAtCompileTime == 1))>;
+
+    template <class M>
+    using RowMajorMatrix = Eigen::Matrix<typename M::Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    //elements are always stored in row major order
+    template <class IOObj, class M,
+              std::enable_if_t<std::is_arithmetic<typename M::Scalar>::value && is_row_major_block<M>::value,
+                               void*> = nullptr>
+    void add_matrix_elements(IOObj& obj, const M& m)
+    {
+        obj.add_array("Elements", m.data(), size_t(m.size()));
+    }
+    template <class IOObj, class M,
+              std::enable_if_t<std::is_arithmetic<typename M::Scalar>::value && !is_row_major_block<M>::value,
+                               void*> = nullptr>
+    void add_matrix_elements(IOObj& obj, const M& m)
+    {
+        //evaluate expressions and reorder column major matrices in one pass
+        const RowMajorMatrix<M> row_major = m;
+        obj.add_array("Elements", row_major.data(), size_t(row_major.size()));
+    }
+    template <class IOObj, class M, std::enable_if_t<!std::is_arithmetic<typename M::Scalar>::value, void*> = nullptr>
+    void add_matrix_elements(IOObj& obj, const M& m)
+    {
+        obj.add_list("Elements", begin(m), end(m));
+    }
+
+    //create a matrix of the requested size, fixed sizes are checked
+    template <class M>
+    IOResult<M> make_matrix(Eigen::Index rows, Eigen::Index cols)
+    {
+        if (rows < 0 || cols < 0 || (M::RowsAtCompileTime != Eigen::Dynamic && rows != M::RowsAtCompileTime) ||
+            (M::ColsAtCompileTime != Eigen::Dynamic && cols != M::ColsAtCompileTime)) {
+            return failure(StatusCode::InvalidValue, "Invalid dimensions of Matrix.");
+        }
+        M m;
+        m.resize(rows, cols);
+        return success(std::move(m));
+    }
+
+    template <class IOObj, class M,
+              std::enable_if_t<std::is_arithmetic<typename M::Scalar>::value && is_row_major_block<M>::value,
+                               void*> = nullptr>
+    IOResult<M> expect_matrix_elements(IOObj& obj, Eigen::Index rows, Eigen::Index cols, Tag<M>)
+    {
+        BOOST_OUTCOME_TRY(m, make_matrix<M>(rows, cols));
+        BOOST_OUTCOME_TRY(obj.expect_array("Elements", m.data(), size_t(m.size())));
+        return success(std::move(m));
+    }
+    template <class IOObj, class M,
+              std::enable_if_t<std::is_arithmetic<typename M::Scalar>::value && !is_row_major_block<M>::value,
+                               void*> = nullptr>
+    IOResult<M> expect_matrix_elements(IOObj& obj, Eigen::Index rows, Eigen::Index cols, Tag<M>)
+    {
+        BOOST_OUTCOME_TRY(m, make_matrix<M>(rows, cols));
+        RowMajorMatrix<M> row_major(rows, cols);
+        BOOST_OUTCOME_TRY(obj.expect_array("Elements", row_major.data(), size_t(row_major.size())));
+        m = row_major;
+        return success(std::move(m));
+    }
+    template <class IOObj, class M, std::enable_if_t<!std::is_arithmetic<typename M::Scalar>::value, void*> = nullptr>
+    IOResult<M> expect_matrix_elements(IOObj& obj, Eigen::Index rows, Eigen::Index cols, Tag<M>)
+    {
+        BOOST_OUTCOME_TRY(v, obj.expect_list("Elements", Tag<typename M::Scalar>{}));
+        if (rows < 0 || cols < 0 || size_t(rows * cols) != v.size()) {
+            return failure(StatusCode::InvalidValue, "Dimensions of Matrix don't match the number of elements.");
+        }
+        BOOST_OUTCOME_TRY(m, make_matrix<M>(rows, cols));
+        for (auto i = Eigen::Index(0); i < rows; ++i) {
+            for (auto j = Eigen::Index(0); j < cols; ++j) {
+                m(i, j) = v[size_t(i * cols + j)];
+            }
+        }
+        return success(std::move(m));
+    }
+} // namespace details
+
 /**
  * serialize an Eigen matrix expression.
  * @tparam IOContext a type that models the IOContext concept.
@@ -592,7 +677,7 @@ void serialize_internal(IOContext& io, const Eigen::EigenBase<M>& mat)
     auto obj = io.create_object("Matrix");
     obj.add_element("Rows", mat.rows());
     obj.add_element("Columns", mat.cols());
-    obj.add_list("Elements", begin(static_cast<const M&>(mat)), end(static_cast<const M&>(mat)));
+    details::add_matrix_elements(obj, static_cast<const M&>(mat));
 }
 
 /**
@@ -608,22 +693,15 @@ void serialize_internal(IOContext& io, const Eigen::EigenBase<M>& mat)
 template <class IOContext, class M, std::enable_if_t<std::is_base_of<Eigen::EigenBase<M>, M>::value, void*> = nullptr>
 IOResult<M> deserialize_internal(IOContext& io, Tag<M> /*tag*/)
 {
-    auto obj      = io.expect_object("Matrix");
-    auto rows     = obj.expect_element("Rows", Tag<Eigen::Index>{});
-    auto cols     = obj.expect_element("Columns", Tag<Eigen::Index>{});
-    auto elements = obj.expect_list("Elements", Tag<typename M::Scalar>{});
+    auto obj  = io.expect_object("Matrix");
+    auto rows = obj.expect_element("Rows", Tag<Eigen::Index>{});
+    auto cols = obj.expect_element("Columns", Tag<Eigen::Index>{});
     return mio::apply(
         io,
-        [](auto&& r, auto&& c, auto&& v) {
-            auto m = M{r, c};
-            for (auto i = Eigen::Index(0); i < r; ++i) {
-                for (auto j = Eigen::Index(0); j < c; ++j) {
-                    m(i, j) = v[i * c + j];
-                }
-            }
-            return m;
+        [&obj](auto&& r, auto&& c) {
+            return details::expect_matrix_elements(obj, r, c, Tag<M>{});
         },
-        rows, cols, elements);
+        rows, cols);
 }
 
 /**
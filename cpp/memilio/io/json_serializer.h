@@ -308,6 +308,17 @@ public:
     void add_list(const std::string& name, Iter b, Iter e);
     /**@}*/
 
+    /**
+     * add contiguous array of numbers to json value.
+     * Stored as a json array, same as add_list.
+     * @tparam T the type of the numbers.
+     * @param name name of the array.
+     * @param data pointer to the first number.
+     * @param n number of numbers.
+     */
+    template <class T>
+    void add_array(const std::string& name, const T* data, size_t n);
+
     /**
      * retrieve element from the json value.
      * @tparam T the type of value to be deserialized.
@@ -347,6 +358,17 @@ public:
     IOResult<std::vector<T>> expect_list(const std::string& name, Tag<T> tag);
     /**@}*/
 
+    /**
+     * retrieve contiguous array of numbers from the json value.
+     * @tparam T the type of the numbers.
+     * @param name name of the array.
+     * @param data pointer to the storage of the numbers.
+     * @param n expected number of numbers.
+     * @return success if the array was found and has the expected size, error otherwise.
+     */
+    template <class T>
+    IOResult<void> expect_array(const std::string& name, T* data, size_t n);
+
     /**
      * The json value that data is stored in.
      */
@@ -660,6 +682,19 @@ void JsonObject::add_list(const std::string& name, Iter b, Iter e)
     }
 }
 
+template <class T>
+void JsonObject::add_array(const std::string& name, const T* data, size_t n)
+{
+    static_assert(JsonType<T>::value, "Arrays must contain basic types.");
+    if (m_status->is_ok()) {
+        auto& array = (m_value[name] = Json::Value(Json::arrayValue));
+        array.resize(Json::ArrayIndex(n));
+        for (size_t i = 0; i < n; ++i) {
+            array[Json::ArrayIndex(i)] = JsonType<T>::transform(data[i]);
+        }
+    }
+}
+
 template <class T, std::enable_if_t<JsonType<T>::value, void*>>
 IOResult<T> JsonObject::expect_element(const std::string& name, Tag<T> /*tag*/) const
 {
@@ -761,6 +796,30 @@ IOResult<std::vector<T>> JsonObject::expect_list(const std::string& name, Tag<T>
     return failure(StatusCode::KeyNotFound, name);
 }
 
+template <class T>
+IOResult<void> JsonObject::expect_array(const std::string& name, T* data, size_t n)
+{
+    static_assert(JsonType<T>::value, "Arrays must contain basic types.");
+    if (m_status->is_error()) {
+        return failure(*m_status);
+    }
+    const auto& array = m_value[name];
+    if (!array.isArray()) {
+        return failure(StatusCode::KeyNotFound, name);
+    }
+    if (array.size() != n) {
+        return failure(StatusCode::InvalidValue, "Json array has the wrong number of elements (" + name + ")");
+    }
+    for (size_t i = 0; i < n; ++i) {
+        auto r = JsonType<T>::transform(array[Json::ArrayIndex(i)]);
+        if (!r) {
+            return failure(r.error().code(), r.error().message() + " (" + name + ")");
+        }
+        data[i] = r.value();
+    }
+    return success();
+}
+
 } // namespace mio
 
 #endif //MEMILIO_HAS_JSONCPP
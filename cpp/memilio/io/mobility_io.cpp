@@ -1,7 +1,10 @@
 #include "memilio/io/mobility_io.h"
 #include "memilio/math/eigen.h"
+#include "memilio/io/binary_cache.h"
 #include "memilio/utils/logging.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -37,102 +40,177 @@ IOResult<int> count_lines(const std::string& filename)
     return success(count);
 }
 
-IOResult<Eigen::MatrixXd> read_mobility_formatted(const std::string& filename)
+namespace details
 {
-    BOOST_OUTCOME_TRY(num_lines, count_lines(filename));
-
-    if (num_lines == 0) {
-        return success(Eigen::MatrixXd(0, 0));
-    }
-
-    std::fstream file;
-    file.open(filename, std::ios::in);
+IOResult<std::string> read_file_to_string(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
         return failure(StatusCode::FileNotFound, filename);
     }
-
-    Eigen::MatrixXd txt_matrix(num_lines - 1, 3);
-    std::vector<int> ids;
-
-    try {
-        std::string tp;
-        int linenumber = 0;
-        while (getline(file, tp)) {
-            if (linenumber > 0) {
-                auto line = split(tp, '\t');
-                if (line.size() < 5) {
-                    return failure(StatusCode::InvalidFileFormat,
-                                   filename + ":" + std::to_string(linenumber) + ": Not enough entries in line.");
-                }
-                ids.push_back(std::stoi(line[2]));
-                txt_matrix(linenumber - 1, 0) = std::stoi(line[2]);
-                txt_matrix(linenumber - 1, 1) = std::stoi(line[3]);
-                txt_matrix(linenumber - 1, 2) = std::stod(line[4]);
-            }
-            linenumber++;
-        }
-    }
-    catch (std::runtime_error& ex) {
-        return failure(StatusCode::InvalidFileFormat, filename + ": " + ex.what());
+    std::string content(size_t(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(&content[0], std::streamsize(content.size()));
+    if (!file) {
+        return failure(StatusCode::UnknownError, filename + ": Could not read file.");
     }
+    return success(std::move(content));
+}
 
-    sort(ids.begin(), ids.end());
-    std::vector<int>::iterator iter = std::unique(ids.begin(), ids.end());
-    ids.resize(std::distance(ids.begin(), iter));
+namespace
+{
+//blanks between values, line breaks are handled separately
+bool is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
 
-    Eigen::MatrixXd migration = Eigen::MatrixXd::Zero(ids.size(), ids.size());
+const char* skip_blanks(const char* p)
+{
+    while (is_blank(*p)) {
+        ++p;
+    }
+    return p;
+}
 
-    for (int k = 0; k < num_lines - 1; k++) {
-        int row_ind = 0;
-        int col_ind = 0;
-        while (txt_matrix(k, 0) != ids[row_ind]) {
-            row_ind++;
-        }
-        while (txt_matrix(k, 1) != ids[col_ind]) {
-            col_ind++;
-        }
-        migration(row_ind, col_ind) = txt_matrix(k, 2);
+//pointer to the start of the next line or the terminating zero
+const char* skip_line(const char* p)
+{
+    while (*p != '\n' && *p != '\0') {
+        ++p;
     }
+    return *p == '\n' ? p + 1 : p;
+}
 
-    return success(migration);
+//strtol/strtod skip line breaks, so the value must start in the current line
+template <class T, class F>
+bool parse_value(const char*& p, F strto, T& value)
+{
+    p = skip_blanks(p);
+    if (*p == '\n' || *p == '\0') {
+        return false;
+    }
+    char* end;
+    value = T(strto(p, &end));
+    if (end == p) {
+        return false;
+    }
+    p = end;
+    return true;
 }
 
-IOResult<Eigen::MatrixXd> read_mobility_plain(const std::string& filename)
+//pointer to the start of the next tab separated field or the end of the line
+const char* skip_field(const char* p)
 {
-    BOOST_OUTCOME_TRY(num_lines, count_lines(filename));
+    while (*p != '\t' && *p != '\n' && *p != '\0') {
+        ++p;
+    }
+    return *p == '\t' ? p + 1 : p;
+}
+} // namespace
 
-    if (num_lines == 0) {
-        return success(Eigen::MatrixXd(0, 0));
+IOResult<Eigen::MatrixXd> parse_mobility_formatted(const std::string& content, const std::string& filename)
+{
+    //entries are collected first, the size of the matrix is known after all ids have been seen
+    std::vector<int> from_ids, to_ids;
+    std::vector<double> values;
+
+    //skip header
+    auto p           = skip_line(content.c_str());
+    auto linenumber  = 1;
+    auto parse_error = [&filename, &linenumber](const std::string& msg) {
+        return failure(StatusCode::InvalidFileFormat, filename + ":" + std::to_string(linenumber) + ": " + msg);
+    };
+    for (; *p != '\0'; p = skip_line(p), ++linenumber) {
+        //from_str and to_str are not used
+        auto field = skip_field(skip_field(p));
+        int from_id, to_id;
+        double value;
+        auto parse_long = [](const char* str, char** end) {
+            return std::strtol(str, end, 10);
+        };
+        if (!parse_value(field, parse_long, from_id) || !parse_value(field = skip_field(field), parse_long, to_id) ||
+            !parse_value(field = skip_field(field), std::strtod, value)) {
+            return parse_error("Not enough entries in line.");
+        }
+        from_ids.push_back(from_id);
+        to_ids.push_back(to_id);
+        values.push_back(value);
     }
 
-    std::fstream file;
-    file.open(filename, std::ios::in);
-    if (!file.is_open()) {
-        return failure(StatusCode::FileNotFound, filename);
+    std::vector<int> ids(from_ids);
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    auto get_index = [&ids](int id) {
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        return it != ids.end() && *it == id ? Eigen::Index(it - ids.begin()) : Eigen::Index(-1);
+    };
+
+    Eigen::MatrixXd migration = Eigen::MatrixXd::Zero(ids.size(), ids.size());
+    for (size_t k = 0; k < values.size(); ++k) {
+        auto row_ind = get_index(from_ids[k]);
+        auto col_ind = get_index(to_ids[k]);
+        if (col_ind < 0) {
+            return failure(StatusCode::InvalidFileFormat,
+                           filename + ": Region " + std::to_string(to_ids[k]) + " has no outgoing entries.");
+        }
+        migration(row_ind, col_ind) = values[k];
     }
 
-    Eigen::MatrixXd migration(num_lines, num_lines);
-
-    try {
-        std::string tp;
-        int linenumber = 0;
-        while (getline(file, tp)) {
-            auto line = split(tp, ' ');
-            if (line.size() != size_t(num_lines)) {
-                return failure(StatusCode::InvalidFileFormat, filename + ": Not a square matrix.");
-            }
-            Eigen::Index i = static_cast<Eigen::Index>(linenumber);
-            for (Eigen::Index j = 0; j < static_cast<Eigen::Index>(line.size()); j++) {
-                migration(i, j) = std::stod(line[j]);
-            }
-            linenumber++;
+    return success(migration);
+}
+
+IOResult<Eigen::MatrixXd> parse_mobility_plain(const std::string& content, const std::string& filename)
+{
+    //values are stored row by row, the number of columns is known after the first line
+    std::vector<double> values;
+    Eigen::Index num_cols = -1;
+    Eigen::Index num_rows = 0;
+
+    for (auto p = content.c_str(); *p != '\0'; p = skip_line(p), ++num_rows) {
+        Eigen::Index num_values = 0;
+        double value;
+        while (parse_value(p, std::strtod, value)) {
+            values.push_back(value);
+            ++num_values;
+        }
+        if (*p != '\n' && *p != '\0') {
+            return failure(StatusCode::InvalidFileFormat,
+                           filename + ":" + std::to_string(num_rows + 1) + ": Invalid value.");
+        }
+        if (num_cols < 0) {
+            num_cols = num_values;
+            values.reserve(size_t(num_cols * num_cols));
+        }
+        else if (num_values != num_cols) {
+            return failure(StatusCode::InvalidFileFormat, filename + ": Not a square matrix.");
         }
     }
-    catch (std::runtime_error& ex) {
-        return failure(StatusCode::InvalidFileFormat, filename + ": " + ex.what());
+    if (num_rows != std::max(num_cols, Eigen::Index(0))) {
+        return failure(StatusCode::InvalidFileFormat, filename + ": Not a square matrix.");
     }
 
-    return success(migration);
+    return success(Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+        values.data(), num_rows, num_rows));
+}
+} // namespace details
+
+IOResult<Eigen::MatrixXd> read_mobility_formatted(const std::string& filename, const std::string& cache_dir)
+{
+    return read_cached<Eigen::MatrixXd>(filename, cache_dir, {"mobility_formatted"},
+                                        [&filename]() -> IOResult<Eigen::MatrixXd> {
+                                            BOOST_OUTCOME_TRY(content, details::read_file_to_string(filename));
+                                            return details::parse_mobility_formatted(content, filename);
+                                        });
+}
+
+IOResult<Eigen::MatrixXd> read_mobility_plain(const std::string& filename, const std::string& cache_dir)
+{
+    return read_cached<Eigen::MatrixXd>(filename, cache_dir, {"mobility_plain"},
+                                        [&filename]() -> IOResult<Eigen::MatrixXd> {
+                                            BOOST_OUTCOME_TRY(content, details::read_file_to_string(filename));
+                                            return details::parse_mobility_plain(content, filename);
+                                        });
 }
 
 } // namespace mio
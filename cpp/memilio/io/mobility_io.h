@@ -43,22 +43,47 @@ std::vector<std::string> split(const std::string& s, char delimiter);
  */
 IOResult<int> count_lines(const std::string& filename);
 
+namespace details
+{
+/**
+ * @brief Reads the whole content of a file with a single read.
+ * @param filename name of file to be read
+ */
+IOResult<std::string> read_file_to_string(const std::string& filename);
+
+/**
+ * @brief Parses formatted migration data, see read_mobility_formatted.
+ * @param content content of the file
+ * @param filename name of the file for error messages
+ */
+IOResult<Eigen::MatrixXd> parse_mobility_formatted(const std::string& content, const std::string& filename);
+
+/**
+ * @brief Parses plain migration data, see read_mobility_plain.
+ * @param content content of the file
+ * @param filename name of the file for error messages
+ */
+IOResult<Eigen::MatrixXd> parse_mobility_plain(const std::string& content, const std::string& filename);
+} // namespace details
+
 /**
  * @brief Reads formatted migration or contact data which is given in columns
  *          from_str	to_str	from_rs	    to_rs	count_abs
  *        and separated by tabs. Writes it into a NxN Eigen Matrix, 
  *        where N is the number of regions
  * @param filename name of file to be read
+ * @param cache_dir directory of a binary cache of the matrix, see read_cached. No cache is used if empty.
  */
-IOResult<Eigen::MatrixXd> read_mobility_formatted(const std::string& filename);
+IOResult<Eigen::MatrixXd> read_mobility_formatted(const std::string& filename, const std::string& cache_dir = "");
 
 /**
  * @brief Reads txt migration data or contact which is given by values only
  *        and separated by spaces. Writes it into a NxN Eigen 
  *        Matrix, where N is the number of regions
  * @param filename name of file to be read
+ * @param cache_dir directory of a binary cache of the matrix, see read_cached. No cache is used if empty.
  */
-IOResult<Eigen::MatrixXd> read_mobility_plain(const std::string& filename);
+IOResult<Eigen::MatrixXd> read_mobility_plain(const std::string& filename, const std::string& cache_dir = "");
 
 } // namespace mio
 
@@ -18,6 +18,7 @@
 * limitations under the License.
 */
 #include "memilio/math/adapt_rk.h"
+#include "memilio/utils/instrumentation.h"
 
 namespace mio
 {
@@ -73,6 +74,13 @@ Tableau::Tableau()
 bool RKIntegratorCore::step(const DerivFunction& f, Eigen::Ref<const Eigen::VectorXd> yt, double& t, double& dt,
                             Eigen::Ref<Eigen::VectorXd> ytp1) const
 {
+    IntegratorStats stats;
+    return step_with_stats(f, yt, t, dt, ytp1, stats);
+}
+
+bool RKIntegratorCore::step_with_stats(const DerivFunction& f, Eigen::Ref<const Eigen::VectorXd> yt, double& t,
+                                       double& dt, Eigen::Ref<Eigen::VectorXd> ytp1, IntegratorStats& stats) const
+{
 
     double max_err   = 1e10;
     double conv_crit = 1e9;
@@ -80,11 +88,13 @@ bool RKIntegratorCore::step(const DerivFunction& f, Eigen::Ref<const Eigen::Vect
     std::vector<Eigen::VectorXd> kt_values;
 
     bool failed_step_size_adapt = false;
+    int num_attempts            = 0;
 
     dt = 2 * dt;
 
     while (max_err > conv_crit && !failed_step_size_adapt) {
         dt = 0.5 * dt;
+        ++num_attempts;
 
         kt_values.resize(0); // remove data from previous loop
         kt_values.resize(m_tab_final.entries_low.size()); // these are the k_ni per y_t, used to compute y_t+1
@@ -188,6 +198,11 @@ bool RKIntegratorCore::step(const DerivFunction& f, Eigen::Ref<const Eigen::Vect
         }
     }
 
+    //every attempt except the last one was rejected
+    stats.num_rhs_evaluations += size_t(num_attempts) * m_tab_final.entries_low.size();
+    stats.num_rejected_steps += size_t(num_attempts - 1);
+    MIO_COUNTER("RKIntegratorCore::step rejected steps", num_attempts - 1);
+
     return !failed_step_size_adapt;
 }
 
@@ -155,6 +155,14 @@ public:
     bool step(const DerivFunction& f, Eigen::Ref<Eigen::VectorXd const> yt, double& t, double& dt,
               Eigen::Ref<Eigen::VectorXd> ytp1) const override;
 
+    /**
+     * Adaptive step width of the integration, also counts the evaluations of the right hand side
+     * and the rejected attempts.
+     * @see step
+     */
+    bool step_with_stats(const DerivFunction& f, Eigen::Ref<Eigen::VectorXd const> yt, double& t, double& dt,
+                         Eigen::Ref<Eigen::VectorXd> ytp1, IntegratorStats& stats) const override;
+
 private:
     Tableau m_tab;
     TableauFinal m_tab_final;
@@ -32,4 +32,11 @@ bool EulerIntegratorCore::step(const DerivFunction& f, Eigen::Ref<const Eigen::V
     return true;
 }
 
+bool EulerIntegratorCore::step_with_stats(const DerivFunction& f, Eigen::Ref<const Eigen::VectorXd> yt, double& t,
+                                          double& dt, Eigen::Ref<Eigen::VectorXd> ytp1, IntegratorStats& stats) const
+{
+    ++stats.num_rhs_evaluations;
+    return step(f, yt, t, dt, ytp1);
+}
+
 } // namespace mio
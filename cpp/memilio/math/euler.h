@@ -43,6 +43,13 @@ public:
      */
     bool step(const DerivFunction& f, Eigen::Ref<const Eigen::VectorXd> yt, double& t, double& dt,
               Eigen::Ref<Eigen::VectorXd> ytp1) const override;
+
+    /**
+     * @brief Fixed step width of the integration, also counts the evaluation of the right hand side.
+     * @see step
+     */
+    bool step_with_stats(const DerivFunction& f, Eigen::Ref<const Eigen::VectorXd> yt, double& t, double& dt,
+                         Eigen::Ref<Eigen::VectorXd> ytp1, IntegratorStats& stats) const override;
 };
 
 } // namespace mio
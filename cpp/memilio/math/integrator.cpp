@@ -19,11 +19,31 @@
 */
 #include "memilio/math/integrator.h"
 #include "memilio/utils/logging.h"
+#include "memilio/utils/instrumentation.h"
+
+#include <chrono>
+#include <cmath>
 
 namespace mio
 {
 
 Eigen::Ref<Eigen::VectorXd> OdeIntegrator::advance(double tmax)
+{
+    MIO_SCOPED_TIMER("OdeIntegrator::advance");
+
+    auto start = std::chrono::steady_clock::now();
+    if (m_dt_output > 0) {
+        advance_dense(tmax);
+    }
+    else {
+        advance_steps(tmax);
+    }
+    m_stats.elapsed_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return m_result.get_last_value();
+}
+
+void OdeIntegrator::advance_steps(double tmax)
 {
     const double t0 = m_result.get_time(m_result.get_num_time_points() - 1);
     assert(tmax > t0);
@@ -36,15 +56,18 @@ Eigen::Ref<Eigen::VectorXd> OdeIntegrator::advance(double tmax)
 
     double t = t0;
     size_t i = m_result.get_num_time_points() - 1;
+    const size_t i0 = i;
     while (std::abs((tmax - t) / (tmax - t0)) > 1e-10) {
         //we don't make timesteps too small as the error estimator of an adaptive integrator
         //may not be able to handle it. this is very conservative and maybe unnecessary,
         //but also unlikely to happen. may need to be reevaluated
 
-        auto dt_eff = std::min(m_dt, tmax - t);
+        auto dt_eff   = std::min(m_dt, tmax - t);
+        double t_prev = t;
         m_result.add_time_point();
-        step_okay &= m_core->step(m_f, m_result[i], t, dt_eff, m_result[i + 1]);
+        step_okay &= m_core->step_with_stats(m_f, m_result[i], t, dt_eff, m_result[i + 1], m_stats);
         m_result.get_last_time() = t;
+        m_stats.add_accepted_step(t - t_prev);
 
         ++i;
 
@@ -54,6 +77,7 @@ Eigen::Ref<Eigen::VectorXd> OdeIntegrator::advance(double tmax)
             m_dt = dt_eff;
         }
     }
+    MIO_COUNTER("OdeIntegrator::advance steps", i - i0);
 
     if (!step_okay) {
         log_warning("Adaptive step sizing failed.");
@@ -64,8 +88,94 @@ Eigen::Ref<Eigen::VectorXd> OdeIntegrator::advance(double tmax)
     else {
         log_info("Adaptive step sizing successful to tolerances.");
     }
+}
 
-    return m_result.get_last_value();
+void OdeIntegrator::advance_dense(double tmax)
+{
+    const double t0 = m_result.get_last_time();
+    assert(tmax > t0);
+
+    //tolerance for matching output points with step points
+    const double eps = 1e-10 * (tmax - t0);
+
+    //first output point after t0
+    auto k_out = Eigen::Index(std::floor((t0 - m_t0) / m_dt_output)) + 1;
+    while (m_t0 + k_out * m_dt_output <= t0 + eps) {
+        ++k_out;
+    }
+
+    m_result.reserve(m_result.get_num_time_points() + Eigen::Index(std::ceil((tmax - t0) / m_dt_output)) + 1);
+
+    //the last value may have been modified since the last call (e.g. by migration), so derivatives are not reused
+    Eigen::VectorXd yt = m_result.get_last_value();
+    Eigen::VectorXd ytp1(yt.size());
+    Eigen::VectorXd dydt(yt.size());
+    Eigen::VectorXd dydtp1(yt.size());
+    m_f(yt, t0, dydt);
+    ++m_stats.num_rhs_evaluations;
+
+    bool step_okay = true;
+
+    double t         = t0;
+    size_t num_steps = 0;
+    while (std::abs((tmax - t) / (tmax - t0)) > 1e-10) {
+        auto dt_eff   = std::min(m_dt, tmax - t);
+        double t_prev = t;
+        step_okay &= m_core->step_with_stats(m_f, yt, t, dt_eff, ytp1, m_stats);
+        m_f(ytp1, t, dydtp1);
+        ++m_stats.num_rhs_evaluations;
+        m_stats.add_accepted_step(t - t_prev);
+        ++num_steps;
+
+        //output points inside of the step are interpolated, an output point at the end of the step is stored exactly
+        for (auto t_out = m_t0 + k_out * m_dt_output; t_out <= t + eps; t_out = m_t0 + (++k_out) * m_dt_output) {
+            if (t_out < t - eps) {
+                hermite_interpolation(t_prev, yt, dydt, t, ytp1, dydtp1, t_out, m_result.add_time_point(t_out));
+            }
+            else if (std::abs((tmax - t) / (tmax - t0)) > 1e-10) {
+                m_result.add_time_point(t, ytp1);
+            }
+        }
+
+        std::swap(yt, ytp1);
+        std::swap(dydt, dydtp1);
+
+        if (std::abs((tmax - t) / (tmax - t0)) > 1e-10 || dt_eff > m_dt) {
+            //same as in advance: don't store the step size of the truncated last step
+            m_dt = dt_eff;
+        }
+    }
+    m_result.add_time_point(t, yt);
+    MIO_COUNTER("OdeIntegrator::advance steps", num_steps);
+
+    if (!step_okay) {
+        log_warning("Adaptive step sizing failed.");
+    }
+    else if (std::abs((tmax - t) / (tmax - t0)) > 1e-15) {
+        log_warning("Last time step too small. Could not reach tmax exactly.");
+    }
+    else {
+        log_info("Adaptive step sizing successful to tolerances.");
+    }
+}
+
+void hermite_interpolation(double t0, Eigen::Ref<const Eigen::VectorXd> y0, Eigen::Ref<const Eigen::VectorXd> dydt0,
+                           double t1, Eigen::Ref<const Eigen::VectorXd> y1, Eigen::Ref<const Eigen::VectorXd> dydt1,
+                           double t, Eigen::Ref<Eigen::VectorXd> y)
+{
+    assert(t0 < t1 && t >= t0 && t <= t1);
+    const auto h  = t1 - t0;
+    const auto s  = (t - t0) / h;
+    const auto s2 = s * s;
+    const auto s3 = s2 * s;
+
+    //hermite basis polynomials
+    const auto h00 = 2 * s3 - 3 * s2 + 1;
+    const auto h10 = s3 - 2 * s2 + s;
+    const auto h01 = -2 * s3 + 3 * s2;
+    const auto h11 = s3 - s2;
+
+    y = h00 * y0 + (h10 * h) * dydt0 + h01 * y1 + (h11 * h) * dydt1;
 }
 
 } // namespace mio
@@ -23,6 +23,10 @@
 #include "memilio/utils/time_series.h"
 
 #include "memilio/math/eigen.h"
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <vector>
 #include <functional>
@@ -37,6 +41,67 @@ namespace mio
 using DerivFunction =
     std::function<void(Eigen::Ref<const Eigen::VectorXd> y, double t, Eigen::Ref<Eigen::VectorXd> dydt)>;
 
+/**
+ * Statistics of the integration of an ODE, e.g. to study the cost of different tolerances.
+ */
+struct IntegratorStats {
+    /**
+     * number of bins of the step size histogram.
+     * Bin 0 counts steps smaller than 1e-6, bins 1 to 6 count steps in one decade each, i.e. [1e-6, 1e-5) to
+     * [0.1, 1), the last bin counts steps of size 1 or larger.
+     */
+    static constexpr size_t NumDtHistogramBins = 8;
+
+    size_t num_rhs_evaluations = 0; ///< number of evaluations of the right hand side.
+    size_t num_accepted_steps  = 0; ///< number of steps that were stored in the result.
+    size_t num_rejected_steps  = 0; ///< number of attempted steps that were rejected by adaptive step sizing.
+    double dt_min = std::numeric_limits<double>::infinity(); ///< smallest accepted step size.
+    double dt_max = 0.0; ///< largest accepted step size.
+    double elapsed_time = 0.0; ///< wall clock time of the integration in seconds.
+    std::array<size_t, NumDtHistogramBins> dt_histogram = {}; ///< number of accepted steps by size.
+
+    /**
+     * get the lower bound of the step sizes counted in a bin of the histogram.
+     * @param bin index of the bin.
+     * @return lower bound of the bin, 0 for the first bin.
+     */
+    static double get_dt_histogram_lower_bound(size_t bin)
+    {
+        assert(bin < NumDtHistogramBins);
+        return bin == 0 ? 0.0 : std::pow(10.0, double(bin) - double(NumDtHistogramBins - 1));
+    }
+
+    /**
+     * record an accepted step.
+     * @param dt size of the step.
+     */
+    void add_accepted_step(double dt)
+    {
+        ++num_accepted_steps;
+        dt_min   = std::min(dt_min, dt);
+        dt_max   = std::max(dt_max, dt);
+        auto bin = dt > 0 ? std::floor(std::log10(dt)) + double(NumDtHistogramBins - 1) : 0.0;
+        ++dt_histogram[size_t(std::max(0.0, std::min(bin, double(NumDtHistogramBins - 1))))];
+    }
+
+    /**
+     * add the statistics of another integration, e.g. to aggregate over the nodes of a graph.
+     */
+    IntegratorStats& operator+=(const IntegratorStats& other)
+    {
+        num_rhs_evaluations += other.num_rhs_evaluations;
+        num_accepted_steps += other.num_accepted_steps;
+        num_rejected_steps += other.num_rejected_steps;
+        dt_min = std::min(dt_min, other.dt_min);
+        dt_max = std::max(dt_max, other.dt_max);
+        elapsed_time += other.elapsed_time;
+        for (size_t i = 0; i < NumDtHistogramBins; ++i) {
+            dt_histogram[i] += other.dt_histogram[i];
+        }
+        return *this;
+    }
+};
+
 class IntegratorCore
 {
 public:
@@ -53,6 +118,19 @@ public:
      */
     virtual bool step(const DerivFunction& f, Eigen::Ref<const Eigen::VectorXd> yt, double& t, double& dt,
                       Eigen::Ref<Eigen::VectorXd> ytp1) const = 0;
+
+    /**
+     * @brief Step of the integration that also records statistics that only the core knows,
+     * e.g. the number of evaluations of the right hand side or the number of rejected attempts of adaptive methods.
+     * The default implementation calls step and records nothing.
+     * @param[in,out] stats statistics of the integration.
+     * @see step
+     */
+    virtual bool step_with_stats(const DerivFunction& f, Eigen::Ref<const Eigen::VectorXd> yt, double& t, double& dt,
+                                 Eigen::Ref<Eigen::VectorXd> ytp1, IntegratorStats& /*stats*/) const
+    {
+        return step(f, yt, t, dt, ytp1);
+    }
 };
 
 /**
@@ -75,6 +153,8 @@ public:
         , m_result(t0, y0)
         , m_dt(dt_init)
         , m_core(core)
+        , m_t0(t0)
+        , m_dt_output(0.0)
     {
     }
 
@@ -84,6 +164,27 @@ public:
      */
     Eigen::Ref<Eigen::VectorXd> advance(double tmax);
 
+    /**
+     * @brief store the result only on an equidistant output grid instead of at every internal step.
+     * The values at the grid points t0 + k * dt_output are computed by cubic hermite interpolation
+     * of the internal steps (dense output), which requires one additional evaluation of the right hand side per step.
+     * The end point of every call to advance is always stored as well, so the simulation can be continued.
+     * @param dt_output distance between output points. 0 (default) stores every internal step.
+     */
+    void set_output_step_size(double dt_output)
+    {
+        assert(dt_output >= 0);
+        m_dt_output = dt_output;
+    }
+
+    /**
+     * @brief distance between output points, 0 if every internal step is stored.
+     */
+    double get_output_step_size() const
+    {
+        return m_dt_output;
+    }
+
     TimeSeries<double>& get_result()
     {
         return m_result;
@@ -99,13 +200,81 @@ public:
         m_core= integrator;
     }
 
+    /**
+     * @brief statistics of all calls to advance since construction or the last call to reset_stats.
+     */
+    const IntegratorStats& get_stats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * @brief set all statistics to zero.
+     */
+    void reset_stats()
+    {
+        m_stats = IntegratorStats{};
+    }
+
+    /**
+     * write the result and the current step size to a checkpoint.
+     * @see CheckpointWriter
+     */
+    template <class Writer>
+    void write_checkpoint(Writer& writer) const
+    {
+        writer.write(m_result);
+        writer.write(m_dt);
+    }
+
+    /**
+     * restore the result and the current step size from a checkpoint.
+     * @see CheckpointReader
+     */
+    template <class Reader>
+    IOResult<void> read_checkpoint(Reader& reader)
+    {
+        BOOST_OUTCOME_TRY(reader.read(m_result));
+        BOOST_OUTCOME_TRY(reader.read(m_dt));
+        return success();
+    }
+
 private:
+    /**
+     * advance the integrator and store every step.
+     */
+    void advance_steps(double tmax);
+
+    /**
+     * advance the integrator and store only points of the output grid.
+     * @see set_output_step_size
+     */
+    void advance_dense(double tmax);
+
     DerivFunction m_f;
     TimeSeries<double> m_result;
     double m_dt;
     std::shared_ptr<IntegratorCore> m_core;
+    double m_t0;
+    double m_dt_output;
+    IntegratorStats m_stats;
 };
 
+/**
+ * @brief cubic hermite interpolation between two points of the solution of an ODE.
+ * @param t0 time of the first point
+ * @param y0 value at t0
+ * @param dydt0 derivative at t0
+ * @param t1 time of the second point
+ * @param y1 value at t1
+ * @param dydt1 derivative at t1
+ * @param t time of the interpolated value, t0 <= t <= t1
+ * @param[out] y interpolated value at t
+ */
+void hermite_interpolation(double t0, Eigen::Ref<const Eigen::VectorXd> y0, Eigen::Ref<const Eigen::VectorXd> dydt0,
+                           double t1, Eigen::Ref<const Eigen::VectorXd> y1, Eigen::Ref<const Eigen::VectorXd> dydt1,
+                           double t, Eigen::Ref<Eigen::VectorXd> y);
+
 } // namespace mio
 
 #endif // INTEGRATOR_H
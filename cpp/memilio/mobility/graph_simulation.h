@@ -21,6 +21,8 @@
 #define EPI_MOBILITY_GRAPH_SIMULATION_H
 
 #include "memilio/mobility/graph.h"
+#include "memilio/io/checkpoint.h"
+#include "memilio/utils/instrumentation.h"
 
 namespace mio
 {
@@ -59,20 +61,28 @@ public:
 
     void advance(double t_max = 1.0)
     {
+        MIO_SCOPED_TIMER("GraphSimulation::advance");
         auto dt = m_dt;
         while (m_t < t_max) {
             if (m_t + dt > t_max) {
                 dt = t_max - m_t;
             }
 
-            for (auto& n : m_graph.nodes()) {
-                m_node_func(m_t, dt, n.property);
+            {
+                MIO_SCOPED_TIMER("GraphSimulation::advance nodes");
+                for (auto& n : m_graph.nodes()) {
+                    m_node_func(m_t, dt, n.property);
+                }
             }
 
             m_t += dt;
 
-            for (auto& e : m_graph.edges()) {
-                m_edge_func(m_t, dt, e.property, m_graph.nodes()[e.start_node_idx].property, m_graph.nodes()[e.end_node_idx].property);
+            {
+                MIO_SCOPED_TIMER("GraphSimulation::advance edges");
+                for (auto& e : m_graph.edges()) {
+                    m_edge_func(m_t, dt, e.property, m_graph.nodes()[e.start_node_idx].property,
+                                m_graph.nodes()[e.end_node_idx].property);
+                }
             }
         }
     }
@@ -97,6 +107,47 @@ public:
         return std::move(m_graph);
     }
 
+    /**
+     * write the state of the simulation to a checkpoint, i.e. the current time and the state of each node and edge.
+     * The properties of nodes and edges must be trivially copyable or have a write_checkpoint member function.
+     * @see save_checkpoint
+     */
+    template <class Writer>
+    void write_checkpoint(Writer& writer) const
+    {
+        writer.write(m_t);
+        writer.write(m_dt);
+        writer.write(uint64_t(m_graph.nodes().size()));
+        for (auto& n : m_graph.nodes()) {
+            writer.write(n.property);
+        }
+        writer.write(uint64_t(m_graph.edges().size()));
+        for (auto& e : m_graph.edges()) {
+            writer.write(e.property);
+        }
+    }
+
+    /**
+     * restore the state of the simulation from a checkpoint.
+     * The graph must have the same nodes and edges as the graph that was written.
+     * @see load_checkpoint
+     */
+    template <class Reader>
+    IOResult<void> read_checkpoint(Reader& reader)
+    {
+        BOOST_OUTCOME_TRY(reader.read(m_t));
+        BOOST_OUTCOME_TRY(reader.read(m_dt));
+        BOOST_OUTCOME_TRY(reader.expect_size(m_graph.nodes().size(), "nodes"));
+        for (auto& n : m_graph.nodes()) {
+            BOOST_OUTCOME_TRY(reader.read(n.property));
+        }
+        BOOST_OUTCOME_TRY(reader.expect_size(m_graph.edges().size(), "edges"));
+        for (auto& e : m_graph.edges()) {
+            BOOST_OUTCOME_TRY(reader.read(e.property));
+        }
+        return success();
+    }
+
 private:
     double m_t;
     double m_dt;
@@ -30,6 +30,7 @@
 #include "memilio/epidemiology/contact_matrix.h"
 #include "memilio/epidemiology/dynamic_npis.h"
 #include "memilio/compartments/simulation.h"
+#include "memilio/utils/instrumentation.h"
 
 #include <cassert>
 
@@ -95,6 +96,30 @@ public:
         m_last_state = m_simulation.get_result().get_last_value();
     }
 
+    /**
+     * write the state of the node to a checkpoint.
+     * @see CheckpointWriter
+     */
+    template <class Writer>
+    void write_checkpoint(Writer& writer) const
+    {
+        writer.write(m_simulation);
+        writer.write(m_last_state);
+        writer.write(m_t0);
+    }
+
+    /**
+     * restore the state of the node from a checkpoint.
+     * @see CheckpointReader
+     */
+    template <class Reader>
+    IOResult<void> read_checkpoint(Reader& reader)
+    {
+        BOOST_OUTCOME_TRY(reader.read(m_simulation));
+        BOOST_OUTCOME_TRY(reader.read(m_last_state));
+        BOOST_OUTCOME_TRY(reader.read(m_t0));
+        return success();
+    }
 
 private:
     Sim m_simulation;
@@ -287,6 +312,42 @@ public:
     template <class Sim>
     void apply_migration(double t, double dt, SimulationNode<Sim>& node_from, SimulationNode<Sim>& node_to);
 
+    /**
+     * write the state of the edge to a checkpoint.
+     * Contains the people that are currently migrated and the dampings implemented by dynamic NPIs.
+     * @see CheckpointWriter
+     */
+    template <class Writer>
+    void write_checkpoint(Writer& writer) const
+    {
+        writer.write(m_parameters.get_coefficients());
+        writer.write(m_migrated);
+        writer.write(m_return_times);
+        writer.write(m_return_migrated);
+        writer.write(m_t_last_dynamic_npi_check);
+        writer.write(m_dynamic_npi.first);
+        writer.write(m_dynamic_npi.second.get());
+    }
+
+    /**
+     * restore the state of the edge from a checkpoint.
+     * @see CheckpointReader
+     */
+    template <class Reader>
+    IOResult<void> read_checkpoint(Reader& reader)
+    {
+        BOOST_OUTCOME_TRY(reader.read(m_parameters.get_coefficients()));
+        BOOST_OUTCOME_TRY(reader.read(m_migrated));
+        BOOST_OUTCOME_TRY(reader.read(m_return_times));
+        BOOST_OUTCOME_TRY(reader.read(m_return_migrated));
+        BOOST_OUTCOME_TRY(reader.read(m_t_last_dynamic_npi_check));
+        BOOST_OUTCOME_TRY(reader.read(m_dynamic_npi.first));
+        double t_npi_end;
+        BOOST_OUTCOME_TRY(reader.read(t_npi_end));
+        m_dynamic_npi.second = SimulationTime(t_npi_end);
+        return success();
+    }
+
 private:
     MigrationParameters m_parameters;
     TimeSeries<double> m_migrated;
@@ -383,6 +444,8 @@ auto get_migration_factors(const SimulationNode<Sim>& node, double t, const Eige
 template <class Sim>
 void MigrationEdge::apply_migration(double t, double dt, SimulationNode<Sim>& node_from, SimulationNode<Sim>& node_to)
 {
+    MIO_SCOPED_TIMER("MigrationEdge::apply_migration");
+
     //check dynamic npis
     if (m_t_last_dynamic_npi_check == -std::numeric_limits<double>::infinity()) {
         m_t_last_dynamic_npi_check = node_from.get_t0();
@@ -390,6 +453,7 @@ void MigrationEdge::apply_migration(double t, double dt, SimulationNode<Sim>& no
 
     auto& dyn_npis = m_parameters.get_dynamic_npis_infected();
     if (dyn_npis.get_thresholds().size() > 0 && floating_point_greater_equal(t, m_t_last_dynamic_npi_check + dyn_npis.get_interval().get())) {
+        MIO_SCOPED_TIMER("MigrationEdge::apply_migration dynamic NPIs");
         auto inf_rel            = get_infections_relative(node_from, t, node_from.get_last_state()) * dyn_npis.get_base_value();
         auto exceeded_threshold = dyn_npis.get_max_exceeded_threshold(inf_rel);
         if (exceeded_threshold != dyn_npis.get_thresholds().end() &&
@@ -408,6 +472,7 @@ void MigrationEdge::apply_migration(double t, double dt, SimulationNode<Sim>& no
     //returns
     for (Eigen::Index i = m_return_times.get_num_time_points() - 1; i >= 0; --i) {
         if (m_return_times.get_time(i) <= t) {
+            MIO_SCOPED_TIMER("MigrationEdge::apply_migration returns");
             auto v0 = find_value_reverse(node_to.get_result(), m_migrated.get_time(i), 1e-10, 1e-10);
             assert(v0 != node_to.get_result().rend() && "unexpected error.");
             calculate_migration_returns(m_migrated[i], node_to.get_simulation(), *v0, m_migrated.get_time(i), dt);
@@ -432,6 +497,23 @@ void MigrationEdge::apply_migration(double t, double dt, SimulationNode<Sim>& no
     m_return_migrated = !m_return_migrated;
 }
 
+/**
+ * aggregate the integrator statistics of the simulations in all nodes of a graph.
+ * The elapsed time is the sum over all nodes.
+ * @param graph graph of simulation nodes, e.g. of a migration simulation.
+ * @return sum of the statistics of all nodes.
+ * @see Simulation::get_integrator_stats
+ */
+template <class Sim, class Edge>
+IntegratorStats get_integrator_stats(const Graph<SimulationNode<Sim>, Edge>& graph)
+{
+    IntegratorStats stats;
+    for (auto& node : graph.nodes()) {
+        stats += node.property.get_simulation().get_integrator_stats();
+    }
+    return stats;
+}
+
 /**
  * edge functor for migration simulation.
  * @see SimulationNode::evolve
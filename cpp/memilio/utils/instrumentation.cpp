@@ -0,0 +1,198 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/utils/instrumentation.h"
+#include "memilio/utils/logging.h"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <mutex>
+
+namespace mio
+{
+
+namespace
+{
+
+struct TraceEvent {
+    const InstrumentationEntry* entry;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    size_t thread;
+};
+
+struct InstrumentationRegistry {
+    std::mutex mutex;
+    std::deque<InstrumentationEntry> entries; //deque for stable references
+    std::atomic<bool> trace_enabled{false};
+    std::mutex trace_mutex;
+    std::vector<TraceEvent> trace_events;
+    std::chrono::steady_clock::time_point trace_start = std::chrono::steady_clock::now();
+};
+
+InstrumentationRegistry& get_registry()
+{
+    //never destroyed, entries may be used during destruction of other static objects
+    static auto registry = new InstrumentationRegistry();
+    return *registry;
+}
+
+//escape characters that are not allowed in json strings
+std::string escape_json(const std::string& s)
+{
+    std::string escaped;
+    escaped.reserve(s.size());
+    for (auto c : s) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        if (static_cast<unsigned char>(c) >= 0x20) {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+InstrumentationEntry& get_instrumentation_entry(const std::string& name, InstrumentationKind kind)
+{
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto iter = std::find_if(registry.entries.begin(), registry.entries.end(), [&name](auto& e) {
+        return e.get_name() == name;
+    });
+    if (iter != registry.entries.end()) {
+        assert(iter->get_kind() == kind && "instrumentation entry used as timer and counter.");
+        return *iter;
+    }
+    registry.entries.emplace_back(name, kind);
+    return registry.entries.back();
+}
+
+std::vector<InstrumentationSummary> get_instrumentation_report()
+{
+    auto& registry = get_registry();
+    std::vector<InstrumentationSummary> report;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& e : registry.entries) {
+            auto calls = e.get_calls();
+            if (calls > 0) {
+                report.push_back({e.get_name(), e.get_kind(), e.get_total(), calls});
+            }
+        }
+    }
+    std::sort(report.begin(), report.end(), [](auto& a, auto& b) {
+        if (a.kind != b.kind) {
+            return a.kind == InstrumentationKind::Timer;
+        }
+        if (a.kind == InstrumentationKind::Timer) {
+            return a.total > b.total;
+        }
+        return a.name < b.name;
+    });
+    return report;
+}
+
+void log_instrumentation_report()
+{
+    auto report = get_instrumentation_report();
+    if (report.empty()) {
+        log_info("Instrumentation report: no measurements. Configure with MEMILIO_ENABLE_INSTRUMENTATION=ON.");
+        return;
+    }
+    log_info("Instrumentation report:");
+    for (auto& s : report) {
+        if (s.kind == InstrumentationKind::Timer) {
+            log_info("  {}: {:.6f} s in {} calls, {:.6f} ms per call", s.name, s.total * 1e-9, s.calls,
+                     s.total * 1e-6 / s.calls);
+        }
+        else {
+            log_info("  {}: {} in {} calls, {:.2f} per call", s.name, s.total, s.calls, double(s.total) / s.calls);
+        }
+    }
+}
+
+void reset_instrumentation()
+{
+    auto& registry = get_registry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& e : registry.entries) {
+            e.reset();
+        }
+    }
+    std::lock_guard<std::mutex> lock(registry.trace_mutex);
+    registry.trace_events.clear();
+    registry.trace_start = std::chrono::steady_clock::now();
+}
+
+void set_instrumentation_trace_enabled(bool enabled)
+{
+    get_registry().trace_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+IOResult<void> write_instrumentation_trace(const std::string& filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return failure(StatusCode::FileNotFound, filename);
+    }
+
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.trace_mutex);
+    auto to_us = [&registry](auto tp) {
+        return std::chrono::duration<double, std::micro>(tp - registry.trace_start).count();
+    };
+    //complete events ("ph": "X") with begin and duration in microseconds
+    file << "{\"traceEvents\":[";
+    for (size_t i = 0; i < registry.trace_events.size(); ++i) {
+        auto& event = registry.trace_events[i];
+        file << (i > 0 ? ",\n" : "\n") << "{\"name\":\"" << escape_json(event.entry->get_name())
+             << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread << ",\"ts\":" << to_us(event.start)
+             << ",\"dur\":" << to_us(event.end) - to_us(event.start) << "}";
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    if (!file) {
+        return failure(StatusCode::UnknownError, "Failed to write instrumentation trace to " + filename);
+    }
+    return success();
+}
+
+namespace details
+{
+void record_instrumentation_event(const InstrumentationEntry& entry, std::chrono::steady_clock::time_point start,
+                                  std::chrono::steady_clock::time_point end)
+{
+    auto& registry = get_registry();
+    if (!registry.trace_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    //small sequential ids are easier to read in trace viewers than system thread ids
+    static std::atomic<size_t> num_threads{0};
+    thread_local size_t thread = num_threads++;
+    std::lock_guard<std::mutex> lock(registry.trace_mutex);
+    registry.trace_events.push_back({&entry, start, end, thread});
+}
+} // namespace details
+
+} // namespace mio
@@ -0,0 +1,238 @@
+/* 
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef MIO_UTILS_INSTRUMENTATION_H
+#define MIO_UTILS_INSTRUMENTATION_H
+
+#include "memilio/config.h"
+#include "memilio/io/io.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mio
+{
+
+/**
+ * Kind of an instrumentation entry.
+ */
+enum class InstrumentationKind
+{
+    Timer,
+    Counter,
+};
+
+/**
+ * Aggregated measurements of one instrumented location in the code, e.g. the time spent in a function.
+ * Entries are shared by all threads, updates are atomic.
+ * Use the macros MIO_SCOPED_TIMER and MIO_COUNTER to create and update entries.
+ */
+class InstrumentationEntry
+{
+public:
+    InstrumentationEntry(std::string name, InstrumentationKind kind)
+        : m_name(std::move(name))
+        , m_kind(kind)
+        , m_total(0)
+        , m_calls(0)
+    {
+    }
+
+    /**
+     * add a measurement.
+     * @param value elapsed nanoseconds for timers, any count for counters.
+     */
+    void add(int64_t value)
+    {
+        m_total.fetch_add(value, std::memory_order_relaxed);
+        m_calls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const std::string& get_name() const
+    {
+        return m_name;
+    }
+
+    InstrumentationKind get_kind() const
+    {
+        return m_kind;
+    }
+
+    /**
+     * sum of all measurements, in nanoseconds for timers.
+     */
+    int64_t get_total() const
+    {
+        return m_total.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * number of measurements.
+     */
+    int64_t get_calls() const
+    {
+        return m_calls.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * set all measurements to zero.
+     */
+    void reset()
+    {
+        m_total.store(0, std::memory_order_relaxed);
+        m_calls.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::string m_name;
+    InstrumentationKind m_kind;
+    std::atomic<int64_t> m_total;
+    std::atomic<int64_t> m_calls;
+};
+
+/**
+ * Get the entry with the specified name, create it if it doesn't exist yet.
+ * References to entries stay valid for the lifetime of the program.
+ * @param name name of the entry.
+ * @param kind kind of the entry, must be the same for all uses of the name.
+ * @return the entry.
+ */
+InstrumentationEntry& get_instrumentation_entry(const std::string& name, InstrumentationKind kind);
+
+/**
+ * Measurements of one entry at some point in time.
+ */
+struct InstrumentationSummary {
+    std::string name;
+    InstrumentationKind kind;
+    int64_t total; ///< total nanoseconds for timers, total count for counters.
+    int64_t calls;
+};
+
+/**
+ * Get the current measurements of all entries that were used at least once.
+ * Timers are sorted by total time, counters by name.
+ */
+std::vector<InstrumentationSummary> get_instrumentation_report();
+
+/**
+ * Write the current measurements of all entries to the log at level info.
+ */
+void log_instrumentation_report();
+
+/**
+ * Set the measurements of all entries to zero and discard all recorded trace events.
+ */
+void reset_instrumentation();
+
+/**
+ * Enable or disable recording of trace events.
+ * While enabled, every timed scope is recorded individually so the measurements can be exported
+ * as a trace using write_instrumentation_trace. Disabled by default as the number of events can be large.
+ * @param enabled true to enable recording.
+ */
+void set_instrumentation_trace_enabled(bool enabled);
+
+/**
+ * Write all recorded trace events in the Chrome trace event format.
+ * The file can be viewed in chrome://tracing or https://ui.perfetto.dev.
+ * @param filename name of the file.
+ * @return nothing if successful, error code otherwise.
+ */
+IOResult<void> write_instrumentation_trace(const std::string& filename);
+
+namespace details
+{
+/**
+ * record a trace event if tracing is enabled.
+ */
+void record_instrumentation_event(const InstrumentationEntry& entry, std::chrono::steady_clock::time_point start,
+                                  std::chrono::steady_clock::time_point end);
+} // namespace details
+
+/**
+ * Measures the time from construction to destruction and adds it to an entry.
+ */
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(InstrumentationEntry& entry)
+        : m_entry(entry)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer()
+    {
+        auto end = std::chrono::steady_clock::now();
+        m_entry.add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count());
+        details::record_instrumentation_event(m_entry, m_start, end);
+    }
+
+private:
+    InstrumentationEntry& m_entry;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace mio
+
+#define MIO_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define MIO_INSTRUMENTATION_CONCAT(a, b) MIO_INSTRUMENTATION_CONCAT_(a, b)
+
+#ifdef MEMILIO_ENABLE_INSTRUMENTATION
+
+/**
+ * Measure the time until the end of the current scope.
+ * Compiled to nothing unless the library is configured with MEMILIO_ENABLE_INSTRUMENTATION.
+ * @param name name of the measurement, string literal.
+ */
+#define MIO_SCOPED_TIMER(name)                                                                                         \
+    static auto& MIO_INSTRUMENTATION_CONCAT(mio_instrumentation_entry_, __LINE__) =                                    \
+        ::mio::get_instrumentation_entry(name, ::mio::InstrumentationKind::Timer);                                     \
+    ::mio::ScopedTimer MIO_INSTRUMENTATION_CONCAT(mio_instrumentation_timer_, __LINE__)(                               \
+        MIO_INSTRUMENTATION_CONCAT(mio_instrumentation_entry_, __LINE__))
+
+/**
+ * Add a value to a counter.
+ * Compiled to nothing unless the library is configured with MEMILIO_ENABLE_INSTRUMENTATION.
+ * The value expression is not evaluated if instrumentation is disabled.
+ * @param name name of the counter, string literal.
+ * @param value integer value to add.
+ */
+#define MIO_COUNTER(name, value)                                                                                       \
+    do {                                                                                                               \
+        static auto& mio_instrumentation_entry =                                                                       \
+            ::mio::get_instrumentation_entry(name, ::mio::InstrumentationKind::Counter);                               \
+        mio_instrumentation_entry.add(int64_t(value));                                                                 \
+    } while (false)
+
+#else
+
+#define MIO_SCOPED_TIMER(name) ((void)0)
+#define MIO_COUNTER(name, value) ((void)sizeof(value))
+
+#endif // MEMILIO_ENABLE_INSTRUMENTATION
+
+#endif // MIO_UTILS_INSTRUMENTATION_H
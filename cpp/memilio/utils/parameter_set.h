@@ -348,15 +348,26 @@ public:
     static IOResult<ParameterSet> deserialize(IOContext& io)
     {
         auto obj = io.expect_object("ParameterSet");
+        //braced initialization reads the elements in the order they were written,
+        //the order of function arguments is unspecified but sequential formats depend on it
+        auto results = std::tuple<IOResult<typename Tags::Type>...>{
+            obj.expect_element(Tags::name(), Tag<typename Tags::Type>{})...};
+        return deserialize_results(io, results, std::index_sequence_for<Tags...>{});
+    }
+
+private:
+    template <class IOContext, class Results, size_t... I>
+    static IOResult<ParameterSet> deserialize_results(IOContext& io, const Results& results,
+                                                      std::index_sequence<I...>)
+    {
         return apply(
             io,
             [](const typename Tags::Type&... t) {
                 return ParameterSet(t...);
             },
-            obj.expect_element(Tags::name(), Tag<typename Tags::Type>{})...);
+            std::get<I>(results)...);
     }
 
-private:
     std::tuple<details::TaggedParameter<Tags>...> m_tup;
 };
 
@@ -23,8 +23,12 @@
 #include "memilio/utils/logging.h"
 #include "memilio/utils/span.h"
 
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <random>
 #include <sstream>
@@ -113,6 +117,175 @@ inline void log_thread_local_rng_seeds(LogLevel level)
     log_rng_seeds(thread_local_rng(), level);
 }
 
+/**
+ * counter based random number generator (Philox4x32-10, see Salmon et al., 2011, 
+ * "Parallel random numbers: as easy as 1, 2, 3").
+ * The random numbers are the encrypted values of a counter, so every combination of key and stream 
+ * defines an independent sequence of random numbers that can be created without any state or setup.
+ * This allows e.g. one sequence per agent and time step so that results don't depend on the order 
+ * in which the agents are processed.
+ * Models the standard UniformRandomBitGenerator concept.
+ */
+class CounterBasedRng
+{
+public:
+    using result_type = uint32_t;
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<uint32_t>::max();
+    }
+
+    /**
+     * create a generator for one stream of random numbers.
+     * @param key key of the generator, e.g. a seed.
+     * @param stream words that identify the stream, e.g. id of an agent and a time step.
+     */
+    CounterBasedRng(uint64_t key, const std::array<uint32_t, 3>& stream)
+        : m_key{uint32_t(key), uint32_t(key >> 32)}
+        , m_counter{0, stream[0], stream[1], stream[2]}
+        , m_block{}
+        , m_idx(4)
+    {
+    }
+
+    result_type operator()()
+    {
+        if (m_idx == 4) {
+            m_block = philox(m_counter, m_key);
+            ++m_counter[0];
+            m_idx = 0;
+        }
+        return m_block[m_idx++];
+    }
+
+    /**
+     * uniformly distributed real number in [0, 1).
+     */
+    double uniform_real()
+    {
+        auto a = (*this)() >> 5;
+        auto b = (*this)() >> 6;
+        return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0); //53 random bits, 2^-53
+    }
+
+    /**
+     * the Philox4x32-10 block function.
+     * @param counter the counter to encrypt.
+     * @param key the key.
+     * @return four random numbers.
+     */
+    static std::array<uint32_t, 4> philox(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key)
+    {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9;
+                key[1] += 0xBB67AE85;
+            }
+            uint64_t p0 = uint64_t(0xD2511F53) * counter[0];
+            uint64_t p1 = uint64_t(0xCD9E8D57) * counter[2];
+            counter     = {uint32_t(p1 >> 32) ^ counter[1] ^ key[0], uint32_t(p1),
+                       uint32_t(p0 >> 32) ^ counter[3] ^ key[1], uint32_t(p0)};
+        }
+        return counter;
+    }
+
+private:
+    std::array<uint32_t, 2> m_key;
+    std::array<uint32_t, 4> m_counter;
+    std::array<uint32_t, 4> m_block;
+    int m_idx;
+};
+
+namespace details
+{
+/**
+ * generator that replaces thread_local_rng() in DistributionAdapter on this thread.
+ * @see ScopedRngStream
+ */
+inline CounterBasedRng*& thread_local_rng_stream()
+{
+    static thread_local CounterBasedRng* rng = nullptr;
+    return rng;
+}
+
+/**
+ * default generator function of DistributionAdapter.
+ * Invokes an instance of the distribution with the current generator of this thread.
+ * Specialized for some distributions that can be sampled faster from uniform real numbers
+ * of a counter based generator. thread_local_rng() is always used with the standard distributions,
+ * so seeded sequences and direct draws from the engine are the same as without the specializations.
+ * @tparam DistT a type that models the standard RandomNumberDistribution concept
+ */
+template <class DistT>
+struct DefaultSampler {
+    static typename DistT::result_type sample(const typename DistT::param_type& params)
+    {
+        if (auto rng = thread_local_rng_stream()) {
+            return DistT(params)(*rng);
+        }
+        return DistT(params)(thread_local_rng());
+    }
+};
+
+/**
+ * exponential distribution by inversion of the cumulative distribution function of a counter based generator.
+ */
+template <class Real>
+struct DefaultSampler<std::exponential_distribution<Real>> {
+    static Real sample(const typename std::exponential_distribution<Real>::param_type& params)
+    {
+        if (auto rng = thread_local_rng_stream()) {
+            return Real(-std::log1p(-rng->uniform_real()) / params.lambda());
+        }
+        return std::exponential_distribution<Real>(params)(thread_local_rng());
+    }
+};
+
+/**
+ * uniform distribution in [a, b) by scaling the numbers of a counter based generator.
+ */
+template <class Real>
+struct DefaultSampler<std::uniform_real_distribution<Real>> {
+    static Real sample(const typename std::uniform_real_distribution<Real>::param_type& params)
+    {
+        if (auto rng = thread_local_rng_stream()) {
+            auto x = params.a() + Real(rng->uniform_real()) * (params.b() - params.a());
+            return x < params.b() ? x : params.a(); //rounding may hit the upper bound
+        }
+        return std::uniform_real_distribution<Real>(params)(thread_local_rng());
+    }
+};
+} // namespace details
+
+/**
+ * redirects the default generator functions of all DistributionAdapters on this thread 
+ * to a counter based generator for the lifetime of this object.
+ * Generator functions that were replaced, e.g. by mocks during testing, are not affected.
+ */
+class ScopedRngStream
+{
+public:
+    ScopedRngStream(CounterBasedRng& rng)
+        : m_previous(details::thread_local_rng_stream())
+    {
+        details::thread_local_rng_stream() = &rng;
+    }
+    ~ScopedRngStream()
+    {
+        details::thread_local_rng_stream() = m_previous;
+    }
+    ScopedRngStream(const ScopedRngStream&) = delete;
+    ScopedRngStream& operator=(const ScopedRngStream&) = delete;
+
+private:
+    CounterBasedRng* m_previous;
+};
+
 /**
  * adapter for a random number distribution.
  * Provides a static thread local instance of the distribution
@@ -142,15 +315,13 @@ public:
     using GeneratorFunction = std::function<ResultType(const ParamType& p)>;
 
     /**
-     * the default generator function invokes an instance of the template parameter
-     * with a static thread local RNG engine.
+     * the default generator samples the distribution with a static thread local RNG engine 
+     * or with the current counter based generator of this thread if there is one.
+     * It is called directly and not through a generator function.
+     * @see ScopedRngStream
+     * @see details::DefaultSampler
      */
-    DistributionAdapter()
-    {
-        m_generator = [](auto&& params) {
-            return DistT(params)(thread_local_rng());
-        };
-    }
+    DistributionAdapter() = default;
 
     /**
      * get a random sample from the distribution.
@@ -162,11 +333,15 @@ public:
     template <class... T>
     ResultType operator()(T&&... params)
     {
-        return m_generator(ParamType{std::forward<T>(params)...});
+        if (m_generator) {
+            return m_generator(ParamType{std::forward<T>(params)...});
+        }
+        return details::DefaultSampler<DistT>::sample(ParamType{std::forward<T>(params)...});
     }
 
     /**
      * get the generator function.
+     * @return the generator function or an empty function if the default generator is used.
      */
     GeneratorFunction get_generator() const
     {
@@ -175,6 +350,7 @@ public:
 
     /**
      * set the generator function.
+     * @param g the new generator function or an empty function to use the default generator.
      */
     void set_generator(GeneratorFunction g)
     {
@@ -305,19 +481,34 @@ public:
      */
     template <class RNG>
     result_type operator()(RNG& rng, param_type p)
+    {
+        return select(std::generate_canonical<double, std::numeric_limits<double>::digits>(rng), p);
+    }
+
+    /**
+     * select the random number by linear search in the weights.
+     * @param u uniformly distributed real number in [0, 1).
+     * @param p parameters of the dstribution.
+     */
+    static result_type select(double u, param_type p)
     {
         auto weights = p.weights();
         if (weights.size() <= 1) {
             return 0;
         }
-        auto sum = std::accumulate(weights.begin(), weights.end(), 0.0);
-        auto u =
-            std::uniform_real_distribution<double>()(rng, std::uniform_real_distribution<double>::param_type{0.0, sum});
+        auto sum              = std::accumulate(weights.begin(), weights.end(), 0.0);
+        auto x                = u * sum;
         auto intermediate_sum = 0.0;
         for (size_t i = 0; i < weights.size(); ++i) {
             intermediate_sum += weights.get_ptr()[i];
-            if (u < intermediate_sum) {
-                return i;
+            if (x < intermediate_sum) {
+                return result_type(i);
+            }
+        }
+        //rounding may hit the upper bound, select the last nonzero weight
+        for (size_t i = weights.size(); i > 0; --i) {
+            if (weights.get_ptr()[i - 1] > 0) {
+                return result_type(i - 1);
             }
         }
         assert(false && "this should never happen.");
@@ -328,6 +519,23 @@ private:
     param_type m_params;
 };
 
+namespace details
+{
+/**
+ * discrete distribution from a single uniform real number of a counter based generator.
+ */
+template <class Int>
+struct DefaultSampler<DiscreteDistributionInPlace<Int>> {
+    static Int sample(const typename DiscreteDistributionInPlace<Int>::param_type& params)
+    {
+        if (auto rng = thread_local_rng_stream()) {
+            return DiscreteDistributionInPlace<Int>::select(rng->uniform_real(), params);
+        }
+        return DiscreteDistributionInPlace<Int>(params)(thread_local_rng());
+    }
+};
+} // namespace details
+
 /**
  * adapted discrete distribution
  * @see DistributionAdapter
@@ -0,0 +1,122 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/utils/thread_pool.h"
+
+#include <cassert>
+
+namespace mio
+{
+
+ThreadPool::ThreadPool(int num_threads)
+    : m_task(nullptr)
+    , m_generation(0)
+    , m_num_running(0)
+    , m_is_stopped(false)
+{
+    assert(num_threads > 0);
+    m_workers.reserve(num_threads - 1);
+    for (int thread_idx = 1; thread_idx < num_threads; ++thread_idx) {
+        m_workers.emplace_back([this, thread_idx] {
+            work(thread_idx);
+        });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_stopped = true;
+    }
+    m_cv_start.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(const std::function<void(int)>& f)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        assert(m_num_running == 0 && "ThreadPool::run must not be called concurrently.");
+        m_task        = &f;
+        m_num_running = int(m_workers.size());
+        m_exception   = nullptr;
+        ++m_generation;
+    }
+    m_cv_start.notify_all();
+
+    std::exception_ptr exception;
+    try {
+        f(0);
+    }
+    catch (...) {
+        exception = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv_done.wait(lock, [this] {
+        return m_num_running == 0;
+    });
+    m_task = nullptr;
+    if (!exception) {
+        exception = m_exception;
+    }
+    lock.unlock();
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void ThreadPool::work(int thread_idx)
+{
+    size_t generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv_start.wait(lock, [this, generation] {
+            return m_is_stopped || m_generation != generation;
+        });
+        if (m_is_stopped) {
+            return;
+        }
+        generation = m_generation;
+        auto task  = m_task;
+
+        //execute without lock so the threads run in parallel
+        lock.unlock();
+        std::exception_ptr exception;
+        try {
+            (*task)(thread_idx);
+        }
+        catch (...) {
+            exception = std::current_exception();
+        }
+        lock.lock();
+
+        if (exception && !m_exception) {
+            m_exception = exception;
+        }
+        if (--m_num_running == 0) {
+            m_cv_done.notify_one();
+        }
+    }
+}
+
+} // namespace mio
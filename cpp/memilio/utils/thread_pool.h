@@ -0,0 +1,89 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef EPI_UTILS_THREAD_POOL_H
+#define EPI_UTILS_THREAD_POOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mio
+{
+
+/**
+ * a fixed number of threads that repeatedly execute the same task in parallel.
+ * The threads are started once and wait between tasks, so short tasks that are executed
+ * very often, e.g. in every time step of a simulation, don't pay for creating threads.
+ * The calling thread takes part in every task, so a pool with one thread doesn't start any threads.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief start the threads of the pool.
+     * @param num_threads number of threads including the calling thread, at least 1.
+     */
+    explicit ThreadPool(int num_threads);
+
+    /**
+     * stops and joins all threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * number of threads including the calling thread.
+     */
+    int get_num_threads() const
+    {
+        return int(m_workers.size()) + 1;
+    }
+
+    /**
+     * @brief execute a task on all threads and wait until it is done on every thread.
+     * The task is called once with each thread index, index 0 is executed on the calling thread.
+     * If the task throws on any thread, the first exception is rethrown after all threads are done.
+     * Must not be called concurrently or from within a task.
+     * @param f task with signature void(int thread_idx).
+     */
+    void run(const std::function<void(int)>& f);
+
+private:
+    void work(int thread_idx);
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_cv_start;
+    std::condition_variable m_cv_done;
+    const std::function<void(int)>* m_task; ///< current task, only valid during run.
+    size_t m_generation; ///< incremented for every task, so each worker executes each task once.
+    int m_num_running; ///< number of workers that haven't finished the current task.
+    bool m_is_stopped;
+    std::exception_ptr m_exception;
+};
+
+} // namespace mio
+
+#endif // EPI_UTILS_THREAD_POOL_H
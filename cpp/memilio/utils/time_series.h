@@ -25,6 +25,7 @@
 #include "memilio/utils/stl_util.h"
 #include "memilio/utils/compiler_diagnostics.h"
 #include "memilio/math/floating_point.h"
+#include "memilio/io/io.h"
 
 #include <iterator>
 #include <vector>
@@ -52,6 +53,8 @@ class TimeSeriesTimeIterator;
  * grows efficiently (like std::vector) in time dimension.
  * Time and values of a single point are stored together in memory: 
  * {t0, v0[0], v0[1], ...}, {t1, v1[0], v1[1], ...}, {t2, v20, ...
+ * The occupied block of storage may start at an offset, so time points can be removed from the front
+ * as efficiently as from the back, e.g. if the time series is used as a queue.
  * @tparam FP any floating point like type accepted by Eigen
  */
 template <class FP>
@@ -82,6 +85,7 @@ public:
      */
     TimeSeries(Eigen::Index num_elements)
         : m_data(num_elements + 1, 0)
+        , m_first(0)
         , m_num_time_points(0)
     {
         assert(num_elements >= 0);
@@ -97,6 +101,7 @@ public:
     template <typename Expr>
     TimeSeries(FP t, Expr&& expr)
         : m_data(expr.rows() + 1, 1)
+        , m_first(0)
         , m_num_time_points(1)
     {
         auto col              = m_data.col(0);
@@ -107,6 +112,7 @@ public:
     /** copy ctor */
     TimeSeries(const TimeSeries& other)
         : m_data(other.get_num_elements() + 1, details::next_pow2(other.m_num_time_points))
+        , m_first(0)
         , m_num_time_points(other.m_num_time_points)
     {
         get_valid_block() = other.get_valid_block();
@@ -133,6 +139,7 @@ public:
         auto data = Matrix(other.get_num_elements() + 1, details::next_pow2(other.m_num_time_points));
         data.leftCols(other.m_num_time_points) = other.get_valid_block();
         m_data                                 = std::move(data);
+        m_first                                = 0;
         m_num_time_points                      = other.m_num_time_points;
         return *this;
     }
@@ -141,6 +148,21 @@ public:
     TimeSeries(TimeSeries&& other) = default;
     TimeSeries& operator=(TimeSeries&& other) = default;
 
+    /**
+     * convert to a time series of a different floating point type.
+     * E.g. results that are computed in double precision can be stored in single precision to save memory.
+     * @tparam FP2 floating point type of the converted time series
+     * @return time series with the same time points and values, converted to FP2
+     */
+    template <class FP2>
+    TimeSeries<FP2> cast() const
+    {
+        TimeSeries<FP2> converted(get_num_elements());
+        converted.m_data            = get_valid_block().template cast<FP2>();
+        converted.m_num_time_points = m_num_time_points;
+        return converted;
+    }
+
     /**
      * number of time points in the series
      */
@@ -200,15 +222,26 @@ public:
 
     /** 
      * remove time point.
+     * Constant time at the front and at the back, otherwise the shorter side of the remaining points is moved.
      * @param i index to remove
      */
     void remove_time_point(Eigen::Index i)
     {
         assert(i >= 0 && i < m_num_time_points);
+        if (i < m_num_time_points / 2) {
+            for (auto j = m_first + i; j > m_first; --j) {
+                m_data.col(j) = m_data.col(j - 1);
+            }
+            ++m_first;
+        }
+        else {
+            for (auto j = m_first + i; j < m_first + m_num_time_points - 1; ++j) {
+                m_data.col(j) = m_data.col(j + 1);
+            }
+        }
         m_num_time_points -= 1;
-        for (auto j = i; j < m_num_time_points; ++j)
-        {
-            m_data.col(j) = m_data.col(j + 1);
+        if (m_num_time_points == 0) {
+            m_first = 0;
         }
     }
 
@@ -223,12 +256,12 @@ public:
     FP& get_time(Eigen::Index i)
     {
         assert(i >= 0 && i < m_num_time_points);
-        return m_data(0, i);
+        return m_data(0, m_first + i);
     }
     const FP& get_time(Eigen::Index i) const
     {
         assert(i >= 0 && i < m_num_time_points);
-        return m_data(0, i);
+        return m_data(0, m_first + i);
     }
 
     /**
@@ -249,12 +282,12 @@ public:
     Eigen::Ref<const Vector> get_value(Eigen::Index i) const
     {
         assert(i >= 0 && i < m_num_time_points);
-        return m_data.col(i).segment(1, get_num_elements());
+        return m_data.col(m_first + i).segment(1, get_num_elements());
     }
     Eigen::Ref<Vector> get_value(Eigen::Index i)
     {
         assert(i >= 0 && i < m_num_time_points);
-        return m_data.col(i).segment(1, get_num_elements());
+        return m_data.col(m_first + i).segment(1, get_num_elements());
     }
     Eigen::Ref<const Vector> operator[](Eigen::Index i) const
     {
@@ -283,8 +316,11 @@ public:
     void reserve(Eigen::Index n)
     {
         assert(n >= 0);
-        if (n > get_capacity()) {
-            m_data.conservativeResize(Eigen::NoChange, details::next_pow2(n));
+        if (m_first + n > get_capacity()) {
+            move_to_front();
+            if (n > get_capacity()) {
+                m_data.conservativeResize(Eigen::NoChange, details::next_pow2(n));
+            }
         }
     }
 
@@ -305,13 +341,50 @@ public:
     {
         assert(m_data.innerStride() == 1);
         assert(m_data.outerStride() == m_data.rows());
-        return m_data.data();
+        return m_data.data() + m_first * get_num_rows();
     }
     const FP* data() const
     {
         assert(m_data.innerStride() == 1);
         assert(m_data.outerStride() == m_data.rows());
-        return m_data.data();
+        return m_data.data() + m_first * get_num_rows();
+    }
+
+    /**
+     * serialize this.
+     * The time points are written as one contiguous array, see data().
+     * @see mio::serialize
+     */
+    template <class IOContext>
+    void serialize(IOContext& io) const
+    {
+        auto obj = io.create_object("TimeSeries");
+        obj.add_element("NumElements", get_num_elements());
+        obj.add_element("NumTimePoints", get_num_time_points());
+        obj.add_array("Data", data(), size_t(get_num_rows() * get_num_time_points()));
+    }
+
+    /**
+     * deserialize an object of this class.
+     * @see mio::deserialize
+     */
+    template <class IOContext>
+    static IOResult<TimeSeries> deserialize(IOContext& io)
+    {
+        auto obj = io.expect_object("TimeSeries");
+        auto ne  = obj.expect_element("NumElements", Tag<Eigen::Index>{});
+        auto nt  = obj.expect_element("NumTimePoints", Tag<Eigen::Index>{});
+        return apply(
+            io,
+            [&obj](auto&& ne_, auto&& nt_) -> IOResult<TimeSeries> {
+                if (ne_ < 0 || nt_ < 0) {
+                    return failure(StatusCode::InvalidValue, "Size of TimeSeries must be non-negative.");
+                }
+                auto ts = TimeSeries::zero(nt_, ne_);
+                BOOST_OUTCOME_TRY(obj.expect_array("Data", ts.data(), size_t(ts.get_num_rows() * nt_)));
+                return success(std::move(ts));
+            },
+            ne, nt);
     }
 
     /*********************
@@ -322,32 +395,32 @@ public:
      *********************/
     iterator begin()
     {
-        return {&m_data, 0};
+        return {&m_data, m_first};
     }
 
     iterator end()
     {
-        return {&m_data, m_num_time_points};
+        return {&m_data, m_first + m_num_time_points};
     }
 
     const_iterator begin() const
     {
-        return {&m_data, 0};
+        return {&m_data, m_first};
     }
 
     const_iterator end() const
     {
-        return {&m_data, m_num_time_points};
+        return {&m_data, m_first + m_num_time_points};
     }
 
     const_iterator cbegin() const
     {
-        return {&m_data, 0};
+        return {&m_data, m_first};
     }
 
     const_iterator cend() const
     {
-        return {&m_data, m_num_time_points};
+        return {&m_data, m_first + m_num_time_points};
     }
 
     reverse_iterator rbegin()
@@ -388,7 +461,7 @@ public:
      *********************/
     Range<std::pair<time_iterator, time_iterator>> get_times()
     {
-        return make_range(time_iterator{&m_data, 0}, time_iterator{&m_data, m_num_time_points});
+        return make_range(time_iterator{&m_data, m_first}, time_iterator{&m_data, m_first + m_num_time_points});
     }
 
     Range<std::pair<const_time_iterator, const_time_iterator>> get_times() const
@@ -398,7 +471,8 @@ public:
 
     Range<std::pair<const_time_iterator, const_time_iterator>> get_const_times() const
     {
-        return make_range(const_time_iterator{&m_data, 0}, const_time_iterator{&m_data, m_num_time_points});
+        return make_range(const_time_iterator{&m_data, m_first},
+                          const_time_iterator{&m_data, m_first + m_num_time_points});
     }
 
     Range<std::pair<reverse_time_iterator, reverse_time_iterator>> get_reverse_times()
@@ -428,23 +502,45 @@ public:
     }
 
 private:
+    template <class FP2>
+    friend class TimeSeries;
+
     void add_time_point_noinit()
     {
-        reserve(m_num_time_points + 1);
+        if (m_first + m_num_time_points == get_capacity() && m_first < m_num_time_points) {
+            //less than half of the storage is free, grow instead of moving the occupied block to the front
+            //so adding stays amortized constant time when points are also removed from the front
+            reserve(get_capacity() + 1);
+        }
+        else {
+            reserve(m_num_time_points + 1);
+        }
         ++m_num_time_points;
     }
+    /** move the occupied block of storage to the first column */
+    void move_to_front()
+    {
+        if (m_first > 0) {
+            for (Eigen::Index j = 0; j < m_num_time_points; ++j) {
+                m_data.col(j) = m_data.col(m_first + j);
+            }
+            m_first = 0;
+        }
+    }
     /** currently occupied block of storage */
     auto get_valid_block()
     {
-        return m_data.leftCols(get_num_time_points());
+        return m_data.middleCols(m_first, get_num_time_points());
     }
     auto get_valid_block() const
     {
-        return m_data.leftCols(get_num_time_points());
+        return m_data.middleCols(m_first, get_num_time_points());
     }
 
     /** data storage */
     Matrix m_data;
+    /** index of the first occupied column in m_data */
+    Eigen::Index m_first;
     /** number of time points (i.e. occupied columns in m_data) */
     Eigen::Index m_num_time_points;
 };
@@ -27,6 +27,11 @@ void UncertainValue::set_distribution(const ParameterDistribution& dist)
     m_dist.reset(dist.clone());
 }
 
+void UncertainValue::remove_distribution()
+{
+    m_dist.reset();
+}
+
 observer_ptr<ParameterDistribution> UncertainValue::get_distribution()
 {
     return m_dist.get();
@@ -118,6 +118,11 @@ public:
      */
     void set_distribution(const ParameterDistribution& dist);
 
+    /**
+     * @brief Removes the distribution, the value remains unchanged.
+     */
+    void remove_distribution();
+
     /**
      * @brief Returns the parameter distribution.
      *
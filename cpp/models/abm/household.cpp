@@ -20,18 +20,33 @@
 
 #include "abm/household.h"
 #include "memilio/math/eigen.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
 #include <string>
 
 namespace mio {
 
 namespace{
 /**
- * Picks an age from a custom index array with a weight for each age group according to a discrete distribution.
- * @param age_groups A custom index array with the weights.
+ * weights of the age groups of a household member as real numbers for the discrete distribution.
+ */
+std::array<double, size_t(mio::AbmAgeGroup::Count)> get_age_group_weights(const mio::HouseholdMember& member)
+{
+    std::array<double, size_t(mio::AbmAgeGroup::Count)> weights;
+    for (auto i = mio::Index<mio::AbmAgeGroup>(0); i < mio::AbmAgeGroup::Count; ++i) {
+        weights[size_t(i)] = member.get_age_weights()[i];
+    }
+    return weights;
+}
+
+/**
+ * Picks an age group according to a discrete distribution.
+ * @param age_group_weights the weight of each age group.
  * @return The picked age group.
  */
-mio::AbmAgeGroup pick_age_group_from_age_distribution(const mio::CustomIndexArray<int, mio::AbmAgeGroup>& age_groups){
-    auto age_group_weights = age_groups.array().cast<double>().eval();
+mio::AbmAgeGroup pick_age_group_from_age_distribution(const std::array<double, size_t(mio::AbmAgeGroup::Count)>& age_group_weights){
     size_t age_group = mio::DiscreteDistribution<size_t>::get_instance()(age_group_weights);
     return (mio::AbmAgeGroup) age_group;
 }
@@ -50,14 +65,13 @@ void HouseholdGroup::add_households(Household household, int number_of_household
 
 void add_household_to_world(mio::World& world, const mio::Household& household){
     auto home = world.add_location(mio::LocationType::Home);
-    auto members = household.get_members();
-    
-    for (auto &memberTouple : members){
-        int count;
-        mio::HouseholdMember member;
-        std::tie(member, count) = memberTouple;
+
+    for (auto& member_tuple : household.get_members()){
+        auto& member = std::get<0>(member_tuple);
+        auto count   = std::get<1>(member_tuple);
+        auto weights = get_age_group_weights(member);
         for (int j = 0; j < count; j++) {
-            auto age_group = pick_age_group_from_age_distribution(member.get_age_weights());
+            auto age_group = pick_age_group_from_age_distribution(weights);
             auto& person = world.add_person(home, mio::InfectionState::Susceptible, age_group);
             person.set_assigned_location(home);
         }
@@ -65,16 +79,61 @@ void add_household_to_world(mio::World& world, const mio::Household& household){
 }
 
 void add_household_group_to_world(mio::World& world, const mio::HouseholdGroup& household_group){
-    auto households = household_group.get_households();
-   
-    for (auto &householdTuple : households){
-        int count;
-        mio::Household household;
-        std::tie(household, count) = householdTuple;
+    //reserve memory for all homes and persons of the group
+    size_t num_persons = world.get_persons().size();
+    size_t num_homes   = world.get_locations()[size_t(mio::LocationType::Home)].size();
+    for (auto& household_tuple : household_group.get_households()) {
+        auto count = size_t(std::get<1>(household_tuple));
+        num_persons += count * std::get<0>(household_tuple).get_total_number_of_members();
+        num_homes += count;
+    }
+    world.reserve_persons(num_persons);
+    world.reserve_locations(mio::LocationType::Home, num_homes);
+
+    for (auto& household_tuple : household_group.get_households()){
+        auto& household = std::get<0>(household_tuple);
+        auto count      = std::get<1>(household_tuple);
         for (int j = 0; j < count; j++) {
             add_household_to_world(world, household);
         }
     }
 }
 
+std::vector<mio::LocationId> add_and_assign_locations(mio::World& world, mio::LocationType type,
+                                                      const std::vector<mio::AbmAgeGroup>& age_groups,
+                                                      int persons_per_location)
+{
+    assert(persons_per_location > 0);
+
+    std::array<bool, size_t(mio::AbmAgeGroup::Count)> is_selected{};
+    for (auto age_group : age_groups) {
+        is_selected[size_t(age_group)] = true;
+    }
+    std::vector<mio::Person*> persons;
+    persons.reserve(world.get_persons().size());
+    for (auto& person : world.get_persons()) {
+        if (is_selected[size_t(person.get_age())]) {
+            persons.push_back(&person);
+        }
+    }
+
+    //distribute the persons randomly, the permutation only depends on the seed of the world
+    //and the locations that already exist, so the stream can't be the stream of a person
+    auto rng = mio::CounterBasedRng(world.get_rng_seed(), {std::numeric_limits<uint32_t>::max(), uint32_t(type),
+                                                           uint32_t(world.get_locations()[size_t(type)].size())});
+    std::shuffle(persons.begin(), persons.end(), rng);
+
+    auto num_locations = (persons.size() + persons_per_location - 1) / persons_per_location;
+    world.reserve_locations(type, world.get_locations()[size_t(type)].size() + num_locations);
+    std::vector<mio::LocationId> locations;
+    locations.reserve(num_locations);
+    for (size_t i = 0; i < num_locations; ++i) {
+        locations.push_back(world.add_location(type));
+    }
+    for (size_t i = 0; i < persons.size(); ++i) {
+        persons[i]->set_assigned_location(locations[i / persons_per_location]);
+    }
+    return locations;
+}
+
 } // namespace mio
@@ -175,11 +175,29 @@ void add_household_to_world(mio::World& world, const mio::Household& household);
 
 /**
  * Adds households from a household group to the world modell.
+ * Memory for all homes and persons of the group is reserved up front.
  * @param world The world class to which the group has to be added.
  * @param household_group The household group to add.
  */
 void add_household_group_to_world(mio::World& world, const mio::HouseholdGroup& household_group);
 
+/**
+ * Adds locations of one type to the world and assigns one of them to each person of some age groups,
+ * e.g. schools to all children or workplaces to all adults.
+ * The persons are distributed randomly, each location is assigned to the same number of persons,
+ * except the last one that may have fewer.
+ * The distribution is determined by the seed of the world, see World::set_rng_seed.
+ * Call after all persons are added to the world.
+ * @param world The world class to which the locations are added.
+ * @param type The type of the new locations.
+ * @param age_groups The age groups of the persons that are assigned one of the new locations.
+ * @param persons_per_location The number of persons assigned to each location.
+ * @return The ids of the new locations, e.g. to set their parameters.
+ */
+std::vector<mio::LocationId> add_and_assign_locations(mio::World& world, mio::LocationType type,
+                                                      const std::vector<mio::AbmAgeGroup>& age_groups,
+                                                      int persons_per_location);
+
 
 
 }
@@ -21,7 +21,9 @@
 #include "abm/location.h"
 #include "abm/person.h"
 #include "abm/random_events.h"
+#include "memilio/io/checkpoint.h"
 
+#include <limits>
 #include <numeric>
 
 namespace mio
@@ -36,44 +38,88 @@ Location::Location(LocationType type, uint32_t index)
 {
 }
 
+namespace
+{
+/**
+ * apply a function to the transitions of the infection state of a person that happen at a constant rate.
+ * @param f function with signature R(InfectionState current_state, const std::pair<InfectionState, double> (&)[N]).
+ * @param no_transition function with signature R(InfectionState current_state) for states without such transitions.
+ */
+template <class F, class G>
+auto visit_progression(const Person& person, const GlobalInfectionParameters& global_params, F f, G no_transition)
+{
+    auto infection_state   = person.get_infection_state();
+    auto vaccination_state = person.get_vaccination_state();
+    auto age               = person.get_age();
+    using Transition = std::pair<InfectionState, double>;
+    switch (infection_state) {
+    case InfectionState::Carrier: {
+        const Transition transitions[] = {
+            {InfectionState::Infected, global_params.get<CarrierToInfected>()[{age, vaccination_state}]},
+            {InfectionState::Recovered_Carrier, global_params.get<CarrierToRecovered>()[{age, vaccination_state}]}};
+        return f(infection_state, transitions);
+    }
+    case InfectionState::Infected: {
+        const Transition transitions[] = {
+            {InfectionState::Recovered_Infected, global_params.get<InfectedToRecovered>()[{age, vaccination_state}]},
+            {InfectionState::Infected_Severe, global_params.get<InfectedToSevere>()[{age, vaccination_state}]}};
+        return f(infection_state, transitions);
+    }
+    case InfectionState::Infected_Severe: {
+        const Transition transitions[] = {
+            {InfectionState::Recovered_Infected, global_params.get<SevereToRecovered>()[{age, vaccination_state}]},
+            {InfectionState::Infected_Critical, global_params.get<SevereToCritical>()[{age, vaccination_state}]}};
+        return f(infection_state, transitions);
+    }
+    case InfectionState::Infected_Critical: {
+        const Transition transitions[] = {
+            {InfectionState::Recovered_Infected, global_params.get<CriticalToRecovered>()[{age, vaccination_state}]},
+            {InfectionState::Dead, global_params.get<CriticalToDead>()[{age, vaccination_state}]}};
+        return f(infection_state, transitions);
+    }
+    case InfectionState::Recovered_Carrier: //fallthrough!
+    case InfectionState::Recovered_Infected: {
+        const Transition transitions[] = {
+            {InfectionState::Susceptible, global_params.get<RecoveredToSusceptible>()[{age, vaccination_state}]}};
+        return f(infection_state, transitions);
+    }
+    default:
+        return no_transition(infection_state); //some states don't transition
+    }
+}
+} // namespace
+
 InfectionState Location::interact(const Person& person, TimeSpan dt,
                                   const GlobalInfectionParameters& global_params) const
 {
     auto infection_state   = person.get_infection_state();
     auto vaccination_state = person.get_vaccination_state();
     auto age               = person.get_age();
-    switch (infection_state) {
-    case InfectionState::Susceptible:
+    if (infection_state == InfectionState::Susceptible) {
         return random_transition(infection_state, dt,
                                  {{InfectionState::Exposed, m_cached_exposure_rate[{age, vaccination_state}]}});
-    case InfectionState::Carrier:
-        return random_transition(
-            infection_state, dt,
-            {{InfectionState::Infected, global_params.get<CarrierToInfected>()[{age, vaccination_state}]},
-             {InfectionState::Recovered_Carrier, global_params.get<CarrierToRecovered>()[{age, vaccination_state}]}});
-    case InfectionState::Infected:
-        return random_transition(
-            infection_state, dt,
-            {{InfectionState::Recovered_Infected, global_params.get<InfectedToRecovered>()[{age, vaccination_state}]},
-             {InfectionState::Infected_Severe, global_params.get<InfectedToSevere>()[{age, vaccination_state}]}});
-    case InfectionState::Infected_Severe:
-        return random_transition(
-            infection_state, dt,
-            {{InfectionState::Recovered_Infected, global_params.get<SevereToRecovered>()[{age, vaccination_state}]},
-             {InfectionState::Infected_Critical, global_params.get<SevereToCritical>()[{age, vaccination_state}]}});
-    case InfectionState::Infected_Critical:
-        return random_transition(
-            infection_state, dt,
-            {{InfectionState::Recovered_Infected, global_params.get<CriticalToRecovered>()[{age, vaccination_state}]},
-             {InfectionState::Dead, global_params.get<CriticalToDead>()[{age, vaccination_state}]}});
-    case InfectionState::Recovered_Carrier: //fallthrough!
-    case InfectionState::Recovered_Infected:
-        return random_transition(
-            infection_state, dt,
-            {{InfectionState::Susceptible, global_params.get<RecoveredToSusceptible>()[{age, vaccination_state}]}});
-    default:
-        return infection_state; //some states don't transition
     }
+    return visit_progression(
+        person, global_params,
+        [dt](auto current_state, auto&& transitions) {
+            return random_transition(current_state, dt, transitions);
+        },
+        [](auto current_state) {
+            return current_state;
+        });
+}
+
+std::pair<InfectionState, double> sample_progression(const Person& person,
+                                                     const GlobalInfectionParameters& global_params)
+{
+    return visit_progression(
+        person, global_params,
+        [](auto current_state, auto&& transitions) {
+            return sample_transition(current_state, transitions);
+        },
+        [](auto current_state) {
+            return std::make_pair(current_state, std::numeric_limits<double>::infinity());
+        });
 }
 
 void Location::begin_step(TimeSpan /*dt*/, const GlobalInfectionParameters& global_params)
@@ -117,6 +163,9 @@ void Location::change_subpopulation(InfectionState s, int delta)
 {
     m_subpopulations[size_t(s)] += delta;
     assert(m_subpopulations[size_t(s)] >= 0 && "subpopulations must be non-negative");
+    if (m_total_subpopulations) {
+        (*m_total_subpopulations)[size_t(s)].fetch_add(delta, std::memory_order_relaxed);
+    }
 }
 
 int Location::get_subpopulation(InfectionState s) const
@@ -129,4 +178,29 @@ Eigen::Ref<const Eigen::VectorXi> Location::get_subpopulations() const
     return Eigen::Map<const Eigen::VectorXi>(m_subpopulations.data(), m_subpopulations.size());
 }
 
+void Location::write_checkpoint(CheckpointWriter& writer) const
+{
+    //the cached exposure rate is computed again at the beginning of the next step
+    writer.write(m_num_persons);
+    writer.write(m_subpopulations);
+    writer.write(m_parameters.get<MaximumContacts>());
+    writer.write(m_testing_scheme.get_interval());
+    writer.write(m_testing_scheme.get_probability());
+    writer.write(m_members);
+}
+
+IOResult<void> Location::read_checkpoint(CheckpointReader& reader)
+{
+    BOOST_OUTCOME_TRY(reader.read(m_num_persons));
+    BOOST_OUTCOME_TRY(reader.read(m_subpopulations));
+    BOOST_OUTCOME_TRY(reader.read(m_parameters.get<MaximumContacts>()));
+    TimeSpan testing_interval;
+    double testing_probability;
+    BOOST_OUTCOME_TRY(reader.read(testing_interval));
+    BOOST_OUTCOME_TRY(reader.read(testing_probability));
+    m_testing_scheme = TestingScheme(testing_interval, testing_probability);
+    BOOST_OUTCOME_TRY(reader.read(m_members));
+    return success();
+}
+
 } // namespace mio
@@ -25,13 +25,19 @@
 #include "abm/state.h"
 #include "abm/location_type.h"
 
+#include "memilio/io/io.h"
 #include "memilio/math/eigen.h"
 #include <array>
+#include <atomic>
+#include <cassert>
 #include <random>
+#include <vector>
 
 namespace mio
 {
 class Person;
+class CheckpointWriter;
+class CheckpointReader;
 
 /**
  * LocationId identifies a Location uniquely. It consists of the LocationType of the Location and an Index.
@@ -49,6 +55,12 @@ struct LocationId
 class Location
 {
 public:
+    /**
+     * number of persons in each infection state at all locations of one type.
+     * Atomic, because locations of the same type are updated concurrently.
+     */
+    using TotalSubpopulations = std::array<std::atomic<int>, size_t(InfectionState::Count)>;
+
    /**
      * construct a Location of a certain type.
      * @param type the type of the location
@@ -93,8 +105,42 @@ public:
      */
     void remove_person(const Person& person);
 
+    /**
+     * indices of the persons at this location in the world.
+     * Only maintained by the world, see World::get_persons, persons that are added with add_person are not members.
+     * The order of the members is not specified.
+     */
+    const std::vector<uint32_t>& get_members() const
+    {
+        return m_members;
+    }
+
+    /**
+     * add a person to the members of this location.
+     * @param person_idx index of the person in the world.
+     * @return position of the person in the members.
+     */
+    uint32_t add_member(uint32_t person_idx)
+    {
+        m_members.push_back(person_idx);
+        return uint32_t(m_members.size() - 1);
+    }
+
+    /**
+     * remove a person from the members of this location.
+     * The last member takes the position of the removed person.
+     * @param position position of the person in the members.
+     */
+    void remove_member(uint32_t position)
+    {
+        assert(position < m_members.size());
+        m_members[position] = m_members.back();
+        m_members.pop_back();
+    }
+
     /** 
      * notification that one person in this location changed infection state.
+     * Like add_person and remove_person, also updates the subpopulations of the world the location belongs to.
      * @param person the person that changed infection state
      * @param old_state the previous infection state of the person
      */
@@ -143,7 +189,21 @@ public:
         return m_testing_scheme;
     }
 
+    /**
+     * write the state of the location to a checkpoint.
+     * @see CheckpointWriter
+     */
+    void write_checkpoint(CheckpointWriter& writer) const;
+
+    /**
+     * restore the state of the location from a checkpoint.
+     * @see CheckpointReader
+     */
+    IOResult<void> read_checkpoint(CheckpointReader& reader);
+
 private:
+    friend class World;
+
     void change_subpopulation(InfectionState s, int delta);
 
 private: 
@@ -154,7 +214,22 @@ private:
     LocalInfectionParameters m_parameters;
     CustomIndexArray<double, AbmAgeGroup, mio::VaccinationState> m_cached_exposure_rate;
     TestingScheme m_testing_scheme;
+    std::vector<uint32_t> m_members;
+    TotalSubpopulations* m_total_subpopulations = nullptr; ///< subpopulations of the world, set by the world.
 };
+
+/**
+ * sample the next change of the infection state of a person that happens at a constant rate,
+ * i.e. the progression of the disease after the incubation and the loss of immunity.
+ * The rates are the same as in Location::interact and don't depend on the location.
+ * @param person the person, with its current infection state.
+ * @param global_params global infection parameters
+ * @return pair of the new infection state and the time in days until the change,
+ * the current infection state and infinity if the state doesn't change at a constant rate.
+ */
+std::pair<InfectionState, double> sample_progression(const Person& person,
+                                                     const GlobalInfectionParameters& global_params);
+
 } // namespace mio
 
 #endif
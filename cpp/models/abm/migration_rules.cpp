@@ -26,11 +26,44 @@
 #include "memilio/utils/random_number_generator.h"
 #include "abm/location_type.h"
 
+#include <algorithm>
+#include <limits>
 #include <random>
 
 namespace mio
 {
 
+namespace
+{
+/**
+ * check if a person at home may leave for the shop in the time step, see go_to_shop.
+ */
+bool can_go_to_shop(const Person& person, TimePoint t)
+{
+    return t.day_of_week() < 6 && t.hour_of_day() > 7 && t.hour_of_day() < 22 && !person.is_in_quarantine();
+}
+
+/**
+ * check if a person at home may leave for a social event in the time step, see go_to_event.
+ */
+bool can_go_to_event(const Person& person, TimePoint t, const AbmMigrationParameters& params)
+{
+    return t < params.get<LockdownDate>() &&
+           ((t.day_of_week() <= 4 && t.hour_of_day() >= 19) || (t.day_of_week() >= 5 && t.hour_of_day() >= 10)) &&
+           !person.is_in_quarantine();
+}
+
+double shopping_rate(const Person& person, TimePoint /*t*/, const AbmMigrationParameters& params)
+{
+    return params.get<BasicShoppingRate>()[person.get_age()];
+}
+
+double social_event_rate(const Person& person, TimePoint t, const AbmMigrationParameters& params)
+{
+    return params.get<SocialEventRate>().get_matrix_at(t.days())[(size_t)person.get_age()];
+}
+} // namespace
+
 LocationType random_migration(const Person& person, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params)
 {
     auto current_loc     = person.get_location_id().type;
@@ -51,9 +84,10 @@ LocationType go_to_school(const Person& person, TimePoint t, TimeSpan dt, const
     auto current_loc = person.get_location_id().type;
 
     if (current_loc == LocationType::Home && t < params.get<LockdownDate>() && t.day_of_week() < 5 &&
+        person.get_age() == AbmAgeGroup::Age5to14 &&
         person.get_go_to_school_time(params) >= t.time_since_midnight() &&
-        person.get_go_to_school_time(params) < t.time_since_midnight() + dt &&
-        person.get_age() == AbmAgeGroup::Age5to14 && person.goes_to_school(t, params) && !person.is_in_quarantine()) {
+        person.get_go_to_school_time(params) < t.time_since_midnight() + dt && person.goes_to_school(t, params) &&
+        !person.is_in_quarantine()) {
         return mio::LocationType::School;
     }
     //return home
@@ -85,10 +119,8 @@ LocationType go_to_shop(const Person& person, TimePoint t, TimeSpan dt, const Ab
 {
     auto current_loc = person.get_location_id().type;
     //leave
-    if (t.day_of_week() < 6 && t.hour_of_day() > 7 && t.hour_of_day() < 22 && current_loc == LocationType::Home &&
-        !person.is_in_quarantine()) {
-        return random_transition(current_loc, dt,
-                                 {{LocationType::BasicsShop, params.get<BasicShoppingRate>()[person.get_age()]}});
+    if (current_loc == LocationType::Home && can_go_to_shop(person, t)) {
+        return random_transition(current_loc, dt, {{LocationType::BasicsShop, shopping_rate(person, t, params)}});
     }
 
     //return home
@@ -103,12 +135,8 @@ LocationType go_to_event(const Person& person, TimePoint t, TimeSpan dt, const A
 {
     auto current_loc = person.get_location_id().type;
     //leave
-    if (current_loc == LocationType::Home && t < params.get<LockdownDate>() &&
-        ((t.day_of_week() <= 4 && t.hour_of_day() >= 19) || (t.day_of_week() >= 5 && t.hour_of_day() >= 10)) &&
-        !person.is_in_quarantine()) {
-        return random_transition(current_loc, dt,
-                                 {{LocationType::SocialEvent,
-                                   params.get<SocialEventRate>().get_matrix_at(t.days())[(size_t)person.get_age()]}});
+    if (current_loc == LocationType::Home && can_go_to_event(person, t, params)) {
+        return random_transition(current_loc, dt, {{LocationType::SocialEvent, social_event_rate(person, t, params)}});
     }
 
     //return home
@@ -150,4 +178,231 @@ LocationType return_home_when_recovered(const Person& person, TimePoint /*t*/, T
     return current_loc;
 }
 
+namespace
+{
+/**
+ * check if the departure time of any person, that is between the minimum and maximum for their age,
+ * can be in the current time step.
+ * Minimum and maximum are not assumed to be ordered.
+ */
+bool is_departure_possible(TimePoint t, TimeSpan dt, const CustomIndexArray<TimeSpan, AbmAgeGroup>& min_time,
+                           const CustomIndexArray<TimeSpan, AbmAgeGroup>& max_time)
+{
+    auto earliest = std::min(*std::min_element(min_time.begin(), min_time.end()),
+                             *std::min_element(max_time.begin(), max_time.end()));
+    auto latest   = std::max(*std::max_element(min_time.begin(), min_time.end()),
+                             *std::max_element(max_time.begin(), max_time.end()));
+    return t.time_since_midnight() <= latest && t.time_since_midnight() + dt > earliest;
+}
+
+/**
+ * time that is never reached, for rules that don't move a person.
+ */
+const auto never = TimePoint(std::numeric_limits<int>::max());
+
+/**
+ * first time step from t on that begins at or after a time.
+ */
+TimePoint first_step_from(TimePoint t, TimeSpan dt, TimePoint time)
+{
+    if (time <= t) {
+        return t;
+    }
+    return t + dt * (((time - t).seconds() + dt.seconds() - 1) / dt.seconds());
+}
+
+/**
+ * first time step from t on that begins at or after a time of the day.
+ */
+TimePoint first_step_from_time_of_day(TimePoint t, TimeSpan dt, TimeSpan time_of_day)
+{
+    if (t.time_since_midnight() >= time_of_day) {
+        return t;
+    }
+    return first_step_from(t, dt, t - t.time_since_midnight() + time_of_day);
+}
+
+/**
+ * first time step from t on in which a rule moves a person that leaves home at the same time each day.
+ * The rule is applied in the time step that contains the time of the departure on each of the next days.
+ * Looks one week ahead, the rule has to be checked again after that.
+ */
+TimePoint next_departure(const Person& person, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params,
+                         TimeSpan departure_time,
+                         LocationType (*rule)(const Person&, TimePoint, TimeSpan, const AbmMigrationParameters&))
+{
+    auto midnight = t - t.time_since_midnight();
+    for (int d = 0; d < 8; ++d) {
+        auto departure = midnight + days(d) + departure_time;
+        if (departure >= t) {
+            auto step = t + dt * ((departure - t).seconds() / dt.seconds());
+            if (rule(person, step, dt, params) != LocationType::Home) {
+                return step;
+            }
+        }
+    }
+    return midnight + days(8);
+}
+} // namespace
+
+LocationTypeSet go_to_school_origins(TimePoint t, TimeSpan dt, const AbmMigrationParameters& params)
+{
+    LocationTypeSet origins;
+    origins[size_t(LocationType::Home)] =
+        t < params.get<LockdownDate>() && t.day_of_week() < 5 &&
+        is_departure_possible(t, dt, params.get<GotoSchoolTimeMinimum>(), params.get<GotoSchoolTimeMaximum>());
+    origins[size_t(LocationType::School)] = t.hour_of_day() >= 15;
+    return origins;
+}
+
+LocationTypeSet go_to_work_origins(TimePoint t, TimeSpan dt, const AbmMigrationParameters& params)
+{
+    LocationTypeSet origins;
+    origins[size_t(LocationType::Home)] =
+        t < params.get<LockdownDate>() && t.day_of_week() < 5 &&
+        is_departure_possible(t, dt, params.get<GotoWorkTimeMinimum>(), params.get<GotoWorkTimeMaximum>());
+    origins[size_t(LocationType::Work)] = t.hour_of_day() >= 17;
+    return origins;
+}
+
+LocationTypeSet go_to_shop_origins(TimePoint t, TimeSpan /*dt*/, const AbmMigrationParameters& /*params*/)
+{
+    LocationTypeSet origins;
+    origins[size_t(LocationType::Home)]       = t.day_of_week() < 6 && t.hour_of_day() > 7 && t.hour_of_day() < 22;
+    origins[size_t(LocationType::BasicsShop)] = true;
+    return origins;
+}
+
+LocationTypeSet go_to_event_origins(TimePoint t, TimeSpan /*dt*/, const AbmMigrationParameters& params)
+{
+    LocationTypeSet origins;
+    origins[size_t(LocationType::Home)] =
+        t < params.get<LockdownDate>() &&
+        ((t.day_of_week() <= 4 && t.hour_of_day() >= 19) || (t.day_of_week() >= 5 && t.hour_of_day() >= 10));
+    origins[size_t(LocationType::SocialEvent)] = t.hour_of_day() >= 20;
+    return origins;
+}
+
+LocationTypeSet go_to_hospital_origins(TimePoint /*t*/, TimeSpan /*dt*/, const AbmMigrationParameters& /*params*/)
+{
+    return LocationTypeSet().set();
+}
+
+LocationTypeSet go_to_icu_origins(TimePoint /*t*/, TimeSpan /*dt*/, const AbmMigrationParameters& /*params*/)
+{
+    return LocationTypeSet().set();
+}
+
+LocationTypeSet return_home_when_recovered_origins(TimePoint /*t*/, TimeSpan /*dt*/,
+                                                   const AbmMigrationParameters& /*params*/)
+{
+    LocationTypeSet origins;
+    origins[size_t(LocationType::Hospital)] = true;
+    origins[size_t(LocationType::ICU)]      = true;
+    return origins;
+}
+
+TimePoint go_to_school_next_time(const Person& person, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params)
+{
+    switch (person.get_location_id().type) {
+    case LocationType::Home:
+        return next_departure(person, t, dt, params, person.get_go_to_school_time(params), &go_to_school);
+    case LocationType::School:
+        return first_step_from_time_of_day(t, dt, hours(15));
+    default:
+        return never;
+    }
+}
+
+TimePoint go_to_work_next_time(const Person& person, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params)
+{
+    switch (person.get_location_id().type) {
+    case LocationType::Home:
+        return next_departure(person, t, dt, params, person.get_go_to_work_time(params), &go_to_work);
+    case LocationType::Work:
+        return first_step_from_time_of_day(t, dt, hours(17));
+    default:
+        return never;
+    }
+}
+
+TimePoint go_to_shop_next_time(const Person& person, TimePoint t, TimeSpan dt,
+                               const AbmMigrationParameters& /*params*/)
+{
+    //the time at the location grows by dt in each step before the rules are applied
+    if (person.get_location_id().type == LocationType::BasicsShop) {
+        return first_step_from(t, dt, t + hours(1) - dt - person.get_time_at_location());
+    }
+    return never;
+}
+
+TimePoint go_to_event_next_time(const Person& person, TimePoint t, TimeSpan dt,
+                                const AbmMigrationParameters& /*params*/)
+{
+    if (person.get_location_id().type == LocationType::SocialEvent) {
+        auto stayed = first_step_from(t, dt, t + hours(2) - dt - person.get_time_at_location());
+        return first_step_from_time_of_day(stayed, dt, hours(20));
+    }
+    return never;
+}
+
+TimePoint go_to_hospital_next_time(const Person& person, TimePoint t, TimeSpan dt,
+                                   const AbmMigrationParameters& params)
+{
+    //only depends on the infection state
+    return go_to_hospital(person, t, dt, params) != person.get_location_id().type ? t : never;
+}
+
+TimePoint go_to_icu_next_time(const Person& person, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params)
+{
+    return go_to_icu(person, t, dt, params) != person.get_location_id().type ? t : never;
+}
+
+TimePoint return_home_when_recovered_next_time(const Person& person, TimePoint t, TimeSpan dt,
+                                               const AbmMigrationParameters& params)
+{
+    return return_home_when_recovered(person, t, dt, params) != person.get_location_id().type ? t : never;
+}
+
+std::pair<TimePoint, LocationType> sample_random_departure(const Person& person, TimePoint t, TimeSpan dt,
+                                                           const AbmMigrationParameters& params,
+                                                           const LocationTypeSet& destinations)
+{
+    auto shop  = destinations[size_t(LocationType::BasicsShop)];
+    auto event = destinations[size_t(LocationType::SocialEvent)];
+    if (person.is_in_quarantine() || !(shop || event)) {
+        return {never, LocationType::Home};
+    }
+
+    //the rules draw from an exponential distribution in each step where the person can leave,
+    //which is the same as adding up the rates until the sum exceeds a single sample from Exp(1).
+    //go_to_shop is applied first, so the shop wins if both rules move the person in the same step.
+    //the rates are constant except for dampings of the social event rate, which are expensive to evaluate.
+    auto& exponential         = ExponentialDistribution<double>::get_instance();
+    auto shop_threshold       = exponential(1.0);
+    auto event_threshold      = exponential(1.0);
+    auto shop_sum             = 0.0;
+    auto event_sum            = 0.0;
+    auto shop_increment       = shopping_rate(person, t, params) * dt.days();
+    auto is_event_rate_damped = params.get<SocialEventRate>().get_dampings().size() > 0;
+    auto event_increment      = social_event_rate(person, t, params) * dt.days();
+    auto end                  = t + days(7);
+    auto s                    = t;
+    for (; s < end; s += dt) {
+        if (shop && can_go_to_shop(person, s)) {
+            shop_sum += shop_increment;
+            if (shop_sum > shop_threshold) {
+                return {s, LocationType::BasicsShop};
+            }
+        }
+        if (event && can_go_to_event(person, s, params)) {
+            event_sum += is_event_rate_damped ? social_event_rate(person, s, params) * dt.days() : event_increment;
+            if (event_sum > event_threshold) {
+                return {s, LocationType::SocialEvent};
+            }
+        }
+    }
+    return {s - dt, LocationType::Home};
+}
+
 } // namespace mio
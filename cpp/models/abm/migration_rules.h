@@ -25,6 +25,9 @@
 #include "abm/parameters.h"
 #include "abm/time.h"
 
+#include <bitset>
+#include <utility>
+
 namespace mio
 {
 
@@ -83,6 +86,75 @@ LocationType return_home_when_recovered(const Person& person, TimePoint t, TimeS
                                         const AbmMigrationParameters& params);
 /**@}*/
 
+/**
+ * set of location types, indexed by LocationType.
+ */
+using LocationTypeSet = std::bitset<size_t(LocationType::Count)>;
+
+/**
+ * @name origins of the migration rules.
+ * The location types where persons can be that may be moved by the corresponding rule during a time step.
+ * Depends only on time and parameters, so it can be evaluated once per time step to skip rules 
+ * for persons at other locations, e.g. most rules at night.
+ * The sets may contain more location types than necessary, but never less.
+ * @param t current time.
+ * @param dt length of the time step.
+ * @param params migration parameters.
+ * @return set of location types.
+ * @{
+ */
+LocationTypeSet go_to_school_origins(TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+LocationTypeSet go_to_work_origins(TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+LocationTypeSet go_to_shop_origins(TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+LocationTypeSet go_to_event_origins(TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+LocationTypeSet go_to_hospital_origins(TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+LocationTypeSet go_to_icu_origins(TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+LocationTypeSet return_home_when_recovered_origins(TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+/**@}*/
+
+/**
+ * @name next migration times of the rules.
+ * The first time step from t on in which the corresponding rule may move the person,
+ * if the infection state, quarantine and location of the person don't change in the meantime.
+ * Used in the event driven mode of the world to apply the rules only in these time steps.
+ * The time steps are assumed to follow each other with constant length dt.
+ * The time may be earlier than the step in which the rule actually moves the person, but never later.
+ * Departures from home at random (see go_to_shop, go_to_event) are not included, see sample_random_departure.
+ * @param p person the rule is applied to, the time at the location is counted until t.
+ * @param t beginning of the next time step.
+ * @param dt length of the time steps.
+ * @param params migration parameters.
+ * @return beginning of a time step or TimePoint(std::numeric_limits<int>::max()) 
+ * if the rule doesn't move the person.
+ * @{
+ */
+TimePoint go_to_school_next_time(const Person& p, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+TimePoint go_to_work_next_time(const Person& p, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+TimePoint go_to_shop_next_time(const Person& p, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+TimePoint go_to_event_next_time(const Person& p, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+TimePoint go_to_hospital_next_time(const Person& p, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+TimePoint go_to_icu_next_time(const Person& p, TimePoint t, TimeSpan dt, const AbmMigrationParameters& params);
+TimePoint return_home_when_recovered_next_time(const Person& p, TimePoint t, TimeSpan dt,
+                                               const AbmMigrationParameters& params);
+/**@}*/
+
+/**
+ * sample when a person at home leaves at random, i.e. when go_to_shop or go_to_event moves the person.
+ * Same distribution as applying the rules in every time step from t on, but the random numbers are drawn only once.
+ * The time steps are assumed to follow each other with constant length dt.
+ * Looks one week ahead, the departure has to be sampled again if it doesn't happen until then.
+ * @param p person at home, the sample is only valid while infection state and quarantine don't change.
+ * @param t beginning of the next time step.
+ * @param dt length of the time steps.
+ * @param params migration parameters.
+ * @param destinations location types that exist, i.e. where the person can go.
+ * @return beginning of the time step of the departure and the destination, 
+ * or the last time step that was sampled and LocationType::Home if the person doesn't leave until then.
+ */
+std::pair<TimePoint, LocationType> sample_random_departure(const Person& p, TimePoint t, TimeSpan dt,
+                                                           const AbmMigrationParameters& params,
+                                                           const LocationTypeSet& destinations);
+
 } // namespace mio
 
 #endif //EPI_ABM_MIGRATION_RULES_H
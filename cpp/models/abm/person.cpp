@@ -20,21 +20,22 @@
 #include "abm/person.h"
 #include "abm/world.h"
 #include "abm/location.h"
+#include "memilio/io/checkpoint.h"
 #include "memilio/utils/random_number_generator.h"
 
 namespace mio
 {
 
 Person::Person(LocationId id, InfectionProperties infection_properties, VaccinationState vaccination_state, AbmAgeGroup age, const GlobalInfectionParameters& global_params)
-    : m_location_id(id)
-    , m_assigned_locations((uint32_t)LocationType::Count, INVALID_LOCATION_INDEX)
-    , m_infection_state(infection_properties.state)
+    : m_infection_state(infection_properties.state)
     , m_vaccination_state(vaccination_state)
     , m_quarantine(false)
     , m_age(age)
+    , m_location_id(id)
     , m_time_at_location(std::numeric_limits<int>::max() / 2) //avoid overflow on next steps
     , m_time_since_negative_test(std::numeric_limits<int>::max() / 2)
 {
+    m_assigned_locations.fill(INVALID_LOCATION_INDEX);
     m_random_workgroup   = UniformDistribution<double>::get_instance()();
     m_random_schoolgroup = UniformDistribution<double>::get_instance()();
     m_random_goto_work_hour = UniformDistribution<double>::get_instance()();
@@ -50,6 +51,20 @@ Person::Person(LocationId id, InfectionProperties infection_properties, Vaccinat
 }
 
 
+Person::Person()
+    : m_infection_state(InfectionState::Susceptible)
+    , m_vaccination_state(VaccinationState::Unvaccinated)
+    , m_quarantine(false)
+    , m_age(0)
+    , m_location_id{INVALID_LOCATION_INDEX, LocationType::Home}
+    , m_random_workgroup(0.0)
+    , m_random_schoolgroup(0.0)
+    , m_random_goto_work_hour(0.0)
+    , m_random_goto_school_hour(0.0)
+{
+    m_assigned_locations.fill(INVALID_LOCATION_INDEX);
+}
+
 Person::Person(LocationId id, InfectionProperties infection_properties, AbmAgeGroup age, const GlobalInfectionParameters& global_params)
     :  Person(id, infection_properties, VaccinationState::Unvaccinated, age, global_params)
 {
@@ -67,6 +82,16 @@ Person::Person(Location& location, InfectionProperties infection_properties, Vac
 
 void Person::interact(TimeSpan dt, const GlobalInfectionParameters& global_infection_params, Location& loc,
                       const GlobalTestingParameters& global_testing_params)
+{
+    auto infection_state = m_infection_state;
+    update_infection_state(dt, global_infection_params, loc, global_testing_params);
+    if (infection_state != m_infection_state) {
+        loc.changed_state(*this, infection_state);
+    }
+}
+
+void Person::update_infection_state(TimeSpan dt, const GlobalInfectionParameters& global_infection_params,
+                                    const Location& loc, const GlobalTestingParameters& global_testing_params)
 {
     auto infection_state     = m_infection_state;
     auto new_infection_state = infection_state;
@@ -98,13 +123,57 @@ void Person::interact(TimeSpan dt, const GlobalInfectionParameters& global_infec
     }
 
     m_infection_state = new_infection_state;
-    if (infection_state != new_infection_state) {
-        loc.changed_state(*this, infection_state);
+
+    m_time_at_location += dt;
+}
+
+void Person::update_exposure(TimeSpan dt, const GlobalInfectionParameters& global_infection_params,
+                             const Location& loc)
+{
+    if (m_infection_state == InfectionState::Susceptible) {
+        m_infection_state = loc.interact(*this, dt, global_infection_params);
+        if (m_infection_state == InfectionState::Exposed) {
+            m_time_until_carrier = hours(int(global_infection_params.get<IncubationPeriod>()[{this->m_age, this->m_vaccination_state}] * 24));
+        }
+        update_quarantine();
+        m_time_at_location += dt;
     }
+    else {
+        pass_time(dt);
+    }
+}
 
+void Person::pass_time(TimeSpan dt)
+{
+    if (m_infection_state == InfectionState::Exposed) {
+        m_time_until_carrier -= dt;
+    }
+    update_quarantine();
     m_time_at_location += dt;
 }
 
+std::pair<InfectionState, double>
+Person::sample_next_transition(const GlobalInfectionParameters& global_infection_params) const
+{
+    if (m_infection_state == InfectionState::Exposed) {
+        return {InfectionState::Carrier, std::max(m_time_until_carrier.days(), 0.0)};
+    }
+    return sample_progression(*this, global_infection_params);
+}
+
+void Person::apply_transition(InfectionState new_infection_state)
+{
+    m_infection_state = new_infection_state;
+    update_quarantine();
+}
+
+void Person::update_quarantine()
+{
+    m_quarantine = m_infection_state == InfectionState::Infected ||
+                   m_infection_state == InfectionState::Infected_Severe ||
+                   m_infection_state == InfectionState::Infected_Critical;
+}
+
 void Person::migrate_to(Location& loc_old, Location& loc_new)
 {
     if (&loc_old != &loc_new) {
@@ -130,11 +199,6 @@ void Person::set_infection_state(InfectionState inf_state)
     m_infection_state = inf_state;
 }
 
-uint32_t Person::get_assigned_location_index(LocationType type) const
-{
-    return m_assigned_locations[(uint32_t)type];
-}
-
 bool Person::goes_to_work(TimePoint t, const AbmMigrationParameters& params) const
 {
     return m_random_workgroup < params.get<WorkRatio>().get_matrix_at(t.days())[0];
@@ -189,4 +253,44 @@ bool Person::get_tested(const TestParameters& params)
         }
     }
 }
+
+void Person::write_checkpoint(CheckpointWriter& writer) const
+{
+    writer.write(m_infection_state);
+    writer.write(m_vaccination_state);
+    writer.write(m_quarantine);
+    writer.write(uint64_t(size_t(m_age)));
+    writer.write(m_location_id.index);
+    writer.write(m_location_id.type);
+    writer.write(m_time_until_carrier);
+    writer.write(m_time_at_location);
+    writer.write(m_time_since_negative_test);
+    writer.write(m_assigned_locations);
+    writer.write(m_random_workgroup);
+    writer.write(m_random_schoolgroup);
+    writer.write(m_random_goto_work_hour);
+    writer.write(m_random_goto_school_hour);
+}
+
+IOResult<void> Person::read_checkpoint(CheckpointReader& reader)
+{
+    BOOST_OUTCOME_TRY(reader.read(m_infection_state));
+    BOOST_OUTCOME_TRY(reader.read(m_vaccination_state));
+    BOOST_OUTCOME_TRY(reader.read(m_quarantine));
+    uint64_t age;
+    BOOST_OUTCOME_TRY(reader.read(age));
+    m_age = Index<AbmAgeGroup>(size_t(age));
+    BOOST_OUTCOME_TRY(reader.read(m_location_id.index));
+    BOOST_OUTCOME_TRY(reader.read(m_location_id.type));
+    BOOST_OUTCOME_TRY(reader.read(m_time_until_carrier));
+    BOOST_OUTCOME_TRY(reader.read(m_time_at_location));
+    BOOST_OUTCOME_TRY(reader.read(m_time_since_negative_test));
+    BOOST_OUTCOME_TRY(reader.read(m_assigned_locations));
+    BOOST_OUTCOME_TRY(reader.read(m_random_workgroup));
+    BOOST_OUTCOME_TRY(reader.read(m_random_schoolgroup));
+    BOOST_OUTCOME_TRY(reader.read(m_random_goto_work_hour));
+    BOOST_OUTCOME_TRY(reader.read(m_random_goto_school_hour));
+    return success();
+}
+
 } // namespace mio
@@ -24,10 +24,12 @@
 #include "abm/age.h"
 #include "abm/time.h"
 #include "abm/parameters.h"
-#include "abm/world.h"
+#include "abm/location.h"
 #include "abm/time.h"
 
+#include <array>
 #include <functional>
+#include <utility>
 
 namespace mio
 {
@@ -100,8 +102,62 @@ public:
     void interact(TimeSpan dt, const GlobalInfectionParameters& global_infection_parameters, Location& loc,
                   const GlobalTestingParameters& global_testing_params);
 
+    /** 
+     * Time passes and the person interacts with the population at its current location.
+     * Same as interact, but the location is not notified if the infection state changes,
+     * the caller is responsible to call Location::changed_state.
+     * Allows persons at the same location to interact concurrently.
+     * @param dt length of the current simulation time step
+     * @param global_infection_parameters infection parameters that are the same in all locations
+     */
+    void update_infection_state(TimeSpan dt, const GlobalInfectionParameters& global_infection_parameters,
+                                const Location& loc, const GlobalTestingParameters& global_testing_params);
+
+    /** 
+     * Time passes and the person interacts with the population at its current location.
+     * Only the infection of a susceptible person is sampled, all other changes of the infection state
+     * are sampled in advance with sample_next_transition and applied with apply_transition.
+     * The remaining incubation time of an exposed person is counted down like in update_infection_state,
+     * so the transition can be sampled again at any time without restarting the incubation.
+     * The caller is responsible to call Location::changed_state.
+     * @param dt length of the current simulation time step
+     * @param global_infection_parameters infection parameters that are the same in all locations
+     */
+    void update_exposure(TimeSpan dt, const GlobalInfectionParameters& global_infection_parameters,
+                         const Location& loc);
+
+    /**
+     * Time passes without interaction, e.g. in time steps where the person can't be infected.
+     * Same as update_exposure for a person that is not susceptible, 
+     * so the time passed in several time steps can be added at once.
+     * @param dt time that passed.
+     */
+    void pass_time(TimeSpan dt);
+
+    /**
+     * sample the next change of the infection state that doesn't depend on the location of the person,
+     * i.e. all changes except infection.
+     * The time is counted from the beginning of the first time step where the change can happen,
+     * i.e. the next time step after the current state was entered.
+     * @param global_infection_parameters infection parameters that are the same in all locations
+     * @return pair of the new infection state and the time in days until the change,
+     * the current infection state and infinity if the state doesn't change by itself.
+     */
+    std::pair<InfectionState, double>
+    sample_next_transition(const GlobalInfectionParameters& global_infection_parameters) const;
+
+    /**
+     * change the infection state as a result of a transition sampled with sample_next_transition.
+     * Quarantine starts or ends like after interact.
+     * The caller is responsible to call Location::changed_state.
+     * @param new_infection_state the new infection state.
+     */
+    void apply_transition(InfectionState new_infection_state);
+
     /** 
      * migrate to a different location.
+     * The subpopulations of both locations and of their world are updated, but not the members of the locations,
+     * use World::evolve to migrate persons of a world.
      * @param loc_new the new location of the person.
      * */
     void migrate_to(Location& loc_old, Location& loc_new);
@@ -126,6 +182,8 @@ public:
     
     /**
      * Sets the current infection state of the person.
+     * The caller is responsible to call Location::changed_state, which also updates the world,
+     * see World::set_infection_state.
      */
     void set_infection_state(InfectionState inf_state);
     
@@ -184,12 +242,21 @@ public:
      * Assume that a person has at most one assigned location of a certrain location type.
      * @param type location type of the assigned location
      */
-    uint32_t get_assigned_location_index(LocationType type) const;
+    uint32_t get_assigned_location_index(LocationType type) const
+    {
+        return m_assigned_locations[(uint32_t)type];
+    }
+
+    /**
+     * index of the assigned location for each location type.
+     * INVALID_LOCATION_INDEX if the person has no assigned location of a type.
+     */
+    using AssignedLocations = std::array<uint32_t, size_t(LocationType::Count)>;
 
     /**
      *returns the assigned locations of the person.
      */
-    const std::vector<uint32_t>& get_assigned_locations() const
+    const AssignedLocations& get_assigned_locations() const
     {
         return m_assigned_locations;
     }
@@ -239,20 +306,43 @@ public:
      */
     bool get_tested(const TestParameters& params);
 
+    /**
+     * write the state of the person to a checkpoint.
+     * The members are written one by one, so the padding between them is not written.
+     * @see CheckpointWriter
+     */
+    void write_checkpoint(CheckpointWriter& writer) const;
+
+    /**
+     * restore the state of the person from a checkpoint.
+     * @see CheckpointReader
+     */
+    IOResult<void> read_checkpoint(CheckpointReader& reader);
+
 private:
-    LocationId m_location_id;
-    std::vector<uint32_t> m_assigned_locations;
+    friend class World;
+
+    /**
+     * create a person without random properties whose state is read from a checkpoint.
+     */
+    Person();
+
+    void update_quarantine();
+
+    //members used by every person in every step first, so they share cache lines
     InfectionState m_infection_state;
     VaccinationState m_vaccination_state;
-    TimeSpan m_time_until_carrier;
     bool m_quarantine;
     mio::Index<AbmAgeGroup> m_age;
+    LocationId m_location_id;
+    TimeSpan m_time_until_carrier;
     TimeSpan m_time_at_location;
+    TimeSpan m_time_since_negative_test;
+    AssignedLocations m_assigned_locations;
     double m_random_workgroup;
     double m_random_schoolgroup;
     double m_random_goto_work_hour;
     double m_random_goto_school_hour;
-    TimeSpan m_time_since_negative_test;
 };
 
 } // namespace mio
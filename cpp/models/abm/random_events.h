@@ -21,11 +21,29 @@
 #include "memilio/utils/random_number_generator.h"
 #include <algorithm>
 #include <array>
+#include <limits>
 #include <numeric>
 
 namespace mio
 {
 
+namespace details
+{
+/**
+ * pick one of the possible transitions using discrete distribution with the rates as weights.
+ */
+template <class T, size_t NumTransitions>
+T pick_transition(const std::pair<T, double> (&transitions)[NumTransitions])
+{
+    std::array<double, NumTransitions> rates;
+    std::transform(std::begin(transitions), std::end(transitions), rates.begin(), [](auto&& t) {
+        return t.second;
+    });
+    auto random_idx = DiscreteDistribution<size_t>::get_instance()(rates);
+    return transitions[random_idx].first;
+}
+} // namespace details
+
 /**
  * select a random transition from a list of possible transitions from the current state to others.
  * Each transition is represented by the new state and the probability of the transition, e.g. 
@@ -58,16 +76,38 @@ T random_transition(T current_state, TimeSpan dt, const std::pair<T, double> (&t
     }
     auto v = ExponentialDistribution<double>::get_instance()(sum);
     if (v < dt.days()) {
-        //pick one of the possible transitions using discrete distribution
-        std::array<double, NumTransitions> rates;
-        std::transform(std::begin(transitions), std::end(transitions), rates.begin(), [](auto&& t) {
-            return t.second;
-        });
-        auto random_idx = DiscreteDistribution<size_t>::get_instance()(rates);
-        return transitions[random_idx].first;
+        return details::pick_transition(transitions);
     }
 
     return current_state;
 }
 
+/**
+ * sample when the next transition from the current state happens and which transition it is.
+ * Same distribution as applying random_transition in consecutive time steps until a transition happens,
+ * but the random numbers are drawn only once.
+ * @tparam T type that represents the states
+ * @tparam NumTransitions number of possible transitions
+ * @param current_state current state before transitions
+ * @param transitions array of pairs of new states and their rates (probabilities)
+ * @return pair of the new state and the time in days until the transition happens, 
+ * current_state and infinity if all rates are zero.
+ */
+template <class T, size_t NumTransitions>
+std::pair<T, double> sample_transition(T current_state, const std::pair<T, double> (&transitions)[NumTransitions])
+{
+    assert(std::all_of(std::begin(transitions), std::end(transitions), [](auto& p) {
+        return p.second >= 0.0;
+    }) && "transition rates must be non-negative");
+
+    auto sum = std::accumulate(std::begin(transitions), std::end(transitions), 0.0, [](auto&& a, auto&& t) {
+        return a + t.second;
+    });
+    if (sum <= 0) { //no transitions or all transitions have rate zero
+        return {current_state, std::numeric_limits<double>::infinity()};
+    }
+    auto v = ExponentialDistribution<double>::get_instance()(sum);
+    return {details::pick_transition(transitions), v};
+}
+
 } // namespace mio
\ No newline at end of file
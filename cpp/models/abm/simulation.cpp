@@ -19,6 +19,8 @@
 */
 #include "abm/simulation.h"
 
+#include <cassert>
+
 namespace mio
 {
 
@@ -40,17 +42,42 @@ void AbmSimulation::advance(TimePoint tmax)
         t += m_dt;
         store_result_at(t);
     }
+    m_t = t;
 }
 
 void AbmSimulation::store_result_at(TimePoint t)
 {
-    m_result.add_time_point(t.days());
-    m_result.get_last_value().setZero();
+#ifndef NDEBUG
+    //the subpopulations of the world are updated incrementally, compare them with a full count
     for (auto&& locations : m_world.get_locations()) {
-        for (auto& location : locations){
-            m_result.get_last_value() += location.get_subpopulations().cast<double>();
+        if (!locations.empty()) {
+            Eigen::VectorXi count = Eigen::VectorXi::Zero(Eigen::Index(InfectionState::Count));
+            for (auto& location : locations) {
+                count += location.get_subpopulations();
+            }
+            assert(count == m_world.get_subpopulations(locations.front().get_type()) &&
+                   "subpopulations of the world don't match the locations.");
         }
     }
+#endif
+    m_result.add_time_point(t.days(), m_world.get_subpopulations().cast<double>());
+}
+
+void AbmSimulation::write_checkpoint(CheckpointWriter& writer) const
+{
+    writer.write(m_t);
+    writer.write(m_dt);
+    writer.write(m_result);
+    writer.write(m_world);
+}
+
+IOResult<void> AbmSimulation::read_checkpoint(CheckpointReader& reader)
+{
+    BOOST_OUTCOME_TRY(reader.read(m_t));
+    BOOST_OUTCOME_TRY(reader.read(m_dt));
+    BOOST_OUTCOME_TRY(reader.read(m_result));
+    BOOST_OUTCOME_TRY(reader.read(m_world));
+    return success();
 }
 
 } // namespace mio
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include "abm/world.h"
 #include "abm/time.h"
 #include "memilio/utils/time_series.h"
+#include "memilio/io/checkpoint.h"
 
 namespace mio
 {
@@ -58,6 +59,19 @@ public:
         return m_result;
     }
 
+    /**
+     * write the state of the simulation to a checkpoint.
+     * @see save_checkpoint
+     */
+    void write_checkpoint(CheckpointWriter& writer) const;
+
+    /**
+     * restore the state of the simulation from a checkpoint.
+     * The world of the simulation must have the same global parameters as the world that was written.
+     * @see load_checkpoint
+     */
+    IOResult<void> read_checkpoint(CheckpointReader& reader);
+
 private:
     void store_result_at(TimePoint t);
 
@@ -190,7 +190,7 @@ public:
      */
     int day_of_week() const
     {
-        return int(days()) % 7;
+        return m_seconds / (24 * 60 * 60) % 7;
     }
 
     /**
@@ -198,7 +198,7 @@ public:
      */
     int hour_of_day() const
     {
-        return int(hours()) % 24;
+        return m_seconds / (60 * 60) % 24;
     }
 
     /**
@@ -206,7 +206,7 @@ public:
      */
     TimeSpan time_since_midnight() const
     {
-        return  TimeSpan(seconds() - ((int)days())*60*60*24);
+        return TimeSpan(m_seconds % (24 * 60 * 60));
     }
 
     /**
@@ -22,25 +22,132 @@
 #include "abm/person.h"
 #include "abm/location.h"
 #include "abm/migration_rules.h"
+#include "memilio/io/checkpoint.h"
 #include "memilio/utils/random_number_generator.h"
 #include "memilio/utils/stl_util.h"
+#include "memilio/utils/instrumentation.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <functional>
+#include <tuple>
 
 namespace mio
 {
 
+namespace
+{
+/**
+ * phases of a time step that draw random numbers, identify the random number streams of a person.
+ */
+enum class StepPhase : uint32_t
+{
+    Interaction,
+    Migration,
+    ScheduleTransition,
+    RescheduleTransition,
+    Creation,
+    ScheduleMigration,
+};
+
+/**
+ * random number stream of a person in one phase of a time step.
+ */
+CounterBasedRng person_rng(uint64_t seed, size_t person_idx, TimePoint t, StepPhase phase)
+{
+    return CounterBasedRng(seed, {uint32_t(person_idx), uint32_t(t.seconds()), uint32_t(phase)});
+}
+
+/**
+ * check if persons in the infection state infect others, see Location::begin_step.
+ */
+bool is_infectious(InfectionState state)
+{
+    return state == InfectionState::Carrier || state == InfectionState::Infected;
+}
+
+/**
+ * split the range [0, n) into contiguous blocks and process each block on a separate thread of the pool.
+ * The first block is processed on the calling thread, so with one thread no other threads are involved.
+ * @param n size of the range.
+ * @param pool the threads, one block per thread.
+ * @param f function with signature void(size_t begin, size_t end, int thread_idx).
+ */
+template <class F>
+void parallel_for_blocks(size_t n, ThreadPool& pool, F f)
+{
+    auto num_threads = pool.get_num_threads();
+    auto block_begin = [n, num_threads](int thread_idx) {
+        return n * thread_idx / num_threads;
+    };
+    auto task = [&f, &block_begin](int thread_idx) {
+        f(block_begin(thread_idx), block_begin(thread_idx + 1), thread_idx);
+    };
+    if (num_threads == 1) {
+        task(0);
+    }
+    else {
+        pool.run(std::ref(task));
+    }
+}
+
+/**
+ * split the locations into contiguous blocks with about the same number of persons 
+ * and process each block on a separate thread.
+ * @param locations the locations.
+ * @param pool the threads, one block per thread.
+ * @param f function with signature void(Location& location, int thread_idx).
+ */
+template <class F>
+void parallel_for_locations(const std::vector<Location*>& locations, ThreadPool& pool, F f)
+{
+    auto num_threads   = pool.get_num_threads();
+    size_t num_members = 0;
+    for (auto location : locations) {
+        num_members += location->get_members().size();
+    }
+    std::vector<size_t> block_begin(num_threads + 1, locations.size());
+    block_begin[0] = 0;
+    size_t count   = 0;
+    int block      = 1;
+    for (size_t i = 0; i < locations.size() && block < num_threads; ++i) {
+        while (block < num_threads && count >= num_members * block / num_threads) {
+            block_begin[block++] = i;
+        }
+        count += locations[i]->get_members().size();
+    }
+    parallel_for_blocks(num_threads, pool, [&](size_t begin, size_t end, int thread_idx) {
+        for (auto b = begin; b < end; ++b) {
+            for (auto i = block_begin[b]; i < block_begin[b + 1]; ++i) {
+                f(*locations[i], thread_idx);
+            }
+        }
+    });
+}
+} // namespace
+
 LocationId World::add_location(LocationType type)
 {
     auto& locations = m_locations[(uint32_t)type];
     uint32_t index  = static_cast<uint32_t>(locations.size());
     locations.emplace_back(Location(type, index));
+    locations.back().m_total_subpopulations = &(*m_subpopulations)[size_t(type)];
     return {index, type};
 }
 
 Person& World::add_person(LocationId id, InfectionState infection_state, AbmAgeGroup age)
 {
-    m_persons.push_back(std::make_unique<Person>(id, infection_state, age, m_infection_parameters));
-    auto& person = *m_persons.back();
-    get_location(person).add_person(person);
+    {
+        auto rng = person_rng(m_rng_seed, m_persons.size(), TimePoint(0), StepPhase::Creation);
+        ScopedRngStream scoped_rng(rng);
+        m_persons.emplace_back(id, infection_state, age, m_infection_parameters);
+    }
+    auto& person   = m_persons.back();
+    auto& location = get_location(person);
+    location.add_person(person);
+    m_member_positions.push_back(location.add_member(uint32_t(m_persons.size() - 1)));
     return person;
 }
 
@@ -48,17 +155,52 @@ Person& World::add_person(LocationId id, InfectionState infection_state, AbmAgeG
 
 void World::evolve(TimePoint t, TimeSpan dt)
 {
-    begin_step(t, dt);
-    interaction(t, dt);
-    migration(t, dt);
+    MIO_SCOPED_TIMER("World::evolve");
+    {
+        MIO_SCOPED_TIMER("World::evolve begin_step");
+        begin_step(t, dt);
+    }
+    {
+        MIO_SCOPED_TIMER("World::evolve interaction");
+        if (m_event_driven) {
+            interaction_event_driven(t, dt);
+        }
+        else {
+            interaction(t, dt);
+        }
+    }
+    {
+        MIO_SCOPED_TIMER("World::evolve migration");
+        migration(t, dt);
+    }
 }
 
-void World::interaction(TimePoint /*t*/, TimeSpan dt)
+void World::interaction(TimePoint t, TimeSpan dt)
 {
-    for (auto&& person : m_persons) {
-        auto& loc = get_location(*person);
-        person->interact(dt, m_infection_parameters, loc, m_testing_parameters);
-    }
+    //persons interact location by location, locations are processed concurrently
+    parallel_for_locations(m_location_ptrs, *m_thread_pool, [&](Location& location, int /*thread_idx*/) {
+        for (auto i : location.get_members()) {
+            auto& person         = m_persons[i];
+            auto rng             = person_rng(m_rng_seed, i, t, StepPhase::Interaction);
+            ScopedRngStream scoped_rng(rng);
+            auto infection_state = person.get_infection_state();
+            person.update_infection_state(dt, m_infection_parameters, location, m_testing_parameters);
+            if (person.get_infection_state() != infection_state) {
+                location.changed_state(person, infection_state);
+            }
+        }
+    });
+}
+
+void World::reserve_persons(size_t num_persons)
+{
+    //persons are stored in blocks that don't need to be reserved
+    m_member_positions.reserve(num_persons);
+}
+
+void World::reserve_locations(LocationType type, size_t num_locations)
+{
+    m_locations[(uint32_t)type].reserve(num_locations);
 }
 
 void World::set_infection_state(Person& person, InfectionState inf_state){
@@ -66,52 +208,390 @@ void World::set_infection_state(Person& person, InfectionState inf_state){
     auto old_state = person.get_infection_state();
     person.set_infection_state(inf_state);
     loc.changed_state(person, old_state);
+    if (m_event_driven) {
+        //the transitions of the person are scheduled again from the new state in the next step
+        auto& members = loc.get_members();
+        auto iter     = std::find_if(members.begin(), members.end(), [this, &person](auto i) {
+            return &m_persons[i] == &person;
+        });
+        assert(iter != members.end());
+        if (*iter < m_num_scheduled_persons) {
+            m_unscheduled_persons.push_back(uint32_t(*iter));
+        }
+    }
+}
+
+void World::schedule_persons(TimePoint t)
+{
+    //persons that were added since the last step start with all their events in this step
+    for (auto i = m_num_scheduled_persons; i < m_persons.size(); ++i) {
+        auto rng = person_rng(m_rng_seed, i, t, StepPhase::ScheduleTransition);
+        ScopedRngStream scoped_rng(rng);
+        schedule_transition(i, t);
+        m_person_events.push_back({t, t, t, LocationType::Count});
+        recheck_migration(i, t);
+        if (is_infectious(m_persons[i].get_infection_state())) {
+            m_infectious_persons.push_back(uint32_t(i));
+        }
+    }
+    m_num_scheduled_persons = m_persons.size();
+    reschedule_transitions(t);
+
+    //persons that are not infectious anymore are removed once per step
+    m_infectious_persons.erase(std::remove_if(m_infectious_persons.begin(), m_infectious_persons.end(),
+                                              [this](auto i) {
+                                                  return !is_infectious(m_persons[i].get_infection_state());
+                                              }),
+                               m_infectious_persons.end());
+    std::sort(m_infectious_persons.begin(), m_infectious_persons.end());
+    m_infectious_persons.erase(std::unique(m_infectious_persons.begin(), m_infectious_persons.end()),
+                               m_infectious_persons.end());
+}
+
+void World::interaction_event_driven(TimePoint t, TimeSpan dt)
+{
+    //only susceptible persons at locations with infectious persons can be infected, see begin_step
+    //infections are collected per thread and scheduled afterwards
+    std::vector<std::vector<size_t>> infections(get_num_threads());
+    parallel_for_locations(m_location_ptrs, *m_thread_pool, [&](Location& location, int thread_idx) {
+        for (auto i : location.get_members()) {
+            auto& person = m_persons[i];
+            if (person.get_infection_state() == InfectionState::Susceptible) {
+                auto rng = person_rng(m_rng_seed, i, t, StepPhase::Interaction);
+                ScopedRngStream scoped_rng(rng);
+                update_time(i, t);
+                person.update_exposure(dt, m_infection_parameters, location);
+                m_person_events[i].updated_until = t + dt;
+                if (person.get_infection_state() != InfectionState::Susceptible) {
+                    location.changed_state(person, InfectionState::Susceptible);
+                    infections[thread_idx].push_back(i);
+                }
+            }
+        }
+    });
+    for (auto& thread_infections : infections) {
+        for (auto i : thread_infections) {
+            schedule_transition(i, t + dt);
+        }
+    }
+
+    //apply the scheduled transitions that happen during this step
+    while (!m_scheduled_transitions.empty() && m_scheduled_transitions.top().time < t + dt) {
+        auto transition = m_scheduled_transitions.top();
+        m_scheduled_transitions.pop();
+        auto& person = m_persons[transition.person_idx];
+        if (person.get_infection_state() != transition.old_state) {
+            continue; //outdated, the state was changed otherwise
+        }
+        update_time(transition.person_idx, t + dt);
+        person.apply_transition(transition.new_state);
+        get_location(person).changed_state(person, transition.old_state);
+        if (is_infectious(transition.new_state) && !is_infectious(transition.old_state)) {
+            m_infectious_persons.push_back(transition.person_idx);
+        }
+        auto rng = person_rng(m_rng_seed, transition.person_idx, t, StepPhase::RescheduleTransition);
+        ScopedRngStream scoped_rng(rng);
+        schedule_transition(transition.person_idx, t + dt);
+        //the new state may move the person, e.g. to the hospital, or change the quarantine
+        recheck_migration(transition.person_idx, t);
+    }
+}
+
+void World::schedule_transition(size_t person_idx, TimePoint t)
+{
+    auto& person     = m_persons[person_idx];
+    auto transition  = person.sample_next_transition(m_infection_parameters);
+    auto max_seconds = double(std::numeric_limits<int>::max() - t.seconds());
+    auto seconds     = transition.second * 24 * 60 * 60;
+    if (seconds < max_seconds) {
+        m_scheduled_transitions.push({t + mio::seconds(int(seconds)), uint32_t(person_idx),
+                                      person.get_infection_state(), transition.first});
+    }
+}
+
+void World::reschedule_transitions(TimePoint t)
+{
+    if (m_unscheduled_persons.empty()) {
+        return;
+    }
+    std::sort(m_unscheduled_persons.begin(), m_unscheduled_persons.end());
+    m_unscheduled_persons.erase(std::unique(m_unscheduled_persons.begin(), m_unscheduled_persons.end()),
+                                m_unscheduled_persons.end());
+
+    //remove the outdated transitions, all other transitions stay as they are
+    std::vector<ScheduledTransition> transitions;
+    transitions.reserve(m_scheduled_transitions.size());
+    while (!m_scheduled_transitions.empty()) {
+        auto& transition = m_scheduled_transitions.top();
+        if (!std::binary_search(m_unscheduled_persons.begin(), m_unscheduled_persons.end(), transition.person_idx)) {
+            transitions.push_back(transition);
+        }
+        m_scheduled_transitions.pop();
+    }
+    m_scheduled_transitions =
+        decltype(m_scheduled_transitions)(std::less<ScheduledTransition>(), std::move(transitions));
+
+    for (auto i : m_unscheduled_persons) {
+        auto rng = person_rng(m_rng_seed, i, t, StepPhase::ScheduleTransition);
+        ScopedRngStream scoped_rng(rng);
+        schedule_transition(i, t);
+        recheck_migration(i, t);
+        if (is_infectious(m_persons[i].get_infection_state())) {
+            m_infectious_persons.push_back(i);
+        }
+    }
+    m_unscheduled_persons.clear();
+}
+
+void World::recheck_migration(size_t person_idx, TimePoint t)
+{
+    //the sampled departure is discarded, it may depend on the previous state
+    auto& events          = m_person_events[person_idx];
+    events.migration_time = t;
+    events.departure_type = LocationType::Count;
+    m_scheduled_migrations[t].push_back(uint32_t(person_idx));
+}
+
+void World::update_time(size_t person_idx, TimePoint t)
+{
+    auto& events = m_person_events[person_idx];
+    if (events.updated_until < t) {
+        m_persons[person_idx].pass_time(t - events.updated_until);
+        events.updated_until = t;
+    }
+}
+
+void World::set_event_driven(bool event_driven)
+{
+    if (event_driven == m_event_driven) {
+        return;
+    }
+    //persons that were skipped are updated, so the default mode continues from the current state
+    for (size_t i = 0; i < m_num_scheduled_persons; ++i) {
+        update_time(i, m_event_driven_time);
+    }
+    m_event_driven = event_driven;
+    m_scheduled_transitions = {};
+    m_num_scheduled_persons = 0;
+    m_unscheduled_persons.clear();
+    m_person_events.clear();
+    m_scheduled_migrations.clear();
+    m_infectious_persons.clear();
 }
 
 void World::migration(TimePoint t, TimeSpan dt)
 {
+    //rules in order of priority, with the location types that must exist for the rule to be applied
+    //and the location types from where the rule can move persons in the current step
     using migration_rule = LocationType (*)(const Person&, TimePoint, TimeSpan, const AbmMigrationParameters&);
-    const std::pair<migration_rule, std::vector<LocationType>> rules[] = {
-        std::make_pair(&return_home_when_recovered,
-                       std::vector<LocationType>{
-                           LocationType::Home,
-                           LocationType::Hospital}), //assumption: if there is an ICU, there is also an hospital
-        std::make_pair(&go_to_hospital, std::vector<LocationType>{LocationType::Home, LocationType::Hospital}),
-        std::make_pair(&go_to_icu, std::vector<LocationType>{LocationType::Hospital, LocationType::ICU}),
-        std::make_pair(&go_to_school, std::vector<LocationType>{LocationType::School, LocationType::Home}),
-        std::make_pair(&go_to_work, std::vector<LocationType>{LocationType::Home, LocationType::Work}),
-        std::make_pair(&go_to_shop, std::vector<LocationType>{LocationType::Home, LocationType::BasicsShop}),
-        std::make_pair(&go_to_event, std::vector<LocationType>{LocationType::Home, LocationType::SocialEvent})};
-    for (auto&& person : m_persons) {
-        for (auto rule : rules) {
-
-            //check if transition rule can be applied
-            const auto& locs = rule.second;
-            bool nonempty    = !locs.empty();
-            nonempty         = std::all_of(locs.begin(), locs.end(), [this](LocationType type) {
-                return !m_locations[(uint32_t)type].empty();
-            });
-            if (nonempty) {
-                auto target_type = rule.first(*person, t, dt, m_migration_parameters);
-                Location* target = find_location(target_type, *person);
-                if (target != &get_location(*person)) {
-                    if (target->get_testing_scheme().run_scheme(*person, m_testing_parameters)) {
-                        person->migrate_to(get_location(*person), *target);
-                    }
-                    break;
+    using migration_origins = LocationTypeSet (*)(TimePoint, TimeSpan, const AbmMigrationParameters&);
+    using migration_next_time = TimePoint (*)(const Person&, TimePoint, TimeSpan, const AbmMigrationParameters&);
+    struct RuleEntry {
+        migration_rule rule;
+        migration_origins origins;
+        migration_next_time next_time;
+        bool random_departure; ///< moves persons from home at random, see sample_random_departure.
+        std::array<LocationType, 2> required_locations;
+    };
+    static const RuleEntry rule_table[] = {
+        //assumption: if there is an ICU, there is also an hospital
+        {&return_home_when_recovered, &return_home_when_recovered_origins, &return_home_when_recovered_next_time,
+         false, {LocationType::Home, LocationType::Hospital}},
+        {&go_to_hospital, &go_to_hospital_origins, &go_to_hospital_next_time, false,
+         {LocationType::Home, LocationType::Hospital}},
+        {&go_to_icu, &go_to_icu_origins, &go_to_icu_next_time, false, {LocationType::Hospital, LocationType::ICU}},
+        {&go_to_school, &go_to_school_origins, &go_to_school_next_time, false,
+         {LocationType::School, LocationType::Home}},
+        {&go_to_work, &go_to_work_origins, &go_to_work_next_time, false, {LocationType::Home, LocationType::Work}},
+        {&go_to_shop, &go_to_shop_origins, &go_to_shop_next_time, true, {LocationType::Home, LocationType::BasicsShop}},
+        {&go_to_event, &go_to_event_origins, &go_to_event_next_time, true,
+         {LocationType::Home, LocationType::SocialEvent}}};
+
+    //applicability of the rules only depends on the time and the world, so it's resolved once per step
+    struct ActiveRule {
+        migration_rule rule;
+        LocationTypeSet origins;
+        migration_next_time next_time;
+        bool random_departure;
+    };
+    std::array<ActiveRule, sizeof(rule_table) / sizeof(rule_table[0])> rules;
+    size_t num_rules = 0;
+    LocationTypeSet existing_types;
+    for (auto type = size_t(0); type < size_t(LocationType::Count); ++type) {
+        existing_types[type] = !m_locations[type].empty();
+    }
+    for (auto& entry : rule_table) {
+        auto has_locations = std::all_of(entry.required_locations.begin(), entry.required_locations.end(),
+                                         [&existing_types](LocationType type) {
+                                             return existing_types[size_t(type)];
+                                         });
+        if (has_locations) {
+            auto origins = entry.origins(t, dt, m_migration_parameters);
+            rules[num_rules++] = {entry.rule, origins, entry.next_time, entry.random_departure};
+        }
+    }
+
+    //the first rule that moves the person decides where the person goes, nullptr if the person stays.
+    //in the event driven mode, the random departures from home may be sampled in advance instead.
+    auto find_target = [&](size_t i, bool departure_sampled) -> Location* {
+        auto& person = m_persons[i];
+        //a rule that doesn't apply returns the current location type, which only leads to a migration
+        //if the person is not at their assigned location of that type
+        auto current_loc  = person.get_location_id();
+        auto at_assigned  = person.get_assigned_location_index(current_loc.type) == current_loc.index;
+        auto current_type = size_t(current_loc.type);
+        for (size_t rule_idx = 0; rule_idx < num_rules; ++rule_idx) {
+            auto& rule = rules[rule_idx];
+            if ((at_assigned && !rule.origins[current_type]) || (departure_sampled && rule.random_departure)) {
+                continue;
+            }
+            auto target_type = rule.rule(person, t, dt, m_migration_parameters);
+            Location* target = find_location(target_type, person);
+            if (target != &get_location(person)) {
+                return target;
+            }
+        }
+        if (departure_sampled) {
+            auto& events = m_person_events[i];
+            if (events.departure_time < t + dt && events.departure_type != LocationType::Home &&
+                !person.is_in_quarantine()) {
+                return find_location(events.departure_type, person);
+            }
+        }
+        return nullptr;
+    };
+
+    if (!m_event_driven) {
+        //persons decide concurrently where to go, migrations are collected per thread
+        //and applied to the locations afterwards
+        std::vector<std::vector<std::pair<size_t, Location*>>> migrations(get_num_threads());
+        parallel_for_blocks(m_persons.size(), *m_thread_pool, [&](size_t begin, size_t end, int thread_idx) {
+            for (size_t i = begin; i < end; ++i) {
+                auto rng = person_rng(m_rng_seed, i, t, StepPhase::Migration);
+                ScopedRngStream scoped_rng(rng);
+                auto target = find_target(i, false);
+                if (target && target->get_testing_scheme().run_scheme(m_persons[i], m_testing_parameters)) {
+                    migrations[thread_idx].emplace_back(i, target);
                 }
             }
+        });
+        for (auto& thread_migrations : migrations) {
+            for (auto& migration : thread_migrations) {
+                migrate(migration.first, *migration.second);
+            }
         }
+        return;
     }
+
+    //in the event driven mode, only persons whose migration is due in this step apply the rules
+    std::vector<uint32_t> persons;
+    while (!m_scheduled_migrations.empty() && m_scheduled_migrations.begin()->first < t + dt) {
+        auto& scheduled = *m_scheduled_migrations.begin();
+        for (auto i : scheduled.second) {
+            if (m_person_events[i].migration_time == scheduled.first) {
+                persons.push_back(i);
+            }
+        }
+        m_scheduled_migrations.erase(m_scheduled_migrations.begin());
+    }
+    std::sort(persons.begin(), persons.end());
+    persons.erase(std::unique(persons.begin(), persons.end()), persons.end());
+
+    //a sampled departure is used in the steps until it happens
+    std::vector<std::vector<std::pair<size_t, Location*>>> migrations(get_num_threads());
+    std::vector<char> tested_positive(persons.size(), false);
+    parallel_for_blocks(persons.size(), *m_thread_pool, [&](size_t begin, size_t end, int thread_idx) {
+        for (size_t j = begin; j < end; ++j) {
+            auto i   = persons[j];
+            auto rng = person_rng(m_rng_seed, i, t, StepPhase::Migration);
+            ScopedRngStream scoped_rng(rng);
+            update_time(i, t + dt);
+            auto& events = m_person_events[i];
+            auto target  = find_target(i, events.departure_type != LocationType::Count && events.departure_time >= t);
+            if (target) {
+                if (target->get_testing_scheme().run_scheme(m_persons[i], m_testing_parameters)) {
+                    migrations[thread_idx].emplace_back(i, target);
+                }
+                else {
+                    tested_positive[j] = true;
+                }
+            }
+        }
+    });
+    for (auto& thread_migrations : migrations) {
+        for (auto& migration : thread_migrations) {
+            migrate(migration.first, *migration.second);
+        }
+    }
+
+    //the next step where the rules may move the person, from the new location
+    parallel_for_blocks(persons.size(), *m_thread_pool, [&](size_t begin, size_t end, int /*thread_idx*/) {
+        for (size_t j = begin; j < end; ++j) {
+            auto i       = persons[j];
+            auto& person = m_persons[i];
+            auto& events = m_person_events[i];
+            auto next    = t + dt;
+            events.departure_type = LocationType::Count;
+            auto current_loc      = person.get_location_id();
+            //the quarantine after a positive test ends in the next step, see Person::pass_time
+            if (tested_positive[j] || person.get_assigned_location_index(current_loc.type) != current_loc.index) {
+                events.migration_time = next;
+                continue;
+            }
+            events.migration_time = TimePoint(std::numeric_limits<int>::max());
+            for (size_t rule_idx = 0; rule_idx < num_rules; ++rule_idx) {
+                events.migration_time = std::min(
+                    events.migration_time, rules[rule_idx].next_time(person, next, dt, m_migration_parameters));
+            }
+            if (current_loc.type == LocationType::Home) {
+                auto rng = person_rng(m_rng_seed, i, t, StepPhase::ScheduleMigration);
+                ScopedRngStream scoped_rng(rng);
+                std::tie(events.departure_time, events.departure_type) =
+                    sample_random_departure(person, next, dt, m_migration_parameters, existing_types);
+                events.migration_time = std::min(events.migration_time, events.departure_time);
+            }
+        }
+    });
+    for (auto i : persons) {
+        auto time = m_person_events[i].migration_time;
+        if (time < TimePoint(std::numeric_limits<int>::max())) {
+            m_scheduled_migrations[time].push_back(i);
+        }
+    }
+    m_event_driven_time = t + dt;
 }
 
-void World::begin_step(TimePoint /*t*/, TimeSpan dt)
+void World::set_num_threads(int num_threads)
 {
-    for (auto&& locations : m_locations) {
-        for (auto& location : locations) {
-            location.begin_step(dt, m_infection_parameters);
+    assert(num_threads > 0);
+    if (num_threads != get_num_threads()) {
+        m_thread_pool = std::make_unique<ThreadPool>(num_threads);
+    }
+}
+
+void World::begin_step(TimePoint t, TimeSpan dt)
+{
+    m_location_ptrs.clear();
+    if (m_event_driven) {
+        //only the locations of infectious persons are needed for the exposure
+        schedule_persons(t);
+        for (auto i : m_infectious_persons) {
+            m_location_ptrs.push_back(&get_location(m_persons[i]));
         }
+        std::sort(m_location_ptrs.begin(), m_location_ptrs.end(), std::less<Location*>());
+        m_location_ptrs.erase(std::unique(m_location_ptrs.begin(), m_location_ptrs.end()), m_location_ptrs.end());
     }
+    else {
+        //locations may have been added since the last step
+        for (auto&& locations : m_locations) {
+            for (auto& location : locations) {
+                m_location_ptrs.push_back(&location);
+            }
+        }
+    }
+    parallel_for_locations(m_location_ptrs, *m_thread_pool, [&](Location& location, int /*thread_idx*/) {
+        location.begin_step(dt, m_infection_parameters);
+    });
 }
 
 auto World::get_locations() const -> Range<
@@ -122,7 +602,12 @@ auto World::get_locations() const -> Range<
 
 auto World::get_persons() const -> Range<std::pair<ConstPersonIterator, ConstPersonIterator>>
 {
-    return std::make_pair(ConstPersonIterator(m_persons.begin()), ConstPersonIterator(m_persons.end()));
+    return std::make_pair(m_persons.cbegin(), m_persons.cend());
+}
+
+auto World::get_persons() -> Range<std::pair<PersonIterator, PersonIterator>>
+{
+    return std::make_pair(m_persons.begin(), m_persons.end());
 }
 
 const Location& World::get_individualized_location(LocationId id) const
@@ -140,6 +625,22 @@ const Location& World::get_location(const Person& person) const
     return get_individualized_location(person.get_location_id());
 }
 
+void World::migrate(size_t person_idx, Location& target)
+{
+    auto& person   = m_persons[person_idx];
+    auto& location = get_location(person);
+    if (&location != &target) {
+        //the last member of the old location takes the place of the person
+        auto position = m_member_positions[person_idx];
+        location.remove_member(position);
+        if (position < location.get_members().size()) {
+            m_member_positions[location.get_members()[position]] = position;
+        }
+        person.migrate_to(location, target);
+        m_member_positions[person_idx] = target.add_member(uint32_t(person_idx));
+    }
+}
+
 Location* World::find_location(LocationType type, const Person& person)
 {
     auto index = person.get_assigned_location_index(type);
@@ -152,12 +653,134 @@ Location& World::get_location(const Person& person)
     return get_individualized_location(person.get_location_id());
 }
 
-int World::get_subpopulation_combined(InfectionState s, LocationType type) const
+Eigen::VectorXi World::get_subpopulations() const
 {
-    auto& locs = m_locations[(uint32_t)type];
-    return std::accumulate(locs.begin(), locs.end(), 0, [&](int running_sum, const Location& loc) {
-        return running_sum + loc.get_subpopulation(s);
-    });
+    Eigen::VectorXi subpopulations = Eigen::VectorXi::Zero(Eigen::Index(InfectionState::Count));
+    for (auto type = size_t(0); type < size_t(LocationType::Count); ++type) {
+        subpopulations += get_subpopulations(LocationType(type));
+    }
+    return subpopulations;
+}
+
+Eigen::VectorXi World::get_subpopulations(LocationType type) const
+{
+    Eigen::VectorXi subpopulations(Eigen::Index(InfectionState::Count));
+    for (auto state = size_t(0); state < size_t(InfectionState::Count); ++state) {
+        subpopulations[Eigen::Index(state)] = get_subpopulation_combined(InfectionState(state), type);
+    }
+    return subpopulations;
+}
+
+void World::write_checkpoint(CheckpointWriter& writer) const
+{
+    writer.write(m_rng_seed);
+    writer.write(m_event_driven);
+    for (auto& locations : m_locations) {
+        writer.write(uint64_t(locations.size()));
+        for (auto& location : locations) {
+            writer.write(location);
+        }
+    }
+    writer.write(uint64_t(m_persons.size()));
+    for (auto& person : m_persons) {
+        person.write_checkpoint(writer);
+    }
+    writer.write(m_member_positions);
+
+    //a priority queue can't be iterated, write the transitions in the order they are applied
+    auto queue = m_scheduled_transitions;
+    std::vector<ScheduledTransition> scheduled_transitions;
+    scheduled_transitions.reserve(queue.size());
+    while (!queue.empty()) {
+        scheduled_transitions.push_back(queue.top());
+        queue.pop();
+    }
+    writer.write(scheduled_transitions);
+    writer.write(uint64_t(m_num_scheduled_persons));
+    writer.write(m_unscheduled_persons);
+    for (auto& events : m_person_events) {
+        writer.write(events.updated_until);
+        writer.write(events.migration_time);
+        writer.write(events.departure_time);
+        writer.write(events.departure_type);
+    }
+    writer.write(m_event_driven_time);
+    for (auto type = size_t(0); type < size_t(LocationType::Count); ++type) {
+        for (auto state = size_t(0); state < size_t(InfectionState::Count); ++state) {
+            writer.write(get_subpopulation_combined(InfectionState(state), LocationType(type)));
+        }
+    }
+}
+
+IOResult<void> World::read_checkpoint(CheckpointReader& reader)
+{
+    BOOST_OUTCOME_TRY(reader.read(m_rng_seed));
+    BOOST_OUTCOME_TRY(reader.read(m_event_driven));
+    for (size_t type = 0; type < m_locations.size(); ++type) {
+        uint64_t num_locations;
+        BOOST_OUTCOME_TRY(reader.read(num_locations));
+        auto& locations = m_locations[type];
+        locations.clear();
+        locations.reserve(size_t(num_locations));
+        for (uint32_t i = 0; i < num_locations; ++i) {
+            locations.emplace_back(LocationType(type), i);
+            locations.back().m_total_subpopulations = &(*m_subpopulations)[type];
+            BOOST_OUTCOME_TRY(reader.read(locations.back()));
+        }
+    }
+    m_location_ptrs.clear();
+
+    uint64_t num_persons;
+    BOOST_OUTCOME_TRY(reader.read(num_persons));
+    m_persons.clear();
+    for (uint64_t i = 0; i < num_persons; ++i) {
+        //persons are trivially copyable, but are not written as a block because of the padding
+        m_persons.push_back(Person());
+        BOOST_OUTCOME_TRY(m_persons.back().read_checkpoint(reader));
+    }
+    BOOST_OUTCOME_TRY(reader.read(m_member_positions));
+    if (m_member_positions.size() != m_persons.size()) {
+        return failure(StatusCode::InvalidFileFormat, "Inconsistent number of persons in checkpoint.");
+    }
+
+    std::vector<ScheduledTransition> scheduled_transitions;
+    BOOST_OUTCOME_TRY(reader.read(scheduled_transitions));
+    m_scheduled_transitions = decltype(m_scheduled_transitions)(std::less<ScheduledTransition>(),
+                                                                std::move(scheduled_transitions));
+    uint64_t num_scheduled_persons;
+    BOOST_OUTCOME_TRY(reader.read(num_scheduled_persons));
+    m_num_scheduled_persons = size_t(num_scheduled_persons);
+    BOOST_OUTCOME_TRY(reader.read(m_unscheduled_persons));
+    if (m_num_scheduled_persons > m_persons.size()) {
+        return failure(StatusCode::InvalidFileFormat, "Inconsistent number of scheduled persons in checkpoint.");
+    }
+
+    //the queue of migrations and the infectious persons are restored from the persons
+    m_person_events.resize(m_num_scheduled_persons);
+    m_scheduled_migrations.clear();
+    m_infectious_persons.clear();
+    for (size_t i = 0; i < m_person_events.size(); ++i) {
+        auto& events = m_person_events[i];
+        BOOST_OUTCOME_TRY(reader.read(events.updated_until));
+        BOOST_OUTCOME_TRY(reader.read(events.migration_time));
+        BOOST_OUTCOME_TRY(reader.read(events.departure_time));
+        BOOST_OUTCOME_TRY(reader.read(events.departure_type));
+        if (events.migration_time < TimePoint(std::numeric_limits<int>::max())) {
+            m_scheduled_migrations[events.migration_time].push_back(uint32_t(i));
+        }
+        if (is_infectious(m_persons[i].get_infection_state())) {
+            m_infectious_persons.push_back(uint32_t(i));
+        }
+    }
+    BOOST_OUTCOME_TRY(reader.read(m_event_driven_time));
+    for (auto& type_subpopulations : *m_subpopulations) {
+        for (auto& subpopulation : type_subpopulations) {
+            int n;
+            BOOST_OUTCOME_TRY(reader.read(n));
+            subpopulation.store(n, std::memory_order_relaxed);
+        }
+    }
+    return success();
 }
 
 AbmMigrationParameters& World::get_migration_parameters()
@@ -29,9 +29,16 @@
 #include "abm/testing_scheme.h"
 #include "memilio/utils/pointer_dereferencing_iterator.h"
 #include "memilio/utils/stl_util.h"
+#include "memilio/utils/random_number_generator.h"
+#include "memilio/utils/thread_pool.h"
 
+#include "boost/container/deque.hpp"
+
+#include <array>
 #include <vector>
+#include <map>
 #include <memory>
+#include <queue>
 
 namespace mio
 {
@@ -45,8 +52,16 @@ class World
 public:
     using LocationIterator      = PointerDereferencingIterator<std::vector<std::unique_ptr<Location>>::iterator>;
     using ConstLocationIterator = PointerDereferencingIterator<std::vector<std::unique_ptr<Location>>::const_iterator>;
-    using PersonIterator        = PointerDereferencingIterator<std::vector<std::unique_ptr<Person>>::iterator>;
-    using ConstPersonIterator   = PointerDereferencingIterator<std::vector<std::unique_ptr<Person>>::const_iterator>;
+    /**
+     * container of all persons.
+     * Persons are stored by value in large blocks, so iterating over persons accesses memory sequentially
+     * and references to persons stay valid when more persons are added.
+     */
+    using PersonStorage =
+        boost::container::deque<Person, void,
+                                 boost::container::deque_options<boost::container::block_size<1024u>>::type>;
+    using PersonIterator      = PersonStorage::iterator;
+    using ConstPersonIterator = PersonStorage::const_iterator;
 
     /**
      * create a World.
@@ -57,6 +72,12 @@ public:
         , m_infection_parameters(params)
         , m_migration_parameters()
         , m_testing_parameters()
+        , m_thread_pool(std::make_unique<ThreadPool>(1))
+        , m_rng_seed(thread_local_rng()())
+        , m_event_driven(false)
+        , m_num_scheduled_persons(0)
+        , m_event_driven_time(0)
+        , m_subpopulations(std::make_unique<SubpopulationsByType>()) //value initialized, i.e. zero
     {
     }
 
@@ -92,9 +113,24 @@ public:
      */
     Person& add_person(LocationId id, InfectionState infection_state, AbmAgeGroup age = AbmAgeGroup::Age15to34);
     
+    /**
+     * reserve memory for persons, e.g. before adding a large number of persons.
+     * @param num_persons total number of persons.
+     */
+    void reserve_persons(size_t num_persons);
+
+    /**
+     * reserve memory for locations of one type, e.g. before adding a large number of locations.
+     * References to locations are invalidated if more locations are added than reserved.
+     * @param type the type of the locations.
+     * @param num_locations total number of locations of the type.
+     */
+    void reserve_locations(LocationType type, size_t num_locations);
+
     /**
      * Sets the current infection state of the person.
      * Use only during setup, may distort the simulation results
+     * In the event driven mode, only the transitions of this person are sampled again in the next step.
      * @param person
      * @param inf_state
      */
@@ -112,6 +148,8 @@ public:
      */
     Range<std::pair<ConstPersonIterator, ConstPersonIterator>> get_persons() const;
 
+    Range<std::pair<PersonIterator, PersonIterator>> get_persons();
+
     /**
      * get an individualized location
      * @param id LocationId of the location
@@ -141,7 +179,25 @@ public:
      * @param type specified location type
      * @return number of persons that are in the specified infection state
      */
-    int get_subpopulation_combined(InfectionState s, LocationType type) const;
+    int get_subpopulation_combined(InfectionState s, LocationType type) const
+    {
+        return (*m_subpopulations)[size_t(type)][size_t(s)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * number of persons in each infection state at all locations of a type.
+     * The numbers are updated by the locations whenever their subpopulations change,
+     * so this does not depend on the number of locations.
+     * @param type specified location type
+     * @return number of persons in each infection state, indexed by InfectionState.
+     */
+    Eigen::VectorXi get_subpopulations(LocationType type) const;
+
+    /**
+     * number of persons in each infection state at all locations.
+     * @return number of persons in each infection state, indexed by InfectionState.
+     */
+    Eigen::VectorXi get_subpopulations() const;
      
     /** 
      *get migration parameters
@@ -164,15 +220,142 @@ public:
 
     const GlobalTestingParameters& get_global_testing_parameters() const;
 
+    /**
+     * set the number of threads used to evolve the world.
+     * The results don't depend on the number of threads, see set_rng_seed.
+     * Random distributions that are mocked on the calling thread are only used with one thread.
+     * The threads are started here and reused in every time step until the number of threads changes.
+     * @param num_threads number of threads, at least 1.
+     */
+    void set_num_threads(int num_threads);
+
+    int get_num_threads() const
+    {
+        return m_thread_pool->get_num_threads();
+    }
+
+    /**
+     * set the seed of the random numbers used to create and evolve the world.
+     * Every person draws random numbers from its own stream for each time step,
+     * identified by the seed, the index of the person and the time.
+     * Persons that are added and locations assigned by add_and_assign_locations afterwards
+     * also draw from streams of this seed.
+     * By default, the seed is drawn from thread_local_rng() when the world is created.
+     * @param seed the seed.
+     */
+    void set_rng_seed(uint64_t seed)
+    {
+        m_rng_seed = seed;
+    }
+
+    uint64_t get_rng_seed() const
+    {
+        return m_rng_seed;
+    }
+
+    /**
+     * enable or disable the event driven mode.
+     * In the event driven mode, only persons with pending events are processed in a time step instead of all persons.
+     * Susceptible persons are only exposed at locations with carriers or infected persons.
+     * All other changes of the infection state don't depend on the location, so the next change is sampled
+     * when a person enters a state (exponentially distributed for constant rates, the remaining incubation time
+     * for exposed persons) and applied in the time step where it happens.
+     * The migration rules are only applied to a person in the time steps where they may move the person,
+     * e.g. at the time the person goes to work or school, or returns home. Departures from home at random
+     * (shopping, social events) are sampled in advance. After a change of the infection state or a positive test,
+     * the rules are applied in the next time step.
+     * The time at the location and the remaining incubation time of a person are only updated when the person is 
+     * processed, all persons are updated when the event driven mode is disabled.
+     * The distribution of the results is the same as in the default mode, but the random numbers are different.
+     * The time step must not change and the parameters and locations must not change 
+     * during the simulation in the event driven mode.
+     * @param event_driven true to enable the event driven mode.
+     */
+    void set_event_driven(bool event_driven);
+
+    bool is_event_driven() const
+    {
+        return m_event_driven;
+    }
+
+    /**
+     * write the state of the world to a checkpoint.
+     * Contains all persons and locations, the state of the random number generation and of the event driven mode.
+     * The global parameters are not written.
+     * @see CheckpointWriter
+     */
+    void write_checkpoint(CheckpointWriter& writer) const;
+
+    /**
+     * restore the state of the world from a checkpoint.
+     * Replaces all persons and locations. The world must have the same global parameters as the world that was written.
+     * @see CheckpointReader
+     */
+    IOResult<void> read_checkpoint(CheckpointReader& reader);
+
 private:
     void interaction(TimePoint t, TimeSpan dt);
+    void interaction_event_driven(TimePoint t, TimeSpan dt);
+    void schedule_persons(TimePoint t);
+    void schedule_transition(size_t person_idx, TimePoint t);
+    void reschedule_transitions(TimePoint t);
+    void recheck_migration(size_t person_idx, TimePoint t);
+    void update_time(size_t person_idx, TimePoint t);
     void migration(TimePoint t, TimeSpan dt);
+    void migrate(size_t person_idx, Location& target);
+
+    /**
+     * number of persons in each infection state for each location type.
+     */
+    using SubpopulationsByType = std::array<Location::TotalSubpopulations, size_t(LocationType::Count)>;
+
+    /**
+     * change of the infection state of a person that is scheduled in the event driven mode.
+     */
+    struct ScheduledTransition {
+        TimePoint time;
+        uint32_t person_idx;
+        InfectionState old_state;
+        InfectionState new_state;
+
+        /**
+         * order for the priority queue, earliest transition first.
+         */
+        bool operator<(const ScheduledTransition& other) const
+        {
+            return std::make_pair(other.time.seconds(), other.person_idx) <
+                   std::make_pair(time.seconds(), person_idx);
+        }
+    };
+
+    /**
+     * state of a person in the event driven mode.
+     */
+    struct PersonEvents {
+        TimePoint updated_until; ///< time until which the person is updated, see update_time.
+        TimePoint migration_time; ///< next time step in which the migration rules are applied to the person.
+        TimePoint departure_time; ///< sampled time step of the next departure from home, see sample_random_departure.
+        LocationType departure_type; ///< destination of the departure, Home if none, Count if not sampled.
+    };
 
-    std::vector<std::unique_ptr<Person>> m_persons;
+    PersonStorage m_persons;
+    std::vector<uint32_t> m_member_positions; ///< position of each person in the members of its location.
     std::vector<std::vector<Location>> m_locations;
+    std::vector<Location*> m_location_ptrs; ///< all locations, updated at the beginning of each step.
     GlobalInfectionParameters m_infection_parameters;
     AbmMigrationParameters m_migration_parameters;
     GlobalTestingParameters m_testing_parameters;
+    std::unique_ptr<ThreadPool> m_thread_pool; ///< threads that evolve the world, started once by set_num_threads.
+    uint64_t m_rng_seed;
+    bool m_event_driven;
+    std::priority_queue<ScheduledTransition> m_scheduled_transitions;
+    size_t m_num_scheduled_persons; ///< persons with smaller index have their transitions scheduled.
+    std::vector<uint32_t> m_unscheduled_persons; ///< persons whose scheduled transitions are outdated.
+    std::vector<PersonEvents> m_person_events; ///< state of each scheduled person in the event driven mode.
+    std::map<TimePoint, std::vector<uint32_t>> m_scheduled_migrations; ///< persons by migration time, may be outdated.
+    std::vector<uint32_t> m_infectious_persons; ///< carriers and infected persons, may contain others.
+    TimePoint m_event_driven_time; ///< end of the last time step in the event driven mode.
+    std::unique_ptr<SubpopulationsByType> m_subpopulations; ///< on the heap, so the locations can refer to it.
 };
 
 } // namespace mio
@@ -18,6 +18,7 @@
 * limitations under the License.
 */
 #include "secir/analyze_result.h"
+#include "memilio/utils/instrumentation.h"
 
 #include <algorithm>
 #include <cassert>
@@ -25,11 +26,16 @@
 namespace mio
 {
 
+namespace details
+{
+
 /**
  * TODO: extrapolate first and last point
  */
-TimeSeries<double> interpolate_simulation_result(const TimeSeries<double>& simulation_result)
+template <class FP>
+TimeSeries<FP> interpolate_simulation_result(const TimeSeries<FP>& simulation_result)
 {
+    MIO_SCOPED_TIMER("interpolate_simulation_result");
     assert(simulation_result.get_num_time_points() > 0 && "TimeSeries must not be empty.");
 
     const auto t0      = simulation_result.get_time(0);
@@ -38,9 +44,9 @@ TimeSeries<double> interpolate_simulation_result(const TimeSeries<double>& simul
     const auto day_max = static_cast<int>(ceil(tmax));
 
     auto day = day0;
-    TimeSeries<double> interpolated(simulation_result.get_num_elements());
+    TimeSeries<FP> interpolated(simulation_result.get_num_elements());
     interpolated.reserve(day_max - day0 + 1);
-    interpolated.add_time_point(day, simulation_result.get_value(0));
+    interpolated.add_time_point(FP(day), simulation_result.get_value(0));
     day++;
 
     //interpolate between pair of time points that lie on either side of each integer day
@@ -51,8 +57,8 @@ TimeSeries<double> interpolate_simulation_result(const TimeSeries<double>& simul
         if (simulation_result.get_time(i) < day && simulation_result.get_time(i + 1) >= day) {
             auto weight = (day - simulation_result.get_time(i)) /
                           (simulation_result.get_time(i + 1) - simulation_result.get_time(i));
-            interpolated.add_time_point(day, simulation_result[i] +
-                                                 (simulation_result[i + 1] - simulation_result[i]) * weight);
+            interpolated.add_time_point(FP(day), simulation_result[i] +
+                                                     (simulation_result[i + 1] - simulation_result[i]) * weight);
             ++day;
         }
         else {
@@ -61,22 +67,22 @@ TimeSeries<double> interpolate_simulation_result(const TimeSeries<double>& simul
     }
 
     if (day_max > tmax) {
-        interpolated.add_time_point(day, simulation_result.get_last_value());
+        interpolated.add_time_point(FP(day), simulation_result.get_last_value());
     }
 
     return interpolated;
 }
 
-std::vector<std::vector<TimeSeries<double>>>
-sum_nodes(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result)
+template <class FP>
+std::vector<std::vector<TimeSeries<FP>>> sum_nodes(const std::vector<std::vector<TimeSeries<FP>>>& ensemble_result)
 {
     auto num_runs        = ensemble_result.size();
     auto num_nodes       = ensemble_result[0].size();
     auto num_time_points = ensemble_result[0][0].get_num_time_points();
     auto num_elements    = ensemble_result[0][0].get_num_elements();
 
-    std::vector<std::vector<TimeSeries<double>>> sum_result(
-        num_runs, std::vector<TimeSeries<double>>(1, TimeSeries<double>::zero(num_time_points, num_elements)));
+    std::vector<std::vector<TimeSeries<FP>>> sum_result(
+        num_runs, std::vector<TimeSeries<FP>>(1, TimeSeries<FP>::zero(num_time_points, num_elements)));
 
     for (size_t run = 0; run < num_runs; run++) {
         for (Eigen::Index time = 0; time < num_time_points; time++) {
@@ -89,14 +95,15 @@ sum_nodes(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result)
     return sum_result;
 }
 
-std::vector<TimeSeries<double>> ensemble_mean(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result)
+template <class FP>
+std::vector<TimeSeries<FP>> ensemble_mean(const std::vector<std::vector<TimeSeries<FP>>>& ensemble_result)
 {
     auto num_runs        = ensemble_result.size();
     auto num_nodes       = ensemble_result[0].size();
     auto num_time_points = ensemble_result[0][0].get_num_time_points();
     auto num_elements    = ensemble_result[0][0].get_num_elements();
 
-    std::vector<TimeSeries<double>> mean(num_nodes, TimeSeries<double>::zero(num_time_points, num_elements));
+    std::vector<TimeSeries<FP>> mean(num_nodes, TimeSeries<FP>::zero(num_time_points, num_elements));
 
     for (size_t run = 0; run < num_runs; run++) {
         assert(ensemble_result[run].size() == num_nodes && "ensemble results not uniform.");
@@ -107,7 +114,7 @@ std::vector<TimeSeries<double>> ensemble_mean(const std::vector<std::vector<Time
                 assert(ensemble_result[run][node].get_num_elements() == num_elements &&
                        "ensemble results not uniform.");
                 mean[node].get_time(time) = ensemble_result[run][node].get_time(time);
-                mean[node][time] += ensemble_result[run][node][time] / num_runs;
+                mean[node][time] += ensemble_result[run][node][time] / FP(num_runs);
             }
         }
     }
@@ -115,8 +122,9 @@ std::vector<TimeSeries<double>> ensemble_mean(const std::vector<std::vector<Time
     return mean;
 }
 
-std::vector<TimeSeries<double>> ensemble_percentile(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result,
-                                                    double p)
+template <class FP>
+std::vector<TimeSeries<FP>> ensemble_percentile(const std::vector<std::vector<TimeSeries<FP>>>& ensemble_result,
+                                                double p)
 {
     assert(p > 0.0 && p < 1.0 && "Invalid percentile value.");
 
@@ -125,9 +133,9 @@ std::vector<TimeSeries<double>> ensemble_percentile(const std::vector<std::vecto
     auto num_time_points = ensemble_result[0][0].get_num_time_points();
     auto num_elements    = ensemble_result[0][0].get_num_elements();
 
-    std::vector<TimeSeries<double>> percentile(num_nodes, TimeSeries<double>::zero(num_time_points, num_elements));
+    std::vector<TimeSeries<FP>> percentile(num_nodes, TimeSeries<FP>::zero(num_time_points, num_elements));
 
-    std::vector<double> single_element_ensemble(num_runs); //reused for each element
+    std::vector<FP> single_element_ensemble(num_runs); //reused for each element
     for (size_t node = 0; node < num_nodes; node++) {
         for (Eigen::Index time = 0; time < num_time_points; time++) {
             percentile[node].get_time(time) = ensemble_result[0][node].get_time(time);
@@ -144,6 +152,52 @@ std::vector<TimeSeries<double>> ensemble_percentile(const std::vector<std::vecto
     return percentile;
 }
 
+} // namespace details
+
+TimeSeries<double> interpolate_simulation_result(const TimeSeries<double>& simulation_result)
+{
+    return details::interpolate_simulation_result(simulation_result);
+}
+
+TimeSeries<float> interpolate_simulation_result(const TimeSeries<float>& simulation_result)
+{
+    return details::interpolate_simulation_result(simulation_result);
+}
+
+std::vector<std::vector<TimeSeries<double>>>
+sum_nodes(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result)
+{
+    return details::sum_nodes(ensemble_result);
+}
+
+std::vector<std::vector<TimeSeries<float>>>
+sum_nodes(const std::vector<std::vector<TimeSeries<float>>>& ensemble_result)
+{
+    return details::sum_nodes(ensemble_result);
+}
+
+std::vector<TimeSeries<double>> ensemble_mean(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result)
+{
+    return details::ensemble_mean(ensemble_result);
+}
+
+std::vector<TimeSeries<float>> ensemble_mean(const std::vector<std::vector<TimeSeries<float>>>& ensemble_result)
+{
+    return details::ensemble_mean(ensemble_result);
+}
+
+std::vector<TimeSeries<double>> ensemble_percentile(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result,
+                                                    double p)
+{
+    return details::ensemble_percentile(ensemble_result, p);
+}
+
+std::vector<TimeSeries<float>> ensemble_percentile(const std::vector<std::vector<TimeSeries<float>>>& ensemble_result,
+                                                   double p)
+{
+    return details::ensemble_percentile(ensemble_result, p);
+}
+
 double result_distance_2norm(const std::vector<mio::TimeSeries<double>>& result1,
                              const std::vector<mio::TimeSeries<double>>& result2)
 {
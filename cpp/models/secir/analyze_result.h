@@ -24,6 +24,8 @@
 #include "secir/secir.h"
 #include "memilio/mobility/mobility.h"
 
+#include <algorithm>
+#include <cassert>
 #include <functional>
 #include <vector>
 
@@ -36,8 +38,11 @@ namespace mio
  * values at new time points are linearly interpolated from their immediate neighbors from the old time points.
  * @param simulation_result time series to interpolate
  * @return interpolated time series
+ * @{
  */
 TimeSeries<double> interpolate_simulation_result(const TimeSeries<double>& simulation_result);
+TimeSeries<float> interpolate_simulation_result(const TimeSeries<float>& simulation_result);
+/** @} */
 
 /**
  * helper template, type returned by overload interpolate_simulation_result(T t)
@@ -62,8 +67,19 @@ std::vector<InterpolateResultT<T>> interpolate_ensemble_results(const std::vecto
     return interpolated;
 }
 
+/**
+ * @brief computes the sum of all nodes of each run.
+ * input must be uniform as returned by interpolated_ensemble_result:
+ * same number of nodes, same time points and elements.
+ * @param ensemble_result uniform results of multiple simulation runs
+ * @return one time series per run with the sum over all nodes
+ * @{
+ */
 std::vector<std::vector<TimeSeries<double>>>
 sum_nodes(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result);
+std::vector<std::vector<TimeSeries<float>>>
+sum_nodes(const std::vector<std::vector<TimeSeries<float>>>& ensemble_result);
+/** @} */
 
 /**
  * @brief computes mean of each compartment, node, and time point over all runs
@@ -72,8 +88,11 @@ sum_nodes(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result);
  * @see interpolated_ensemble_result
  * @param ensemble_results uniform results of multiple simulation runs
  * @return mean of the results over all runs
+ * @{
  */
 std::vector<TimeSeries<double>> ensemble_mean(const std::vector<std::vector<TimeSeries<double>>>& ensemble_results);
+std::vector<TimeSeries<float>> ensemble_mean(const std::vector<std::vector<TimeSeries<float>>>& ensemble_results);
+/** @} */
 
 /**
  * @brief computes the p percentile of the result for each compartment, node, and time point.
@@ -85,9 +104,13 @@ std::vector<TimeSeries<double>> ensemble_mean(const std::vector<std::vector<Time
  * @param ensemble_result uniform results of multiple simulation runs
  * @param p percentile value in open interval (0, 1)
  * @return p percentile of the results over all runs
+ * @{
  */
 std::vector<TimeSeries<double>> ensemble_percentile(const std::vector<std::vector<TimeSeries<double>>>& ensemble_result,
                                                     double p);
+std::vector<TimeSeries<float>> ensemble_percentile(const std::vector<std::vector<TimeSeries<float>>>& ensemble_result,
+                                                   double p);
+/** @} */
 /**
  * interpolate time series with evenly spaced, integer time points for each node.
  * @see interpolate_simulation_result
@@ -107,6 +130,115 @@ interpolate_simulation_result(const Graph<SimulationNode<Simulation>, MigrationE
     return interpolated;
 }
 
+namespace details
+{
+/**
+ * call a function for a reference to each parameter of a model whose percentiles are computed,
+ * always in the same order.
+ * The ICU capacity is not included because its percentile is computed relative to the population.
+ * @see ensemble_params_percentile
+ */
+template <class Model, class F>
+void for_each_percentile_param(Model&& model, F f)
+{
+    auto num_groups = model.parameters.get_num_groups();
+    for (auto i = AgeGroup(0); i < num_groups; i++) {
+        //Population
+        for (size_t compart = 0; compart < (size_t)InfectionState::Count; ++compart) {
+            f(model.populations[{i, (InfectionState)compart}]);
+        }
+        // times
+        f(model.parameters.template get<IncubationTime>()[i]);
+        f(model.parameters.template get<SerialInterval>()[i]);
+        f(model.parameters.template get<InfectiousTimeMild>()[i]);
+        f(model.parameters.template get<HospitalizedToICUTime>()[i]);
+        f(model.parameters.template get<HospitalizedToHomeTime>()[i]);
+        f(model.parameters.template get<HomeToHospitalizedTime>()[i]);
+        f(model.parameters.template get<ICUToDeathTime>()[i]);
+        f(model.parameters.template get<ICUToHomeTime>()[i]);
+        //probs
+        f(model.parameters.template get<RelativeCarrierInfectability>()[i]);
+        f(model.parameters.template get<RiskOfInfectionFromSympomatic>()[i]);
+        f(model.parameters.template get<MaxRiskOfInfectionFromSympomatic>()[i]);
+        f(model.parameters.template get<AsymptoticCasesPerInfectious>()[i]);
+        f(model.parameters.template get<HospitalizedCasesPerInfectious>()[i]);
+        f(model.parameters.template get<ICUCasesPerHospitalized>()[i]);
+        f(model.parameters.template get<mio::DeathsPerICU>()[i]);
+    }
+    // group independent params
+    f(model.parameters.template get<mio::Seasonality>());
+    f(model.parameters.template get<mio::TestAndTraceCapacity>());
+}
+} // namespace details
+
+/**
+ * @brief get the values of the parameters of a model whose percentiles are computed.
+ * Only these values are required to compute the percentiles, so large ensembles can store them instead of the models.
+ * The ICU capacity is stored relative to the population.
+ * @see ensemble_params_percentile
+ * @param model a model.
+ * @return the values of the parameters in the order expected by set_percentile_params.
+ */
+template <class Model>
+std::vector<double> get_percentile_params(const Model& model)
+{
+    std::vector<double> values;
+    details::for_each_percentile_param(model, [&values](auto& param) {
+        values.push_back(double(param));
+    });
+    values.push_back(model.parameters.template get<mio::ICUCapacity>() * model.populations.get_total());
+    return values;
+}
+
+/**
+ * @brief set the parameters of a model whose percentiles are computed.
+ * @see get_percentile_params
+ * @param model a model with the same number of groups as the model whose values were taken.
+ * @param values values returned by get_percentile_params or their percentiles.
+ */
+template <class Model>
+void set_percentile_params(Model& model, const std::vector<double>& values)
+{
+    auto value = values.begin();
+    details::for_each_percentile_param(model, [&value](auto& param) {
+        param = *value++;
+    });
+    assert(value + 1 == values.end() && "Unexpected number of values.");
+    model.parameters.template set<mio::ICUCapacity>(*value);
+}
+
+/**
+ * @brief computes the p percentile of the parameters for each node.
+ * @param ensemble_params values of the parameters of each node of each run as returned by get_percentile_params,
+ *                        i.e. ensemble_params[run][node].
+ * @param p percentile value in open interval (0, 1)
+ * @return p percentile of the values of each node over all runs.
+ */
+inline std::vector<std::vector<double>>
+ensemble_params_percentile(const std::vector<std::vector<std::vector<double>>>& ensemble_params, double p)
+{
+    assert(p > 0.0 && p < 1.0 && "Invalid percentile value.");
+
+    auto num_runs  = ensemble_params.size();
+    auto num_nodes = ensemble_params[0].size();
+
+    std::vector<std::vector<double>> percentile(num_nodes);
+    std::vector<double> single_element_ensemble(num_runs); //reused for each element
+    for (size_t node = 0; node < num_nodes; node++) {
+        auto num_values = ensemble_params[0][node].size();
+        percentile[node].resize(num_values);
+        for (size_t i = 0; i < num_values; i++) {
+            std::transform(ensemble_params.begin(), ensemble_params.end(), single_element_ensemble.begin(),
+                           [node, i](auto& run) {
+                               return run[node][i];
+                           });
+            std::sort(single_element_ensemble.begin(), single_element_ensemble.end());
+            percentile[node][i] = single_element_ensemble[static_cast<size_t>(num_runs * p)];
+        }
+    }
+    return percentile;
+}
+
 /**
  * @brief computes the p percentile of the parameters for each node.
  * @param ensemble_result graph of multiple simulation runs
@@ -118,98 +250,24 @@ std::vector<Model> ensemble_params_percentile(const std::vector<std::vector<Mode
 {
     assert(p > 0.0 && p < 1.0 && "Invalid percentile value.");
 
-    auto num_runs   = ensemble_params.size();
-    auto num_nodes  = ensemble_params[0].size();
-    auto num_groups = (size_t)ensemble_params[0][0].parameters.get_num_groups();
-
-    std::vector<double> single_element_ensemble(num_runs);
-
-    // lamda function that calculates the percentile of a single paramter
-    std::vector<Model> percentile(num_nodes, Model((int)num_groups));
-    auto param_percentil = [&ensemble_params, p, num_runs, &percentile](auto n, auto get_param) mutable {
-        std::vector<double> single_element(num_runs);
-        for (size_t run = 0; run < num_runs; run++) {
-            auto const& params  = ensemble_params[run][n];
-            single_element[run] = get_param(params);
-        }
-        std::sort(single_element.begin(), single_element.end());
-        auto& new_params = get_param(percentile[n]);
-        new_params       = single_element[static_cast<size_t>(num_runs * p)];
-    };
-
-    for (size_t node = 0; node < num_nodes; node++) {
-        for (auto i = AgeGroup(0); i < AgeGroup(num_groups); i++) {
-            //Population
-            for (size_t compart = 0; compart < (size_t)InfectionState::Count; ++compart) {
-                param_percentil(
-                    node, [ compart, i ](auto&& model) -> auto& {
-                        return model.populations[{i, (InfectionState)compart}];
-                    });
-            }
-            // times
-            param_percentil(
-                node, [i](auto&& model) -> auto& { return model.parameters.template get<IncubationTime>()[i]; });
-            param_percentil(
-                node, [i](auto&& model) -> auto& { return model.parameters.template get<SerialInterval>()[i]; });
-            param_percentil(
-                node, [i](auto&& model) -> auto& { return model.parameters.template get<InfectiousTimeMild>()[i]; });
-            param_percentil(
-                node, [i](auto&& model) -> auto& { return model.parameters.template get<HospitalizedToICUTime>()[i]; });
-            param_percentil(
-                node, [i](auto&& model) -> auto& {
-                    return model.parameters.template get<HospitalizedToHomeTime>()[i];
-                });
-            param_percentil(
-                node, [i](auto&& model) -> auto& {
-                    return model.parameters.template get<HomeToHospitalizedTime>()[i];
-                });
-            param_percentil(
-                node, [i](auto&& model) -> auto& { return model.parameters.template get<ICUToDeathTime>()[i]; });
-            param_percentil(
-                node, [i](auto&& model) -> auto& { return model.parameters.template get<ICUToHomeTime>()[i]; });
-            //probs
-            param_percentil(
-                node, [i](auto&& model) -> auto& {
-                    return model.parameters.template get<RelativeCarrierInfectability>()[i];
-                });
-            param_percentil(
-                node, [i](auto&& model) -> auto& {
-                    return model.parameters.template get<RiskOfInfectionFromSympomatic>()[i];
-                });
-            param_percentil(
-                node, [i](auto&& model) -> auto& {
-                    return model.parameters.template get<MaxRiskOfInfectionFromSympomatic>()[i];
-                });
-            param_percentil(
-                node, [i](auto&& model) -> auto& {
-                    return model.parameters.template get<AsymptoticCasesPerInfectious>()[i];
-                });
-            param_percentil(
-                node, [i](auto&& model) -> auto& {
-                    return model.parameters.template get<HospitalizedCasesPerInfectious>()[i];
-                });
-            param_percentil(
-                node, [i](auto&& model) -> auto& {
-                    return model.parameters.template get<ICUCasesPerHospitalized>()[i];
-                });
-            param_percentil(
-                node, [i](auto&& model) -> auto& { return model.parameters.template get<mio::DeathsPerICU>()[i]; });
-        }
-        // group independent params
-        param_percentil(
-            node, [](auto&& model) -> auto& { return model.parameters.template get<mio::Seasonality>(); });
-        param_percentil(
-            node, [](auto&& model) -> auto& { return model.parameters.template get<mio::TestAndTraceCapacity>(); });
+    auto num_groups = (int)(size_t)ensemble_params[0][0].parameters.get_num_groups();
 
-        for (size_t run = 0; run < num_runs; run++) {
+    std::vector<std::vector<std::vector<double>>> ensemble_values;
+    ensemble_values.reserve(ensemble_params.size());
+    std::transform(ensemble_params.begin(), ensemble_params.end(), std::back_inserter(ensemble_values),
+                   [](auto& run) {
+                       std::vector<std::vector<double>> run_values;
+                       run_values.reserve(run.size());
+                       std::transform(run.begin(), run.end(), std::back_inserter(run_values), [](auto& model) {
+                           return get_percentile_params(model);
+                       });
+                       return run_values;
+                   });
 
-            auto const& params = ensemble_params[run][node];
-            single_element_ensemble[run] =
-                params.parameters.template get<mio::ICUCapacity>() * params.populations.get_total();
-        }
-        std::sort(single_element_ensemble.begin(), single_element_ensemble.end());
-        percentile[node].parameters.template set<mio::ICUCapacity>(
-            single_element_ensemble[static_cast<size_t>(num_runs * p)]);
+    auto percentile_values = ensemble_params_percentile(ensemble_values, p);
+    std::vector<Model> percentile(percentile_values.size(), Model(num_groups));
+    for (size_t node = 0; node < percentile.size(); node++) {
+        set_percentile_params(percentile[node], percentile_values[node]);
     }
     return percentile;
 }
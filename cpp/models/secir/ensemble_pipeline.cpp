@@ -0,0 +1,206 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "secir/ensemble_pipeline.h"
+
+#if defined(MEMILIO_HAS_HDF5) && defined(MEMILIO_HAS_JSONCPP)
+
+#include "secir/analyze_result.h"
+#include "secir/parameter_studies.h"
+#include "secir/secir_parameters_io.h"
+#include "secir/secir_result_io.h"
+#include "memilio/io/async_writer.h"
+#include "memilio/utils/instrumentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+
+namespace mio
+{
+
+namespace
+{
+
+/**
+ * name of the directory of a percentile, e.g. "p05" for 0.05.
+ */
+std::string percentile_dir_name(double p)
+{
+    char name[8];
+    snprintf(name, sizeof(name), "p%02d", int(std::round(p * 100)));
+    return name;
+}
+
+/**
+ * graph without edges that contains the parameters of each node.
+ */
+Graph<SecirModel, MigrationParameters> make_graph_no_edges(const std::vector<std::vector<double>>& params,
+                                                           const std::vector<int>& ids, int num_groups)
+{
+    auto graph = Graph<SecirModel, MigrationParameters>();
+    for (auto i = size_t(0); i < ids.size(); ++i) {
+        auto model = SecirModel(num_groups);
+        set_percentile_params(model, params[i]);
+        graph.add_node(ids[i], model);
+    }
+    return graph;
+}
+
+/**
+ * percentiles of the results of each node in a file written by ResultEnsembleWriter.
+ * The runs are read one node at a time.
+ * @return results of each node for each percentile, i.e. result[percentile][node].
+ */
+IOResult<std::vector<std::vector<TimeSeries<float>>>> results_percentiles(const std::string& filename,
+                                                                         const std::vector<int>& ids, int num_groups,
+                                                                         size_t num_runs,
+                                                                         const std::vector<double>& percentiles)
+{
+    std::vector<std::vector<TimeSeries<float>>> result(percentiles.size());
+    for (auto id : ids) {
+        auto ensemble_node = std::vector<std::vector<TimeSeries<double>>>();
+        {
+            BOOST_OUTCOME_TRY(runs, read_result_ensemble_node(filename, id, num_groups));
+            if (runs.size() != num_runs) {
+                return failure(StatusCode::InvalidFileFormat, "Unexpected number of runs in " + filename + ".");
+            }
+            ensemble_node.reserve(num_runs);
+            std::transform(runs.begin(), runs.end(), std::back_inserter(ensemble_node), [](auto& run) {
+                return std::vector<TimeSeries<double>>{run.get_groups()};
+            });
+        }
+        for (size_t i = 0; i < percentiles.size(); ++i) {
+            result[i].push_back(ensemble_percentile(ensemble_node, percentiles[i])[0].cast<float>());
+        }
+    }
+    return success(std::move(result));
+}
+
+} // namespace
+
+EnsembleStatistics::EnsembleStatistics(const std::vector<int>& ids, int num_groups, size_t num_runs)
+    : m_ids(ids)
+    , m_num_groups(num_groups)
+    , m_params(num_runs)
+    , m_num_added(0)
+{
+}
+
+void EnsembleStatistics::add_run(size_t run_idx, std::vector<std::vector<double>> params)
+{
+    assert(run_idx < m_params.size());
+    assert(params.size() == m_ids.size());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_params[run_idx] = std::move(params);
+    ++m_num_added;
+}
+
+IOResult<void> EnsembleStatistics::save_percentiles(const std::string& runs_filename,
+                                                    const std::string& runs_sum_filename,
+                                                    const std::string& result_dir,
+                                                    const std::vector<double>& percentiles) const
+{
+    MIO_SCOPED_TIMER("EnsembleStatistics::save_percentiles");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_num_added != m_params.size()) {
+        return failure(StatusCode::InvalidValue, "Not all runs of the ensemble have been added.");
+    }
+
+    auto num_runs = m_params.size();
+    BOOST_OUTCOME_TRY(results, results_percentiles(runs_filename, m_ids, m_num_groups, num_runs, percentiles));
+    BOOST_OUTCOME_TRY(results_sum, results_percentiles(runs_sum_filename, {0}, m_num_groups, num_runs, percentiles));
+    for (size_t i = 0; i < percentiles.size(); ++i) {
+        auto percentile_dir = result_dir + "/" + percentile_dir_name(percentiles[i]);
+        BOOST_OUTCOME_TRY(create_directory(percentile_dir));
+        BOOST_OUTCOME_TRY(save_result(results_sum[i], {0}, percentile_dir + "/Results_sum.h5"));
+        BOOST_OUTCOME_TRY(save_result(results[i], m_ids, percentile_dir + "/Results.h5"));
+        BOOST_OUTCOME_TRY(write_graph(
+            make_graph_no_edges(ensemble_params_percentile(m_params, percentiles[i]), m_ids, m_num_groups),
+            percentile_dir, IOF_OmitDistributions));
+    }
+    return success();
+}
+
+IOResult<void> run_ensemble(const Graph<SecirModel, MigrationParameters>& graph, const EnsembleOptions& options,
+                            const std::string& result_dir)
+{
+    MIO_SCOPED_TIMER("run_ensemble");
+
+    std::vector<int> ids(graph.nodes().size());
+    std::transform(graph.nodes().begin(), graph.nodes().end(), ids.begin(), [](auto& n) {
+        return n.id;
+    });
+    auto num_groups = int((size_t)graph.nodes()[0].property.parameters.get_num_groups());
+
+    auto statistics = EnsembleStatistics(ids, num_groups, options.num_runs);
+
+    //all runs are appended to the same files in the order of their indices while the next runs are simulated
+    using RunResult    = std::pair<std::vector<TimeSeries<float>>, std::vector<TimeSeries<float>>>;
+    auto runs_filename = result_dir + "/Results_runs.h5";
+    auto sum_filename  = result_dir + "/Results_runs_sum.h5";
+    auto runs_writer   = ResultEnsembleWriter(runs_filename, ids, options.compression_level);
+    auto sum_writer    = ResultEnsembleWriter(sum_filename, {0}, options.compression_level);
+    auto result_writer = AsyncWriter<RunResult>(
+        [&](size_t, RunResult&& r) -> IOResult<void> {
+            BOOST_OUTCOME_TRY(runs_writer.add_run(r.first));
+            BOOST_OUTCOME_TRY(sum_writer.add_run(r.second));
+            return success();
+        },
+        size_t(2 * std::max(options.num_threads, 1)));
+
+    auto parameter_study =
+        ParameterStudy<SecirSimulation<>>{graph, options.t0, options.tmax, options.dt, options.num_runs};
+    BOOST_OUTCOME_TRY(parameter_study.run_parallel(
+        std::max(options.num_threads, 1),
+        [&](auto results_graph, size_t run_idx) {
+            auto interpolated = interpolate_simulation_result(results_graph);
+            auto result       = std::vector<TimeSeries<float>>();
+            result.reserve(interpolated.size());
+            std::transform(interpolated.begin(), interpolated.end(), std::back_inserter(result), [](auto& ts) {
+                return ts.template cast<float>();
+            });
+
+            //only the values are required for the percentiles
+            auto params = std::vector<std::vector<double>>();
+            params.reserve(results_graph.nodes().size());
+            std::transform(results_graph.nodes().begin(), results_graph.nodes().end(), std::back_inserter(params),
+                           [](auto&& node) {
+                               return get_percentile_params(node.property.get_simulation().get_model());
+                           });
+
+            auto result_sum = std::move(sum_nodes(std::vector<std::vector<TimeSeries<float>>>{result})[0]);
+            result_writer.add(run_idx, {std::move(result), std::move(result_sum)});
+            statistics.add_run(run_idx, std::move(params));
+        },
+        options.seeds,
+        [&result_writer](auto&&) {
+            //the missing run would block the threads that add later runs to the writer
+            result_writer.cancel();
+        }));
+    BOOST_OUTCOME_TRY(result_writer.finish());
+    BOOST_OUTCOME_TRY(statistics.save_percentiles(runs_filename, sum_filename, result_dir, options.percentiles));
+
+    return success();
+}
+
+} // namespace mio
+
+#endif // MEMILIO_HAS_HDF5 && MEMILIO_HAS_JSONCPP
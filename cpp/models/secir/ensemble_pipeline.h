@@ -0,0 +1,133 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef EPI_SECIR_ENSEMBLE_PIPELINE_H
+#define EPI_SECIR_ENSEMBLE_PIPELINE_H
+
+#include "memilio/config.h"
+
+#if defined(MEMILIO_HAS_HDF5) && defined(MEMILIO_HAS_JSONCPP)
+
+#include "secir/secir.h"
+#include "memilio/mobility/mobility.h"
+#include "memilio/mobility/graph.h"
+#include "memilio/utils/time_series.h"
+#include "memilio/io/io.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mio
+{
+
+/**
+ * options of an ensemble of simulation runs with sampled parameters.
+ * @see run_ensemble
+ */
+struct EnsembleOptions {
+    double t0     = 0.0; ///< start time of the simulations.
+    double tmax   = 1.0; ///< end time of the simulations.
+    double dt     = 0.5; ///< time step of the migration between the nodes.
+    size_t num_runs = 1; ///< number of simulation runs.
+    int num_threads = 1; ///< number of threads that compute the runs.
+    /**
+     * seeds of the random number generator.
+     * Random seeds are used if empty, otherwise each run is seeded with the seeds and its index,
+     * so the results don't depend on the number of threads.
+     */
+    std::vector<unsigned int> seeds = {};
+    /**
+     * percentiles of the results and parameters that are stored, each in the open interval (0, 1).
+     */
+    std::vector<double> percentiles = {0.05, 0.25, 0.50, 0.75, 0.95};
+    int compression_level = 4; ///< deflate level of the files that contain all runs, see ResultEnsembleWriter.
+};
+
+/**
+ * collects the sampled parameters of the runs of an ensemble and computes percentiles over all runs.
+ * Only the values of the parameters that are required for the percentiles are stored for each run,
+ * see get_percentile_params. The results are not stored, their percentiles are computed from the files that
+ * contain all runs, one node at a time, so the memory doesn't grow with the number of runs times the number of nodes.
+ * Runs can be added concurrently and in any order.
+ */
+class EnsembleStatistics
+{
+public:
+    /**
+     * @brief create an empty collection.
+     * @param ids ids of the nodes.
+     * @param num_groups number of age groups of the models in the nodes.
+     * @param num_runs number of runs in the ensemble.
+     */
+    EnsembleStatistics(const std::vector<int>& ids, int num_groups, size_t num_runs);
+
+    /**
+     * @brief add the parameters of one run.
+     * Thread safe.
+     * @param run_idx index of the run in [0, num_runs).
+     * @param params values of the sampled parameters of each node, see get_percentile_params.
+     */
+    void add_run(size_t run_idx, std::vector<std::vector<double>> params);
+
+    /**
+     * @brief save the percentiles of the results and parameters.
+     * Creates one subdirectory per percentile, e.g. "p05" for the 5% percentile,
+     * that contains the files "Results.h5" with the results of each node, "Results_sum.h5"
+     * with the results summed over all nodes, and the parameters of each node in a graph without edges.
+     * All runs must have been added and written to the files.
+     * @param runs_filename file with the results of each node of all runs, see ResultEnsembleWriter.
+     * @param runs_sum_filename file with the results of all runs summed over all nodes, stored with id 0.
+     * @param result_dir directory for the percentiles.
+     * @param percentiles percentiles to store, each in the open interval (0, 1).
+     * @return any io errors that occur during reading or writing of the files.
+     */
+    IOResult<void> save_percentiles(const std::string& runs_filename, const std::string& runs_sum_filename,
+                                    const std::string& result_dir, const std::vector<double>& percentiles) const;
+
+private:
+    std::vector<int> m_ids;
+    int m_num_groups;
+    std::vector<std::vector<std::vector<double>>> m_params;
+    size_t m_num_added;
+    mutable std::mutex m_mutex;
+};
+
+/**
+ * @brief run an ensemble of simulations with parameters sampled from the input graph.
+ * The runs are computed in parallel. Each run is simulated, interpolated to days, and handed to
+ * the statistics and a background writer as soon as it is completed.
+ * If a run fails, the remaining runs are not computed and the error is returned.
+ * Writes the following files to the result directory:
+ * - "Results_runs.h5" with the interpolated results of each node of all runs, see ResultEnsembleWriter.
+ * - "Results_runs_sum.h5" with the results of all runs summed over all nodes, stored with id 0.
+ * - the percentiles of results and parameters, see EnsembleStatistics::save_percentiles.
+ * @param graph input graph with distributions of the parameters in each node.
+ * @param options options of the ensemble.
+ * @param result_dir directory for the results, must exist.
+ * @return any io errors that occur during writing of the files.
+ */
+IOResult<void> run_ensemble(const Graph<SecirModel, MigrationParameters>& graph, const EnsembleOptions& options,
+                            const std::string& result_dir);
+
+} // namespace mio
+
+#endif // MEMILIO_HAS_HDF5 && MEMILIO_HAS_JSONCPP
+
+#endif // EPI_SECIR_ENSEMBLE_PIPELINE_H
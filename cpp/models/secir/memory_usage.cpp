@@ -0,0 +1,147 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "secir/memory_usage.h"
+#include "memilio/utils/parameter_distributions.h"
+
+namespace mio
+{
+
+namespace
+{
+
+//size of the concrete type of a distribution
+struct DistributionSizeVisitor : ConstParameterDistributionVisitor {
+    void visit(const ParameterDistributionNormal& dist) override
+    {
+        size = sizeof(dist);
+    }
+    void visit(const ParameterDistributionUniform& dist) override
+    {
+        size = sizeof(dist);
+    }
+    size_t size = 0;
+};
+
+size_t get_distribution_memory(const UncertainValue& value)
+{
+    auto dist = value.get_distribution();
+    if (!dist) {
+        return 0;
+    }
+    DistributionSizeVisitor visitor;
+    dist->accept(visitor);
+    return visitor.size + dist->get_predefined_samples().capacity() * sizeof(double);
+}
+
+size_t get_distribution_memory(const DampingSampling& damping)
+{
+    return get_distribution_memory(damping.get_value()) +
+           damping.get_matrix_indices().capacity() * sizeof(size_t) +
+           size_t(damping.get_group_weights().size()) * sizeof(double);
+}
+
+size_t get_distribution_memory(const std::vector<DampingSampling>& dampings)
+{
+    auto size = dampings.capacity() * sizeof(DampingSampling);
+    for (auto& d : dampings) {
+        size += get_distribution_memory(d);
+    }
+    return size;
+}
+
+//memory of a matrix that is shared by use_count objects
+template <class M>
+size_t get_shared_memory(const M& matrix, long use_count)
+{
+    return (sizeof(M) + size_t(matrix.size()) * sizeof(typename M::Scalar)) / size_t(std::max(use_count, 1l));
+}
+
+void add_memory_usage(const UncertainValue& value, ModelMemoryUsage& usage)
+{
+    usage.distributions += get_distribution_memory(value);
+}
+
+template <class... Tags>
+void add_memory_usage(const CustomIndexArray<UncertainValue, Tags...>& values, ModelMemoryUsage& usage)
+{
+    usage.parameters += values.numel() * sizeof(UncertainValue);
+    for (auto& v : values) {
+        usage.distributions += get_distribution_memory(v);
+    }
+}
+
+void add_memory_usage(const UncertainContactMatrix& contacts, ModelMemoryUsage& usage)
+{
+    auto& matrices = contacts.get_cont_freq_mat();
+    usage.contacts += matrices.get_num_matrices() * sizeof(ContactMatrix);
+    for (size_t i = 0; i < matrices.get_num_matrices(); ++i) {
+        auto& matrix = matrices[i];
+        //baseline and minimum are stored behind shared pointers, the size of the object is already counted
+        usage.contacts += get_shared_memory(matrix.get_baseline(), matrix.get_baseline_use_count());
+        usage.contacts += get_shared_memory(matrix.get_minimum(), matrix.get_minimum_use_count());
+        for (auto& damping : matrix.get_dampings()) {
+            usage.contacts += sizeof(damping) + size_t(damping.get_coeffs().size()) * sizeof(double);
+        }
+    }
+    usage.contacts += contacts.get_school_holidays().capacity() * sizeof(contacts.get_school_holidays()[0]);
+    usage.distributions +=
+        get_distribution_memory(contacts.get_dampings()) + get_distribution_memory(contacts.get_school_holiday_damping());
+}
+
+void add_memory_usage(const DynamicNPIs& npis, ModelMemoryUsage& usage)
+{
+    for (auto&& threshold : npis.get_thresholds()) {
+        usage.distributions += sizeof(threshold) + get_distribution_memory(threshold.second);
+    }
+}
+
+template <class T>
+void add_memory_usage(const T&, ModelMemoryUsage&)
+{
+    //parameter without memory outside of the model object
+}
+
+} // namespace
+
+ModelMemoryUsage get_memory_usage(const SecirModel& model)
+{
+    ModelMemoryUsage usage;
+    usage.model = sizeof(model);
+    foreach (model.parameters, [&usage](auto& p, auto) {
+        add_memory_usage(p, usage);
+    });
+    usage.populations += model.populations.numel() * sizeof(UncertainValue);
+    for (auto& v : model.populations) {
+        usage.distributions += get_distribution_memory(v);
+    }
+    return usage;
+}
+
+std::vector<ModelMemoryUsage> get_memory_usage(const Graph<SecirModel, MigrationParameters>& graph)
+{
+    std::vector<ModelMemoryUsage> usage;
+    usage.reserve(graph.nodes().size());
+    for (auto& node : graph.nodes()) {
+        usage.push_back(get_memory_usage(node.property));
+    }
+    return usage;
+}
+
+} // namespace mio
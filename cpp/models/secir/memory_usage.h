@@ -0,0 +1,121 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef EPI_SECIR_MEMORY_USAGE_H
+#define EPI_SECIR_MEMORY_USAGE_H
+
+#include "secir/secir.h"
+#include "memilio/mobility/mobility.h"
+#include "memilio/mobility/graph.h"
+#include "memilio/utils/time_series.h"
+
+#include <vector>
+
+namespace mio
+{
+
+/**
+ * memory used by a model in bytes.
+ * Memory that is shared by multiple models, e.g. baselines of contact matrices (see DampingMatrixExpression),
+ * is divided evenly between the models that share it, so the memory of all models of a graph can be summed up.
+ * Small internal caches and the overhead of the allocator are not included.
+ */
+struct ModelMemoryUsage {
+    size_t model         = 0; ///< size of the model object itself.
+    size_t populations   = 0; ///< values of all compartments.
+    size_t parameters    = 0; ///< values of the parameters except contact patterns.
+    size_t contacts      = 0; ///< baselines, minimums and dampings of the contact matrices, school holidays.
+    size_t distributions = 0; ///< distributions of the parameters, damping samplings, dynamic NPIs.
+
+    /**
+     * total memory used by the model.
+     */
+    size_t total() const
+    {
+        return model + populations + parameters + contacts + distributions;
+    }
+};
+
+/**
+ * memory used by a node of a simulation graph in bytes.
+ */
+struct NodeMemoryUsage {
+    ModelMemoryUsage model; ///< model of the simulation in the node.
+    size_t simulation = 0; ///< simulation object, integrator, and state of the node without the result.
+    size_t result     = 0; ///< result of the simulation, including reserved time points.
+
+    /**
+     * total memory used by the node.
+     */
+    size_t total() const
+    {
+        return model.total() + simulation + result;
+    }
+};
+
+/**
+ * @brief get the memory used by a model.
+ * @param model a model.
+ * @return memory used by the model.
+ */
+ModelMemoryUsage get_memory_usage(const SecirModel& model);
+
+/**
+ * @brief get the memory used by a time series.
+ * @param ts a time series.
+ * @return memory used by the values of the time series, including reserved time points.
+ */
+template <class FP>
+size_t get_memory_usage(const TimeSeries<FP>& ts)
+{
+    return size_t(ts.get_num_rows() * ts.get_capacity()) * sizeof(FP);
+}
+
+/**
+ * @brief get the memory used by each node of a graph of models.
+ * @param graph a graph of models, e.g. the input of a parameter study.
+ * @return memory used by each node.
+ */
+std::vector<ModelMemoryUsage> get_memory_usage(const Graph<SecirModel, MigrationParameters>& graph);
+
+/**
+ * @brief get the memory used by each node of a graph of simulations.
+ * @param graph a graph of simulations, e.g. a result of a parameter study.
+ * @return memory used by each node.
+ */
+template <class Sim>
+std::vector<NodeMemoryUsage> get_memory_usage(const Graph<SimulationNode<Sim>, MigrationEdge>& graph)
+{
+    std::vector<NodeMemoryUsage> usage;
+    usage.reserve(graph.nodes().size());
+    for (auto& node : graph.nodes()) {
+        auto& sim = node.property.get_simulation();
+        NodeMemoryUsage node_usage;
+        node_usage.model  = get_memory_usage(sim.get_model());
+        node_usage.result = get_memory_usage(sim.get_result());
+        node_usage.simulation =
+            sizeof(node.property) + size_t(node.property.get_last_state().size()) * sizeof(double);
+        usage.push_back(node_usage);
+    }
+    return usage;
+}
+
+} // namespace mio
+
+#endif // EPI_SECIR_MEMORY_USAGE_H
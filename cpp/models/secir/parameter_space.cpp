@@ -150,6 +150,91 @@ void draw_sample_infection(SecirModel& model)
     }
 }
 
+namespace
+{
+void remove_distributions(UncertainValue& value)
+{
+    value.remove_distribution();
+}
+
+template <class... Tags>
+void remove_distributions(CustomIndexArray<UncertainValue, Tags...>& values)
+{
+    for (auto& v : values) {
+        v.remove_distribution();
+    }
+}
+
+void remove_distributions(UncertainContactMatrix& contacts)
+{
+    //sampled dampings are already applied to the contact matrices, holidays are only used for sampling
+    std::vector<DampingSampling>().swap(contacts.get_dampings());
+    std::vector<std::pair<SimulationTime, SimulationTime>>().swap(contacts.get_school_holidays());
+    contacts.get_school_holiday_damping() =
+        DampingSampling(0.0, DampingLevel(0), DampingType(0), SimulationTime(0), {}, Eigen::VectorXd());
+}
+
+void remove_distributions(DynamicNPIs& npis)
+{
+    for (auto&& threshold : npis.get_thresholds()) {
+        for (auto& npi : threshold.second) {
+            npi.get_value().remove_distribution();
+        }
+    }
+}
+
+template <class T>
+void remove_distributions(T&)
+{
+    //parameter without distributions
+}
+} // namespace
+
+void freeze(SecirModel& model)
+{
+    foreach (model.parameters, [](auto& p, auto) {
+        remove_distributions(p);
+    });
+    for (auto& v : model.populations) {
+        v.remove_distribution();
+    }
+}
+
+void freeze(Graph<SecirModel, MigrationParameters>& graph)
+{
+    for (auto& node : graph.nodes()) {
+        freeze(node.property);
+    }
+    for (auto& edge : graph.edges()) {
+        remove_distributions(edge.property.get_dynamic_npis_infected());
+    }
+    share_contact_patterns(graph);
+}
+
+void share_contact_patterns(Graph<SecirModel, MigrationParameters>& graph)
+{
+    for (size_t i = 0; i < graph.nodes().size(); ++i) {
+        auto& contacts = graph.nodes()[i].property.parameters.get<ContactPatterns>().get_cont_freq_mat();
+        for (auto& matrix : contacts) {
+            matrix.share_baseline_and_minimum();
+        }
+        //compare with all previous nodes in case there are groups of nodes with different contacts
+        for (size_t j = 0; j < i; ++j) {
+            auto& other_contacts = graph.nodes()[j].property.parameters.get<ContactPatterns>().get_cont_freq_mat();
+            if (other_contacts.get_num_matrices() != contacts.get_num_matrices()) {
+                continue;
+            }
+            auto shared = true;
+            for (size_t k = 0; k < contacts.get_num_matrices(); ++k) {
+                shared &= contacts[k].share_baseline_and_minimum(other_contacts[k]);
+            }
+            if (shared) {
+                break;
+            }
+        }
+    }
+}
+
 void draw_sample(SecirModel& model)
 {
     draw_sample_infection(model);
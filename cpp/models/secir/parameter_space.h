@@ -24,6 +24,7 @@
 #include "memilio/utils/logging.h"
 #include "memilio/utils/parameter_distributions.h"
 #include "secir/secir.h"
+#include "memilio/mobility/mobility.h"
 
 #include <assert.h>
 #include <string>
@@ -62,6 +63,35 @@ void draw_sample_infection(SecirModel& model);
 */
 void draw_sample(SecirModel& model);
 
+/**
+ * removes all distributions from the model, e.g. after sampling.
+ * Removes the distributions of all parameters and populations, the damping samplings and school holidays of the 
+ * contact patterns (the sampled dampings remain in the contact matrices), and the distributions of dynamic NPIs.
+ * The values are unchanged, so the model can still be simulated, but not sampled again.
+ * Reduces the memory used by the model, e.g. to store the sampled parameters of many runs.
+ * @param[inout] model SecirModel to freeze.
+ */
+void freeze(SecirModel& model);
+
+/**
+ * removes all distributions from all nodes and edges of a graph and shares equal contact patterns between nodes.
+ * @see freeze(SecirModel&)
+ * @see share_contact_patterns
+ * @param[inout] graph graph to freeze.
+ */
+void freeze(Graph<SecirModel, MigrationParameters>& graph);
+
+/**
+ * shares the baselines and minimums of contact matrices between all nodes of a graph where they are equal.
+ * Contact patterns are usually the same in all nodes, but nodes that are created independently, e.g. read
+ * from files, store a copy each. Sharing is enabled for the contact matrices of all nodes, so copies of the graph,
+ * e.g. in every run of a parameter study, share them as well. The matrices are copied again when they are
+ * modified in a node.
+ * @see DampingMatrixExpression::share_baseline_and_minimum
+ * @param[inout] graph graph whose nodes share the contact patterns.
+ */
+void share_contact_patterns(Graph<SecirModel, MigrationParameters>& graph);
+
 } // namespace mio
 
 #endif // PARAMETER_SPACE_H
@@ -25,8 +25,15 @@
 #include "memilio/utils/time_series.h"
 #include "memilio/mobility/mobility.h"
 #include "memilio/compartments/simulation.h"
+#include "memilio/utils/instrumentation.h"
+#include "memilio/io/io.h"
 
+#include <atomic>
 #include <cmath>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace mio
 {
@@ -113,15 +120,123 @@ public:
     template<class HandleSimulationResultFunction>
     void run(HandleSimulationResultFunction result_processing_function)
     {
+        MIO_SCOPED_TIMER("ParameterStudy::run");
         // Iterate over all parameters in the parameter space
         for (size_t i = 0; i < m_num_runs; i++) {
-            auto sim = create_sampled_simulation();
-            sim.advance(m_tmax);
-
+            auto sim = [this] {
+                MIO_SCOPED_TIMER("ParameterStudy::run sampling");
+                return create_sampled_simulation();
+            }();
+            {
+                MIO_SCOPED_TIMER("ParameterStudy::run simulation");
+                sim.advance(m_tmax);
+            }
+            MIO_SCOPED_TIMER("ParameterStudy::run result processing");
             result_processing_function(std::move(sim).get_graph());
         }
     }
 
+    /*
+     * @brief Carry out all simulations in the parameter study on multiple threads.
+     * The runs are distributed round robin, i.e. thread i computes the runs i, i + num_threads, ..., so the runs that
+     * are completed at the same time have similar indices, e.g., for writing them in order with an AsyncWriter.
+     * Each run samples from its own copy of the input graph, so the runs are independent of each other and the input
+     * graph of this study is not modified. Predefined samples of the parameter distributions are therefore used in
+     * every run instead of one per run as in run().
+     * If seeds are given, the random number generator of the thread is seeded with the seeds and the index of the run
+     * before each run, so the result of each run doesn't depend on the number of threads. The generator of the
+     * calling thread is restored afterwards.
+     * If a run or the processing of its result throws an exception, no more runs are started or processed and
+     * the exception is returned as an error after all threads are done.
+     * @param num_threads number of threads, including the calling thread.
+     * @param result_processing_function Processing function for simulation results, e.g., output function.
+     *                                   Receives the result and the index of the run after each run is completed.
+     *                                   Called concurrently from all threads, but in increasing order of run indices
+     *                                   on each thread.
+     * @param seeds seeds of the random number generator, random seeds are used if empty.
+     * @param error_handling_function Called once with the error as soon as the first run fails, while the other
+     *                                threads may still be running, e.g., to cancel an AsyncWriter.
+     * @return the error of the first failed run, if any.
+     * @{
+     */
+    template <class HandleSimulationResultFunction, class HandleErrorFunction>
+    IOResult<void> run_parallel(int num_threads, HandleSimulationResultFunction result_processing_function,
+                                const std::vector<unsigned int>& seeds,
+                                HandleErrorFunction error_handling_function) const
+    {
+        MIO_SCOPED_TIMER("ParameterStudy::run_parallel");
+        assert(num_threads > 0);
+        std::atomic<bool> is_failed{false};
+        std::mutex error_mutex;
+        IOResult<void> status = success();
+        auto set_error        = [&](const std::string& msg) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!is_failed) {
+                is_failed = true;
+                status    = failure(StatusCode::UnknownError, msg);
+                error_handling_function(status.error());
+            }
+        };
+        auto run_thread = [&, this](int thread_idx) {
+            try {
+                for (auto i = size_t(thread_idx); i < m_num_runs && !is_failed; i += size_t(num_threads)) {
+                    //sampling modifies the distributions (e.g. cached normal samples),
+                    //so each run starts from a copy of the input graph
+                    auto graph = m_graph;
+                    if (!seeds.empty()) {
+                        auto run_seeds = seeds;
+                        run_seeds.push_back(static_cast<unsigned int>(i));
+                        thread_local_rng().seed(run_seeds);
+                    }
+                    auto sim = [&graph, this] {
+                        MIO_SCOPED_TIMER("ParameterStudy::run sampling");
+                        return create_sampled_simulation(graph);
+                    }();
+                    {
+                        MIO_SCOPED_TIMER("ParameterStudy::run simulation");
+                        sim.advance(m_tmax);
+                    }
+                    if (is_failed) {
+                        break;
+                    }
+                    MIO_SCOPED_TIMER("ParameterStudy::run result processing");
+                    result_processing_function(std::move(sim).get_graph(), i);
+                }
+            }
+            catch (const std::exception& e) {
+                set_error(e.what());
+            }
+            catch (...) {
+                set_error("Unknown exception in run of parameter study.");
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(size_t(num_threads - 1));
+        for (int thread_idx = 1; thread_idx < num_threads; ++thread_idx) {
+            threads.emplace_back(run_thread, thread_idx);
+        }
+        {
+            //the calling thread is reseeded for its runs, it continues with its own state afterwards
+            auto caller_rng = thread_local_rng();
+            run_thread(0);
+            if (!seeds.empty()) {
+                thread_local_rng() = caller_rng;
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return status;
+    }
+
+    template <class HandleSimulationResultFunction>
+    IOResult<void> run_parallel(int num_threads, HandleSimulationResultFunction result_processing_function,
+                                const std::vector<unsigned int>& seeds = {}) const
+    {
+        return run_parallel(num_threads, result_processing_function, seeds, [](auto&&) {});
+    }
+    /** @} */
+
     /*
      * @brief Carry out all simulations in the parameter study.
      * Convinience function for a few number of runs, but uses a lot of memory.
@@ -220,18 +335,25 @@ public:
 private:
     //sample parameters and create simulation
     mio::GraphSimulation<mio::Graph<mio::SimulationNode<Simulation>, mio::MigrationEdge>> create_sampled_simulation()
+    {
+        return create_sampled_simulation(m_graph);
+    }
+
+    //sample parameters of a graph, e.g. a copy of the input graph, and create simulation
+    mio::GraphSimulation<mio::Graph<mio::SimulationNode<Simulation>, mio::MigrationEdge>>
+    create_sampled_simulation(mio::Graph<typename Simulation::Model, mio::MigrationParameters>& graph) const
     {
         mio::Graph<mio::SimulationNode<Simulation>, mio::MigrationEdge> sim_graph;
 
         //sample global parameters
-        auto& shared_params_model = m_graph.nodes()[0].property;
+        auto& shared_params_model = graph.nodes()[0].property;
         draw_sample_infection(shared_params_model);
         auto& shared_contacts = shared_params_model.parameters.template get<mio::ContactPatterns>();
         shared_contacts.draw_sample_dampings();
         auto& shared_dynamic_npis = shared_params_model.parameters.template get<DynamicNPIsInfected>();
         shared_dynamic_npis.draw_sample();
 
-        for (auto& params_node : m_graph.nodes()) {
+        for (auto& params_node : graph.nodes()) {
             auto& node_model = params_node.property;
 
             //sample local parameters
@@ -253,7 +375,7 @@ private:
             sim_graph.add_node(params_node.id, node_model, m_t0, m_dt_integration);
         }
 
-        for (auto& edge : m_graph.edges()) {
+        for (auto& edge : graph.edges()) {
             auto edge_params = edge.property;
             apply_dampings(edge_params.get_coefficients(), shared_contacts.get_dampings(), [&edge_params](auto& v) {
                 return make_migration_damping_vector(edge_params.get_coefficients().get_shape(), v);
@@ -435,6 +435,37 @@ public:
         }
     }
 
+    /**
+     * @brief write the state of the simulation to a checkpoint.
+     * Includes the dampings of the contact patterns that are implemented by dynamic NPIs during the simulation.
+     * @see CheckpointWriter
+     */
+    template <class Writer>
+    void write_checkpoint(Writer& writer) const
+    {
+        Base::write_checkpoint(writer);
+        writer.write(m_t_last_npi_check);
+        writer.write(m_dynamic_npi.first);
+        writer.write(m_dynamic_npi.second.get());
+        writer.write(this->get_model().parameters.template get<ContactPatterns>().get_cont_freq_mat());
+    }
+
+    /**
+     * @brief restore the state of the simulation from a checkpoint.
+     * @see CheckpointReader
+     */
+    template <class Reader>
+    IOResult<void> read_checkpoint(Reader& reader)
+    {
+        BOOST_OUTCOME_TRY(Base::read_checkpoint(reader));
+        BOOST_OUTCOME_TRY(reader.read(m_t_last_npi_check));
+        BOOST_OUTCOME_TRY(reader.read(m_dynamic_npi.first));
+        double t_npi_end;
+        BOOST_OUTCOME_TRY(reader.read(t_npi_end));
+        m_dynamic_npi.second = SimulationTime(t_npi_end);
+        return reader.read(this->get_model().parameters.template get<ContactPatterns>().get_cont_freq_mat());
+    }
+
 private:
     double m_t_last_npi_check;
     std::pair<double, SimulationTime> m_dynamic_npi = {-std::numeric_limits<double>::max(), mio::SimulationTime(0)};
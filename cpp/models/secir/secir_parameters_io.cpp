@@ -24,6 +24,7 @@
 
 #include "secir/secir_result_io.h"
 #include "memilio/io/io.h"
+#include "memilio/io/binary_cache.h"
 #include "memilio/utils/memory.h"
 #include "memilio/utils/uncertain_value.h"
 #include "memilio/utils/stl_util.h"
@@ -45,30 +46,14 @@
 #include <string>
 #include <random>
 #include <fstream>
+#include <unordered_map>
+#include <algorithm>
 
 namespace mio
 {
 
 namespace details
 {
-    IOResult<Date> get_max_date(const Json::Value& root)
-    {
-        Date max_date = Date(0, 1, 1);
-        for (unsigned int i = 0; i < root.size(); i++) {
-            auto js_date = root[i]["Date"];
-            if (!js_date.isString()) {
-                log_error("Date element must be a string.");
-                return failure(StatusCode::InvalidType, "Date element must be a string.");
-            }
-            auto date_temp = parse_date(js_date.asString());
-            if (date_temp > max_date) {
-                max_date = date_temp;
-            }
-        }
-
-        return success(max_date);
-    }
-
     void interpolate_ages(const std::vector<double>& age_ranges, std::vector<std::vector<double>>& interpolation,
                           std::vector<bool>& carry_over)
     {
@@ -123,8 +108,199 @@ namespace details
         carry_over.push_back(true);
     }
 
-    IOResult<void> read_rki_data(
-        std::string const& path, const std::string& id_name, std::vector<int> const& vregion, Date date,
+    CaseDataCube CaseDataCube::sum_regions(const std::vector<size_t>& region_map, size_t num_regions) const
+    {
+        assert(region_map.size() == m_num_regions);
+        CaseDataCube summed(m_first_date, m_num_days, m_num_columns, num_regions, m_num_age_groups);
+        for (size_t column = 0; column < m_num_columns; ++column) {
+            for (size_t region_idx = 0; region_idx < m_num_regions; ++region_idx) {
+                if (region_map[region_idx] >= num_regions) {
+                    continue;
+                }
+                for (size_t age = 0; age < m_num_age_groups; ++age) {
+                    auto src = m_values.data() + get_flat_index(column, region_idx, age, 0);
+                    auto dst = summed.m_values.data() + summed.get_flat_index(column, region_map[region_idx], age, 0);
+                    for (int day = 0; day < m_num_days; ++day) {
+                        dst[day] += src[day];
+                    }
+                }
+            }
+        }
+        return summed;
+    }
+
+    void CaseDataCube::write_checkpoint(CheckpointWriter& writer) const
+    {
+        writer.write(m_first_date);
+        writer.write(int64_t(m_num_days));
+        writer.write(uint64_t(m_num_columns));
+        writer.write(uint64_t(m_num_regions));
+        writer.write(uint64_t(m_num_age_groups));
+        writer.write(m_values);
+    }
+
+    IOResult<void> CaseDataCube::read_checkpoint(CheckpointReader& reader)
+    {
+        int64_t num_days;
+        uint64_t num_columns, num_regions, num_age_groups;
+        BOOST_OUTCOME_TRY(reader.read(m_first_date));
+        BOOST_OUTCOME_TRY(reader.read(num_days));
+        BOOST_OUTCOME_TRY(reader.read(num_columns));
+        BOOST_OUTCOME_TRY(reader.read(num_regions));
+        BOOST_OUTCOME_TRY(reader.read(num_age_groups));
+        BOOST_OUTCOME_TRY(reader.read(m_values));
+        if (num_days < 0 || m_values.size() != num_columns * num_regions * num_age_groups * uint64_t(num_days)) {
+            return failure(StatusCode::InvalidFileFormat, "Invalid size of case data in cache.");
+        }
+        m_num_days       = int(num_days);
+        m_num_columns    = size_t(num_columns);
+        m_num_regions    = size_t(num_regions);
+        m_num_age_groups = size_t(num_age_groups);
+        return success();
+    }
+
+    namespace
+    {
+        /**
+         * @brief reads the json file into a cube with one region for each key in the file.
+         */
+        IOResult<RegionCaseData> read_case_data_file(const std::string& path, const std::string& id_name,
+                                                     const std::string& age_name,
+                                                     const std::vector<std::string>& age_names,
+                                                     const std::vector<std::string>& column_names)
+        {
+            if (!boost::filesystem::exists(path)) {
+                log_error("Case data file not found: {}.", path);
+                return failure(StatusCode::FileNotFound, path);
+            }
+
+            Json::Reader reader;
+            Json::Value root;
+
+            std::ifstream file(path);
+            if (!reader.parse(file, root)) {
+                log_error(reader.getFormattedErrorMessages());
+                return failure(StatusCode::UnknownError, path + ", " + reader.getFormattedErrorMessages());
+            }
+            if (root.size() == 0) {
+                log_error("Case data file is empty.");
+                return failure(StatusCode::InvalidFileFormat, path + ", file is empty.");
+            }
+
+            //first pass: dates and regions of all entries, consecutive entries usually have the same date
+            RegionCaseData result;
+            std::unordered_map<int, size_t> region_idx_by_id;
+            std::vector<size_t> region_indices(root.size());
+            std::vector<Date> dates(root.size());
+            std::string prev_date_str;
+            Date prev_date;
+            for (unsigned int i = 0; i < root.size(); i++) {
+                auto& js_date = root[i]["Date"];
+                if (!js_date.isString()) {
+                    log_error("Date element must be a string.");
+                    return failure(StatusCode::InvalidType, "Date element must be a string.");
+                }
+                auto date_str = js_date.asString();
+                if (date_str != prev_date_str) {
+                    prev_date     = parse_date(date_str);
+                    prev_date_str = std::move(date_str);
+                }
+                dates[i] = prev_date;
+
+                auto id           = root[i][id_name].asInt();
+                auto inserted     = region_idx_by_id.emplace(id, result.region_ids.size());
+                region_indices[i] = inserted.first->second;
+                if (inserted.second) {
+                    result.region_ids.push_back(id);
+                }
+            }
+            auto minmax_date = std::minmax_element(dates.begin(), dates.end());
+            auto first_date  = *minmax_date.first;
+            auto num_days    = get_offset_in_days(*minmax_date.second, first_date) + 1;
+
+            auto num_age_groups = age_name.empty() ? size_t(1) : age_names.size();
+            result.data =
+                CaseDataCube(first_date, num_days, column_names.size(), result.region_ids.size(), num_age_groups);
+
+            //second pass: values
+            for (unsigned int i = 0; i < root.size(); i++) {
+                auto& entry = root[i];
+                size_t age  = 0;
+                if (!age_name.empty()) {
+                    age = size_t(std::find(age_names.begin(), age_names.end(), entry[age_name].asString()) -
+                                 age_names.begin());
+                    if (age == age_names.size()) {
+                        continue;
+                    }
+                }
+
+                auto day = get_offset_in_days(dates[i], first_date);
+                for (size_t column = 0; column < column_names.size(); ++column) {
+                    result.data.add_value(column, region_indices[i], age, day,
+                                          entry[column_names[column]].asDouble());
+                }
+            }
+
+            return success(std::move(result));
+        }
+    } // namespace
+
+    IOResult<RegionCaseData> read_case_data_all_regions(const std::string& path, const std::string& id_name,
+                                                        const std::string& age_name,
+                                                        const std::vector<std::string>& age_names,
+                                                        const std::vector<std::string>& column_names,
+                                                        const std::string& cache_dir)
+    {
+        auto config = std::vector<std::string>{"case_data", id_name, age_name};
+        config.insert(config.end(), age_names.begin(), age_names.end());
+        config.insert(config.end(), column_names.begin(), column_names.end());
+        return read_cached<RegionCaseData>(path, cache_dir, config, [&]() {
+            return read_case_data_file(path, id_name, age_name, age_names, column_names);
+        });
+    }
+
+    IOResult<CaseDataCube> read_case_data(const std::string& path, const std::string& id_name,
+                                          const std::vector<int>& vregion, const std::string& age_name,
+                                          const std::vector<std::string>& age_names,
+                                          const std::vector<std::string>& column_names, const std::string& cache_dir)
+    {
+        BOOST_OUTCOME_TRY(all_regions,
+                          read_case_data_all_regions(path, id_name, age_name, age_names, column_names, cache_dir));
+
+        //region key 0 matches every entry, otherwise the first matching key is used
+        auto zero_idx = size_t(std::find(vregion.begin(), vregion.end(), 0) - vregion.begin());
+        std::unordered_map<int, size_t> region_idx_by_id;
+        for (size_t region_idx = 0; region_idx < zero_idx; ++region_idx) {
+            region_idx_by_id.emplace(vregion[region_idx], region_idx);
+        }
+        std::vector<size_t> region_map(all_regions.region_ids.size(), zero_idx);
+        for (size_t i = 0; i < all_regions.region_ids.size(); ++i) {
+            auto it = region_idx_by_id.find(all_regions.region_ids[i]);
+            if (it != region_idx_by_id.end()) {
+                region_map[i] = std::min(zero_idx, it->second);
+            }
+        }
+
+        return success(all_regions.data.sum_regions(region_map, vregion.size()));
+    }
+
+    IOResult<CaseDataCube> read_rki_data(const std::string& path, const std::string& id_name,
+                                         const std::vector<int>& vregion, const std::string& cache_dir)
+    {
+        //the age group "unknown" is ignored
+        return read_case_data(path, id_name, vregion, "Age_RKI",
+                              {"A00-A04", "A05-A14", "A15-A34", "A35-A59", "A60-A79", "A80+"},
+                              {"Confirmed", "Deaths"}, cache_dir);
+    }
+
+    IOResult<CaseDataCube> read_divi_data(const std::string& path, const std::string& id_name,
+                                          const std::vector<int>& vregion, const std::string& cache_dir)
+    {
+        return read_case_data(path, id_name, vregion, "", {}, {"ICU"}, cache_dir);
+    }
+
+    IOResult<void> compute_rki_data(
+        const CaseDataCube& rki_data, std::vector<int> const& vregion, Date date,
         std::vector<std::vector<double>>& vnum_exp, std::vector<std::vector<double>>& vnum_car,
         std::vector<std::vector<double>>& vnum_inf, std::vector<std::vector<double>>& vnum_hosp,
         std::vector<std::vector<double>>& vnum_icu, std::vector<std::vector<double>>& vnum_death,
@@ -136,28 +312,10 @@ namespace details
         const std::vector<std::vector<double>>& vmu_I_H, const std::vector<std::vector<double>>& vmu_H_U,
         const std::vector<double>& scaling_factor_inf)
     {
-        if (!boost::filesystem::exists(path)) {
-            log_error("RKI data file not found: {}.", path);
-            return failure(StatusCode::FileNotFound, path);
-        }
-
-        Json::Reader reader;
-        Json::Value root;
-
-        std::ifstream rki(path);
-        if (!reader.parse(rki, root)) {
-            log_error(reader.getFormattedErrorMessages());
-            return failure(StatusCode::UnknownError, path + ", " + reader.getFormattedErrorMessages());
-        }
-
-        BOOST_OUTCOME_TRY(max_date, get_max_date(root));
-        if (max_date == Date(0, 1, 1)) {
-            log_error("RKI data file is empty.");
-            return failure(StatusCode::InvalidFileFormat, path + ", file is empty.");
-        }
+        auto max_date = rki_data.get_last_date();
         if (max_date < date) {
             log_error("Specified date does not exist in RKI data");
-            return failure(StatusCode::OutOfRange, path + ", specified date does not exist in RKI data.");
+            return failure(StatusCode::OutOfRange, "Specified date does not exist in RKI data.");
         }
         auto days_surplus = get_offset_in_days(max_date, date) - 6;
 
@@ -168,116 +326,70 @@ namespace details
         std::vector<std::string> age_names = {"A00-A04", "A05-A14", "A15-A34", "A35-A59", "A60-A79", "A80+", "unknown"};
         std::vector<double> age_ranges     = {5., 10., 20., 25., 20., 20.};
 
-        for (unsigned int i = 0; i < root.size(); i++) {
-            auto it = std::find_if(vregion.begin(), vregion.end(), [&root, i, &id_name](auto r) {
-                return r == 0 || root[i][id_name].asInt() == r;
-            });
-            if (it != vregion.end()) {
-                auto region_idx = size_t(it - vregion.begin());
-
-                auto& t_exp_to_car  = vt_exp_to_car[region_idx];
-                auto& t_car_to_rec  = vt_car_to_rec[region_idx];
-                auto& t_car_to_inf  = vt_car_to_inf[region_idx];
-                auto& t_inf_to_rec  = vt_inf_to_rec[region_idx];
-                auto& t_inf_to_hosp = vt_inf_to_hosp[region_idx];
-                auto& t_hosp_to_rec = vt_hosp_to_rec[region_idx];
-                auto& t_hosp_to_icu = vt_hosp_to_icu[region_idx];
-                auto& t_icu_to_dead = vt_icu_to_dead[region_idx];
-
-                auto& num_car   = vnum_car[region_idx];
-                auto& num_inf   = vnum_inf[region_idx];
-                auto& num_rec   = vnum_rec[region_idx];
-                auto& num_exp   = vnum_exp[region_idx];
-                auto& num_hosp  = vnum_hosp[region_idx];
-                auto& num_death = vnum_death[region_idx];
-                auto& num_icu   = vnum_icu[region_idx];
-
-                auto& mu_C_R = vmu_C_R[region_idx];
-                auto& mu_I_H = vmu_I_H[region_idx];
-                auto& mu_H_U = vmu_H_U[region_idx];
-
-                auto date_df = parse_date(root[i]["Date"].asString());
-
-                auto it_age = std::find(age_names.begin(), age_names.end() - 1, root[i]["Age_RKI"].asString());
-                if (it_age != age_names.end() - 1) {
-                    auto age = size_t(it_age - age_names.begin());
-
-                    bool read_icu = false; //params.populations.get({age, SecirCompartments::U}) == 0;
-
-                    if (date_df == offset_date_by_days(date, 0)) {
-                        num_inf[age] += (1 - mu_C_R[age]) * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                        num_rec[age] += root[i]["Confirmed"].asDouble();
-                    }
-                    if (date_df == offset_date_by_days(date, days_surplus)) {
-                        num_car[age] +=
-                            (2 * mu_C_R[age] - 1) * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                    }
-                    // -R9
-                    if (date_df == offset_date_by_days(date, -t_car_to_rec[age] + days_surplus)) {
-                        num_car[age] -= mu_C_R[age] * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                    }
-                    // +R2
-                    if (date_df == offset_date_by_days(date, +t_exp_to_car[age] + days_surplus)) {
-                        num_exp[age] += mu_C_R[age] * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                    }
-                    // +R3
-                    if (date_df == offset_date_by_days(date, +t_car_to_inf[age] + days_surplus)) {
-                        num_car[age] += (1 - mu_C_R[age]) * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                        num_exp[age] -= (1 - mu_C_R[age]) * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                    }
-                    // R2 - R9
-                    if (date_df == offset_date_by_days(date, t_exp_to_car[age] - t_car_to_rec[age] + days_surplus)) {
-                        num_exp[age] -= mu_C_R[age] * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                    }
-                    // R2 + R3
-                    if (date_df == offset_date_by_days(date, t_exp_to_car[age] + t_car_to_inf[age] + days_surplus)) {
-                        num_exp[age] += (1 - mu_C_R[age]) * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                    }
-                    // -R4
-                    if (date_df == offset_date_by_days(date, -t_inf_to_rec[age])) {
-                        num_inf[age] -= (1 - mu_C_R[age]) * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                    }
-                    // -R6
-                    if (date_df == offset_date_by_days(date, -t_inf_to_hosp[age])) {
-                        num_inf[age] -= mu_I_H[age] * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                        num_hosp[age] += mu_I_H[age] * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                    }
-                    // -R6 - R7
-                    if (date_df == offset_date_by_days(date, -t_inf_to_hosp[age] - t_hosp_to_icu[age])) {
-                        num_inf[age] +=
-                            mu_I_H[age] * mu_H_U[age] * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                        num_hosp[age] -=
-                            mu_I_H[age] * mu_H_U[age] * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                        if (read_icu) {
-                            num_icu[age] +=
-                                mu_H_U[age] * mu_I_H[age] * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                        }
-                    }
-                    // -R6 - R5
-                    if (date_df == offset_date_by_days(date, -t_inf_to_hosp[age] - t_hosp_to_rec[age])) {
-                        num_inf[age] +=
-                            mu_I_H[age] * (1 - mu_H_U[age]) * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                        num_hosp[age] -=
-                            mu_I_H[age] * (1 - mu_H_U[age]) * scaling_factor_inf[age] * root[i]["Confirmed"].asDouble();
-                    }
-                    // -R10 - R6 - R7
-                    if (date_df ==
-                        offset_date_by_days(date, -t_icu_to_dead[age] - t_inf_to_hosp[age] - t_hosp_to_icu[age])) {
-                        num_death[age] += root[i]["Deaths"].asDouble();
-                    }
-                    if (read_icu) {
-                        // -R6 - R7 - R7
-                        if (date_df == offset_date_by_days(date, -t_inf_to_hosp[age] - 2 * t_hosp_to_icu[age])) {
-                            num_icu[age] -= mu_I_H[age] * mu_H_U[age] * mu_H_U[age] * scaling_factor_inf[age] *
-                                            root[i]["Confirmed"].asDouble();
-                        }
-                        // -R6 - R5 - R7
-                        if (date_df == offset_date_by_days(date, -t_inf_to_hosp[age] - t_hosp_to_icu[age])) {
-                            num_icu[age] -= mu_I_H[age] * mu_H_U[age] * (1 - mu_H_U[age]) * scaling_factor_inf[age] *
-                                            root[i]["Confirmed"].asDouble();
-                        }
-                    }
-                }
+        //all dates are offsets in days from the first date of the data
+        auto date_idx = get_offset_in_days(date, rki_data.get_first_date());
+
+        for (size_t region_idx = 0; region_idx < vregion.size(); ++region_idx) {
+            auto& t_exp_to_car  = vt_exp_to_car[region_idx];
+            auto& t_car_to_rec  = vt_car_to_rec[region_idx];
+            auto& t_car_to_inf  = vt_car_to_inf[region_idx];
+            auto& t_inf_to_rec  = vt_inf_to_rec[region_idx];
+            auto& t_inf_to_hosp = vt_inf_to_hosp[region_idx];
+            auto& t_hosp_to_rec = vt_hosp_to_rec[region_idx];
+            auto& t_hosp_to_icu = vt_hosp_to_icu[region_idx];
+            auto& t_icu_to_dead = vt_icu_to_dead[region_idx];
+
+            auto& num_car   = vnum_car[region_idx];
+            auto& num_inf   = vnum_inf[region_idx];
+            auto& num_rec   = vnum_rec[region_idx];
+            auto& num_exp   = vnum_exp[region_idx];
+            auto& num_hosp  = vnum_hosp[region_idx];
+            auto& num_death = vnum_death[region_idx];
+
+            auto& mu_C_R = vmu_C_R[region_idx];
+            auto& mu_I_H = vmu_I_H[region_idx];
+            auto& mu_H_U = vmu_H_U[region_idx];
+
+            for (size_t age = 0; age < rki_data.get_num_age_groups(); ++age) {
+                auto confirmed = [&rki_data, region_idx, age, date_idx](int offset_days) {
+                    return rki_data.get_value(0, region_idx, age, date_idx + offset_days);
+                };
+                auto deaths = [&rki_data, region_idx, age, date_idx](int offset_days) {
+                    return rki_data.get_value(1, region_idx, age, date_idx + offset_days);
+                };
+                auto scaling = scaling_factor_inf[age];
+
+                num_inf[age] += (1 - mu_C_R[age]) * scaling * confirmed(0);
+                num_rec[age] += confirmed(0);
+                num_car[age] += (2 * mu_C_R[age] - 1) * scaling * confirmed(days_surplus);
+                // -R9
+                num_car[age] -= mu_C_R[age] * scaling * confirmed(-t_car_to_rec[age] + days_surplus);
+                // +R2
+                num_exp[age] += mu_C_R[age] * scaling * confirmed(t_exp_to_car[age] + days_surplus);
+                // +R3
+                num_car[age] += (1 - mu_C_R[age]) * scaling * confirmed(t_car_to_inf[age] + days_surplus);
+                num_exp[age] -= (1 - mu_C_R[age]) * scaling * confirmed(t_car_to_inf[age] + days_surplus);
+                // R2 - R9
+                num_exp[age] -= mu_C_R[age] * scaling * confirmed(t_exp_to_car[age] - t_car_to_rec[age] + days_surplus);
+                // R2 + R3
+                num_exp[age] +=
+                    (1 - mu_C_R[age]) * scaling * confirmed(t_exp_to_car[age] + t_car_to_inf[age] + days_surplus);
+                // -R4
+                num_inf[age] -= (1 - mu_C_R[age]) * scaling * confirmed(-t_inf_to_rec[age]);
+                // -R6
+                num_inf[age] -= mu_I_H[age] * scaling * confirmed(-t_inf_to_hosp[age]);
+                num_hosp[age] += mu_I_H[age] * scaling * confirmed(-t_inf_to_hosp[age]);
+                // -R6 - R7
+                num_inf[age] += mu_I_H[age] * mu_H_U[age] * scaling * confirmed(-t_inf_to_hosp[age] - t_hosp_to_icu[age]);
+                num_hosp[age] -=
+                    mu_I_H[age] * mu_H_U[age] * scaling * confirmed(-t_inf_to_hosp[age] - t_hosp_to_icu[age]);
+                // -R6 - R5
+                num_inf[age] +=
+                    mu_I_H[age] * (1 - mu_H_U[age]) * scaling * confirmed(-t_inf_to_hosp[age] - t_hosp_to_rec[age]);
+                num_hosp[age] -=
+                    mu_I_H[age] * (1 - mu_H_U[age]) * scaling * confirmed(-t_inf_to_hosp[age] - t_hosp_to_rec[age]);
+                // -R10 - R6 - R7
+                num_death[age] += deaths(-t_icu_to_dead[age] - t_inf_to_hosp[age] - t_hosp_to_icu[age]);
             }
         }
 
@@ -322,8 +434,29 @@ namespace details
         return success();
     }
 
+    IOResult<void> read_rki_data(
+        std::string const& path, const std::string& id_name, std::vector<int> const& vregion, Date date,
+        std::vector<std::vector<double>>& vnum_exp, std::vector<std::vector<double>>& vnum_car,
+        std::vector<std::vector<double>>& vnum_inf, std::vector<std::vector<double>>& vnum_hosp,
+        std::vector<std::vector<double>>& vnum_icu, std::vector<std::vector<double>>& vnum_death,
+        std::vector<std::vector<double>>& vnum_rec, const std::vector<std::vector<int>>& vt_car_to_rec,
+        const std::vector<std::vector<int>>& vt_car_to_inf, const std::vector<std::vector<int>>& vt_exp_to_car,
+        const std::vector<std::vector<int>>& vt_inf_to_rec, const std::vector<std::vector<int>>& vt_inf_to_hosp,
+        const std::vector<std::vector<int>>& vt_hosp_to_rec, const std::vector<std::vector<int>>& vt_hosp_to_icu,
+        const std::vector<std::vector<int>>& vt_icu_to_dead, const std::vector<std::vector<double>>& vmu_C_R,
+        const std::vector<std::vector<double>>& vmu_I_H, const std::vector<std::vector<double>>& vmu_H_U,
+        const std::vector<double>& scaling_factor_inf)
+    {
+        BOOST_OUTCOME_TRY(rki_data, read_rki_data(path, id_name, vregion));
+        return compute_rki_data(rki_data, vregion, date, vnum_exp, vnum_car, vnum_inf, vnum_hosp, vnum_icu, vnum_death,
+                                vnum_rec, vt_car_to_rec, vt_car_to_inf, vt_exp_to_car, vt_inf_to_rec, vt_inf_to_hosp,
+                                vt_hosp_to_rec, vt_hosp_to_icu, vt_icu_to_dead, vmu_C_R, vmu_I_H, vmu_H_U,
+                                scaling_factor_inf);
+    }
+
     IOResult<void> set_rki_data(std::vector<SecirModel>& model, const std::string& path, const std::string& id_name,
-                      std::vector<int> const& region, Date date, const std::vector<double>& scaling_factor_inf)
+                                std::vector<int> const& region, Date date, const std::vector<double>& scaling_factor_inf,
+                                const std::string& cache_dir)
     {
 
         std::vector<double> age_ranges = {5., 10., 20., 25., 20., 20.};
@@ -378,10 +511,11 @@ namespace details
         std::vector<std::vector<double>> num_hosp(model.size(), std::vector<double>(age_ranges.size(), 0.0));
         std::vector<std::vector<double>> num_icu(model.size(), std::vector<double>(age_ranges.size(), 0.0));
 
-        BOOST_OUTCOME_TRY(read_rki_data(path, id_name, region, date, num_exp, num_car, num_inf, num_hosp, num_icu,
-                                        num_death, num_rec, t_car_to_rec, t_car_to_inf, t_exp_to_car, t_inf_to_rec,
-                                        t_inf_to_hosp, t_hosp_to_rec, t_hosp_to_icu, t_icu_to_dead, mu_C_R, mu_I_H,
-                                        mu_H_U, scaling_factor_inf));
+        BOOST_OUTCOME_TRY(rki_data, read_rki_data(path, id_name, region, cache_dir));
+        BOOST_OUTCOME_TRY(compute_rki_data(rki_data, region, date, num_exp, num_car, num_inf, num_hosp, num_icu,
+                                           num_death, num_rec, t_car_to_rec, t_car_to_inf, t_exp_to_car, t_inf_to_rec,
+                                           t_inf_to_hosp, t_hosp_to_rec, t_hosp_to_icu, t_icu_to_dead, mu_C_R, mu_I_H,
+                                           mu_H_U, scaling_factor_inf));
 
         for (size_t county = 0; county < model.size(); county++) {
             if (std::accumulate(num_inf[county].begin(), num_inf[county].end(), 0.0) > 0) {
@@ -410,86 +544,105 @@ namespace details
         return success();
     }
 
-    IOResult<void> read_divi_data(const std::string& path, const std::string& id_name, const std::vector<int>& vregion,
-                                  Date date, std::vector<double>& vnum_icu)
+    IOResult<void> compute_divi_data(const CaseDataCube& divi_data, Date date, std::vector<double>& vnum_icu)
     {
-        if (!boost::filesystem::exists(path)) {
-            log_error("DIVI data file not found: {}.", path);
-            return failure(StatusCode::FileNotFound, path);
-        }
-
-        Json::Reader reader;
-        Json::Value root;
-
-        std::ifstream divi(path);
-        if (!reader.parse(divi, root)) {
-            log_error(reader.getFormattedErrorMessages());
-            return failure(StatusCode::UnknownError, path + ", " + reader.getFormattedErrorMessages());
-        }
-
-        BOOST_OUTCOME_TRY(max_date, get_max_date(root));
-        if (max_date == Date(0, 1, 1)) {
-            log_error("DIVI data file is empty.");
-            return failure(StatusCode::InvalidFileFormat, path + ", file is empty.");
-        }
-        if (max_date < date) {
+        if (divi_data.get_last_date() < date) {
             log_error("Specified date does not exist in DIVI data.");
-            return failure(StatusCode::OutOfRange, path + ", specified date does not exist in DIVI data.");
+            return failure(StatusCode::OutOfRange, "Specified date does not exist in DIVI data.");
         }
 
-        for (unsigned int i = 0; i < root.size(); i++) {
-            auto it      = std::find_if(vregion.begin(), vregion.end(), [&root, i, &id_name](auto r) {
-                return r == 0 || r == root[i][id_name].asInt();
-            });
-            auto date_df = parse_date(root[i]["Date"].asString());
-            if (it != vregion.end() && date_df == date) {
-                auto region_idx = size_t(it - vregion.begin());
-                auto& num_icu   = vnum_icu[region_idx];
-                num_icu         = root[i]["ICU"].asDouble();
-            }
+        auto date_idx = get_offset_in_days(date, divi_data.get_first_date());
+        for (size_t region_idx = 0; region_idx < vnum_icu.size(); ++region_idx) {
+            vnum_icu[region_idx] = divi_data.get_value(0, region_idx, 0, date_idx);
         }
 
         return success();
     }
 
-    IOResult<std::vector<std::vector<double>>> read_population_data(const std::string& path, const std::string& id_name,
-                                                                    const std::vector<int>& vregion)
+    IOResult<void> read_divi_data(const std::string& path, const std::string& id_name, const std::vector<int>& vregion,
+                                  Date date, std::vector<double>& vnum_icu)
     {
-        if (!boost::filesystem::exists(path)) {
-            log_error("Population data file not found: {}.", path);
-            return failure(StatusCode::FileNotFound, path);
-        }
+        BOOST_OUTCOME_TRY(divi_data, read_divi_data(path, id_name, vregion));
+        return compute_divi_data(divi_data, date, vnum_icu);
+    }
+
+    namespace
+    {
+        const std::vector<std::string> population_age_names = {
+            "<3 years",    "3-5 years",   "6-14 years",  "15-17 years", "18-24 years", "25-29 years",
+            "30-39 years", "40-49 years", "50-64 years", "65-74 years", ">74 years"};
+
+        /**
+         * @brief reads the population of each region in the census data file.
+         * The data has no date, so the cube has only a single day.
+         */
+        IOResult<RegionCaseData> read_population_data_file(const std::string& path, const std::string& id_name)
+        {
+            if (!boost::filesystem::exists(path)) {
+                log_error("Population data file not found: {}.", path);
+                return failure(StatusCode::FileNotFound, path);
+            }
+
+            Json::Reader reader;
+            Json::Value root;
+
+            std::ifstream census(path);
+            if (!reader.parse(census, root)) {
+                log_error(reader.getFormattedErrorMessages());
+                return failure(StatusCode::UnknownError, path + ", " + reader.getFormattedErrorMessages());
+            }
 
-        Json::Reader reader;
-        Json::Value root;
+            RegionCaseData result;
+            std::unordered_map<int, size_t> region_idx_by_id;
+            std::vector<size_t> region_indices(root.size());
+            for (unsigned int i = 0; i < root.size(); i++) {
+                auto id           = (int)root[i][id_name].asDouble();
+                auto inserted     = region_idx_by_id.emplace(id, result.region_ids.size());
+                region_indices[i] = inserted.first->second;
+                if (inserted.second) {
+                    result.region_ids.push_back(id);
+                }
+            }
+
+            result.data = CaseDataCube(Date(0, 1, 1), 1, 1, result.region_ids.size(), population_age_names.size());
+            for (unsigned int i = 0; i < root.size(); i++) {
+                for (size_t age = 0; age < population_age_names.size(); age++) {
+                    result.data.add_value(0, region_indices[i], age, 0, root[i][population_age_names[age]].asDouble());
+                }
+            }
 
-        std::ifstream census(path);
-        if (!reader.parse(census, root)) {
-            log_error(reader.getFormattedErrorMessages());
-            return failure(StatusCode::UnknownError, path + ", " + reader.getFormattedErrorMessages());
+            return success(std::move(result));
         }
+    } // namespace
 
-        std::vector<std::string> age_names = {"<3 years",    "3-5 years",   "6-14 years",  "15-17 years",
-                                              "18-24 years", "25-29 years", "30-39 years", "40-49 years",
-                                              "50-64 years", "65-74 years", ">74 years"};
-        std::vector<double> age_ranges     = {3., 3., 9., 3., 7., 5., 10., 10., 15., 10., 25.};
+    IOResult<std::vector<std::vector<double>>> read_population_data(const std::string& path, const std::string& id_name,
+                                                                    const std::vector<int>& vregion,
+                                                                    const std::string& cache_dir)
+    {
+        BOOST_OUTCOME_TRY(population, read_cached<RegionCaseData>(path, cache_dir, {"population", id_name}, [&]() {
+                              return read_population_data_file(path, id_name);
+                          }));
+
+        auto& age_names                = population_age_names;
+        std::vector<double> age_ranges = {3., 3., 9., 3., 7., 5., 10., 10., 15., 10., 25.};
 
         std::vector<std::vector<double>> interpolation(age_names.size());
         std::vector<bool> carry_over;
 
         interpolate_ages(age_ranges, interpolation, carry_over);
 
+        //counties also match the key of their state
         std::vector<std::vector<double>> vnum_population(vregion.size(), std::vector<double>(age_names.size(), 0.0));
-
-        for (unsigned int i = 0; i < root.size(); i++) {
-            auto it = std::find_if(vregion.begin(), vregion.end(), [&root, i, &id_name](auto r) {
-                return r == 0 || (int)root[i][id_name].asDouble() / 1000 == r || root[i][id_name] == r;
+        for (size_t i = 0; i < population.region_ids.size(); ++i) {
+            auto id = population.region_ids[i];
+            auto it = std::find_if(vregion.begin(), vregion.end(), [id](auto r) {
+                return r == 0 || id / 1000 == r || id == r;
             });
             if (it != vregion.end()) {
                 auto region_idx      = size_t(it - vregion.begin());
                 auto& num_population = vnum_population[region_idx];
                 for (size_t age = 0; age < age_names.size(); age++) {
-                    num_population[age] += root[i][age_names[age]].asDouble();
+                    num_population[age] += population.data.get_value(0, i, age, 0);
                 }
             }
         }
@@ -514,9 +667,10 @@ namespace details
     }
 
     IOResult<void> set_population_data(std::vector<SecirModel>& model, const std::string& path,
-                                       const std::string& id_name, const std::vector<int>& vregion)
+                                       const std::string& id_name, const std::vector<int>& vregion,
+                                       const std::string& cache_dir)
     {
-        BOOST_OUTCOME_TRY(num_population, read_population_data(path, id_name, vregion));
+        BOOST_OUTCOME_TRY(num_population, read_population_data(path, id_name, vregion, cache_dir));
 
         for (size_t region = 0; region < vregion.size(); region++) {
             if (std::accumulate(num_population[region].begin(), num_population[region].end(), 0.0) > 0) {
@@ -536,7 +690,8 @@ namespace details
     }
 
     IOResult<void> set_divi_data(std::vector<SecirModel>& model, const std::string& path, const std::string& id_name,
-                                 const std::vector<int>& vregion, Date date, double scaling_factor_icu)
+                                 const std::vector<int>& vregion, Date date, double scaling_factor_icu,
+                                 const std::string& cache_dir)
     {
         std::vector<double> sum_mu_I_U(vregion.size(), 0);
         std::vector<std::vector<double>> mu_I_U{model.size()};
@@ -550,7 +705,8 @@ namespace details
             }
         }
         std::vector<double> num_icu(model.size(), 0.0);
-        BOOST_OUTCOME_TRY(read_divi_data(path, id_name, vregion, date, num_icu));
+        BOOST_OUTCOME_TRY(divi_data, read_divi_data(path, id_name, vregion, cache_dir));
+        BOOST_OUTCOME_TRY(compute_divi_data(divi_data, date, num_icu));
 
         for (size_t region = 0; region < vregion.size(); region++) {
             auto num_groups = model[region].parameters.get_num_groups();
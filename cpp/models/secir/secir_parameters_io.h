@@ -33,6 +33,7 @@
 #include "memilio/mobility/mobility.h"
 #include "memilio/io/io.h"
 #include "memilio/io/json_serializer.h"
+#include "memilio/io/checkpoint.h"
 #include "memilio/utils/date.h"
 
 namespace mio
@@ -169,6 +170,263 @@ namespace details
     void interpolate_ages(const std::vector<double>& age_ranges, std::vector<std::vector<double>>& interpolation,
                           std::vector<bool>& carry_over);
 
+    /**
+     * @brief daily case data of several regions and age groups.
+     * Stores one or more data columns (e.g. confirmed cases and deaths) for each region, age group and day in one
+     * contiguous array with the days as the innermost dimension. The cube covers all days from the earliest to the
+     * latest date in the file, so it can be evaluated for any date without reading the file again.
+     */
+    class CaseDataCube
+    {
+    public:
+        /**
+         * @brief create an empty cube, e.g. to read it from a cache.
+         */
+        CaseDataCube() = default;
+
+        /**
+         * @brief create a cube where all values are zero.
+         * @param first_date first date in the data.
+         * @param num_days number of days starting at first_date.
+         * @param num_columns number of data columns.
+         * @param num_regions number of regions.
+         * @param num_age_groups number of age groups.
+         */
+        CaseDataCube(Date first_date, int num_days, size_t num_columns, size_t num_regions, size_t num_age_groups)
+            : m_first_date(first_date)
+            , m_num_days(num_days)
+            , m_num_columns(num_columns)
+            , m_num_regions(num_regions)
+            , m_num_age_groups(num_age_groups)
+            , m_values(num_columns * num_regions * num_age_groups * size_t(num_days), 0.0)
+        {
+            assert(num_days > 0);
+        }
+
+        /**
+         * @brief first date in the data.
+         */
+        Date get_first_date() const
+        {
+            return m_first_date;
+        }
+
+        /**
+         * @brief last date in the data.
+         */
+        Date get_last_date() const
+        {
+            return offset_date_by_days(m_first_date, m_num_days - 1);
+        }
+
+        /**
+         * @brief number of days in the data.
+         */
+        int get_num_days() const
+        {
+            return m_num_days;
+        }
+
+        /**
+         * @brief number of regions in the data.
+         */
+        size_t get_num_regions() const
+        {
+            return m_num_regions;
+        }
+
+        /**
+         * @brief number of age groups in the data.
+         */
+        size_t get_num_age_groups() const
+        {
+            return m_num_age_groups;
+        }
+
+        /**
+         * @brief value of a data column for a region and age group on a day.
+         * @param column index of the data column.
+         * @param region_idx index of the region.
+         * @param age index of the age group.
+         * @param day offset in days from the first date, may be outside of the data.
+         * @return the value or zero if there is no data on this day.
+         */
+        double get_value(size_t column, size_t region_idx, size_t age, int day) const
+        {
+            if (day < 0 || day >= m_num_days) {
+                return 0.0;
+            }
+            return m_values[get_flat_index(column, region_idx, age, day)];
+        }
+
+        /**
+         * @brief add to the value of a data column for a region and age group on a day.
+         * @param column index of the data column.
+         * @param region_idx index of the region.
+         * @param age index of the age group.
+         * @param day offset in days from the first date, must be inside of the data.
+         * @param value value to add.
+         */
+        void add_value(size_t column, size_t region_idx, size_t age, int day, double value)
+        {
+            assert(day >= 0 && day < m_num_days);
+            m_values[get_flat_index(column, region_idx, age, day)] += value;
+        }
+
+        /**
+         * @brief the same data, but with the values of several regions summed up.
+         * @param region_map index of the new region for each region, may be num_regions to ignore a region.
+         * @param num_regions number of new regions.
+         */
+        CaseDataCube sum_regions(const std::vector<size_t>& region_map, size_t num_regions) const;
+
+        /**
+         * serialize the cube into a binary cache.
+         * @see CheckpointWriter
+         */
+        void write_checkpoint(CheckpointWriter& writer) const;
+
+        /**
+         * deserialize the cube from a binary cache.
+         * @see CheckpointReader
+         */
+        IOResult<void> read_checkpoint(CheckpointReader& reader);
+
+    private:
+        size_t get_flat_index(size_t column, size_t region_idx, size_t age, int day) const
+        {
+            return ((column * m_num_regions + region_idx) * m_num_age_groups + age) * size_t(m_num_days) + size_t(day);
+        }
+
+        Date m_first_date       = Date(0, 1, 1);
+        int m_num_days          = 0;
+        size_t m_num_columns    = 0;
+        size_t m_num_regions    = 0;
+        size_t m_num_age_groups = 0;
+        std::vector<double> m_values;
+    };
+
+    /**
+     * @brief the data of all regions in a file, before it is matched to the regions of interest.
+     */
+    struct RegionCaseData {
+        std::vector<int> region_ids; ///< key of each region in the cube, in the order of appearance in the file.
+        CaseDataCube data;
+
+        /**
+         * serialize into a binary cache.
+         * @see CheckpointWriter
+         */
+        template <class Writer>
+        void write_checkpoint(Writer& writer) const
+        {
+            writer.write(region_ids);
+            writer.write(data);
+        }
+
+        /**
+         * deserialize from a binary cache.
+         * @see CheckpointReader
+         */
+        template <class Reader>
+        IOResult<void> read_checkpoint(Reader& reader)
+        {
+            BOOST_OUTCOME_TRY(reader.read(region_ids));
+            BOOST_OUTCOME_TRY(reader.read(data));
+            if (data.get_num_regions() != region_ids.size()) {
+                return failure(StatusCode::InvalidFileFormat, "Invalid number of regions in case data cache.");
+            }
+            return success();
+        }
+    };
+
+    /**
+     * @brief reads a case data file with all regions.
+     * If a cache directory is specified, the data is read from a binary cache in that directory. The cache is
+     * created when the file is read the first time and is replaced when the content of the file changes.
+     * Caching is skipped with a warning if the cache can't be written.
+     * @param path Path to the file
+     * @param id_name Name of region key column
+     * @param age_name Name of the age group column, if empty, the data has a single age group
+     * @param age_names Names of the age groups; entries with other age groups are ignored
+     * @param column_names Names of the data columns
+     * @param cache_dir Directory of the binary cache, no cache is used if empty
+     */
+    IOResult<RegionCaseData> read_case_data_all_regions(const std::string& path, const std::string& id_name,
+                                                        const std::string& age_name,
+                                                        const std::vector<std::string>& age_names,
+                                                        const std::vector<std::string>& column_names,
+                                                        const std::string& cache_dir = "");
+
+    /**
+     * @brief reads a case data file once into a cube of regions, age groups and days.
+     * Entries of the same region, age group and day are summed up. Entries are matched to regions
+     * like in the other readers: the region key 0 matches all entries, so values of all regions are summed up.
+     * @param path Path to the file
+     * @param id_name Name of region key column
+     * @param vregion Keys of the regions of interest
+     * @param age_name Name of the age group column, if empty, the data has a single age group
+     * @param age_names Names of the age groups; entries with other age groups are ignored
+     * @param column_names Names of the data columns
+     * @param cache_dir Directory of the binary cache, no cache is used if empty; see read_case_data_all_regions
+     */
+    IOResult<CaseDataCube> read_case_data(const std::string& path, const std::string& id_name,
+                                          const std::vector<int>& vregion, const std::string& age_name,
+                                          const std::vector<std::string>& age_names,
+                                          const std::vector<std::string>& column_names,
+                                          const std::string& cache_dir = "");
+
+    /**
+     * @brief reads confirmed cases and deaths from RKI into a cube.
+     * Column 0 contains the confirmed cases, column 1 the deaths.
+     * @param path Path to RKI file
+     * @param id_name Name of region key column
+     * @param vregion Keys of the regions of interest
+     * @param cache_dir Directory of the binary cache, no cache is used if empty
+     */
+    IOResult<CaseDataCube> read_rki_data(const std::string& path, const std::string& id_name,
+                                         const std::vector<int>& vregion, const std::string& cache_dir = "");
+
+    /**
+     * @brief reads the number of ICU patients from DIVI register into a cube with a single age group.
+     * @param path Path to DIVI file
+     * @param id_name Name of region key column
+     * @param vregion Keys of the regions of interest
+     * @param cache_dir Directory of the binary cache, no cache is used if empty
+     */
+    IOResult<CaseDataCube> read_divi_data(const std::string& path, const std::string& id_name,
+                                          const std::vector<int>& vregion, const std::string& cache_dir = "");
+
+    /**
+     * @brief computes populations from RKI data that was already read.
+     * @param rki_data RKI data, see read_rki_data
+     * @param region vector of keys of the region of interest
+     * @param date Date at which the populations are computed
+     * @param num_* output vector for number of people in the corresponding compartement
+     * @param t_* vector average time it takes to get from one compartement to another for each age group
+     * @param mu_* vector probabilities to get from one compartement to another for each age group
+     */
+    IOResult<void> compute_rki_data(
+        const CaseDataCube& rki_data, std::vector<int> const& region, Date date,
+        std::vector<std::vector<double>>& num_exp, std::vector<std::vector<double>>& num_car,
+        std::vector<std::vector<double>>& num_inf, std::vector<std::vector<double>>& num_hosp,
+        std::vector<std::vector<double>>& num_icu, std::vector<std::vector<double>>& num_death,
+        std::vector<std::vector<double>>& num_rec, const std::vector<std::vector<int>>& t_car_to_rec,
+        const std::vector<std::vector<int>>& t_car_to_inf, const std::vector<std::vector<int>>& t_exp_to_car,
+        const std::vector<std::vector<int>>& t_inf_to_rec, const std::vector<std::vector<int>>& t_inf_to_hosp,
+        const std::vector<std::vector<int>>& t_hosp_to_rec, const std::vector<std::vector<int>>& t_hosp_to_icu,
+        const std::vector<std::vector<int>>& t_icu_to_dead, const std::vector<std::vector<double>>& mu_C_R,
+        const std::vector<std::vector<double>>& mu_I_H, const std::vector<std::vector<double>>& mu_H_U,
+        const std::vector<double>& scaling_factor_inf);
+
+    /**
+     * @brief gets the number of ICU patients from DIVI data that was already read.
+     * @param divi_data DIVI data, see read_divi_data
+     * @param date Date at which the data is read
+     * @param vnum_icu number of ICU patients
+     */
+    IOResult<void> compute_divi_data(const CaseDataCube& divi_data, Date date, std::vector<double>& vnum_icu);
+
     /**
      * @brief reads populations data from RKI
      * @param path Path to RKI file
@@ -206,9 +464,11 @@ namespace details
      * @param month Specifies month at which the data is read
      * @param day Specifies day at which the data is read
      * @param scaling_factor_inf factors by which to scale the confirmed cases of rki data
+     * @param cache_dir Directory of the binary cache, no cache is used if empty
      */
     IOResult<void> set_rki_data(std::vector<SecirModel>& model, const std::string& path, const std::string& id_name,
-                      std::vector<int> const& region, Date date, const std::vector<double>& scaling_factor_inf);
+                      std::vector<int> const& region, Date date, const std::vector<double>& scaling_factor_inf,
+                      const std::string& cache_dir = "");
 
     /**
      * @brief reads number of ICU patients from DIVI register into SecirParams
@@ -233,18 +493,22 @@ namespace details
      * @param month Specifies month at which the data is read
      * @param day Specifies day at which the data is read
      * @param scaling_factor_icu factor by which to scale the icu cases of divi data
+     * @param cache_dir Directory of the binary cache, no cache is used if empty
      */
     IOResult<void> set_divi_data(std::vector<SecirModel>& model, const std::string& path, const std::string& id_name,
-                       const std::vector<int>& vregion, Date date, double scaling_factor_icu);
+                       const std::vector<int>& vregion, Date date, double scaling_factor_icu,
+                       const std::string& cache_dir = "");
 
     /**
      * @brief reads population data from census data
      * @param path Path to RKI file
      * @param id_name Name of region key column
      * @param vregion vector of keys of the regions of interest
+     * @param cache_dir Directory of the binary cache, no cache is used if empty
      */
     IOResult<std::vector<std::vector<double>>> read_population_data(const std::string& path, const std::string& id_name,
-                                                          const std::vector<int>& vregion);
+                                                          const std::vector<int>& vregion,
+                                                          const std::string& cache_dir = "");
 
     /**
      * @brief sets population data from census data
@@ -252,9 +516,10 @@ namespace details
      * @param path Path to RKI file
      * @param id_name Name of region key column
      * @param vregion vector of keys of the regions of interest
+     * @param cache_dir Directory of the binary cache, no cache is used if empty
      */
     IOResult<void> set_population_data(std::vector<SecirModel>& model, const std::string& path, const std::string& id_name,
-                             const std::vector<int>& vregion);
+                             const std::vector<int>& vregion, const std::string& cache_dir = "");
 } //namespace details
 
 #ifdef MEMILIO_HAS_HDF5
@@ -270,12 +535,13 @@ namespace details
 * @param month Specifies month at which the data is read
 * @param day Specifies day at which the data is read
 * @param scaling_factor_inf factors by which to scale the confirmed cases of rki data
+* @param cache_dir Directory of the binary cache of the input files, no cache is used if empty
 */
 template <class Model>
 IOResult<void> extrapolate_rki_results(std::vector<Model>& model, const std::string& data_dir,
                                        const std::string& results_dir, std::vector<int> const& region, Date date,
                                        const std::vector<double>& scaling_factor_inf, double scaling_factor_icu,
-                                       int num_days)
+                                       int num_days, const std::string& cache_dir = "")
 {
 
     std::string id_name            = "ID_County";
@@ -333,6 +599,15 @@ IOResult<void> extrapolate_rki_results(std::vector<Model>& model, const std::str
     std::vector<TimeSeries<double>> rki_data(
         region.size(), TimeSeries<double>::zero(num_days, (size_t)InfectionState::Count * age_ranges.size()));
 
+    //read all files only once, the values of each day are computed from the data in memory
+    BOOST_OUTCOME_TRY(rki_cube, details::read_rki_data(path_join(data_dir, "all_county_age_ma_rki.json"), id_name,
+                                                       region, cache_dir));
+    BOOST_OUTCOME_TRY(divi_cube,
+                      details::read_divi_data(path_join(data_dir, "county_divi.json"), id_name, region, cache_dir));
+    BOOST_OUTCOME_TRY(num_population, details::read_population_data(
+                                          path_join(data_dir, "county_current_population.json"), id_name, region,
+                                          cache_dir));
+
     for (size_t j = 0; j < static_cast<size_t>(num_days); j++) {
         std::vector<std::vector<double>> num_inf(model.size(), std::vector<double>(age_ranges.size(), 0.0));
         std::vector<std::vector<double>> num_death(model.size(), std::vector<double>(age_ranges.size(), 0.0));
@@ -343,13 +618,11 @@ IOResult<void> extrapolate_rki_results(std::vector<Model>& model, const std::str
         std::vector<std::vector<double>> dummy_icu(model.size(), std::vector<double>(age_ranges.size(), 0.0));
         std::vector<double> num_icu(model.size(), 0.0);
 
-        BOOST_OUTCOME_TRY(details::read_rki_data(
-            path_join(data_dir, "all_county_age_ma_rki.json"), id_name, region, date, num_exp, num_car, num_inf, num_hosp,
-            dummy_icu, num_death, num_rec, t_car_to_rec, t_car_to_inf, t_exp_to_car, t_inf_to_rec, t_inf_to_hosp,
-            t_hosp_to_rec, t_hosp_to_icu, t_icu_to_dead, mu_C_R, mu_I_H, mu_H_U, scaling_factor_inf));
-        BOOST_OUTCOME_TRY(details::read_divi_data(path_join(data_dir, "county_divi.json"), id_name, region, date, num_icu));
-        BOOST_OUTCOME_TRY(num_population, 
-            details::read_population_data(path_join(data_dir, "county_current_population.json"), id_name, region));
+        BOOST_OUTCOME_TRY(details::compute_rki_data(
+            rki_cube, region, date, num_exp, num_car, num_inf, num_hosp, dummy_icu, num_death, num_rec, t_car_to_rec,
+            t_car_to_inf, t_exp_to_car, t_inf_to_rec, t_inf_to_hosp, t_hosp_to_rec, t_hosp_to_icu, t_icu_to_dead,
+            mu_C_R, mu_I_H, mu_H_U, scaling_factor_inf));
+        BOOST_OUTCOME_TRY(details::compute_divi_data(divi_cube, date, num_icu));
 
         for (size_t i = 0; i < region.size(); i++) {
             for (size_t age = 0; age < age_ranges.size(); age++) {
@@ -390,25 +663,27 @@ IOResult<void> extrapolate_rki_results(std::vector<Model>& model, const std::str
  * @param scaling_factor_inf factors by which to scale the confirmed cases of rki data
  * @param scaling_factor_icu factor by which to scale the icu cases of divi data
  * @param dir directory of files
+ * @param cache_dir directory of the binary cache of the files, no cache is used if empty.
+ * Repeated reads of the same files are much faster with a cache.
  */
 template <class Model>
 IOResult<void> read_population_data_germany(std::vector<Model>& model, Date date,
                                             const std::vector<double>& scaling_factor_inf, double scaling_factor_icu,
-                                            const std::string& dir)
+                                            const std::string& dir, const std::string& cache_dir = "")
 {
     std::string id_name;
     std::vector<int> region(1, 0);
     if (date > Date(2020, 4, 23)) {
-        BOOST_OUTCOME_TRY(
-            details::set_divi_data(model, path_join(dir, "germany_divi.json"), id_name, {0}, date, scaling_factor_icu));
+        BOOST_OUTCOME_TRY(details::set_divi_data(model, path_join(dir, "germany_divi.json"), id_name, {0}, date,
+                                                 scaling_factor_icu, cache_dir));
     }
     else {
         log_warning("No DIVI data available for this date");
     }
-    BOOST_OUTCOME_TRY(
-        details::set_rki_data(model, path_join(dir, "all_age_ma_rki.json"), id_name, {0}, date, scaling_factor_inf));
-    BOOST_OUTCOME_TRY(
-        details::set_population_data(model, path_join(dir, "county_current_population.json"), "ID_County", {0}));
+    BOOST_OUTCOME_TRY(details::set_rki_data(model, path_join(dir, "all_age_ma_rki.json"), id_name, {0}, date,
+                                            scaling_factor_inf, cache_dir));
+    BOOST_OUTCOME_TRY(details::set_population_data(model, path_join(dir, "county_current_population.json"),
+                                                   "ID_County", {0}, cache_dir));
     return success();
 }
 
@@ -420,25 +695,27 @@ IOResult<void> read_population_data_germany(std::vector<Model>& model, Date date
  * @param scaling_factor_inf factors by which to scale the confirmed cases of rki data
  * @param scaling_factor_icu factor by which to scale the icu cases of divi data
  * @param dir directory of files
+ * @param cache_dir directory of the binary cache of the files, no cache is used if empty.
+ * Repeated reads of the same files are much faster with a cache.
  */
 template <class Model>
 IOResult<void> read_population_data_state(std::vector<Model>& model, Date date, std::vector<int>& state,
                                 const std::vector<double>& scaling_factor_inf, double scaling_factor_icu,
-                                const std::string& dir)
+                                const std::string& dir, const std::string& cache_dir = "")
 {
     std::string id_name = "ID_State";
     if (date > Date(2020, 4, 23)) {
-        BOOST_OUTCOME_TRY(
-            details::set_divi_data(model, path_join(dir, "state_divi.json"), id_name, state, date, scaling_factor_icu));
+        BOOST_OUTCOME_TRY(details::set_divi_data(model, path_join(dir, "state_divi.json"), id_name, state, date,
+                                                 scaling_factor_icu, cache_dir));
     }
     else {
         log_warning("No DIVI data available for this date");
     }
 
     BOOST_OUTCOME_TRY(details::set_rki_data(model, path_join(dir, "all_state_age_ma_rki.json"), id_name, state, date,
-                                            scaling_factor_inf));
-    BOOST_OUTCOME_TRY(
-        details::set_population_data(model, path_join(dir, "county_current_population.json"), "ID_County", state));
+                                            scaling_factor_inf, cache_dir));
+    BOOST_OUTCOME_TRY(details::set_population_data(model, path_join(dir, "county_current_population.json"),
+                                                   "ID_County", state, cache_dir));
     return success();
 }
 
@@ -450,25 +727,27 @@ IOResult<void> read_population_data_state(std::vector<Model>& model, Date date,
  * @param scaling_factor_inf factors by which to scale the confirmed cases of rki data
  * @param scaling_factor_icu factor by which to scale the icu cases of divi data
  * @param dir directory of files
+ * @param cache_dir directory of the binary cache of the files, no cache is used if empty.
+ * Repeated reads of the same files are much faster with a cache.
  */
 template <class Model>
 IOResult<void> read_population_data_county(std::vector<Model>& model, Date date, const std::vector<int>& county,
                                            const std::vector<double>& scaling_factor_inf, double scaling_factor_icu,
-                                           const std::string& dir)
+                                           const std::string& dir, const std::string& cache_dir = "")
 {
     std::string id_name = "ID_County";
 
     if (date > Date(2020, 4, 23)) {
         BOOST_OUTCOME_TRY(details::set_divi_data(model, path_join(dir, "county_divi.json"), id_name, county, date,
-                                                 scaling_factor_icu));
+                                                 scaling_factor_icu, cache_dir));
     }
     else {
         log_warning("No DIVI data available for this date");
     }
     BOOST_OUTCOME_TRY(details::set_rki_data(model, path_join(dir, "all_county_age_ma_rki.json"), id_name, county, date,
-                                            scaling_factor_inf));
-    BOOST_OUTCOME_TRY(
-        details::set_population_data(model, path_join(dir, "county_current_population.json"), "ID_County", county));
+                                            scaling_factor_inf, cache_dir));
+    BOOST_OUTCOME_TRY(details::set_population_data(model, path_join(dir, "county_current_population.json"),
+                                                   "ID_County", county, cache_dir));
     return success();
 }
 
@@ -24,7 +24,10 @@
 #include "memilio/io/hdf5_cpp.h"
 #include "memilio/math/eigen_util.h"
 #include "memilio/epidemiology/damping.h"
+#include "memilio/utils/instrumentation.h"
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 #include <iostream>
 #include <string>
@@ -32,9 +35,59 @@
 namespace mio
 {
 
-IOResult<void> save_result(const std::vector<TimeSeries<double>>& results, const std::vector<int>& ids,
+namespace details
+{
+/**
+ * write consecutive value columns of a time series directly from its buffer.
+ * The buffer of the time series is a row major (time points x (1 + elements)) matrix, 
+ * column 0 contains the time, the other columns the values.
+ * @param dset data set to write to.
+ * @param file_space selection in the data set, must have num_time_points x num_cols elements.
+ * @param ts time series to write.
+ * @param first_col first column of the buffer to write.
+ * @param num_cols number of columns to write.
+ */
+template <class FP>
+IOResult<void> write_columns(hid_t dset, hid_t file_space, const TimeSeries<FP>& ts, hsize_t first_col,
+                             hsize_t num_cols)
+{
+    hsize_t dims_mem[] = {static_cast<hsize_t>(ts.get_num_time_points()), static_cast<hsize_t>(ts.get_num_rows())};
+    H5DataSpace dspace_mem{H5Screate_simple(2, dims_mem, NULL)};
+    MEMILIO_H5_CHECK(dspace_mem.id, StatusCode::UnknownError, "Memory DataSpace could not be created.");
+    hsize_t start[] = {0, first_col};
+    hsize_t count[] = {dims_mem[0], num_cols};
+    MEMILIO_H5_CHECK(H5Sselect_hyperslab(dspace_mem.id, H5S_SELECT_SET, start, NULL, count, NULL),
+                     StatusCode::UnknownError, "Memory DataSpace could not be selected.");
+    MEMILIO_H5_CHECK(H5Dwrite(dset, h5_native_type<FP>(), dspace_mem.id, file_space, H5P_DEFAULT, ts.data()),
+                     StatusCode::UnknownError, "Data could not be written.");
+    return success();
+}
+
+/**
+ * sum of all groups of a time series.
+ * @return column major (compartments x time points) matrix, i.e. the same layout as a row major 
+ * (time points x compartments) data set.
+ */
+template <class FP>
+Eigen::Matrix<FP, Eigen::Dynamic, Eigen::Dynamic> sum_groups(const TimeSeries<FP>& result)
+{
+    const auto n_compart = Eigen::Index(InfectionState::Count);
+    const auto nb_groups = result.get_num_elements() / n_compart;
+    auto values          = Eigen::Map<const Eigen::Matrix<FP, Eigen::Dynamic, Eigen::Dynamic>>(
+        result.data(), result.get_num_rows(), result.get_num_time_points());
+    Eigen::Matrix<FP, Eigen::Dynamic, Eigen::Dynamic> total =
+        Eigen::Matrix<FP, Eigen::Dynamic, Eigen::Dynamic>::Zero(n_compart, result.get_num_time_points());
+    for (Eigen::Index group = 0; group < nb_groups; ++group) {
+        total += values.middleRows(1 + group * n_compart, n_compart);
+    }
+    return total;
+}
+
+template <class FP>
+IOResult<void> save_result(const std::vector<TimeSeries<FP>>& results, const std::vector<int>& ids,
                            const std::string& filename)
 {
+    MIO_SCOPED_TIMER("save_result");
     int county = 0;
     H5File file{H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT)};
     MEMILIO_H5_CHECK(file.id, StatusCode::FileNotFound, filename);
@@ -45,49 +98,227 @@ IOResult<void> save_result(const std::vector<TimeSeries<double>>& results, const
 
         const int n_data    = static_cast<int>(result.get_num_time_points());
         const int n_compart = (int)InfectionState::Count;
-        const int nb_groups = static_cast<int>(result[0].size()) / n_compart;
+        const int nb_groups = static_cast<int>(result.get_num_elements()) / n_compart;
 
         hsize_t dims_t[] = {static_cast<hsize_t>(n_data)};
         H5DataSpace dspace_t{H5Screate_simple(1, dims_t, NULL)};
         MEMILIO_H5_CHECK(dspace_t.id, StatusCode::UnknownError, "Time DataSpace could not be created.");
-        H5DataSet dset_t{
-            H5Dcreate(county_group.id, "Time", H5T_NATIVE_DOUBLE, dspace_t.id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)};
+        H5DataSet dset_t{H5Dcreate(county_group.id, "Time", h5_native_type<FP>(), dspace_t.id, H5P_DEFAULT,
+                                   H5P_DEFAULT, H5P_DEFAULT)};
         MEMILIO_H5_CHECK(dset_t.id, StatusCode::UnknownError, "Time DataSet could not be created (Time).");
-        auto values_t = std::vector<double>(result.get_times().begin(), result.get_times().end());
-        MEMILIO_H5_CHECK(H5Dwrite(dset_t.id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values_t.data()),
-                     StatusCode::UnknownError, "Time data could not be written.");
-
-        auto total =
-            std::vector<Eigen::Matrix<double, n_compart, 1>>(n_data, Eigen::Matrix<double, n_compart, 1>::Constant(0));
+        BOOST_OUTCOME_TRY(write_columns(dset_t.id, H5S_ALL, result, 0, 1));
 
         for (int group = 0; group < nb_groups + 1; ++group) {
-            auto dset = std::vector<Eigen::Matrix<double, n_compart, 1>>(n_data);
-            if (group < nb_groups) {
-                for (size_t irow = 0; irow < static_cast<size_t>(result.get_num_time_points()); ++irow) {
-                    auto v     = result[irow].eval();
-                    auto slice = mio::slice(v, {group * n_compart, n_compart});
-                    dset[irow] = slice;
-                    total[irow] += slice;
-                }
-            }
-
             hsize_t dims_values[] = {static_cast<hsize_t>(n_data), static_cast<hsize_t>(n_compart)};
             H5DataSpace dspace_values{H5Screate_simple(2, dims_values, NULL)};
             MEMILIO_H5_CHECK(dspace_values.id, StatusCode::UnknownError, "Values DataSpace could not be created.");
             auto dset_name   = group == nb_groups ? std::string("Total") : "Group" + std::to_string(group + 1);
-            H5DataSet dset_values{H5Dcreate(county_group.id, dset_name.c_str(), H5T_NATIVE_DOUBLE,
+            H5DataSet dset_values{H5Dcreate(county_group.id, dset_name.c_str(), h5_native_type<FP>(),
                                                    dspace_values.id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)};
             MEMILIO_H5_CHECK(dset_values.id, StatusCode::UnknownError, "Values DataSet could not be created.");
 
-            MEMILIO_H5_CHECK(H5Dwrite(dset_values.id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                                  group == nb_groups ? total.data() : dset.data()),
-                         StatusCode::UnknownError, "Values data could not be written.");
+            if (group < nb_groups) {
+                BOOST_OUTCOME_TRY(write_columns(dset_values.id, H5S_ALL, result, 1 + group * n_compart, n_compart));
+            }
+            else {
+                auto total = sum_groups(result);
+                MEMILIO_H5_CHECK(H5Dwrite(dset_values.id, h5_native_type<FP>(), H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                                          total.data()),
+                                 StatusCode::UnknownError, "Values data could not be written.");
+            }
         }
         county++;
     }
     return success();
 }
 
+/**
+ * write the data of one run into a data set with an extendable first dimension for the runs.
+ * The data set is created with chunks of one run for the first run and extended for all other runs.
+ * @param loc group that contains the data set.
+ * @param name name of the data set.
+ * @param type HDF5 data type of the data set.
+ * @param run index of the run, the data set must contain all previous runs.
+ * @param n_data number of time points of the run.
+ * @param n_cols number of values per time point, the data set has rank 2 if n_cols is 0, otherwise rank 3.
+ * @param compression_level deflate level, 0 for no compression.
+ * @param write function that writes the run with signature IOResult<void>(hid_t dset, hid_t file_space).
+ */
+template <class F>
+IOResult<void> write_run(hid_t loc, const std::string& name, hid_t type, hsize_t run, hsize_t n_data, hsize_t n_cols,
+                         int compression_level, F write)
+{
+    const int rank = n_cols > 0 ? 3 : 2;
+    hsize_t dims[] = {run + 1, n_data, n_cols};
+    hid_t dset_id  = -1;
+    if (run == 0) {
+        hsize_t max_dims[]   = {H5S_UNLIMITED, n_data, n_cols};
+        hsize_t chunk_dims[] = {1, n_data, n_cols};
+        H5DataSpace dspace{H5Screate_simple(rank, dims, max_dims)};
+        MEMILIO_H5_CHECK(dspace.id, StatusCode::UnknownError, "DataSpace could not be created (" + name + ").");
+        H5PropertyList props{H5Pcreate(H5P_DATASET_CREATE)};
+        MEMILIO_H5_CHECK(props.id, StatusCode::UnknownError, "Property list could not be created.");
+        MEMILIO_H5_CHECK(H5Pset_chunk(props.id, rank, chunk_dims), StatusCode::UnknownError,
+                         "Chunks could not be set (" + name + ").");
+        if (compression_level > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0) {
+            MEMILIO_H5_CHECK(H5Pset_deflate(props.id, compression_level), StatusCode::UnknownError,
+                             "Compression could not be set (" + name + ").");
+        }
+        dset_id = H5Dcreate(loc, name.c_str(), type, dspace.id, H5P_DEFAULT, props.id, H5P_DEFAULT);
+    }
+    else {
+        dset_id = H5Dopen(loc, name.c_str(), H5P_DEFAULT);
+    }
+    H5DataSet dset{dset_id};
+    MEMILIO_H5_CHECK(dset.id, StatusCode::UnknownError, "DataSet could not be opened (" + name + ").");
+
+    if (run > 0) {
+        H5DataSpace dspace{H5Dget_space(dset.id)};
+        MEMILIO_H5_CHECK(dspace.id, StatusCode::UnknownError, "DataSpace could not be read (" + name + ").");
+        hsize_t old_dims[3] = {0, 0, 0};
+        if (H5Sget_simple_extent_ndims(dspace.id) != rank || H5Sget_simple_extent_dims(dspace.id, old_dims, NULL) < 0 ||
+            old_dims[0] != run || old_dims[1] != n_data || (rank == 3 && old_dims[2] != n_cols)) {
+            return failure(StatusCode::InvalidValue, "Run does not match previous runs (" + name + ").");
+        }
+        MEMILIO_H5_CHECK(H5Dset_extent(dset.id, dims), StatusCode::UnknownError,
+                         "DataSet could not be extended (" + name + ").");
+    }
+
+    H5DataSpace file_space{H5Dget_space(dset.id)};
+    MEMILIO_H5_CHECK(file_space.id, StatusCode::UnknownError, "DataSpace could not be read (" + name + ").");
+    hsize_t start[] = {run, 0, 0};
+    hsize_t count[] = {1, n_data, n_cols};
+    MEMILIO_H5_CHECK(H5Sselect_hyperslab(file_space.id, H5S_SELECT_SET, start, NULL, count, NULL),
+                     StatusCode::UnknownError, "DataSpace could not be selected (" + name + ").");
+    return write(dset.id, file_space.id);
+}
+
+/**
+ * read a complete data set of doubles.
+ * @param dims dimensions of the data set, must have space for the rank of the data set.
+ */
+IOResult<std::vector<double>> read_dataset(hid_t loc, const std::string& name, int rank, hsize_t* dims)
+{
+    H5DataSet dset{H5Dopen(loc, name.c_str(), H5P_DEFAULT)};
+    MEMILIO_H5_CHECK(dset.id, StatusCode::UnknownError, "DataSet could not be read (" + name + ").");
+    H5DataSpace dspace{H5Dget_space(dset.id)};
+    MEMILIO_H5_CHECK(dspace.id, StatusCode::UnknownError, "DataSpace could not be read (" + name + ").");
+    if (H5Sget_simple_extent_ndims(dspace.id) != rank) {
+        return failure(StatusCode::InvalidFileFormat, "Unexpected rank of DataSet (" + name + ").");
+    }
+    H5Sget_simple_extent_dims(dspace.id, dims, NULL);
+    auto values = std::vector<double>(H5Sget_simple_extent_npoints(dspace.id));
+    MEMILIO_H5_CHECK(H5Dread(dset.id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()),
+                     StatusCode::UnknownError, "Data could not be read (" + name + ").");
+    return success(std::move(values));
+}
+} // namespace details
+
+IOResult<void> save_result(const std::vector<TimeSeries<double>>& results, const std::vector<int>& ids,
+                           const std::string& filename)
+{
+    return details::save_result(results, ids, filename);
+}
+
+IOResult<void> save_result(const std::vector<TimeSeries<float>>& results, const std::vector<int>& ids,
+                           const std::string& filename)
+{
+    return details::save_result(results, ids, filename);
+}
+
+ResultEnsembleWriter::ResultEnsembleWriter(const std::string& filename, const std::vector<int>& ids,
+                                           int compression_level)
+    : m_filename(filename)
+    , m_ids(ids)
+    , m_compression_level(compression_level)
+    , m_num_runs(0)
+{
+    assert(compression_level >= 0 && compression_level <= 9);
+}
+
+template <class FP>
+IOResult<void> ResultEnsembleWriter::add_run_impl(const std::vector<TimeSeries<FP>>& results)
+{
+    assert(results.size() == m_ids.size());
+
+    //the file is created with the first run, so an existing file is overwritten like by save_result
+    const hsize_t run = m_num_runs;
+
+    //check all nodes before anything is written so a run is either appended completely or not at all
+    for (size_t node = 0; node < results.size(); ++node) {
+        if (results[node].get_num_elements() % Eigen::Index(InfectionState::Count) != 0) {
+            return failure(StatusCode::InvalidValue,
+                           "Unexpected number of elements in the result of node " + std::to_string(m_ids[node]) + ".");
+        }
+        if (run > 0 && (results[node].get_num_time_points() != m_shapes[node].first ||
+                        results[node].get_num_elements() != m_shapes[node].second)) {
+            return failure(StatusCode::InvalidValue,
+                           "Result of node " + std::to_string(m_ids[node]) + " does not match previous runs.");
+        }
+    }
+
+    H5File file{run == 0 ? H5Fcreate(m_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT)
+                         : H5Fopen(m_filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT)};
+    MEMILIO_H5_CHECK(file.id, StatusCode::FileNotFound, m_filename);
+
+    for (size_t node = 0; node < results.size(); ++node) {
+        auto& result            = results[node];
+        auto group_name         = "/" + std::to_string(m_ids[node]);
+        const hsize_t n_data    = result.get_num_time_points();
+        const hsize_t n_compart = (hsize_t)InfectionState::Count;
+        const hsize_t nb_groups = result.get_num_elements() / n_compart;
+
+        H5Group node_group{run == 0
+                               ? H5Gcreate(file.id, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)
+                               : H5Gopen(file.id, group_name.c_str(), H5P_DEFAULT)};
+        MEMILIO_H5_CHECK(node_group.id, StatusCode::UnknownError, "Group could not be opened (" + group_name + ")");
+
+        BOOST_OUTCOME_TRY(details::write_run(node_group.id, "Time", h5_native_type<FP>(), run, n_data, 0,
+                                             m_compression_level, [&result](hid_t dset, hid_t file_space) {
+                                                 return details::write_columns(dset, file_space, result, 0, 1);
+                                             }));
+        for (hsize_t group = 0; group < nb_groups; ++group) {
+            auto dset_name = "Group" + std::to_string(group + 1);
+            BOOST_OUTCOME_TRY(details::write_run(
+                node_group.id, dset_name, h5_native_type<FP>(), run, n_data, n_compart, m_compression_level,
+                [&result, group, n_compart](hid_t dset, hid_t file_space) {
+                    return details::write_columns(dset, file_space, result, 1 + group * n_compart, n_compart);
+                }));
+        }
+        auto total = details::sum_groups(result);
+        BOOST_OUTCOME_TRY(details::write_run(
+            node_group.id, "Total", h5_native_type<FP>(), run, n_data, n_compart, m_compression_level,
+            [&total](hid_t dset, hid_t file_space) -> IOResult<void> {
+                hsize_t dims_mem[] = {static_cast<hsize_t>(total.size())};
+                H5DataSpace dspace_mem{H5Screate_simple(1, dims_mem, NULL)};
+                MEMILIO_H5_CHECK(dspace_mem.id, StatusCode::UnknownError, "Memory DataSpace could not be created.");
+                MEMILIO_H5_CHECK(H5Dwrite(dset, h5_native_type<FP>(), dspace_mem.id, file_space, H5P_DEFAULT,
+                                          total.data()),
+                                 StatusCode::UnknownError, "Values data could not be written.");
+                return success();
+            }));
+    }
+
+    if (run == 0) {
+        m_shapes.clear();
+        std::transform(results.begin(), results.end(), std::back_inserter(m_shapes), [](auto& result) {
+            return std::make_pair(result.get_num_time_points(), result.get_num_elements());
+        });
+    }
+    ++m_num_runs;
+    return success();
+}
+
+IOResult<void> ResultEnsembleWriter::add_run(const std::vector<TimeSeries<double>>& result)
+{
+    return add_run_impl(result);
+}
+
+IOResult<void> ResultEnsembleWriter::add_run(const std::vector<TimeSeries<float>>& result)
+{
+    return add_run_impl(result);
+}
+
 herr_t store_group_name(hid_t loc_id, const char* name, const H5L_info_t* linfo, void* opdata)
 {
     unused(linfo);
@@ -180,6 +411,93 @@ IOResult<std::vector<SecirSimulationResult>> read_result(const std::string& file
     return success(results);
 }
 
+namespace details
+{
+/**
+ * read the results of one node of all runs from a file written by ResultEnsembleWriter.
+ * @param name name of the group of the node in the file.
+ */
+IOResult<std::vector<SecirSimulationResult>> read_result_ensemble_node(hid_t file, const std::string& name,
+                                                                       int nb_groups)
+{
+    const int nb_compart = (int)InfectionState::Count;
+
+    hsize_t dims_t[2];
+    BOOST_OUTCOME_TRY(time, details::read_dataset(file, "/" + name + "/Time", 2, dims_t));
+    const auto num_runs = dims_t[0];
+    const auto n_data   = dims_t[1];
+
+    std::vector<TimeSeries<double>> groups(num_runs, TimeSeries<double>(nb_compart * nb_groups));
+    std::vector<TimeSeries<double>> totals(num_runs, TimeSeries<double>(nb_compart));
+    for (size_t run = 0; run < num_runs; ++run) {
+        groups[run].reserve(n_data);
+        totals[run].reserve(n_data);
+        for (size_t i = 0; i < n_data; ++i) {
+            groups[run].add_time_point(time[run * n_data + i]);
+            totals[run].add_time_point(time[run * n_data + i]);
+        }
+    }
+
+    for (int group = 0; group < nb_groups + 1; ++group) {
+        auto dset_name =
+            "/" + name + (group == nb_groups ? std::string("/Total") : "/Group" + std::to_string(group + 1));
+        hsize_t dims_values[3];
+        BOOST_OUTCOME_TRY(values, details::read_dataset(file, dset_name, 3, dims_values));
+        if (dims_values[0] != num_runs || dims_values[1] != n_data || dims_values[2] != hsize_t(nb_compart)) {
+            return failure(StatusCode::InvalidFileFormat, "Unexpected size of DataSet (" + dset_name + ").");
+        }
+        for (size_t run = 0; run < num_runs; ++run) {
+            for (size_t i = 0; i < n_data; ++i) {
+                auto v =
+                    Eigen::Map<const Eigen::VectorXd>(values.data() + (run * n_data + i) * nb_compart, nb_compart);
+                if (group < nb_groups) {
+                    groups[run][i].segment(group * nb_compart, nb_compart) = v;
+                }
+                else {
+                    totals[run][i] = v;
+                }
+            }
+        }
+    }
+
+    std::vector<SecirSimulationResult> results;
+    results.reserve(num_runs);
+    for (size_t run = 0; run < num_runs; ++run) {
+        results.push_back(SecirSimulationResult(groups[run], totals[run]));
+    }
+    return success(std::move(results));
+}
+} // namespace details
+
+IOResult<std::vector<std::vector<SecirSimulationResult>>> read_result_ensemble(const std::string& filename,
+                                                                            int nb_groups)
+{
+    H5File file{H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT)};
+    MEMILIO_H5_CHECK(file.id, StatusCode::FileNotFound, filename);
+
+    std::vector<std::string> group_names;
+    MEMILIO_H5_CHECK(H5Literate(file.id, H5_INDEX_NAME, H5_ITER_INC, NULL, &store_group_name, &group_names),
+                     StatusCode::UnknownError, "Group names could not be read.");
+
+    std::vector<std::vector<SecirSimulationResult>> results;
+    for (auto& name : group_names) {
+        BOOST_OUTCOME_TRY(node_results, details::read_result_ensemble_node(file.id, name, nb_groups));
+        results.resize(node_results.size());
+        for (size_t run = 0; run < node_results.size(); ++run) {
+            results[run].push_back(std::move(node_results[run]));
+        }
+    }
+    return success(results);
+}
+
+IOResult<std::vector<SecirSimulationResult>> read_result_ensemble_node(const std::string& filename, int id,
+                                                                       int nb_groups)
+{
+    H5File file{H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT)};
+    MEMILIO_H5_CHECK(file.id, StatusCode::FileNotFound, filename);
+    return details::read_result_ensemble_node(file.id, std::to_string(id), nb_groups);
+}
+
 } // namespace mio
 
 #endif //MEMILIO_HAS_HDF5
@@ -34,12 +34,18 @@ namespace mio
 
 /**
  * @brief save secir simulation result to h5 file
+ * The data sets are stored in the precision of the result, 
+ * i.e. results in single precision need half the disk space.
  * @param times Vector of timesteps used during simulation
  * @param secir Results of secir simulation
  * @param filename name of file
+ * @{
  */
 IOResult<void> save_result(const std::vector<TimeSeries<double>>& result, const std::vector<int>& ids,
                            const std::string& filename);
+IOResult<void> save_result(const std::vector<TimeSeries<float>>& result, const std::vector<int>& ids,
+                           const std::string& filename);
+/** @} */
 
 class SecirSimulationResult
 {
@@ -85,13 +91,85 @@ private:
     TimeSeries<double> m_totals;
 };
 
+/**
+ * @brief appends the results of simulation runs to a single h5 file.
+ * The file has the same layout as the files written by save_result, i.e. one group per node with 
+ * the data sets "Time", "Group1", "Group2", ..., and "Total", but each data set has an additional 
+ * first dimension for the runs that is extended every time a run is added.
+ * The data sets are chunked with one chunk per run and compressed.
+ * All runs must have the same nodes with the same number of time points, 
+ * e.g., the results of interpolate_simulation_result.
+ */
+class ResultEnsembleWriter
+{
+public:
+    /**
+     * @brief create a writer, the file is created (or overwritten) when the first run is added.
+     * @param filename name of file
+     * @param ids ids of the nodes in the results of each run.
+     * @param compression_level deflate level between 0 (no compression) and 9.
+     */
+    ResultEnsembleWriter(const std::string& filename, const std::vector<int>& ids, int compression_level = 4);
+
+    /**
+     * @brief append the results of one run to the file.
+     * The values are written in the precision of the first run.
+     * The results of each node must have the same number of time points and elements as in the first run,
+     * otherwise nothing is written.
+     * @param result results of each node of the run.
+     * @{
+     */
+    IOResult<void> add_run(const std::vector<TimeSeries<double>>& result);
+    IOResult<void> add_run(const std::vector<TimeSeries<float>>& result);
+    /** @} */
+
+    /**
+     * @brief number of runs in the file.
+     */
+    size_t get_num_runs() const
+    {
+        return m_num_runs;
+    }
+
+private:
+    template <class FP>
+    IOResult<void> add_run_impl(const std::vector<TimeSeries<FP>>& result);
+
+    std::string m_filename;
+    std::vector<int> m_ids;
+    int m_compression_level;
+    size_t m_num_runs;
+    std::vector<std::pair<Eigen::Index, Eigen::Index>> m_shapes; ///< time points and elements of each node.
+};
+
 /**
  * @brief read secir simulation result from h5 file
+ * Results stored in single precision are converted to double precision.
  * @param filename name of file
  * @param nb_groups number of groups used during simulation
  */
 IOResult<std::vector<SecirSimulationResult>> read_result(const std::string& filename, int nb_groups);
 
+/**
+ * @brief read secir simulation results of all runs from a h5 file written by ResultEnsembleWriter.
+ * @param filename name of file
+ * @param nb_groups number of groups used during simulation
+ * @return results of each node for each run, i.e. result[run][node].
+ */
+IOResult<std::vector<std::vector<SecirSimulationResult>>> read_result_ensemble(const std::string& filename,
+                                                                            int nb_groups);
+
+/**
+ * @brief read secir simulation results of one node of all runs from a h5 file written by ResultEnsembleWriter.
+ * Only the data of the node is read, so large ensembles can be processed one node at a time.
+ * @param filename name of file
+ * @param id id of the node
+ * @param nb_groups number of groups used during simulation
+ * @return results of the node for each run.
+ */
+IOResult<std::vector<SecirSimulationResult>> read_result_ensemble_node(const std::string& filename, int id,
+                                                                       int nb_groups);
+
 } // namespace mio
 
 #endif // MEMILIO_HAS_HDF5
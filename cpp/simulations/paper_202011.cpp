@@ -23,6 +23,7 @@
 */
 
 #include "secir/parameter_studies.h"
+#include "secir/ensemble_pipeline.h"
 #include "memilio/epidemiology/regions.h"
 #include "secir/secir_parameters_io.h"
 #include "secir/secir_result_io.h"
@@ -30,6 +31,7 @@
 #include "boost/filesystem.hpp"
 #include <cstdio>
 #include <iomanip>
+#include <thread>
 
 namespace fs = boost::filesystem;
 
@@ -463,8 +465,10 @@ mio::IOResult<void> set_nodes(const mio::SecirParams& params, mio::Date start_da
     }
     auto scaling_factor_infected = std::vector<double>(size_t(params.get_num_groups()), 2.5);
     auto scaling_factor_icu      = 1.0;
+    //binary cache of the json files, so repeated runs don't parse the same files again
     BOOST_OUTCOME_TRY(mio::read_population_data_county(counties, start_date, county_ids, scaling_factor_infected,
-                                                       scaling_factor_icu, (data_dir / "pydata" / "Germany").string()));
+                                                       scaling_factor_icu, (data_dir / "pydata" / "Germany").string(),
+                                                       (data_dir / "pydata" / "Germany" / "cache").string()));
     // set_synthetic_population_data(counties);
 
     for (size_t county_idx = 0; county_idx < counties.size(); ++county_idx) {
@@ -513,10 +517,13 @@ mio::IOResult<void> set_edges(const fs::path& data_dir,
                               mio::Graph<mio::SecirModel, mio::MigrationParameters>& params_graph)
 {
     //migration between nodes
+    auto cache_dir = (data_dir / "mobility" / "cache").string();
     BOOST_OUTCOME_TRY(migration_data_commuter,
-                      mio::read_mobility_plain((data_dir / "mobility" / "commuter_migration_scaled.txt").string()));
+                      mio::read_mobility_plain((data_dir / "mobility" / "commuter_migration_scaled.txt").string(),
+                                               cache_dir));
     BOOST_OUTCOME_TRY(migration_data_twitter,
-                      mio::read_mobility_plain((data_dir / "mobility" / "twitter_scaled_1252.txt").string()));
+                      mio::read_mobility_plain((data_dir / "mobility" / "twitter_scaled_1252.txt").string(),
+                                               cache_dir));
     if (size_t(migration_data_commuter.rows()) != params_graph.nodes().size() ||
         size_t(migration_data_commuter.cols()) != params_graph.nodes().size() ||
         size_t(migration_data_twitter.rows()) != params_graph.nodes().size() ||
@@ -623,139 +630,6 @@ mio::IOResult<void> save_graph(const mio::Graph<mio::SecirModel, mio::MigrationP
     return mio::write_graph(params_graph, save_dir.string());
 }
 
-/**
- * Create an unconnected graph.
- * Can be used to save space on disk when writing parameters if the edges are not required.
- * @param params parameters for each county node.
- * @param county_ids id of each county node.
- * @return graph with county nodes but no edges.
- */
-auto make_graph_no_edges(const std::vector<mio::SecirModel>& params, const std::vector<int>& county_ids)
-{
-    //make a graph without edges for writing to file
-    auto graph = mio::Graph<mio::SecirModel, mio::MigrationParameters>();
-    for (auto i = size_t(0); i < county_ids.size(); ++i) {
-        graph.add_node(county_ids[i], params[i]);
-    }
-    return graph;
-}
-
-/**
- * Save the result of a single parameter study run.
- * Creates a new subdirectory for this run.
- * @param result result of the simulation run.
- * @param params parameters used for the simulation run.
- * @param county_ids ids of the county nodes.
- * @param result_dir top level directory for all results of the parameter study.
- * @param run_idx index of the run.
- * @return any io errors that occur during writing of the files.
- */
-mio::IOResult<void> save_result(const std::vector<mio::TimeSeries<double>>& result,
-                                const std::vector<mio::SecirModel>& params, const std::vector<int>& county_ids,
-                                const fs::path& result_dir, size_t run_idx)
-{
-    auto result_dir_run = result_dir / ("run" + std::to_string(run_idx));
-    BOOST_OUTCOME_TRY(mio::create_directory(result_dir_run.string()));
-    BOOST_OUTCOME_TRY(mio::save_result(result, county_ids, (result_dir_run / "Result.h5").string()));
-    BOOST_OUTCOME_TRY(
-        mio::write_graph(make_graph_no_edges(params, county_ids), result_dir_run.string(), mio::IOF_OmitDistributions));
-    return mio::success();
-}
-
-/**
- * Save the results of a parameter study.
- * Stores different percentiles and sums of the results and parameters. 
- * @param ensemble_results result of each simulation run.
- * @param ensemble_params parameters used for each simulation run.
- * @param county_ids ids of the county nodes.
- * @param result_dir top level directory for all results of the parameter study.
- * @return any io errors that occur during writing of the files.
- */
-mio::IOResult<void> save_results(const std::vector<std::vector<mio::TimeSeries<double>>>& ensemble_results,
-                                 const std::vector<std::vector<mio::SecirModel>>& ensemble_params,
-                                 const std::vector<int>& county_ids, const fs::path& result_dir)
-{
-    //save results and sum of results over nodes
-    auto ensemble_result_sum = mio::sum_nodes(ensemble_results);
-    for (size_t i = 0; i < ensemble_result_sum.size(); ++i) {
-        BOOST_OUTCOME_TRY(mio::save_result(ensemble_result_sum[i], {0},
-                                           (result_dir / ("results_run" + std::to_string(i) + "_sum.h5")).string()));
-        BOOST_OUTCOME_TRY(mio::save_result(ensemble_results[i], county_ids,
-                                           (result_dir / ("results_run" + std::to_string(i) + ".h5")).string()));
-    }
-
-    //make directories for percentiles
-    auto result_dir_p05 = result_dir / "p05";
-    auto result_dir_p25 = result_dir / "p25";
-    auto result_dir_p50 = result_dir / "p50";
-    auto result_dir_p75 = result_dir / "p75";
-    auto result_dir_p95 = result_dir / "p95";
-    BOOST_OUTCOME_TRY(mio::create_directory(result_dir_p05.string()));
-    BOOST_OUTCOME_TRY(mio::create_directory(result_dir_p25.string()));
-    BOOST_OUTCOME_TRY(mio::create_directory(result_dir_p50.string()));
-    BOOST_OUTCOME_TRY(mio::create_directory(result_dir_p75.string()));
-    BOOST_OUTCOME_TRY(mio::create_directory(result_dir_p95.string()));
-
-    //save percentiles of results, summed over nodes
-    {
-        auto ensemble_results_sum_p05 = mio::ensemble_percentile(ensemble_result_sum, 0.05);
-        auto ensemble_results_sum_p25 = mio::ensemble_percentile(ensemble_result_sum, 0.25);
-        auto ensemble_results_sum_p50 = mio::ensemble_percentile(ensemble_result_sum, 0.50);
-        auto ensemble_results_sum_p75 = mio::ensemble_percentile(ensemble_result_sum, 0.75);
-        auto ensemble_results_sum_p95 = mio::ensemble_percentile(ensemble_result_sum, 0.95);
-
-        BOOST_OUTCOME_TRY(
-            mio::save_result(ensemble_results_sum_p05, {0}, (result_dir_p05 / "Results_sum.h5").string()));
-        BOOST_OUTCOME_TRY(
-            mio::save_result(ensemble_results_sum_p25, {0}, (result_dir_p25 / "Results_sum.h5").string()));
-        BOOST_OUTCOME_TRY(
-            mio::save_result(ensemble_results_sum_p50, {0}, (result_dir_p50 / "Results_sum.h5").string()));
-        BOOST_OUTCOME_TRY(
-            mio::save_result(ensemble_results_sum_p75, {0}, (result_dir_p75 / "Results_sum.h5").string()));
-        BOOST_OUTCOME_TRY(
-            mio::save_result(ensemble_results_sum_p95, {0}, (result_dir_p95 / "Results_sum.h5").string()));
-    }
-
-    //save percentiles of results
-    {
-        auto ensemble_results_p05 = mio::ensemble_percentile(ensemble_results, 0.05);
-        auto ensemble_results_p25 = mio::ensemble_percentile(ensemble_results, 0.25);
-        auto ensemble_results_p50 = mio::ensemble_percentile(ensemble_results, 0.50);
-        auto ensemble_results_p75 = mio::ensemble_percentile(ensemble_results, 0.75);
-        auto ensemble_results_p95 = mio::ensemble_percentile(ensemble_results, 0.95);
-
-        BOOST_OUTCOME_TRY(mio::save_result(ensemble_results_p05, county_ids, (result_dir_p05 / "Results.h5").string()));
-        BOOST_OUTCOME_TRY(mio::save_result(ensemble_results_p25, county_ids, (result_dir_p25 / "Results.h5").string()));
-        BOOST_OUTCOME_TRY(mio::save_result(ensemble_results_p50, county_ids, (result_dir_p50 / "Results.h5").string()));
-        BOOST_OUTCOME_TRY(mio::save_result(ensemble_results_p75, county_ids, (result_dir_p75 / "Results.h5").string()));
-        BOOST_OUTCOME_TRY(mio::save_result(ensemble_results_p95, county_ids, (result_dir_p95 / "Results.h5").string()));
-    }
-
-    //save percentiles of parameters
-    {
-        auto ensemble_params_p05 = mio::ensemble_params_percentile(ensemble_params, 0.05);
-        auto ensemble_params_p25 = mio::ensemble_params_percentile(ensemble_params, 0.25);
-        auto ensemble_params_p50 = mio::ensemble_params_percentile(ensemble_params, 0.50);
-        auto ensemble_params_p75 = mio::ensemble_params_percentile(ensemble_params, 0.75);
-        auto ensemble_params_p95 = mio::ensemble_params_percentile(ensemble_params, 0.95);
-
-        auto make_graph = [&county_ids](auto&& params) {
-            return make_graph_no_edges(params, county_ids);
-        };
-        BOOST_OUTCOME_TRY(
-            mio::write_graph(make_graph(ensemble_params_p05), result_dir_p05.string(), mio::IOF_OmitDistributions));
-        BOOST_OUTCOME_TRY(
-            mio::write_graph(make_graph(ensemble_params_p25), result_dir_p25.string(), mio::IOF_OmitDistributions));
-        BOOST_OUTCOME_TRY(
-            mio::write_graph(make_graph(ensemble_params_p50), result_dir_p50.string(), mio::IOF_OmitDistributions));
-        BOOST_OUTCOME_TRY(
-            mio::write_graph(make_graph(ensemble_params_p75), result_dir_p75.string(), mio::IOF_OmitDistributions));
-        BOOST_OUTCOME_TRY(
-            mio::write_graph(make_graph(ensemble_params_p95), result_dir_p95.string(), mio::IOF_OmitDistributions));
-    }
-    return mio::success();
-}
-
 /**
  * Different modes for running the parameter study.
  */
@@ -793,40 +667,19 @@ mio::IOResult<void> run(RunMode mode, const fs::path& data_dir, const fs::path&
     else {
         BOOST_OUTCOME_TRY(loaded, load_graph(save_dir));
         params_graph = loaded;
+        //nodes are read separately, so they don't share the contact patterns yet
+        mio::share_contact_patterns(params_graph);
     }
 
-    std::vector<int> county_ids(params_graph.nodes().size());
-    std::transform(params_graph.nodes().begin(), params_graph.nodes().end(), county_ids.begin(), [](auto& n) {
-        return n.id;
-    });
-
-    //run parameter study
-    auto parameter_study =
-        mio::ParameterStudy<mio::SecirSimulation<>>{params_graph, 0.0, num_days_sim, 0.5, size_t(num_runs)};
-    auto ensemble_results = std::vector<std::vector<mio::TimeSeries<double>>>{};
-    ensemble_results.reserve(size_t(num_runs));
-    auto ensemble_params = std::vector<std::vector<mio::SecirModel>>{};
-    ensemble_params.reserve(size_t(num_runs));
-    auto save_result_result = mio::IOResult<void>(mio::success());
-    auto run_idx            = size_t(0);
-    parameter_study.run([&](auto results_graph) {
-        ensemble_results.push_back(mio::interpolate_simulation_result(results_graph));
-
-        ensemble_params.emplace_back();
-        ensemble_params.back().reserve(results_graph.nodes().size());
-        std::transform(results_graph.nodes().begin(), results_graph.nodes().end(),
-                       std::back_inserter(ensemble_params.back()), [](auto&& node) {
-                           return node.property.get_simulation().get_model();
-                       });
-
-        if (save_result_result) {
-            save_result_result =
-                save_result(ensemble_results.back(), ensemble_params.back(), county_ids, result_dir, run_idx);
-        }
-        ++run_idx;
-    });
-    BOOST_OUTCOME_TRY(save_result_result);
-    BOOST_OUTCOME_TRY(save_results(ensemble_results, ensemble_params, county_ids, result_dir));
+    //run parameter study, results are written while the runs are computed
+    auto options        = mio::EnsembleOptions{};
+    options.t0          = 0.0;
+    options.tmax        = num_days_sim;
+    options.dt          = 0.5;
+    options.num_runs    = size_t(num_runs);
+    options.num_threads = int(std::max(std::thread::hardware_concurrency(), 1u));
+    options.seeds       = mio::thread_local_rng().get_seeds();
+    BOOST_OUTCOME_TRY(mio::run_ensemble(params_graph, options, result_dir.string()));
 
     return mio::success();
 }
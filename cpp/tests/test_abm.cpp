@@ -22,6 +22,7 @@
 #include "abm/lockdown_rules.h"
 #include "memilio/math/eigen_util.h"
 #include "matchers.h"
+#include "temp_file_register.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <memory>
@@ -168,8 +169,11 @@ TEST(TestPerson, setGetAssignedLocation)
 {
     auto location = mio::Location(mio::LocationType::Work, 2);
     auto person   = mio::Person(location, mio::InfectionState::Recovered_Carrier, mio::AbmAgeGroup::Age60to79, {});
+    ASSERT_THAT(person.get_assigned_locations(), testing::Each(mio::INVALID_LOCATION_INDEX));
+
     person.set_assigned_location(location);
     ASSERT_EQ((int)person.get_assigned_location_index(mio::LocationType::Work), 2);
+    ASSERT_EQ(person.get_assigned_location_index(mio::LocationType::Home), mio::INVALID_LOCATION_INDEX);
 
     person.set_assigned_location({4, mio::LocationType::Work});
     ASSERT_EQ((int)person.get_assigned_location_index(mio::LocationType::Work), 4);
@@ -515,6 +519,26 @@ TEST(TestWorld, addPerson)
     ASSERT_EQ(&world.get_persons()[1], &p2);
 }
 
+TEST(TestWorld, addManyPersons)
+{
+    auto world    = mio::World();
+    auto location = world.add_location(mio::LocationType::Home);
+
+    auto& p1 = world.add_person(location, mio::InfectionState::Carrier);
+    std::vector<mio::Person*> persons = {&p1};
+    for (int i = 0; i < 5000; ++i) {
+        persons.push_back(&world.add_person(location, mio::InfectionState::Susceptible));
+    }
+
+    //references stay valid when persons are added
+    ASSERT_EQ(world.get_persons().size(), persons.size());
+    for (size_t i = 0; i < persons.size(); ++i) {
+        ASSERT_EQ(&world.get_persons()[i], persons[i]);
+    }
+    EXPECT_EQ(p1.get_infection_state(), mio::InfectionState::Carrier);
+    EXPECT_EQ(world.get_individualized_location(location).get_subpopulation(mio::InfectionState::Susceptible), 5000);
+}
+
 TEST(TestWorld, getSubpopulationCombined)
 {
     auto world   = mio::World();
@@ -531,6 +555,64 @@ TEST(TestWorld, getSubpopulationCombined)
     ASSERT_EQ(world.get_subpopulation_combined(mio::InfectionState::Carrier, mio::LocationType::School), 2);
 }
 
+TEST(TestWorld, subpopulationsMatchLocations)
+{
+    for (auto event_driven : {false, true}) {
+        auto world = mio::World();
+        world.set_event_driven(event_driven);
+        auto home     = world.add_location(mio::LocationType::Home);
+        auto work     = world.add_location(mio::LocationType::Work);
+        auto shop     = world.add_location(mio::LocationType::BasicsShop);
+        auto hospital = world.add_location(mio::LocationType::Hospital);
+        auto icu      = world.add_location(mio::LocationType::ICU);
+        for (int i = 0; i < 50; ++i) {
+            auto& p = world.add_person(home, i % 4 == 0 ? mio::InfectionState::Carrier
+                                                        : mio::InfectionState::Susceptible);
+            for (auto loc : {home, work, shop, hospital, icu}) {
+                p.set_assigned_location(loc);
+            }
+        }
+        world.set_infection_state(world.get_persons()[1], mio::InfectionState::Infected);
+
+        for (auto t = mio::TimePoint(0); t < mio::TimePoint(0) + mio::days(3); t += mio::hours(1)) {
+            world.evolve(t, mio::hours(1));
+            for (auto type = size_t(0); type < size_t(mio::LocationType::Count); ++type) {
+                Eigen::VectorXi expected = Eigen::VectorXi::Zero(Eigen::Index(mio::InfectionState::Count));
+                for (auto& location : world.get_locations()[type]) {
+                    expected += location.get_subpopulations();
+                }
+                ASSERT_EQ(print_wrap(world.get_subpopulations(mio::LocationType(type))), print_wrap(expected));
+            }
+            ASSERT_EQ(world.get_subpopulations().sum(), 50);
+        }
+    }
+}
+
+TEST(TestWorld, subpopulationsFollowLocationChanges)
+{
+    auto world = mio::World();
+    auto home  = world.add_location(mio::LocationType::Home);
+    auto work  = world.add_location(mio::LocationType::Work);
+    auto& p    = world.add_person(home, mio::InfectionState::Susceptible);
+    EXPECT_EQ(world.get_subpopulation_combined(mio::InfectionState::Susceptible, mio::LocationType::Home), 1);
+
+    //changes through the locations and persons directly are counted as well
+    auto& home_loc = world.get_individualized_location(home);
+    auto& work_loc = world.get_individualized_location(work);
+    p.set_infection_state(mio::InfectionState::Carrier);
+    home_loc.changed_state(p, mio::InfectionState::Susceptible);
+    EXPECT_EQ(world.get_subpopulation_combined(mio::InfectionState::Susceptible, mio::LocationType::Home), 0);
+    EXPECT_EQ(world.get_subpopulation_combined(mio::InfectionState::Carrier, mio::LocationType::Home), 1);
+    p.migrate_to(home_loc, work_loc);
+    EXPECT_EQ(world.get_subpopulation_combined(mio::InfectionState::Carrier, mio::LocationType::Home), 0);
+    EXPECT_EQ(world.get_subpopulation_combined(mio::InfectionState::Carrier, mio::LocationType::Work), 1);
+
+    //counters stay valid when the world is moved
+    auto moved = std::move(world);
+    moved.get_individualized_location(work).remove_person(p);
+    EXPECT_EQ(moved.get_subpopulation_combined(mio::InfectionState::Carrier, mio::LocationType::Work), 0);
+}
+
 TEST(TestWorld, evolveStateTransition)
 {
     using testing::Return;
@@ -886,6 +968,127 @@ TEST(TestMigrationRules, event_return)
     ASSERT_EQ(mio::go_to_event(p, t, dt, {}), mio::LocationType::Home);
 }
 
+TEST(TestMigrationRules, origins)
+{
+    auto params      = mio::AbmMigrationParameters();
+    auto t_morning   = mio::TimePoint(0) + mio::days(2) + mio::hours(6);
+    auto t_night     = mio::TimePoint(0) + mio::days(2) + mio::hours(2);
+    auto t_afternoon = mio::TimePoint(0) + mio::days(2) + mio::hours(17);
+    auto t_sunday    = mio::TimePoint(0) + mio::days(6) + mio::hours(6);
+    auto dt          = mio::hours(1);
+    auto home        = size_t(mio::LocationType::Home);
+
+    EXPECT_TRUE(mio::go_to_school_origins(t_morning, dt, params)[home]);
+    EXPECT_TRUE(mio::go_to_work_origins(t_morning, dt, params)[home]);
+    EXPECT_FALSE(mio::go_to_school_origins(t_night, dt, params)[home]);
+    EXPECT_FALSE(mio::go_to_work_origins(t_night, dt, params)[home]);
+    EXPECT_FALSE(mio::go_to_school_origins(t_sunday, dt, params)[home]);
+    EXPECT_FALSE(mio::go_to_work_origins(t_sunday, dt, params)[home]);
+    EXPECT_FALSE(mio::go_to_shop_origins(t_night, dt, params)[home]);
+    EXPECT_FALSE(mio::go_to_event_origins(t_night, dt, params)[home]);
+    EXPECT_TRUE(mio::go_to_hospital_origins(t_night, dt, params).all());
+
+    EXPECT_FALSE(mio::go_to_work_origins(t_morning, dt, params)[size_t(mio::LocationType::Work)]);
+    EXPECT_TRUE(mio::go_to_work_origins(t_afternoon, dt, params)[size_t(mio::LocationType::Work)]);
+    EXPECT_TRUE(mio::go_to_school_origins(t_afternoon, dt, params)[size_t(mio::LocationType::School)]);
+
+    params.get<mio::LockdownDate>() = mio::TimePoint(0);
+    EXPECT_FALSE(mio::go_to_school_origins(t_morning, dt, params)[home]);
+    EXPECT_FALSE(mio::go_to_work_origins(t_morning, dt, params)[home]);
+}
+
+TEST(TestMigrationRules, next_times)
+{
+    auto params = mio::AbmMigrationParameters();
+    auto t      = mio::TimePoint(0) + mio::hours(1);
+    auto dt     = mio::hours(1);
+    auto never  = mio::TimePoint(std::numeric_limits<int>::max());
+
+    //no step before the next time moves the person from home, the step at the next time does
+    auto home     = mio::Location(mio::LocationType::Home, 0);
+    auto p_adult  = mio::Person(home, mio::InfectionState::Susceptible, mio::AbmAgeGroup::Age35to59, {});
+    auto p_child  = mio::Person(home, mio::InfectionState::Susceptible, mio::AbmAgeGroup::Age5to14, {});
+    auto t_work   = mio::go_to_work_next_time(p_adult, t, dt, params);
+    auto t_school = mio::go_to_school_next_time(p_child, t, dt, params);
+    ASSERT_LT(t_work, t + mio::days(1));
+    ASSERT_LT(t_school, t + mio::days(1));
+    for (auto s = t; s < t_work; s += dt) {
+        EXPECT_EQ(mio::go_to_work(p_adult, s, dt, params), mio::LocationType::Home);
+    }
+    for (auto s = t; s < t_school; s += dt) {
+        EXPECT_EQ(mio::go_to_school(p_child, s, dt, params), mio::LocationType::Home);
+    }
+    EXPECT_EQ(mio::go_to_work(p_adult, t_work, dt, params), mio::LocationType::Work);
+    EXPECT_EQ(mio::go_to_school(p_child, t_school, dt, params), mio::LocationType::School);
+
+    //return in the afternoon
+    auto work     = mio::Location(mio::LocationType::Work, 0);
+    auto school   = mio::Location(mio::LocationType::School, 0);
+    auto p_worker = mio::Person(work, mio::InfectionState::Susceptible, mio::AbmAgeGroup::Age35to59, {});
+    auto p_pupil  = mio::Person(school, mio::InfectionState::Susceptible, mio::AbmAgeGroup::Age5to14, {});
+    EXPECT_EQ(mio::go_to_work_next_time(p_worker, t + mio::hours(8), dt, params), t + mio::hours(16));
+    EXPECT_EQ(mio::go_to_school_next_time(p_pupil, t + mio::hours(8), dt, params), t + mio::hours(14));
+    EXPECT_EQ(mio::go_to_school_next_time(p_pupil, t + mio::hours(16), dt, params), t + mio::hours(16));
+
+    //return from the shop when the person stayed for an hour
+    auto shop   = mio::Location(mio::LocationType::BasicsShop, 0);
+    auto p_shop = mio::Person(home, mio::InfectionState::Susceptible, mio::AbmAgeGroup::Age35to59, {});
+    auto t_shop = t + mio::days(4) + mio::hours(9);
+    home.add_person(p_shop);
+    p_shop.migrate_to(home, shop);
+    EXPECT_EQ(mio::go_to_shop_next_time(p_shop, t_shop, dt, params), t_shop);
+    EXPECT_EQ(mio::go_to_shop(p_shop, t_shop, dt, params), mio::LocationType::BasicsShop);
+    p_shop.pass_time(dt);
+    EXPECT_EQ(mio::go_to_shop(p_shop, t_shop, dt, params), mio::LocationType::Home);
+
+    //rules that don't apply
+    EXPECT_EQ(mio::go_to_work_next_time(p_pupil, t, dt, params), never);
+    EXPECT_EQ(mio::go_to_shop_next_time(p_adult, t, dt, params), never);
+    EXPECT_EQ(mio::go_to_hospital_next_time(p_adult, t, dt, params), never);
+}
+
+TEST(TestMigrationRules, sample_random_departure)
+{
+    auto params       = mio::AbmMigrationParameters();
+    auto monday       = mio::TimePoint(0);
+    auto dt           = mio::hours(1);
+    auto destinations = mio::LocationTypeSet();
+    destinations.set(size_t(mio::LocationType::BasicsShop));
+    destinations.set(size_t(mio::LocationType::SocialEvent));
+    auto home = mio::Location(mio::LocationType::Home, 0);
+    auto p    = mio::Person(home, mio::InfectionState::Susceptible, mio::AbmAgeGroup::Age60to79, {});
+
+    ScopedMockDistribution<testing::StrictMock<MockDistribution<mio::ExponentialDistribution<double>>>>
+        mock_exponential_dist;
+
+    //thresholds for the shop and the event, the first step where the person can go that reaches the threshold
+    EXPECT_CALL(mock_exponential_dist.get_mock(), invoke)
+        .Times(2)
+        .WillOnce(testing::Return(0.01))
+        .WillOnce(testing::Return(100.));
+    EXPECT_EQ(mio::sample_random_departure(p, monday, dt, params, destinations),
+              std::make_pair(monday + mio::hours(8), mio::LocationType::BasicsShop));
+
+    EXPECT_CALL(mock_exponential_dist.get_mock(), invoke)
+        .Times(2)
+        .WillOnce(testing::Return(100.))
+        .WillOnce(testing::Return(0.01));
+    EXPECT_EQ(mio::sample_random_departure(p, monday, dt, params, destinations),
+              std::make_pair(monday + mio::hours(19), mio::LocationType::SocialEvent));
+
+    //the rate of one visit per day is spread over the steps of the day
+    EXPECT_CALL(mock_exponential_dist.get_mock(), invoke)
+        .Times(2)
+        .WillOnce(testing::Return(2.5 / 24))
+        .WillOnce(testing::Return(100.));
+    EXPECT_EQ(mio::sample_random_departure(p, monday, dt, params, destinations),
+              std::make_pair(monday + mio::hours(10), mio::LocationType::BasicsShop));
+
+    //no departure without destinations
+    EXPECT_EQ(mio::sample_random_departure(p, monday, dt, params, mio::LocationTypeSet()).second,
+              mio::LocationType::Home);
+}
+
 TEST(TestLockdownRules, school_closure)
 {
     auto t         = mio::TimePoint(0);
@@ -1128,6 +1331,9 @@ TEST(TestWorld, evolveMigration)
     EXPECT_EQ(p2.get_location_id().type, mio::LocationType::School);
     EXPECT_EQ(school.get_subpopulations().sum(), 1);
     EXPECT_EQ(work.get_subpopulations().sum(), 1);
+    EXPECT_THAT(work.get_members(), testing::ElementsAre(0u));
+    EXPECT_THAT(school.get_members(), testing::ElementsAre(1u));
+    EXPECT_THAT(world.get_individualized_location(home_id).get_members(), testing::IsEmpty());
 }
 
 TEST(TestSimulation, advance_random)
@@ -1154,6 +1360,53 @@ TEST(TestSimulation, advance_random)
     }
 }
 
+TEST(TestSimulation, resumeFromCheckpoint)
+{
+    auto make_world = [](bool event_driven) {
+        auto world = mio::World();
+        world.set_rng_seed(7);
+        world.set_event_driven(event_driven);
+        auto home   = world.add_location(mio::LocationType::Home);
+        auto work   = world.add_location(mio::LocationType::Work);
+        auto school = world.add_location(mio::LocationType::School);
+        auto shop   = world.add_location(mio::LocationType::BasicsShop);
+        world.get_individualized_location(shop).get_infection_parameters().set<mio::MaximumContacts>(5);
+        for (int i = 0; i < 100; ++i) {
+            auto state = i % 4 == 0 ? mio::InfectionState::Carrier : mio::InfectionState::Susceptible;
+            auto age   = i % 3 == 0 ? mio::AbmAgeGroup::Age5to14 : mio::AbmAgeGroup::Age15to34;
+            auto& p    = world.add_person(home, state, age);
+            for (auto loc : {home, age == mio::AbmAgeGroup::Age5to14 ? school : work, shop}) {
+                p.set_assigned_location(loc);
+            }
+        }
+        return world;
+    };
+
+    TempFileRegister file_register;
+    for (auto event_driven : {false, true}) {
+        auto path = file_register.get_unique_path("checkpoint-%%%%-%%%%.bin");
+
+        auto sim = mio::AbmSimulation(mio::TimePoint(0), make_world(event_driven));
+        sim.advance(mio::TimePoint(0) + mio::days(2));
+        ASSERT_THAT(mio::save_checkpoint(path, sim), IsSuccess());
+        sim.advance(mio::TimePoint(0) + mio::days(5));
+
+        //persons and locations are restored as well, the world doesn't need to be set up again
+        auto restored = mio::AbmSimulation(mio::TimePoint(0), mio::World());
+        ASSERT_THAT(mio::load_checkpoint(path, restored), IsSuccess());
+        ASSERT_EQ(restored.get_result().get_num_time_points(), 2 * 24 + 1);
+        restored.advance(mio::TimePoint(0) + mio::days(5));
+
+        ASSERT_EQ(restored.get_result().get_num_time_points(), sim.get_result().get_num_time_points());
+        for (Eigen::Index i = 0; i < sim.get_result().get_num_time_points(); ++i) {
+            ASSERT_EQ(restored.get_result().get_time(i), sim.get_result().get_time(i));
+            ASSERT_EQ(print_wrap(restored.get_result()[i]), print_wrap(sim.get_result()[i])) << "at time point " << i;
+        }
+        //something happened after the checkpoint
+        ASSERT_NE(print_wrap(sim.get_result()[2 * 24]), print_wrap(sim.get_result().get_last_value()));
+    }
+}
+
 TEST(TestDiscreteDistribution, generate)
 {
     using namespace mio;
@@ -1173,3 +1426,342 @@ TEST(TestDiscreteDistribution, generate)
         ASSERT_LE(d, 4);
     }
 }
+
+TEST(TestCounterBasedRng, philox)
+{
+    //known answers from the Random123 library
+    EXPECT_THAT(mio::CounterBasedRng::philox({0, 0, 0, 0}, {0, 0}),
+                testing::ElementsAre(0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8));
+    EXPECT_THAT(mio::CounterBasedRng::philox({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}),
+                testing::ElementsAre(0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1));
+
+    auto rng = mio::CounterBasedRng(0, {0, 0, 0});
+    EXPECT_EQ(rng(), 0x6627e8d5);
+    EXPECT_EQ(rng(), 0xe169c58d);
+    EXPECT_EQ(rng(), 0xbc57ac4c);
+    EXPECT_EQ(rng(), 0x9b00dbd8);
+    EXPECT_EQ(rng(), mio::CounterBasedRng::philox({1, 0, 0, 0}, {0, 0})[0]);
+}
+
+TEST(TestCounterBasedRng, scopedStream)
+{
+    auto draw = [](uint32_t stream) {
+        auto rng = mio::CounterBasedRng(123, {stream, 0, 0});
+        mio::ScopedRngStream scoped_rng(rng);
+        return std::make_pair(mio::UniformDistribution<double>::get_instance()(),
+                              mio::ExponentialDistribution<double>::get_instance()(1.0));
+    };
+    EXPECT_EQ(draw(0), draw(0));
+    EXPECT_NE(draw(0), draw(1));
+}
+
+TEST(TestDistributionAdapter, defaultSamplers)
+{
+    auto n        = 100000;
+    auto sum_exp  = 0.0;
+    auto sum_unif = 0.0;
+    auto counts   = std::array<int, 3>{};
+    auto weights  = std::vector<double>{1.0, 0.0, 3.0};
+    auto rng      = mio::CounterBasedRng(0, {1, 2, 3});
+    for (int i = 0; i < n; ++i) {
+        //alternate between the engine and a counter based generator
+        auto scoped_rng = i % 2 == 0 ? std::make_unique<mio::ScopedRngStream>(rng) : nullptr;
+        sum_exp += mio::ExponentialDistribution<double>::get_instance()(2.0);
+        auto u = mio::UniformDistribution<double>::get_instance()(2.0, 3.0);
+        ASSERT_GE(u, 2.0);
+        ASSERT_LT(u, 3.0);
+        sum_unif += u;
+        ++counts[mio::DiscreteDistribution<size_t>::get_instance()(weights)];
+    }
+    EXPECT_NEAR(sum_exp / n, 0.5, 0.01);
+    EXPECT_NEAR(sum_unif / n, 2.5, 0.01);
+    EXPECT_NEAR(counts[0] / double(n), 0.25, 0.01);
+    EXPECT_EQ(counts[1], 0);
+    EXPECT_NEAR(counts[2] / double(n), 0.75, 0.01);
+}
+
+TEST(TestDistributionAdapter, engineUsesStandardDistributions)
+{
+    //seeded sequences of thread_local_rng() are the same as with the standard distributions
+    auto rng     = mio::thread_local_rng();
+    auto weights = std::vector<double>{1.0, 2.0, 3.0};
+    EXPECT_EQ(mio::ExponentialDistribution<double>::get_instance()(2.0),
+              std::exponential_distribution<double>(2.0)(rng));
+    EXPECT_EQ(mio::thread_local_rng()(), rng());
+    EXPECT_EQ(mio::UniformDistribution<double>::get_instance()(2.0, 3.0),
+              std::uniform_real_distribution<double>(2.0, 3.0)(rng));
+    EXPECT_EQ(mio::DiscreteDistribution<size_t>::get_instance()(weights),
+              mio::DiscreteDistributionInPlace<size_t>(weights)(rng));
+    EXPECT_EQ(mio::thread_local_rng()(), rng());
+}
+
+TEST(TestDistributionAdapter, reseedAndRestoreGenerator)
+{
+    auto draw = [] {
+        return std::make_pair(mio::ExponentialDistribution<double>::get_instance()(1.0),
+                              mio::UniformDistribution<double>::get_instance()());
+    };
+    auto seeds = mio::thread_local_rng().get_seeds();
+    mio::thread_local_rng().seed({1, 2, 3, 4, 5, 6});
+    auto first = draw();
+    draw();
+    mio::thread_local_rng().seed({1, 2, 3, 4, 5, 6});
+    EXPECT_EQ(draw(), first);
+
+    //empty generator restores the default
+    auto& exponential = mio::ExponentialDistribution<double>::get_instance();
+    EXPECT_FALSE(exponential.get_generator());
+    exponential.set_generator([](auto&&) {
+        return -1.0;
+    });
+    EXPECT_EQ(exponential(1.0), -1.0);
+    exponential.set_generator({});
+    EXPECT_GE(exponential(1.0), 0.0);
+
+    mio::thread_local_rng().seed(seeds);
+}
+
+TEST(TestWorld, evolveIndependentOfNumThreads)
+{
+    auto make_world = [](int num_threads, bool event_driven) {
+        //same random numbers for setup of each world
+        auto rng = mio::CounterBasedRng(0, {0, 0, 0});
+        mio::ScopedRngStream scoped_rng(rng);
+
+        auto world = mio::World();
+        world.set_rng_seed(42);
+        world.set_num_threads(num_threads);
+        world.set_event_driven(event_driven);
+        auto home     = world.add_location(mio::LocationType::Home);
+        auto school   = world.add_location(mio::LocationType::School);
+        auto work     = world.add_location(mio::LocationType::Work);
+        auto shop     = world.add_location(mio::LocationType::BasicsShop);
+        auto event    = world.add_location(mio::LocationType::SocialEvent);
+        auto hospital = world.add_location(mio::LocationType::Hospital);
+        auto icu      = world.add_location(mio::LocationType::ICU);
+        for (int i = 0; i < 100; ++i) {
+            auto state  = i % 5 == 0 ? mio::InfectionState::Carrier
+                                     : (i % 7 == 0 ? mio::InfectionState::Infected : mio::InfectionState::Susceptible);
+            auto age    = i % 3 == 0 ? mio::AbmAgeGroup::Age5to14 : mio::AbmAgeGroup::Age15to34;
+            auto& p     = world.add_person(home, state, age);
+            for (auto loc : {home, age == mio::AbmAgeGroup::Age5to14 ? school : work, shop, event, hospital, icu}) {
+                p.set_assigned_location(loc);
+            }
+        }
+        return world;
+    };
+
+    for (auto event_driven : {false, true}) {
+        auto sim1 = mio::AbmSimulation(mio::TimePoint(0), make_world(1, event_driven));
+        auto sim4 = mio::AbmSimulation(mio::TimePoint(0), make_world(4, event_driven));
+        sim1.advance(mio::TimePoint(0) + mio::days(5));
+        sim4.advance(mio::TimePoint(0) + mio::days(5));
+
+        ASSERT_EQ(sim1.get_result().get_num_time_points(), sim4.get_result().get_num_time_points());
+        for (Eigen::Index i = 0; i < sim1.get_result().get_num_time_points(); ++i) {
+            ASSERT_EQ(print_wrap(sim1.get_result()[i]), print_wrap(sim4.get_result()[i])) << "at time point " << i;
+        }
+        //something happened
+        ASSERT_NE(print_wrap(sim1.get_result()[0]), print_wrap(sim1.get_result().get_last_value()));
+    }
+}
+
+TEST(TestWorld, locationMembers)
+{
+    auto world = mio::World();
+    auto home  = world.add_location(mio::LocationType::Home);
+    auto work  = world.add_location(mio::LocationType::Work);
+    auto shop  = world.add_location(mio::LocationType::BasicsShop);
+    for (int i = 0; i < 50; ++i) {
+        auto& p = world.add_person(home, mio::InfectionState::Susceptible);
+        for (auto loc : {home, work, shop}) {
+            p.set_assigned_location(loc);
+        }
+    }
+
+    for (auto t = mio::TimePoint(0); t < mio::TimePoint(0) + mio::days(3); t += mio::hours(1)) {
+        world.evolve(t, mio::hours(1));
+
+        //every person is member of its current location exactly once
+        size_t num_members = 0;
+        for (auto&& locations : world.get_locations()) {
+            for (auto& location : locations) {
+                for (auto idx : location.get_members()) {
+                    auto id = world.get_persons().begin()[idx].get_location_id();
+                    ASSERT_EQ(id.type, location.get_type());
+                    ASSERT_EQ(id.index, location.get_index());
+                }
+                num_members += location.get_members().size();
+            }
+        }
+        ASSERT_EQ(num_members, 50);
+    }
+}
+
+TEST(TestWorld, evolveEventDriven)
+{
+    //only recovery of carriers at rate 1 per day, compare to the exact distribution after one day
+    auto num_persons = 2000;
+    auto recovered   = std::array<double, 2>{};
+    for (auto event_driven : {false, true}) {
+        auto world = mio::World();
+        world.set_rng_seed(3);
+        world.set_event_driven(event_driven);
+        auto& params = world.get_global_infection_parameters();
+        params.get<mio::CarrierToInfected>()      = {{mio::AbmAgeGroup::Count, mio::VaccinationState::Count}, 0.};
+        params.get<mio::CarrierToRecovered>()     = {{mio::AbmAgeGroup::Count, mio::VaccinationState::Count}, 1.};
+        params.get<mio::RecoveredToSusceptible>() = {{mio::AbmAgeGroup::Count, mio::VaccinationState::Count}, 0.};
+        auto home = world.add_location(mio::LocationType::Home);
+        for (int i = 0; i < num_persons; ++i) {
+            world.add_person(home, mio::InfectionState::Carrier).set_assigned_location(home);
+        }
+
+        auto sim = mio::AbmSimulation(mio::TimePoint(0), std::move(world));
+        sim.advance(mio::TimePoint(0) + mio::days(1));
+        auto result = sim.get_result().get_last_value();
+        EXPECT_EQ(result.sum(), num_persons);
+        recovered[event_driven] = result[Eigen::Index(mio::InfectionState::Recovered_Carrier)] / num_persons;
+    }
+    EXPECT_NEAR(recovered[0], 1 - std::exp(-1.0), 0.05);
+    EXPECT_NEAR(recovered[1], 1 - std::exp(-1.0), 0.05);
+}
+
+TEST(TestWorld, eventDrivenTransitionsAreScheduled)
+{
+    auto world   = mio::World();
+    auto& params = world.get_global_infection_parameters();
+    params.get<mio::CarrierToInfected>()      = {{mio::AbmAgeGroup::Count, mio::VaccinationState::Count}, 0.};
+    params.get<mio::CarrierToRecovered>()     = {{mio::AbmAgeGroup::Count, mio::VaccinationState::Count}, 0.5};
+    params.get<mio::RecoveredToSusceptible>() = {{mio::AbmAgeGroup::Count, mio::VaccinationState::Count}, 0.};
+    world.set_event_driven(true);
+    auto home = world.add_location(mio::LocationType::Home);
+    auto& p   = world.add_person(home, mio::InfectionState::Carrier);
+    p.set_assigned_location(home);
+
+    ScopedMockDistribution<testing::StrictMock<MockDistribution<mio::ExponentialDistribution<double>>>>
+        mock_exponential_dist;
+    ScopedMockDistribution<testing::StrictMock<MockDistribution<mio::DiscreteDistribution<size_t>>>>
+        mock_discrete_dist;
+    //the time until the transition is drawn once, not every step
+    EXPECT_CALL(mock_exponential_dist.get_mock(), invoke).Times(1).WillOnce(testing::Return(2.5 / 24));
+    EXPECT_CALL(mock_discrete_dist.get_mock(), invoke).Times(1).WillOnce(testing::Return(1));
+
+    world.evolve(mio::TimePoint(0), mio::hours(1));
+    world.evolve(mio::TimePoint(0) + mio::hours(1), mio::hours(1));
+    EXPECT_EQ(p.get_infection_state(), mio::InfectionState::Carrier);
+    world.evolve(mio::TimePoint(0) + mio::hours(2), mio::hours(1));
+    EXPECT_EQ(p.get_infection_state(), mio::InfectionState::Recovered_Carrier);
+    EXPECT_EQ(world.get_individualized_location(home).get_subpopulation(mio::InfectionState::Recovered_Carrier), 1);
+    world.evolve(mio::TimePoint(0) + mio::hours(3), mio::hours(1));
+    EXPECT_EQ(p.get_infection_state(), mio::InfectionState::Recovered_Carrier);
+}
+
+TEST(TestWorld, eventDrivenIncubationIsNotRestarted)
+{
+    for (auto switch_mode : {false, true}) {
+        auto world   = mio::World();
+        auto& params = world.get_global_infection_parameters();
+        params.get<mio::IncubationPeriod>() = {{mio::AbmAgeGroup::Count, mio::VaccinationState::Count}, 1.};
+        world.set_event_driven(true);
+        auto home = world.add_location(mio::LocationType::Home);
+
+        //5 hours until the exposed person becomes a carrier
+        ScopedMockDistribution<testing::StrictMock<MockDistribution<mio::UniformIntDistribution<int>>>>
+            mock_uniform_int_dist;
+        EXPECT_CALL(mock_uniform_int_dist.get_mock(), invoke).Times(1).WillOnce(testing::Return(5));
+        auto& exposed = world.add_person(home, mio::InfectionState::Exposed);
+        auto& other   = world.add_person(home, mio::InfectionState::Recovered_Infected);
+        exposed.set_assigned_location(home);
+        other.set_assigned_location(home);
+
+        auto t = mio::TimePoint(0);
+        for (int i = 0; i < 5; ++i) {
+            if (i == 2) {
+                if (switch_mode) {
+                    world.set_event_driven(false);
+                }
+                else {
+                    world.set_infection_state(other, mio::InfectionState::Susceptible);
+                }
+            }
+            if (i == 4 && switch_mode) {
+                world.set_event_driven(true);
+            }
+            world.evolve(t, mio::hours(1));
+            t += mio::hours(1);
+            EXPECT_EQ(exposed.get_infection_state(), mio::InfectionState::Exposed) << "step " << i;
+        }
+        world.evolve(t, mio::hours(1));
+        EXPECT_EQ(exposed.get_infection_state(), mio::InfectionState::Carrier);
+    }
+}
+
+TEST(TestWorld, eventDrivenCommuteMatchesDefault)
+{
+    //commutes are deterministic, so both modes move the persons at the same time
+    auto locations = std::array<std::vector<mio::LocationId>, 2>{};
+    for (auto event_driven : {false, true}) {
+        auto world = mio::World();
+        world.set_rng_seed(7);
+        world.set_event_driven(event_driven);
+        auto home   = world.add_location(mio::LocationType::Home);
+        auto work   = world.add_location(mio::LocationType::Work);
+        auto school = world.add_location(mio::LocationType::School);
+        for (auto age : {mio::AbmAgeGroup::Age5to14, mio::AbmAgeGroup::Age15to34, mio::AbmAgeGroup::Age35to59,
+                         mio::AbmAgeGroup::Age60to79}) {
+            for (int i = 0; i < 25; ++i) {
+                auto& p = world.add_person(home, mio::InfectionState::Susceptible, age);
+                p.set_assigned_location(home);
+                p.set_assigned_location(work);
+                p.set_assigned_location(school);
+            }
+        }
+
+        auto t = mio::TimePoint(0);
+        for (int i = 0; i < 3 * 24; ++i) {
+            world.evolve(t, mio::hours(1));
+            t += mio::hours(1);
+            for (auto& p : world.get_persons()) {
+                locations[event_driven].push_back(p.get_location_id());
+            }
+        }
+    }
+    ASSERT_EQ(locations[0].size(), locations[1].size());
+    for (size_t i = 0; i < locations[0].size(); ++i) {
+        ASSERT_EQ(locations[0][i].type, locations[1][i].type) << "entry " << i;
+        ASSERT_EQ(locations[0][i].index, locations[1][i].index) << "entry " << i;
+    }
+}
+
+TEST(TestWorld, eventDrivenShoppingFrequency)
+{
+    //the sampled departures visit the shop as often as the rule applied in every step
+    auto num_persons = 1000;
+    auto visits      = std::array<double, 2>{};
+    for (auto event_driven : {false, true}) {
+        auto world = mio::World();
+        world.set_rng_seed(11);
+        world.set_event_driven(event_driven);
+        auto home = world.add_location(mio::LocationType::Home);
+        auto shop = world.add_location(mio::LocationType::BasicsShop);
+        for (int i = 0; i < num_persons; ++i) {
+            auto& p = world.add_person(home, mio::InfectionState::Susceptible, mio::AbmAgeGroup::Age35to59);
+            p.set_assigned_location(home);
+            p.set_assigned_location(shop);
+        }
+
+        auto t = mio::TimePoint(0);
+        for (int i = 0; i < 7 * 24; ++i) {
+            world.evolve(t, mio::hours(1));
+            t += mio::hours(1);
+            for (auto& p : world.get_persons()) {
+                if (p.get_location_id().type == mio::LocationType::BasicsShop &&
+                    p.get_time_at_location() < mio::hours(1)) {
+                    ++visits[event_driven];
+                }
+            }
+        }
+    }
+    EXPECT_GT(visits[0], 2 * num_persons);
+    EXPECT_NEAR(visits[1] / visits[0], 1.0, 0.1);
+}
@@ -456,4 +456,41 @@ TEST(TestDistance, one_compartment)
     v2[1].add_time_point(1.0, Eigen::VectorXd::Constant(n, 0.0))[e] = 10.0;
 
     ASSERT_EQ(mio::result_distance_2norm(v1, v2, mio::InfectionState::Exposed), std::sqrt(4.0 + 1.0 + 0.0 + 36.0));
-}
\ No newline at end of file
+}
+
+TEST(TestInterpolateTimeSeries, singlePrecision)
+{
+    using Vec = mio::TimeSeries<float>::Vector;
+    mio::TimeSeries<float> ts(1);
+    ts.add_time_point(0.0f, Vec::Constant(1, 0.0f));
+    ts.add_time_point(0.5f, Vec::Constant(1, 1.0f));
+    ts.add_time_point(2.5f, Vec::Constant(1, 2.0f));
+
+    auto interpolated = mio::interpolate_simulation_result(ts);
+    static_assert(std::is_same<decltype(interpolated), mio::TimeSeries<float>>::value, "wrong type");
+
+    ASSERT_THAT(interpolated.get_times(), testing::ElementsAre(0.0f, 1.0f, 2.0f, 3.0f));
+    ASSERT_FLOAT_EQ(interpolated[1][0], 1.25f);
+    ASSERT_FLOAT_EQ(interpolated[2][0], 1.75f);
+    ASSERT_FLOAT_EQ(interpolated[3][0], 2.0f);
+}
+
+TEST(TestEnsembleMean, singlePrecision)
+{
+    using Vec = mio::TimeSeries<float>::Vector;
+    std::vector<std::vector<mio::TimeSeries<float>>> ensemble(
+        2, std::vector<mio::TimeSeries<float>>(1, mio::TimeSeries<float>(1)));
+    ensemble[0][0].add_time_point(0.0f, Vec::Constant(1, 1.0f));
+    ensemble[1][0].add_time_point(0.0f, Vec::Constant(1, 2.0f));
+
+    auto mean = mio::ensemble_mean(ensemble);
+    ASSERT_EQ(mean.size(), 1);
+    ASSERT_FLOAT_EQ(mean[0][0][0], 1.5f);
+
+    auto percentile = mio::ensemble_percentile(ensemble, 0.6);
+    ASSERT_FLOAT_EQ(percentile[0][0][0], 2.0f);
+
+    auto sum = mio::sum_nodes(ensemble);
+    ASSERT_EQ(sum.size(), 2);
+    ASSERT_FLOAT_EQ(sum[1][0][0][0], 2.0f);
+}
@@ -0,0 +1,134 @@
+/* 
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele, Wadim Koslow
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/io/async_writer.h"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(TestAsyncWriter, writesInOrder)
+{
+    std::vector<size_t> written;
+    std::vector<int> values;
+    {
+        mio::AsyncWriter<int> writer(
+            [&](size_t idx, int&& v) {
+                written.push_back(idx);
+                values.push_back(v);
+                return mio::success();
+            },
+            2);
+        for (auto idx : {2, 0, 1, 4, 3}) {
+            writer.add(idx, 10 * idx);
+        }
+        ASSERT_TRUE(writer.finish());
+    }
+    EXPECT_THAT(written, testing::ElementsAre(0, 1, 2, 3, 4));
+    EXPECT_THAT(values, testing::ElementsAre(0, 10, 20, 30, 40));
+}
+
+TEST(TestAsyncWriter, parallelProducers)
+{
+    const size_t num_items   = 200;
+    const size_t max_queued  = 3;
+    const size_t num_threads = 4;
+
+    std::vector<size_t> written;
+    std::atomic<size_t> num_added{0};
+    mio::AsyncWriter<size_t> writer(
+        [&](size_t idx, size_t&& v) {
+            EXPECT_EQ(idx, v);
+            //items up to idx, full queue, and the item that is accepted when the queue is full
+            EXPECT_LE(num_added.load(), idx + 1 + max_queued + 1);
+            written.push_back(idx);
+            return mio::success();
+        },
+        max_queued);
+
+    //each thread produces every num_threads-th item, threads run in random order
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<size_t> indices;
+            for (size_t i = t; i < num_items; i += num_threads) {
+                indices.push_back(i);
+            }
+            for (auto i : indices) {
+                writer.add(i, i);
+                ++num_added;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_TRUE(writer.finish());
+
+    ASSERT_EQ(written.size(), num_items);
+    for (size_t i = 0; i < num_items; ++i) {
+        EXPECT_EQ(written[i], i);
+    }
+}
+
+TEST(TestAsyncWriter, stopsAfterError)
+{
+    std::vector<size_t> written;
+    mio::AsyncWriter<int> writer(
+        [&](size_t idx, int&&) -> mio::IOResult<void> {
+            written.push_back(idx);
+            if (idx == 1) {
+                return mio::failure(mio::StatusCode::UnknownError, "error");
+            }
+            return mio::success();
+        },
+        10);
+    for (size_t idx = 0; idx < 4; ++idx) {
+        writer.add(idx, 0);
+    }
+    auto status = writer.finish();
+    ASSERT_FALSE(status);
+    EXPECT_EQ(status.error().code(), mio::StatusCode::UnknownError);
+    EXPECT_THAT(written, testing::ElementsAre(0, 1));
+}
+
+TEST(TestAsyncWriter, cancelUnblocksProducers)
+{
+    std::vector<size_t> written;
+    mio::AsyncWriter<int> writer(
+        [&](size_t idx, int&&) {
+            written.push_back(idx);
+            return mio::success();
+        },
+        1);
+
+    //index 0 is never added, so the producer waits until the writer is cancelled
+    std::thread producer([&] {
+        for (size_t idx = 1; idx < 4; ++idx) {
+            writer.add(idx, 0);
+        }
+    });
+    writer.cancel();
+    producer.join();
+
+    auto status = writer.finish();
+    ASSERT_FALSE(status);
+    EXPECT_TRUE(written.empty());
+}
@@ -0,0 +1,267 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/io/binary_serializer.h"
+#include "memilio/utils/custom_index_array.h"
+#include "memilio/utils/uncertain_value.h"
+#include "memilio/utils/time_series.h"
+#include "secir/secir.h"
+#include "matchers.h"
+#include "gtest/gtest.h"
+#include <tuple>
+#include <vector>
+
+namespace binarytest
+{
+struct Foo {
+    int i;
+    template <class IOContext>
+    void serialize(IOContext& io) const
+    {
+        auto obj = io.create_object("Foo");
+        obj.add_element("i", i);
+    }
+
+    template <class IOContext>
+    static mio::IOResult<Foo> deserialize(IOContext& io)
+    {
+        auto obj = io.expect_object("Foo");
+        auto i   = obj.expect_element("i", mio::Tag<int>{});
+        return mio::apply(
+            io,
+            [](auto i_) {
+                return Foo{i_};
+            },
+            i);
+    }
+    bool operator==(const Foo& other) const
+    {
+        return i == other.i;
+    }
+};
+
+struct Bar {
+    std::string s;
+    std::vector<Foo> v;
+    boost::optional<Foo> o;
+    std::vector<double> d;
+
+    template <class IOContext>
+    void serialize(IOContext& io) const
+    {
+        auto obj = io.create_object("Bar");
+        obj.add_element("s", s);
+        obj.add_list("v", v.begin(), v.end());
+        obj.add_optional("o", o.get_ptr());
+        obj.add_list("d", d.begin(), d.end());
+    }
+    template <class IOContext>
+    static mio::IOResult<Bar> deserialize(IOContext& io)
+    {
+        auto obj = io.expect_object("Bar");
+        auto s   = obj.expect_element("s", mio::Tag<std::string>{});
+        auto v   = obj.expect_list("v", mio::Tag<Foo>{});
+        auto o   = obj.expect_optional("o", mio::Tag<Foo>{});
+        auto d   = obj.expect_list("d", mio::Tag<double>{});
+        return mio::apply(
+            io,
+            [](auto&& s_, auto&& v_, auto&& o_, auto&& d_) {
+                return Bar{s_, v_, o_, d_};
+            },
+            s, v, o, d);
+    }
+    bool operator==(const Bar& other) const
+    {
+        return s == other.s && v == other.v && o == other.o && d == other.d;
+    }
+};
+
+struct Tag {
+};
+
+} // namespace binarytest
+
+TEST(TestBinarySerializer, basic_type)
+{
+    auto stream = mio::serialize_binary(-3);
+    ASSERT_THAT(print_wrap(stream), IsSuccess());
+    ASSERT_EQ(stream.value().size(), sizeof(int));
+    //little endian on every machine
+    EXPECT_EQ(stream.value().data()[0], 0xfd);
+    EXPECT_EQ(stream.value().data()[3], 0xff);
+    auto r = mio::deserialize_binary(stream.value(), mio::Tag<int>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    EXPECT_EQ(r.value(), -3);
+
+    auto r_string = mio::deserialize_binary(mio::serialize_binary(std::string("Hello")).value(),
+                                            mio::Tag<std::string>{});
+    ASSERT_THAT(print_wrap(r_string), IsSuccess());
+    EXPECT_EQ(r_string.value(), "Hello");
+}
+
+TEST(TestBinarySerializer, aggregate)
+{
+    binarytest::Bar bar{"Hello", {{1}, {2}}, binarytest::Foo{3}, {0.5, 1.5, 2.5}};
+    auto stream = mio::serialize_binary(bar);
+    ASSERT_THAT(print_wrap(stream), IsSuccess());
+    auto r = mio::deserialize_binary(stream.value(), mio::Tag<binarytest::Bar>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    EXPECT_EQ(r.value(), bar);
+
+    bar.o = boost::none;
+    bar.v.clear();
+    auto r_empty = mio::deserialize_binary(mio::serialize_binary(bar).value(), mio::Tag<binarytest::Bar>{});
+    ASSERT_THAT(print_wrap(r_empty), IsSuccess());
+    EXPECT_EQ(r_empty.value(), bar);
+}
+
+TEST(TestBinarySerializer, tuple)
+{
+    auto tup    = std::make_tuple(1, 2.5, std::string("Hello"), true);
+    auto stream = mio::serialize_binary(tup);
+    ASSERT_THAT(print_wrap(stream), IsSuccess());
+    auto r = mio::deserialize_binary(stream.value(), mio::Tag<decltype(tup)>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    EXPECT_EQ(r.value(), tup);
+}
+
+TEST(TestBinarySerializer, matrix)
+{
+    Eigen::MatrixXd m(2, 3);
+    m << 1.0, 2.0, 3.0, 4.0, 5.0, 6.0;
+    auto stream = mio::serialize_binary(m);
+    ASSERT_THAT(print_wrap(stream), IsSuccess());
+    //dimensions and elements, no overhead per element
+    EXPECT_EQ(stream.value().size(), 2 * sizeof(int64_t) + 6 * sizeof(double));
+    auto r = mio::deserialize_binary(stream.value(), mio::Tag<Eigen::MatrixXd>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    EXPECT_EQ(print_wrap(r.value()), print_wrap(m));
+
+    //fixed size must match
+    auto r_fixed = mio::deserialize_binary(stream.value(), mio::Tag<Eigen::Matrix2d>{});
+    EXPECT_EQ(r_fixed.error().code(), mio::StatusCode::InvalidValue);
+}
+
+TEST(TestBinarySerializer, customindexarray)
+{
+    mio::CustomIndexArray<double, binarytest::Tag> a(mio::Index<binarytest::Tag>(2));
+    a[mio::Index<binarytest::Tag>(0)] = 1.0;
+    a[mio::Index<binarytest::Tag>(1)] = 2.0;
+    auto stream                       = mio::serialize_binary(a);
+    ASSERT_THAT(print_wrap(stream), IsSuccess());
+    auto r = mio::deserialize_binary(stream.value(), mio::Tag<mio::CustomIndexArray<double, binarytest::Tag>>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    EXPECT_EQ(r.value().size(), mio::Index<binarytest::Tag>(2));
+    EXPECT_THAT(r.value(), testing::ElementsAre(1.0, 2.0));
+}
+
+TEST(TestBinarySerializer, uncertain_value)
+{
+    mio::UncertainValue uv(2.0);
+    uv.set_distribution(mio::ParameterDistributionNormal(-1.0, 3.0, 1.0, 0.5));
+    auto stream = mio::serialize_binary(uv);
+    ASSERT_THAT(print_wrap(stream), IsSuccess());
+    auto r = mio::deserialize_binary(stream.value(), mio::Tag<mio::UncertainValue>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    EXPECT_EQ(double(r.value()), 2.0);
+    auto distribution = dynamic_cast<mio::ParameterDistributionNormal*>(r.value().get_distribution().get());
+    ASSERT_NE(distribution, nullptr);
+    EXPECT_EQ(distribution->get_mean(), 1.0);
+    EXPECT_EQ(distribution->get_standard_dev(), 0.5);
+    EXPECT_EQ(distribution->get_lower_bound(), -1.0);
+    EXPECT_EQ(distribution->get_upper_bound(), 3.0);
+
+    auto r_omit = mio::deserialize_binary(mio::serialize_binary(uv, mio::IOF_OmitDistributions).value(),
+                                          mio::Tag<mio::UncertainValue>{}, mio::IOF_OmitDistributions);
+    ASSERT_THAT(print_wrap(r_omit), IsSuccess());
+    EXPECT_EQ(double(r_omit.value()), 2.0);
+    EXPECT_EQ(r_omit.value().get_distribution(), nullptr);
+}
+
+TEST(TestBinarySerializer, model)
+{
+    mio::SecirModel model(2);
+    model.parameters.get<mio::IncubationTime>()[mio::AgeGroup(1)] = 5.2;
+    model.parameters.get<mio::IncubationTime>()[mio::AgeGroup(1)].set_distribution(
+        mio::ParameterDistributionUniform(4.0, 6.0));
+    model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat()[0].get_baseline().setConstant(10);
+    model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat()[0].add_damping(0.5, mio::SimulationTime(5.0));
+    model.populations[{mio::AgeGroup(0), mio::InfectionState::Infected}] = 100;
+    model.populations.set_difference_from_total({mio::AgeGroup(0), mio::InfectionState::Susceptible}, 10000);
+
+    auto stream = mio::serialize_binary(model);
+    ASSERT_THAT(print_wrap(stream), IsSuccess());
+    auto r = mio::deserialize_binary(stream.value(), mio::Tag<mio::SecirModel>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    EXPECT_EQ(r.value().populations.get_total(), model.populations.get_total());
+    EXPECT_EQ(r.value().parameters.get<mio::ContactPatterns>().get_cont_freq_mat(),
+              model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat());
+
+    //serializing the restored model produces exactly the same data
+    auto stream2 = mio::serialize_binary(r.value());
+    ASSERT_THAT(print_wrap(stream2), IsSuccess());
+    EXPECT_EQ(stream2.value().bytes(), stream.value().bytes());
+}
+
+TEST(TestBinarySerializer, errors)
+{
+    binarytest::Bar bar{"Hello", {{1}, {2}}, binarytest::Foo{3}, {0.5, 1.5, 2.5}};
+    auto bytes = mio::serialize_binary(bar).value().bytes();
+
+    //truncated data
+    for (auto n : {size_t(0), size_t(5), bytes.size() / 2, bytes.size() - 1}) {
+        auto truncated = mio::ByteStream(std::vector<unsigned char>(bytes.begin(), bytes.begin() + n));
+        auto r         = mio::deserialize_binary(truncated, mio::Tag<binarytest::Bar>{});
+        ASSERT_FALSE(r) << "truncated to " << n << " bytes";
+        EXPECT_EQ(r.error().code(), mio::StatusCode::InvalidFileFormat);
+    }
+
+    //corrupted size of a list
+    auto corrupted = bytes;
+    //string size + string + list size
+    auto list_pos = sizeof(uint64_t) + 5;
+    ASSERT_GE(corrupted.size(), list_pos + sizeof(uint64_t));
+    for (size_t i = list_pos; i < list_pos + sizeof(uint64_t); ++i) {
+        corrupted.data()[i] = 0xff;
+    }
+    auto r = mio::deserialize_binary(mio::ByteStream(corrupted), mio::Tag<binarytest::Bar>{});
+    ASSERT_FALSE(r);
+    EXPECT_EQ(r.error().code(), mio::StatusCode::InvalidFileFormat);
+}
+
+TEST(TestBinarySerializer, time_series)
+{
+    mio::TimeSeries<double> ts(2);
+    for (int i = 0; i < 5; ++i) {
+        ts.add_time_point(i * 0.5, Eigen::Vector2d(i, 2 * i));
+    }
+    ts.remove_time_point(0); //not stored at the front of the buffer
+    auto stream = mio::serialize_binary(ts);
+    ASSERT_THAT(print_wrap(stream), IsSuccess());
+    //sizes and one block of data
+    EXPECT_EQ(stream.value().size(), 3 * sizeof(int64_t) + 12 * sizeof(double));
+
+    auto r = mio::deserialize_binary(stream.value(), mio::Tag<mio::TimeSeries<double>>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    ASSERT_EQ(r.value().get_num_time_points(), 4);
+    for (Eigen::Index i = 0; i < 4; ++i) {
+        EXPECT_EQ(r.value().get_time(i), ts.get_time(i));
+        EXPECT_EQ(print_wrap(r.value()[i]), print_wrap(ts[i]));
+    }
+}
@@ -0,0 +1,251 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/io/checkpoint.h"
+#include "memilio/mobility/mobility.h"
+#include "secir/secir.h"
+#include "matchers.h"
+#include "temp_file_register.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+using MigrationGraph = mio::Graph<mio::SimulationNode<mio::SecirSimulation<>>, mio::MigrationEdge>;
+
+MigrationGraph make_checkpoint_graph()
+{
+    mio::SecirModel model(1);
+    model.parameters.get<mio::IncubationTime>()[mio::AgeGroup(0)]                 = 5.2;
+    model.parameters.get<mio::InfectiousTimeMild>()[mio::AgeGroup(0)]             = 6;
+    model.parameters.get<mio::SerialInterval>()[mio::AgeGroup(0)]                 = 4.2;
+    model.parameters.get<mio::HospitalizedToHomeTime>()[mio::AgeGroup(0)]         = 12;
+    model.parameters.get<mio::HomeToHospitalizedTime>()[mio::AgeGroup(0)]         = 5;
+    model.parameters.get<mio::HospitalizedToICUTime>()[mio::AgeGroup(0)]          = 2;
+    model.parameters.get<mio::ICUToHomeTime>()[mio::AgeGroup(0)]                  = 8;
+    model.parameters.get<mio::ICUToDeathTime>()[mio::AgeGroup(0)]                 = 5;
+    model.parameters.get<mio::InfectionProbabilityFromContact>()[mio::AgeGroup(0)] = 0.05;
+    model.parameters.get<mio::RelativeCarrierInfectability>()[mio::AgeGroup(0)]    = 1;
+    model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat()[0].get_baseline().setConstant(10);
+    model.populations[{mio::AgeGroup(0), mio::InfectionState::Infected}] = 100;
+    model.populations.set_difference_from_total({mio::AgeGroup(0), mio::InfectionState::Susceptible}, 10000);
+
+    //low threshold, so NPIs are implemented in the nodes and on the edges during the simulation
+    mio::DynamicNPIs npis;
+    npis.set_threshold(0.001 * 10'000, {mio::DampingSampling{0.5, mio::DampingLevel(0), mio::DampingType(0),
+                                                             mio::SimulationTime(0), {0}, Eigen::VectorXd::Ones(1)}});
+    npis.set_duration(mio::SimulationTime(3.0));
+    npis.set_base_value(10'000);
+    npis.set_interval(mio::SimulationTime(1.0));
+    model.parameters.get<mio::DynamicNPIsInfected>() = npis;
+
+    mio::MigrationParameters migration(Eigen::VectorXd::Constant(Eigen::Index(mio::InfectionState::Count), 0.1));
+    migration.set_dynamic_npis_infected(npis);
+
+    MigrationGraph g;
+    g.add_node(0, model, 0.0);
+    model.populations[{mio::AgeGroup(0), mio::InfectionState::Infected}] = 0;
+    g.add_node(1, model, 0.0);
+    g.add_edge(0, 1, migration);
+    g.add_edge(1, 0, migration);
+    return g;
+}
+
+} // namespace
+
+TEST(TestCheckpoint, graphSimulationResumesIdentically)
+{
+    TempFileRegister file_register;
+    auto path = file_register.get_unique_path("checkpoint-%%%%-%%%%.bin");
+
+    auto sim = mio::make_migration_sim(0.0, 0.5, make_checkpoint_graph());
+    sim.advance(4.5);
+    //NPIs are active at the checkpoint
+    ASSERT_GT(sim.get_graph()
+                  .nodes()[0]
+                  .property.get_simulation()
+                  .get_model()
+                  .parameters.get<mio::ContactPatterns>()
+                  .get_cont_freq_mat()[0]
+                  .get_dampings()
+                  .size(),
+              0);
+    ASSERT_GT(sim.get_graph().edges()[0].property.get_parameters().get_coefficients()[0].get_dampings().size(), 0);
+    ASSERT_THAT(mio::save_checkpoint(path, sim), IsSuccess());
+    sim.advance(10.0);
+
+    auto restored = mio::make_migration_sim(0.0, 0.5, make_checkpoint_graph());
+    ASSERT_THAT(mio::load_checkpoint(path, restored), IsSuccess());
+    EXPECT_EQ(restored.get_t(), 4.5);
+    restored.advance(10.0);
+
+    for (size_t n = 0; n < 2; ++n) {
+        auto& result          = sim.get_graph().nodes()[n].property.get_result();
+        auto& restored_result = restored.get_graph().nodes()[n].property.get_result();
+        ASSERT_EQ(restored_result.get_num_time_points(), result.get_num_time_points());
+        for (Eigen::Index i = 0; i < result.get_num_time_points(); ++i) {
+            ASSERT_EQ(restored_result.get_time(i), result.get_time(i));
+            ASSERT_EQ(print_wrap(restored_result[i]), print_wrap(result[i])) << "at time point " << i;
+        }
+        auto& contacts =
+            sim.get_graph().nodes()[n].property.get_simulation().get_model().parameters.get<mio::ContactPatterns>();
+        auto& restored_contacts = restored.get_graph()
+                                      .nodes()[n]
+                                      .property.get_simulation()
+                                      .get_model()
+                                      .parameters.get<mio::ContactPatterns>();
+        EXPECT_EQ(restored_contacts.get_cont_freq_mat(), contacts.get_cont_freq_mat());
+    }
+    for (size_t e = 0; e < 2; ++e) {
+        EXPECT_EQ(restored.get_graph().edges()[e].property.get_parameters().get_coefficients(),
+                  sim.get_graph().edges()[e].property.get_parameters().get_coefficients());
+    }
+}
+
+TEST(TestCheckpoint, timeSeriesInStream)
+{
+    mio::TimeSeries<double> ts(2);
+    for (int i = 0; i < 5; ++i) {
+        ts.add_time_point(i * 0.5, Eigen::Vector2d(i, 2 * i));
+    }
+    ts.remove_time_point(0); //not stored at the front of the buffer
+
+    std::stringstream stream;
+    mio::CheckpointWriter writer(stream);
+    writer.write(ts);
+    ASSERT_THAT(writer.get_status(), IsSuccess());
+
+    mio::TimeSeries<double> restored(2);
+    mio::CheckpointReader reader(stream);
+    ASSERT_THAT(reader.read(restored), IsSuccess());
+    ASSERT_EQ(restored.get_num_time_points(), 4);
+    for (Eigen::Index i = 0; i < 4; ++i) {
+        EXPECT_EQ(restored.get_time(i), ts.get_time(i));
+        EXPECT_EQ(print_wrap(restored[i]), print_wrap(ts[i]));
+    }
+
+    //different number of elements
+    stream.clear();
+    stream.seekg(0);
+    mio::TimeSeries<double> wrong_size(3);
+    EXPECT_EQ(reader.read(wrong_size).error().code(), mio::StatusCode::InvalidValue);
+}
+
+TEST(TestCheckpoint, sizeExceedsStream)
+{
+    //sizes from corrupted data are checked before memory is allocated
+    auto read_corrupted = [](auto&& value, std::initializer_list<int64_t> sizes) {
+        std::stringstream stream;
+        mio::CheckpointWriter writer(stream);
+        for (auto size : sizes) {
+            writer.write(size);
+        }
+        writer.write(1.0);
+        mio::CheckpointReader reader(stream);
+        return reader.read(value);
+    };
+    std::vector<double> v;
+    EXPECT_EQ(read_corrupted(v, {int64_t(1) << 60}).error().code(), mio::StatusCode::InvalidFileFormat);
+    std::vector<std::vector<double>> vv;
+    EXPECT_EQ(read_corrupted(vv, {int64_t(1) << 60}).error().code(), mio::StatusCode::InvalidFileFormat);
+    Eigen::MatrixXd m;
+    EXPECT_EQ(read_corrupted(m, {int64_t(1) << 32, int64_t(1) << 32}).error().code(),
+              mio::StatusCode::InvalidFileFormat);
+    EXPECT_EQ(read_corrupted(m, {2, int64_t(1) << 62}).error().code(), mio::StatusCode::InvalidFileFormat);
+    mio::TimeSeries<double> ts(2);
+    EXPECT_EQ(read_corrupted(ts, {2, int64_t(1) << 40}).error().code(), mio::StatusCode::InvalidFileFormat);
+
+    //sizes that fit are read
+    EXPECT_THAT(read_corrupted(v, {1}), IsSuccess());
+    EXPECT_EQ(v, std::vector<double>{1.0});
+}
+
+TEST(TestCheckpoint, errors)
+{
+    TempFileRegister file_register;
+    auto path = file_register.get_unique_path("checkpoint-%%%%-%%%%.bin");
+    auto sim  = mio::make_migration_sim(0.0, 0.5, make_checkpoint_graph());
+
+    //file doesn't exist
+    EXPECT_EQ(mio::load_checkpoint(path, sim).error().code(), mio::StatusCode::FileNotFound);
+
+    //not a checkpoint
+    {
+        std::ofstream file(path);
+        file << "{\"not\": \"a checkpoint\"}";
+    }
+    EXPECT_EQ(mio::load_checkpoint(path, sim).error().code(), mio::StatusCode::InvalidFileFormat);
+
+    //different graph
+    ASSERT_THAT(mio::save_checkpoint(path, sim), IsSuccess());
+    auto graph = make_checkpoint_graph();
+    auto model = graph.nodes()[0].property.get_simulation().get_model();
+    graph.add_node(2, model, 0.0);
+    auto other_sim = mio::make_migration_sim(0.0, 0.5, std::move(graph));
+    EXPECT_EQ(mio::load_checkpoint(path, other_sim).error().code(), mio::StatusCode::InvalidValue);
+
+    //truncated file
+    std::string content;
+    {
+        std::ifstream file(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(content.data(), std::streamsize(content.size() / 2));
+    }
+    EXPECT_EQ(mio::load_checkpoint(path, sim).error().code(), mio::StatusCode::InvalidFileFormat);
+}
+
+TEST(TestCheckpoint, temporaryFileIsRemoved)
+{
+    TempFileRegister file_register;
+    auto dir = file_register.get_unique_path("checkpoint-%%%%-%%%%");
+    boost::filesystem::create_directory(dir);
+    auto path             = dir + "/checkpoint.bin";
+    auto num_files_in_dir = [&dir] {
+        return std::distance(boost::filesystem::directory_iterator(dir), boost::filesystem::directory_iterator());
+    };
+
+    //error while writing
+    {
+        mio::details::CheckpointOutputFile file(path);
+        ASSERT_THAT(file.get_status(), IsSuccess());
+        file.get_stream().setstate(std::ios::badbit);
+        EXPECT_FALSE(file.commit());
+    }
+    EXPECT_EQ(num_files_in_dir(), 0);
+
+    //aborted before commit
+    {
+        mio::details::CheckpointOutputFile file(path);
+        ASSERT_THAT(file.get_status(), IsSuccess());
+        file.get_stream() << "incomplete";
+        EXPECT_EQ(num_files_in_dir(), 1);
+    }
+    EXPECT_EQ(num_files_in_dir(), 0);
+
+    //only the complete file remains
+    auto sim = mio::make_migration_sim(0.0, 0.5, make_checkpoint_graph());
+    ASSERT_THAT(mio::save_checkpoint(path, sim), IsSuccess());
+    EXPECT_EQ(num_files_in_dir(), 1);
+    EXPECT_TRUE(boost::filesystem::exists(path));
+}
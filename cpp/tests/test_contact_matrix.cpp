@@ -73,4 +73,76 @@ TEST(TestContactMatrixGroup, sum)
 
     EXPECT_THAT(print_wrap(cmg.get_matrix_at(0.0)), MatrixNear(Eigen::MatrixXd::Constant(3, 3, 6.0)));
     EXPECT_THAT(print_wrap(cmg.get_matrix_at(1.0)), MatrixNear(Eigen::MatrixXd::Constant(3, 3, 3.0)));
-}
\ No newline at end of file
+}
+
+TEST(TestContactMatrix, copyOnWrite)
+{
+    auto B = Eigen::MatrixXd::Constant(2, 2, 3.0).eval();
+    auto M = Eigen::MatrixXd::Constant(2, 2, 1.0).eval();
+    mio::ContactMatrix cm(B, M);
+    const auto& const_cm = cm;
+
+    //copies are deep by default, references stay valid
+    auto deep_copy             = cm;
+    auto& baseline             = cm.get_baseline();
+    const auto& const_baseline = const_cm.get_baseline();
+    EXPECT_FALSE(cm.is_shared());
+    EXPECT_EQ(const_cm.get_baseline_use_count(), 1);
+    EXPECT_EQ(const_cm.get_minimum_use_count(), 1);
+    baseline(0, 0) = 4.0;
+    EXPECT_EQ(&cm.get_baseline(), &baseline);
+    EXPECT_EQ(const_baseline(0, 0), 4.0);
+    EXPECT_EQ(static_cast<const mio::ContactMatrix&>(deep_copy).get_baseline()(0, 0), 3.0);
+    baseline(0, 0) = 3.0;
+
+    //copies share baseline and minimum if sharing is enabled
+    cm.share_baseline_and_minimum();
+    auto copy = cm;
+    EXPECT_TRUE(copy.is_shared());
+    EXPECT_EQ(const_cm.get_baseline_use_count(), 2);
+    EXPECT_EQ(const_cm.get_minimum_use_count(), 2);
+    EXPECT_EQ(&const_cm.get_baseline(), &static_cast<const mio::ContactMatrix&>(copy).get_baseline());
+
+    //modification makes a private copy and ends sharing
+    copy.get_baseline()(0, 0) = 5.0;
+    EXPECT_FALSE(copy.is_shared());
+    EXPECT_TRUE(cm.is_shared());
+    EXPECT_EQ(const_cm.get_baseline_use_count(), 1);
+    EXPECT_EQ(const_cm.get_minimum_use_count(), 1);
+    EXPECT_EQ(print_wrap(const_cm.get_baseline()), print_wrap(B));
+    EXPECT_EQ(copy.get_baseline()(0, 0), 5.0);
+    EXPECT_EQ(print_wrap(copy.get_matrix_at(0.0)), print_wrap(copy.get_baseline()));
+
+    //share again only if equal
+    EXPECT_FALSE(copy.share_baseline_and_minimum(cm));
+    EXPECT_FALSE(copy.is_shared());
+    copy.get_baseline()(0, 0) = 3.0;
+    EXPECT_TRUE(copy.share_baseline_and_minimum(deep_copy));
+    EXPECT_TRUE(deep_copy.is_shared());
+    EXPECT_EQ(const_cm.get_baseline_use_count(), 1);
+    EXPECT_EQ(deep_copy.get_baseline_use_count(), 2);
+    auto other = mio::ContactMatrix(Eigen::MatrixXd::Constant(3, 3, 3.0));
+    EXPECT_FALSE(copy.share_baseline_and_minimum(other));
+}
+
+TEST(TestContactMatrix, moveLeavesEmptyMatrices)
+{
+    mio::ContactMatrix cm(Eigen::MatrixXd::Constant(2, 2, 3.0), Eigen::MatrixXd::Constant(2, 2, 1.0));
+    auto moved = std::move(cm);
+    EXPECT_EQ(moved.get_num_groups(), 2);
+
+    //moved-from object can still be used and copied
+    const auto& const_cm = cm;
+    EXPECT_EQ(const_cm.get_baseline().size(), 0);
+    EXPECT_EQ(const_cm.get_minimum().size(), 0);
+    EXPECT_EQ(cm.get_num_groups(), 0);
+    auto copy = cm;
+    EXPECT_EQ(copy, cm);
+
+    //modification doesn't affect other moved-from objects
+    auto other = mio::ContactMatrix(Eigen::MatrixXd::Constant(2, 2, 3.0));
+    moved      = std::move(other);
+    cm.get_baseline().resize(1, 1);
+    EXPECT_EQ(cm.get_baseline().size(), 1);
+    EXPECT_EQ(static_cast<const mio::ContactMatrix&>(other).get_baseline().size(), 0);
+}
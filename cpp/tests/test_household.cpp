@@ -107,3 +107,70 @@ TEST(TestHouseholds, test_add_household_group_to_world)
     EXPECT_EQ(persons[61].get_location_id().index, persons[62].get_location_id().index);
     EXPECT_EQ(persons[62].get_location_id().index, persons[63].get_location_id().index);
 }
+
+TEST(TestHouseholds, test_add_and_assign_locations)
+{
+    auto child = mio::HouseholdMember();
+    child.set_age_weight(mio::AbmAgeGroup::Age5to14, 1);
+
+    auto adult = mio::HouseholdMember();
+    adult.set_age_weight(mio::AbmAgeGroup::Age35to59, 1);
+
+    auto household = mio::Household();
+    household.add_members(child, 5);
+    household.add_members(adult, 2);
+    auto household_group = mio::HouseholdGroup();
+    household_group.add_households(household, 5);
+
+    auto world = mio::World();
+    add_household_group_to_world(world, household_group);
+    auto schools = add_and_assign_locations(world, mio::LocationType::School, {mio::AbmAgeGroup::Age5to14}, 10);
+
+    // 25 children in schools of 10
+    ASSERT_EQ(schools.size(), 3);
+    std::vector<int> num_students(schools.size(), 0);
+    for (auto& person : world.get_persons()) {
+        auto school_idx = person.get_assigned_location_index(mio::LocationType::School);
+        if (person.get_age() == mio::AbmAgeGroup::Age5to14) {
+            ASSERT_LT(school_idx, schools.size());
+            ++num_students[school_idx];
+        }
+        else {
+            EXPECT_EQ(school_idx, mio::INVALID_LOCATION_INDEX);
+        }
+    }
+    EXPECT_EQ(num_students, (std::vector<int>{10, 10, 5}));
+}
+
+TEST(TestHouseholds, test_add_and_assign_locations_seeded)
+{
+    auto make_world = [](uint64_t seed) {
+        auto world = mio::World();
+        world.set_rng_seed(seed);
+        auto home = world.add_location(mio::LocationType::Home);
+        for (int i = 0; i < 20; ++i) {
+            world.add_person(home, mio::InfectionState::Susceptible, mio::AbmAgeGroup::Age5to14);
+        }
+        add_and_assign_locations(world, mio::LocationType::School, {mio::AbmAgeGroup::Age5to14}, 2);
+        return world;
+    };
+    auto get_schools = [](const mio::World& world) {
+        std::vector<uint32_t> schools;
+        for (auto& person : world.get_persons()) {
+            schools.push_back(person.get_assigned_location_index(mio::LocationType::School));
+        }
+        return schools;
+    };
+
+    //same seed gives the same distribution independent of the global generator
+    auto world1 = make_world(1);
+    mio::thread_local_rng().seed({1, 2, 3});
+    auto world2 = make_world(1);
+    EXPECT_EQ(get_schools(world1), get_schools(world2));
+    auto params = mio::AbmMigrationParameters();
+    EXPECT_EQ(world1.get_persons()[3].get_go_to_work_time(params), world2.get_persons()[3].get_go_to_work_time(params));
+
+    //different seed gives a different distribution
+    auto world3 = make_world(2);
+    EXPECT_NE(get_schools(world1), get_schools(world3));
+}
@@ -0,0 +1,142 @@
+/*
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/utils/instrumentation.h"
+#include "memilio/mobility/mobility.h"
+#include "seir/seir.h"
+#include "matchers.h"
+#include "temp_file_register.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+
+const mio::InstrumentationSummary* find_summary(const std::vector<mio::InstrumentationSummary>& report,
+                                                const std::string& name)
+{
+    auto iter = std::find_if(report.begin(), report.end(), [&name](auto& s) {
+        return s.name == name;
+    });
+    return iter != report.end() ? &*iter : nullptr;
+}
+
+} // namespace
+
+TEST(TestInstrumentation, timersAndCounters)
+{
+    mio::reset_instrumentation();
+
+    auto& timer   = mio::get_instrumentation_entry("test timer", mio::InstrumentationKind::Timer);
+    auto& counter = mio::get_instrumentation_entry("test counter", mio::InstrumentationKind::Counter);
+    EXPECT_EQ(&mio::get_instrumentation_entry("test timer", mio::InstrumentationKind::Timer), &timer);
+
+    for (int i = 0; i < 3; ++i) {
+        mio::ScopedTimer scoped_timer(timer);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        counter.add(i);
+    }
+
+    auto report = mio::get_instrumentation_report();
+    auto timer_summary   = find_summary(report, "test timer");
+    auto counter_summary = find_summary(report, "test counter");
+    ASSERT_NE(timer_summary, nullptr);
+    ASSERT_NE(counter_summary, nullptr);
+    EXPECT_EQ(timer_summary->kind, mio::InstrumentationKind::Timer);
+    EXPECT_EQ(timer_summary->calls, 3);
+    EXPECT_GE(timer_summary->total, 3'000'000);
+    EXPECT_EQ(counter_summary->kind, mio::InstrumentationKind::Counter);
+    EXPECT_EQ(counter_summary->calls, 3);
+    EXPECT_EQ(counter_summary->total, 3);
+    //timers before counters
+    EXPECT_LT(timer_summary, counter_summary);
+
+    mio::reset_instrumentation();
+    report = mio::get_instrumentation_report();
+    EXPECT_EQ(find_summary(report, "test timer"), nullptr);
+    EXPECT_EQ(find_summary(report, "test counter"), nullptr);
+}
+
+TEST(TestInstrumentation, trace)
+{
+    mio::reset_instrumentation();
+    auto& timer = mio::get_instrumentation_entry("test \"trace\"", mio::InstrumentationKind::Timer);
+
+    {
+        mio::ScopedTimer scoped_timer(timer);
+    }
+    mio::set_instrumentation_trace_enabled(true);
+    for (int i = 0; i < 2; ++i) {
+        mio::ScopedTimer scoped_timer(timer);
+    }
+    mio::set_instrumentation_trace_enabled(false);
+
+    TempFileRegister file_register;
+    auto path = file_register.get_unique_path("trace-%%%%-%%%%.json");
+    ASSERT_THAT(mio::write_instrumentation_trace(path), IsSuccess());
+
+    std::ifstream file(path);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(content.find("{\"traceEvents\":["), 0);
+    //only events while tracing was enabled, with escaped name
+    size_t num_events = 0;
+    for (auto pos = content.find("\"ph\":\"X\""); pos != std::string::npos; pos = content.find("\"ph\":\"X\"", pos + 1)) {
+        ++num_events;
+    }
+    EXPECT_EQ(num_events, 2);
+    EXPECT_NE(content.find("\"name\":\"test \\\"trace\\\"\""), std::string::npos);
+
+    EXPECT_EQ(mio::write_instrumentation_trace("/non/existent/dir/trace.json").error().code(),
+              mio::StatusCode::FileNotFound);
+    mio::reset_instrumentation();
+}
+
+#ifdef MEMILIO_ENABLE_INSTRUMENTATION
+TEST(TestInstrumentation, graphSimulation)
+{
+    mio::reset_instrumentation();
+
+    mio::SeirModel model;
+    model.populations[{mio::Index<mio::SeirInfType>(mio::SeirInfType::S)}] = 9990;
+    model.populations[{mio::Index<mio::SeirInfType>(mio::SeirInfType::E)}] = 10;
+    model.parameters.set<mio::StageTimeIncubationInv>(1);
+    model.parameters.get<mio::ContactFrequency>().get_baseline()(0, 0) = 2.7;
+    model.parameters.set<mio::StageTimeInfectiousInv>(1);
+    mio::Graph<mio::SimulationNode<mio::Simulation<mio::SeirModel>>, mio::MigrationEdge> g;
+    g.add_node(0, model, 0.0);
+    g.add_node(1, model, 0.0);
+    g.add_edge(0, 1, Eigen::VectorXd::Constant((size_t)mio::SeirInfType::Count, 0.01));
+    auto sim = mio::make_migration_sim(0.0, 0.5, std::move(g));
+    sim.advance(2.0);
+
+    auto report = mio::get_instrumentation_report();
+    ASSERT_NE(find_summary(report, "GraphSimulation::advance"), nullptr);
+    EXPECT_EQ(find_summary(report, "GraphSimulation::advance nodes")->calls, 4);
+    EXPECT_EQ(find_summary(report, "MigrationEdge::apply_migration")->calls, 4);
+    //one call per node and step
+    auto steps = find_summary(report, "OdeIntegrator::advance steps");
+    ASSERT_NE(steps, nullptr);
+    EXPECT_EQ(steps->calls, 8);
+    EXPECT_GE(steps->total, 8);
+    EXPECT_GT(find_summary(report, "CompartmentalModel::eval_right_hand_side")->total, steps->total);
+    mio::reset_instrumentation();
+}
+#endif
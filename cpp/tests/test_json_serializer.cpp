@@ -22,6 +22,7 @@
 #include "memilio/utils/custom_index_array.h"
 #include "memilio/utils/parameter_set.h"
 #include "memilio/utils/uncertain_value.h"
+#include "memilio/utils/time_series.h"
 #include "matchers.h"
 #include "distributions_helpers.h"
 #include "gtest/gtest.h"
@@ -426,4 +427,44 @@ TEST(TestJsonSerializer, container)
     auto r = mio::deserialize(js2, mio::Tag<std::vector<int>>{});
     ASSERT_THAT(print_wrap(r), IsSuccess());
     EXPECT_THAT(r.value(), testing::ElementsAreArray(v.data(), 3));
-}
\ No newline at end of file
+}
+
+TEST(TestJsonSerializer, matrix_row_major)
+{
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> m(2, 3);
+    m << 1.0, 2.0, 3.0, 4.0, 5.0, 6.0;
+    auto js = mio::serialize_json(m);
+    ASSERT_THAT(print_wrap(js), IsSuccess());
+    //same format as column major matrices
+    auto r = mio::deserialize_json(js.value(), mio::Tag<Eigen::MatrixXd>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    EXPECT_EQ(print_wrap(r.value()), print_wrap(Eigen::MatrixXd(m)));
+
+    //wrong number of elements
+    auto js_wrong           = js.value();
+    js_wrong["Elements"][6] = 7.0;
+    auto r_wrong            = mio::deserialize_json(js_wrong, mio::Tag<Eigen::MatrixXd>{});
+    EXPECT_EQ(r_wrong.error().code(), mio::StatusCode::InvalidValue);
+}
+
+TEST(TestJsonSerializer, time_series)
+{
+    mio::TimeSeries<double> ts(2);
+    for (int i = 0; i < 5; ++i) {
+        ts.add_time_point(i * 0.5, Eigen::Vector2d(i, 2 * i));
+    }
+    auto js = mio::serialize_json(ts);
+    ASSERT_THAT(print_wrap(js), IsSuccess());
+    EXPECT_EQ(js.value()["NumElements"], Json::Int64(2));
+    EXPECT_EQ(js.value()["NumTimePoints"], Json::Int64(5));
+    EXPECT_EQ(js.value()["Data"].size(), 15);
+    EXPECT_EQ(js.value()["Data"][3], 0.5);
+
+    auto r = mio::deserialize_json(js.value(), mio::Tag<mio::TimeSeries<double>>{});
+    ASSERT_THAT(print_wrap(r), IsSuccess());
+    ASSERT_EQ(r.value().get_num_time_points(), 5);
+    for (Eigen::Index i = 0; i < 5; ++i) {
+        EXPECT_EQ(r.value().get_time(i), ts.get_time(i));
+        EXPECT_EQ(print_wrap(r.value()[i]), print_wrap(ts[i]));
+    }
+}
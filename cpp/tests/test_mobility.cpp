@@ -163,3 +163,34 @@ TEST(TestMobility, edgeApplyMigration)
     EXPECT_DOUBLE_EQ(node1.get_result().get_last_value().sum(), 900);
     EXPECT_DOUBLE_EQ(node2.get_result().get_last_value().sum(), 1100);
 }
+
+TEST(TestMobility, integratorStatsOfGraph)
+{
+    mio::SeirModel model;
+    model.populations[{mio::Index<mio::SeirInfType>(mio::SeirInfType::S)}] = 900;
+    model.populations[{mio::Index<mio::SeirInfType>(mio::SeirInfType::E)}] = 100;
+    model.parameters.get<mio::ContactFrequency>().get_baseline()(0, 0) = 10;
+    model.parameters.set<mio::TransmissionRisk>(0.4);
+    model.parameters.set<mio::StageTimeIncubationInv>(1. / 4);
+    model.parameters.set<mio::StageTimeInfectiousInv>(1. / 10);
+
+    mio::Graph<mio::SimulationNode<mio::Simulation<mio::SeirModel>>, mio::MigrationEdge> g;
+    g.add_node(0, model, 0.0);
+    g.add_node(1, model, 0.0);
+    g.add_edge(0, 1, Eigen::VectorXd::Constant(4, 0.1));
+    g.add_edge(1, 0, Eigen::VectorXd::Constant(4, 0.1));
+    auto sim = mio::make_migration_sim(0.0, 0.5, std::move(g));
+    sim.advance(3.0);
+
+    auto& node0 = sim.get_graph().nodes()[0].property.get_simulation().get_integrator_stats();
+    auto& node1 = sim.get_graph().nodes()[1].property.get_simulation().get_integrator_stats();
+    EXPECT_GE(node0.num_accepted_steps, 6);
+    EXPECT_GT(node0.num_rhs_evaluations, node0.num_accepted_steps);
+
+    auto stats = mio::get_integrator_stats(sim.get_graph());
+    EXPECT_EQ(stats.num_accepted_steps, node0.num_accepted_steps + node1.num_accepted_steps);
+    EXPECT_EQ(stats.num_rhs_evaluations, node0.num_rhs_evaluations + node1.num_rhs_evaluations);
+    EXPECT_EQ(stats.num_rejected_steps, node0.num_rejected_steps + node1.num_rejected_steps);
+    EXPECT_EQ(stats.dt_min, std::min(node0.dt_min, node1.dt_min));
+    EXPECT_EQ(stats.dt_max, std::max(node0.dt_max, node1.dt_max));
+}
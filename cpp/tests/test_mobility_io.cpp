@@ -22,8 +22,10 @@
 #include "memilio/utils/logging.h"
 #include "memilio/math/eigen.h"
 #include "matchers.h"
+#include "temp_file_register.h"
 
 #include <gtest/gtest.h>
+#include <fstream>
 
 TEST(TestReadMigration, readFormatted)
 {
@@ -116,3 +118,76 @@ TEST(TestReadMigration, readPlain)
     ASSERT_EQ(test_matrix.cols(), matrix_read.value().cols());
     ASSERT_EQ(print_wrap(test_matrix), print_wrap(matrix_read.value()));
 }
+
+TEST(TestReadMigration, readPlainFormats)
+{
+    //blanks, windows line endings, no line break at the end of the file
+    auto matrix_read = mio::details::parse_mobility_plain("1 2.5e-1\t3\r\n4  5 6\r\n7 8 -9", "test");
+    ASSERT_THAT(print_wrap(matrix_read), IsSuccess());
+    Eigen::MatrixXd expected(3, 3);
+    expected << 1, 0.25, 3, 4, 5, 6, 7, 8, -9;
+    EXPECT_EQ(print_wrap(matrix_read.value()), print_wrap(expected));
+
+    EXPECT_EQ(mio::details::parse_mobility_plain("", "test").value().size(), 0);
+    EXPECT_EQ(mio::details::parse_mobility_plain("1 2\n3 4\n5 6\n", "test").error().code(),
+              mio::StatusCode::InvalidFileFormat);
+    EXPECT_EQ(mio::details::parse_mobility_plain("1 2\n3\n", "test").error().code(),
+              mio::StatusCode::InvalidFileFormat);
+    EXPECT_EQ(mio::details::parse_mobility_plain("1 2\n3 a\n", "test").error().code(),
+              mio::StatusCode::InvalidFileFormat);
+    EXPECT_EQ(mio::read_mobility_plain("not_a_file.txt").error().code(), mio::StatusCode::FileNotFound);
+}
+
+TEST(TestReadMigration, readFormattedErrors)
+{
+    auto header = std::string("from_str\tto_str\tfrom_rs\tto_rs\tcount_abs\n");
+    EXPECT_EQ(mio::details::parse_mobility_formatted(header + "A\tB\t1\t2\n2\t3\t4\t5\t6\n", "test").error().code(),
+              mio::StatusCode::InvalidFileFormat);
+    //region 3 is not in the first column
+    EXPECT_EQ(mio::details::parse_mobility_formatted(header + "A\tB\t1\t3\t1.0\n", "test").error().code(),
+              mio::StatusCode::InvalidFileFormat);
+}
+
+TEST(TestReadMigration, readPlainCache)
+{
+    TempFileRegister file_register;
+    auto filename  = file_register.get_unique_path("Mobility-%%%%-%%%%.txt");
+    auto cache_dir = file_register.get_unique_path("MobilityCache-%%%%-%%%%");
+    {
+        std::ofstream file(filename);
+        file << "0 1\n2 0\n";
+    }
+
+    //first read creates the cache, second read uses it
+    for (int i = 0; i < 2; ++i) {
+        auto matrix_read = mio::read_mobility_plain(filename, cache_dir);
+        ASSERT_THAT(print_wrap(matrix_read), IsSuccess());
+        EXPECT_EQ(matrix_read.value()(1, 0), 2.0);
+        EXPECT_EQ(std::distance(boost::filesystem::directory_iterator(cache_dir),
+                                boost::filesystem::directory_iterator()),
+                  1);
+    }
+
+    //cache is replaced if the file changes
+    {
+        std::ofstream file(filename);
+        file << "0 1\n3 0\n";
+    }
+    auto matrix_read = mio::read_mobility_plain(filename, cache_dir);
+    ASSERT_THAT(print_wrap(matrix_read), IsSuccess());
+    EXPECT_EQ(matrix_read.value()(1, 0), 3.0);
+
+    //file with the same name in another directory gets its own cache
+    auto other_dir = file_register.get_unique_path("Mobility-%%%%-%%%%");
+    boost::filesystem::create_directory(other_dir);
+    auto other_filename = mio::path_join(other_dir, boost::filesystem::path(filename).filename().string());
+    {
+        std::ofstream file(other_filename);
+        file << "0 1\n4 0\n";
+    }
+    auto other_matrix_read = mio::read_mobility_plain(other_filename, cache_dir);
+    ASSERT_THAT(print_wrap(other_matrix_read), IsSuccess());
+    EXPECT_EQ(other_matrix_read.value()(1, 0), 4.0);
+    EXPECT_EQ(std::distance(boost::filesystem::directory_iterator(cache_dir), boost::filesystem::directory_iterator()),
+              2);
+}
@@ -28,6 +28,7 @@
 #include <fstream>
 #include <ios>
 #include <cmath>
+#include <numeric>
 
 void sin_deriv(Eigen::Ref<Eigen::VectorXd const> /*y*/, const double t, Eigen::Ref<Eigen::VectorXd> dydt)
 {
@@ -240,3 +241,111 @@ TEST(TestOdeIntegrator, integratorContinuesAtLastState)
     integrator.advance(4 * dt);
     integrator.advance(5 * dt);
 }
+
+TEST(TestOdeIntegrator, hermiteInterpolationIsExactForCubics)
+{
+    //y = t^3 - t, y' = 3t^2 - 1
+    auto y    = [](double t) { return t * t * t - t; };
+    auto dydt = [](double t) { return 3 * t * t - 1; };
+
+    double t0 = 0.5, t1 = 2.0;
+    Eigen::VectorXd result(1);
+    for (auto t : {0.5, 0.7, 1.25, 1.9, 2.0}) {
+        mio::hermite_interpolation(t0, Eigen::VectorXd::Constant(1, y(t0)), Eigen::VectorXd::Constant(1, dydt(t0)), t1,
+                                   Eigen::VectorXd::Constant(1, y(t1)), Eigen::VectorXd::Constant(1, dydt(t1)), t,
+                                   result);
+        EXPECT_NEAR(result[0], y(t), 1e-12);
+    }
+}
+
+TEST(TestOdeIntegrator, denseOutputOnGrid)
+{
+    auto core = std::make_shared<mio::RKIntegratorCore>();
+    core->set_abs_tolerance(1e-8);
+    core->set_rel_tolerance(1e-8);
+    core->set_dt_max(1.0);
+
+    auto integrator = mio::OdeIntegrator(&sin_deriv, 0.0, Eigen::VectorXd::Constant(1, 0), 0.1, core);
+    integrator.set_output_step_size(0.5);
+    integrator.advance(1.3);
+    integrator.advance(3.0);
+
+    //output grid, end points of advance are always stored
+    auto& result = integrator.get_result();
+    auto expected_times = std::vector<double>{0.0, 0.5, 1.0, 1.3, 1.5, 2.0, 2.5, 3.0};
+    ASSERT_EQ(result.get_num_time_points(), Eigen::Index(expected_times.size()));
+    for (Eigen::Index i = 0; i < result.get_num_time_points(); ++i) {
+        EXPECT_NEAR(result.get_time(i), expected_times[i], 1e-12);
+        EXPECT_NEAR(result[i][0], std::sin(result.get_time(i)), 1e-5);
+    }
+}
+
+TEST(TestOdeIntegrator, stats)
+{
+    auto core = std::make_shared<mio::RKIntegratorCore>();
+    core->set_abs_tolerance(1e-10);
+    core->set_rel_tolerance(1e-10);
+
+    //initial step size is too large for the tolerances, so some steps are rejected
+    auto integrator = mio::OdeIntegrator(&sin_deriv, 0.0, Eigen::VectorXd::Constant(1, 0), 1.0, core);
+    integrator.advance(2.0);
+
+    auto& stats = integrator.get_stats();
+    EXPECT_EQ(stats.num_accepted_steps, size_t(integrator.get_result().get_num_time_points() - 1));
+    EXPECT_GT(stats.num_rejected_steps, 0);
+    //six stages per attempt
+    EXPECT_EQ(stats.num_rhs_evaluations, 6 * (stats.num_accepted_steps + stats.num_rejected_steps));
+    EXPECT_GT(stats.dt_min, 0.0);
+    EXPECT_LE(stats.dt_min, stats.dt_max);
+    EXPECT_LT(stats.dt_max, 1.0);
+    EXPECT_GE(stats.elapsed_time, 0.0);
+    EXPECT_EQ(std::accumulate(stats.dt_histogram.begin(), stats.dt_histogram.end(), size_t(0)),
+              stats.num_accepted_steps);
+
+    //statistics accumulate over calls
+    auto stats_first = stats;
+    integrator.advance(3.0);
+    EXPECT_GT(integrator.get_stats().num_accepted_steps, stats_first.num_accepted_steps);
+
+    integrator.reset_stats();
+    EXPECT_EQ(integrator.get_stats().num_accepted_steps, 0);
+    EXPECT_EQ(integrator.get_stats().num_rhs_evaluations, 0);
+}
+
+TEST(TestOdeIntegrator, statsEuler)
+{
+    auto integrator = mio::OdeIntegrator(&sin_deriv, 0.0, Eigen::VectorXd::Constant(1, 0), 0.1,
+                                         std::make_shared<mio::EulerIntegratorCore>());
+    integrator.advance(1.0);
+
+    //one evaluation per step
+    auto& stats = integrator.get_stats();
+    EXPECT_EQ(stats.num_rejected_steps, 0);
+    EXPECT_EQ(stats.num_rhs_evaluations, stats.num_accepted_steps);
+}
+
+TEST(TestOdeIntegrator, statsHistogramAndAggregation)
+{
+    mio::IntegratorStats stats;
+    stats.add_accepted_step(1e-8);
+    stats.add_accepted_step(0.5);
+    stats.add_accepted_step(0.25);
+    stats.add_accepted_step(2.0);
+    EXPECT_EQ(stats.num_accepted_steps, 4);
+    EXPECT_EQ(stats.dt_min, 1e-8);
+    EXPECT_EQ(stats.dt_max, 2.0);
+    EXPECT_THAT(stats.dt_histogram, testing::ElementsAre(1, 0, 0, 0, 0, 0, 2, 1));
+    EXPECT_EQ(mio::IntegratorStats::get_dt_histogram_lower_bound(0), 0.0);
+    EXPECT_DOUBLE_EQ(mio::IntegratorStats::get_dt_histogram_lower_bound(6), 0.1);
+    EXPECT_DOUBLE_EQ(mio::IntegratorStats::get_dt_histogram_lower_bound(7), 1.0);
+
+    mio::IntegratorStats other;
+    other.num_rhs_evaluations = 10;
+    other.num_rejected_steps  = 1;
+    other.add_accepted_step(1e-3);
+    stats += other;
+    EXPECT_EQ(stats.num_accepted_steps, 5);
+    EXPECT_EQ(stats.num_rejected_steps, 1);
+    EXPECT_EQ(stats.num_rhs_evaluations, 10);
+    EXPECT_EQ(stats.dt_histogram[4], 1);
+}
@@ -21,9 +21,14 @@
 #include "secir/secir.h"
 #include "secir/parameter_space.h"
 #include "secir/parameter_studies.h"
+#include "secir/memory_usage.h"
 #include "memilio/mobility/mobility.h"
 #include "memilio/utils/random_number_generator.h"
+#include "matchers.h"
 #include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <mutex>
 #include <stdio.h>
 
 TEST(ParameterStudies, sample_from_secir_params)
@@ -207,6 +212,161 @@ TEST(ParameterStudies, sample_graph)
     }
 }
 
+TEST(ParameterStudies, run_parallel)
+{
+    mio::SecirModel model(2);
+    for (auto i = mio::AgeGroup(0); i < mio::AgeGroup(2); ++i) {
+        model.populations[{i, mio::InfectionState::Exposed}]  = 100;
+        model.populations[{i, mio::InfectionState::Infected}] = 50;
+        model.populations.set_difference_from_group_total<mio::AgeGroup>({i, mio::InfectionState::Susceptible},
+                                                                         10000);
+    }
+    model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat()[0].get_baseline().setConstant(5.0);
+    mio::set_params_distributions_normal(model, 0.0, 5.0, 0.2);
+
+    auto graph = mio::Graph<mio::SecirModel, mio::MigrationParameters>();
+    graph.add_node(0, model);
+    graph.add_node(1, model);
+    graph.add_edge(0, 1, mio::MigrationParameters(Eigen::VectorXd::Constant(Eigen::Index(2 * 8), 0.1)));
+    graph.add_edge(1, 0, mio::MigrationParameters(Eigen::VectorXd::Constant(Eigen::Index(2 * 8), 0.1)));
+
+    const auto num_runs = size_t(5);
+    auto study          = mio::ParameterStudy<mio::SecirSimulation<>>(graph, 0.0, 5.0, 0.5, num_runs);
+    auto run            = [&](int num_threads) {
+        std::mutex mutex;
+        std::vector<Eigen::VectorXd> final_values(num_runs);
+        std::vector<int> num_calls(num_runs, 0);
+        auto status = study.run_parallel(
+            num_threads,
+            [&](auto results_graph, size_t run_idx) {
+                std::lock_guard<std::mutex> lock(mutex);
+                final_values[run_idx] = results_graph.nodes()[0].property.get_result().get_last_value();
+                ++num_calls[run_idx];
+            },
+            {1, 2, 3});
+        EXPECT_TRUE(status);
+        EXPECT_EQ(num_calls, std::vector<int>(num_runs, 1));
+        return final_values;
+    };
+
+    //seeded results don't depend on the number of threads
+    auto results_sequential = run(1);
+    auto results_parallel   = run(3);
+    for (size_t i = 0; i < num_runs; ++i) {
+        EXPECT_EQ(results_sequential[i], results_parallel[i]);
+    }
+    EXPECT_NE(results_sequential[0], results_sequential[1]);
+
+    //the generator of the calling thread continues with its own state
+    auto expected_rng = mio::thread_local_rng();
+    run(2);
+    EXPECT_EQ(mio::thread_local_rng()(), expected_rng());
+}
+
+TEST(ParameterStudies, run_parallel_error)
+{
+    mio::SecirModel model(1);
+    model.populations[{mio::AgeGroup(0), mio::InfectionState::Infected}] = 50;
+    model.populations.set_difference_from_total({mio::AgeGroup(0), mio::InfectionState::Susceptible}, 1000);
+
+    auto graph = mio::Graph<mio::SecirModel, mio::MigrationParameters>();
+    graph.add_node(0, model);
+
+    const auto num_runs = size_t(20);
+    auto study          = mio::ParameterStudy<mio::SecirSimulation<>>(graph, 0.0, 1.0, 0.5, num_runs);
+    std::atomic<int> num_errors{0};
+    std::atomic<size_t> num_processed{0};
+    auto status = study.run_parallel(
+        2,
+        [&](auto&&, size_t run_idx) {
+            if (run_idx == 1) {
+                throw std::runtime_error("run failed");
+            }
+            ++num_processed;
+        },
+        {}, [&](auto&&) {
+            ++num_errors;
+        });
+
+    //the exception is returned instead of terminating and the failed thread starts no more runs
+    ASSERT_FALSE(status);
+    EXPECT_EQ(status.error().code(), mio::StatusCode::UnknownError);
+    EXPECT_EQ(status.error().message(), "run failed");
+    EXPECT_EQ(num_errors, 1);
+    EXPECT_LE(num_processed, num_runs / 2);
+}
+
+TEST(ParameterStudies, freeze_and_memory_usage)
+{
+    mio::SecirModel model(2);
+    for (auto i = mio::AgeGroup(0); i < mio::AgeGroup(2); ++i) {
+        model.populations[{i, mio::InfectionState::Exposed}]  = 100;
+        model.populations[{i, mio::InfectionState::Infected}] = 50;
+        model.populations.set_difference_from_group_total<mio::AgeGroup>({i, mio::InfectionState::Susceptible},
+                                                                         10000);
+    }
+    model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat()[0].get_baseline().setConstant(5.0);
+    model.parameters.get<mio::ContactPatterns>().get_dampings().push_back(
+        mio::DampingSampling(0.5, mio::DampingLevel(0), mio::DampingType(0), mio::SimulationTime(1.0), {0},
+                             Eigen::VectorXd::Constant(2, 1.0)));
+    mio::set_params_distributions_normal(model, 0.0, 5.0, 0.2);
+    //copies of the model share the contacts
+    model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat()[0].share_baseline_and_minimum();
+
+    auto graph = mio::Graph<mio::SecirModel, mio::MigrationParameters>();
+    graph.add_node(0, model);
+    graph.add_node(1, model);
+    graph.add_node(2, model);
+    graph.add_edge(0, 1, mio::MigrationParameters(Eigen::VectorXd::Constant(Eigen::Index(2 * 8), 0.1)));
+    //node with a private copy of the contacts, e.g. read from a file
+    graph.nodes()[2].property.parameters.get<mio::ContactPatterns>().get_cont_freq_mat()[0].get_baseline();
+
+    auto get_baseline = [](auto&& g, size_t node_idx) -> const Eigen::MatrixXd& {
+        const mio::SecirModel& m = g.nodes()[node_idx].property;
+        return m.parameters.template get<mio::ContactPatterns>().get_cont_freq_mat()[0].get_baseline();
+    };
+    EXPECT_EQ(&get_baseline(graph, 0), &get_baseline(graph, 1));
+    EXPECT_NE(&get_baseline(graph, 0), &get_baseline(graph, 2));
+
+    auto usage = mio::get_memory_usage(graph);
+    ASSERT_EQ(usage.size(), 3);
+    EXPECT_GT(usage[0].distributions, 0);
+    EXPECT_GT(usage[0].parameters, 0);
+    EXPECT_GT(usage[0].populations, 0);
+    EXPECT_EQ(usage[0].model, sizeof(mio::SecirModel));
+    EXPECT_LT(usage[0].contacts, usage[2].contacts);
+
+    auto frozen = graph;
+    mio::freeze(frozen);
+    auto frozen_usage = mio::get_memory_usage(frozen);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(frozen_usage[i].distributions, 0);
+        EXPECT_LT(frozen_usage[i].total(), usage[i].total());
+    }
+    EXPECT_EQ(&get_baseline(frozen, 0), &get_baseline(frozen, 2));
+
+    //values are unchanged
+    const mio::SecirModel& frozen_model = frozen.nodes()[1].property;
+    EXPECT_EQ(frozen_model.parameters.get<mio::IncubationTime>()[mio::AgeGroup(1)].value(),
+              model.parameters.get<mio::IncubationTime>()[mio::AgeGroup(1)].value());
+    EXPECT_EQ(frozen_model.parameters.get<mio::IncubationTime>()[mio::AgeGroup(1)].get_distribution(), nullptr);
+    auto& frozen_exposed = frozen_model.populations[{mio::AgeGroup(0), mio::InfectionState::Exposed}];
+    EXPECT_EQ(frozen_exposed.value(), 100);
+    EXPECT_EQ(frozen_exposed.get_distribution(), nullptr);
+    EXPECT_EQ(frozen_model.parameters.get<mio::ContactPatterns>().get_dampings().size(), 0);
+    EXPECT_EQ(print_wrap(frozen_model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat().get_matrix_at(2.0)),
+              print_wrap(model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat().get_matrix_at(2.0)));
+
+    //nodes of a sampled simulation share contacts
+    auto study     = mio::ParameterStudy<mio::SecirSimulation<>>(graph, 0.0, 1.0, 0.5, 1);
+    auto results   = study.run();
+    auto sim_usage = mio::get_memory_usage(results[0]);
+    ASSERT_EQ(sim_usage.size(), 3);
+    EXPECT_GT(sim_usage[0].result, 0);
+    EXPECT_GT(sim_usage[0].simulation, 0);
+    EXPECT_EQ(sim_usage[0].model.contacts, sim_usage[2].model.contacts);
+}
+
 TEST(ParameterStudies, test_normal_distribution)
 {
     mio::log_thread_local_rng_seeds(mio::LogLevel::warn);
@@ -30,6 +30,8 @@
 #include "temp_file_register.h"
 #include "memilio/utils/date.h"
 #include <gtest/gtest.h>
+#include <fstream>
+#include <numeric>
 
 TEST(TestSaveParameters, json_single_sim_write_read_compare)
 {
@@ -637,3 +639,157 @@ TEST(TestSaveParameters, ExtrapolateRKI)
                     1e-1);
     }
 }
+
+TEST(TestSaveParameters, ExtrapolateRKIMultipleDays)
+{
+    std::vector<mio::SecirModel> model{mio::SecirModel(6)};
+
+    model[0].apply_constraints();
+    std::vector<double> scaling_factor_inf(6, 1.0);
+    double scaling_factor_icu = 1.0;
+    mio::Date date(2020, 12, 8);
+
+    std::vector<int> county = {1002};
+
+    for (auto group = mio::AgeGroup(0); group < mio::AgeGroup(6); group++) {
+        model[0].parameters.get<mio::AsymptoticCasesPerInfectious>()[group]   = 0.1 * ((size_t)group + 1);
+        model[0].parameters.get<mio::HospitalizedCasesPerInfectious>()[group] = 0.11 * ((size_t)group + 1);
+        model[0].parameters.get<mio::ICUCasesPerHospitalized>()[group]        = 0.12 * ((size_t)group + 1);
+    }
+
+    TempFileRegister file_register;
+    auto results_dir = file_register.get_unique_path("ExtrapolateRKI-%%%%-%%%%");
+    boost::filesystem::create_directory(results_dir);
+    auto extrapolate_result = mio::extrapolate_rki_results(model, TEST_DATA_DIR, results_dir, county, date,
+                                                           scaling_factor_inf, scaling_factor_icu, 3);
+    ASSERT_THAT(print_wrap(extrapolate_result), IsSuccess());
+
+    auto read_result = mio::read_result(mio::path_join(results_dir, "Results_rki.h5"), 6);
+    ASSERT_THAT(print_wrap(read_result), IsSuccess());
+    auto results = read_result.value()[0].get_groups();
+    ASSERT_EQ(results.get_num_time_points(), 3);
+
+    //every day is the same as reading the data for that day only
+    for (int day = 0; day < 3; ++day) {
+        auto day_model = model;
+        ASSERT_THAT(print_wrap(mio::read_population_data_county(day_model, mio::offset_date_by_days(date, day), county,
+                                                                scaling_factor_inf, scaling_factor_icu,
+                                                                TEST_DATA_DIR)),
+                    IsSuccess());
+        for (auto i = mio::AgeGroup(0); i < mio::AgeGroup(6); ++i) {
+            for (auto s = mio::InfectionState(0); s < mio::InfectionState::Count; s = mio::InfectionState(size_t(s) + 1)) {
+                EXPECT_NEAR(results[day](day_model[0].populations.get_flat_index({i, s})),
+                            (day_model[0].populations[{i, s}]), 1e-6);
+            }
+        }
+    }
+}
+
+TEST(TestSaveParameters, ReadCaseDataCube)
+{
+    auto path = mio::path_join(TEST_DATA_DIR, "all_county_age_ma_rki.json");
+
+    //region key 0 matches all entries
+    auto all = mio::details::read_rki_data(path, "ID_County", {0});
+    ASSERT_THAT(print_wrap(all), IsSuccess());
+    //entries of the county are assigned to the first matching region
+    auto split = mio::details::read_rki_data(path, "ID_County", {1002, 0});
+    ASSERT_THAT(print_wrap(split), IsSuccess());
+
+    auto& cube_all   = all.value();
+    auto& cube_split = split.value();
+    ASSERT_EQ(cube_all.get_num_days(), cube_split.get_num_days());
+    ASSERT_EQ(cube_all.get_num_age_groups(), 6);
+    EXPECT_EQ(mio::get_offset_in_days(cube_all.get_last_date(), cube_all.get_first_date()),
+              cube_all.get_num_days() - 1);
+
+    double sum_county = 0.0;
+    for (size_t column = 0; column < 2; ++column) {
+        for (size_t age = 0; age < 6; ++age) {
+            for (int day = 0; day < cube_all.get_num_days(); ++day) {
+                EXPECT_NEAR(cube_all.get_value(column, 0, age, day),
+                            cube_split.get_value(column, 0, age, day) + cube_split.get_value(column, 1, age, day),
+                            1e-6);
+                sum_county += cube_split.get_value(column, 0, age, day);
+            }
+            //no data outside of the date range
+            EXPECT_EQ(cube_all.get_value(column, 0, age, -1), 0.0);
+            EXPECT_EQ(cube_all.get_value(column, 0, age, cube_all.get_num_days()), 0.0);
+        }
+    }
+    EXPECT_GT(sum_county, 0.0);
+
+    EXPECT_EQ(mio::details::read_rki_data("not_a_file.json", "ID_County", {0}).error().code(),
+              mio::StatusCode::FileNotFound);
+}
+
+TEST(TestSaveParameters, ReadPopulationDataCountyCache)
+{
+    std::vector<mio::SecirModel> model(1, {6});
+    model[0].apply_constraints();
+    std::vector<double> scaling_factor_inf(6, 1.0);
+    double scaling_factor_icu = 1.0;
+    mio::Date date(2020, 12, 10);
+    std::vector<int> county = {1002};
+
+    for (auto group = mio::AgeGroup(0); group < mio::AgeGroup(6); group++) {
+        model[0].parameters.get<mio::AsymptoticCasesPerInfectious>()[group]   = 0.1 * ((size_t)group + 1);
+        model[0].parameters.get<mio::HospitalizedCasesPerInfectious>()[group] = 0.11 * ((size_t)group + 1);
+        model[0].parameters.get<mio::ICUCasesPerHospitalized>()[group]        = 0.12 * ((size_t)group + 1);
+    }
+
+    //copy the data, so it can be modified
+    TempFileRegister file_register;
+    auto data_dir  = file_register.get_unique_path("CacheData-%%%%-%%%%");
+    auto cache_dir = file_register.get_unique_path("Cache-%%%%-%%%%");
+    boost::filesystem::create_directory(data_dir);
+    for (auto file : {"county_divi.json", "all_county_age_ma_rki.json", "county_current_population.json"}) {
+        boost::filesystem::copy_file(mio::path_join(TEST_DATA_DIR, file), mio::path_join(data_dir, file));
+    }
+
+    auto uncached_model = model;
+    ASSERT_THAT(print_wrap(mio::read_population_data_county(uncached_model, date, county, scaling_factor_inf,
+                                                            scaling_factor_icu, data_dir)),
+                IsSuccess());
+
+    //first read creates the cache, second read uses it
+    for (int i = 0; i < 2; ++i) {
+        auto cached_model = model;
+        ASSERT_THAT(print_wrap(mio::read_population_data_county(cached_model, date, county, scaling_factor_inf,
+                                                                scaling_factor_icu, data_dir, cache_dir)),
+                    IsSuccess());
+        EXPECT_THAT(print_wrap(cached_model[0].populations.get_compartments()),
+                    MatrixNear(print_wrap(uncached_model[0].populations.get_compartments()), 1e-10, 1e-10));
+        EXPECT_EQ(std::distance(boost::filesystem::directory_iterator(cache_dir),
+                                boost::filesystem::directory_iterator()),
+                  3);
+    }
+
+    //modified file invalidates the cache
+    {
+        std::ofstream file(mio::path_join(data_dir, "county_current_population.json"));
+        file << "[{\"ID_County\": 1002, \"<3 years\": 100, \"3-5 years\": 100, \"6-14 years\": 100, "
+                "\"15-17 years\": 100, \"18-24 years\": 100, \"25-29 years\": 100, \"30-39 years\": 100, "
+                "\"40-49 years\": 100, \"50-64 years\": 100, \"65-74 years\": 100, \">74 years\": 100}]";
+    }
+    auto population = mio::details::read_population_data(mio::path_join(data_dir, "county_current_population.json"),
+                                                          "ID_County", county, cache_dir);
+    ASSERT_THAT(print_wrap(population), IsSuccess());
+    EXPECT_NEAR(std::accumulate(population.value()[0].begin(), population.value()[0].end(), 0.0), 1100, 1e-10);
+
+    //broken cache is replaced
+    for (auto& entry : boost::filesystem::directory_iterator(cache_dir)) {
+        std::ofstream file(entry.path().string(), std::ios::binary | std::ios::trunc);
+        file << "broken";
+    }
+    auto cube = mio::details::read_rki_data(mio::path_join(data_dir, "all_county_age_ma_rki.json"), "ID_County",
+                                            county, cache_dir);
+    auto uncached_cube =
+        mio::details::read_rki_data(mio::path_join(data_dir, "all_county_age_ma_rki.json"), "ID_County", county);
+    ASSERT_THAT(print_wrap(cube), IsSuccess());
+    ASSERT_THAT(print_wrap(uncached_cube), IsSuccess());
+    ASSERT_EQ(cube.value().get_num_days(), uncached_cube.value().get_num_days());
+    for (int day = 0; day < cube.value().get_num_days(); ++day) {
+        EXPECT_EQ(cube.value().get_value(0, 0, 2, day), uncached_cube.value().get_value(0, 0, 2, day));
+    }
+}
@@ -22,6 +22,10 @@
 #include "secir/secir.h"
 #include "memilio/utils/time_series.h"
 #include "secir/secir_result_io.h"
+#include "secir/secir_parameters_io.h"
+#include "secir/parameter_space.h"
+#include "secir/ensemble_pipeline.h"
+#include "secir/analyze_result.h"
 #include "temp_file_register.h"
 #include <gtest/gtest.h>
 
@@ -112,3 +116,170 @@ TEST(TestSaveResult, compareResultWithH5)
         }
     }
 }
+
+TEST(TestSaveResult, singlePrecision)
+{
+    mio::TimeSeries<float> result((Eigen::Index)mio::InfectionState::Count * 2);
+    for (int i = 0; i < 3; ++i) {
+        result.add_time_point(float(i), mio::TimeSeries<float>::Vector::LinSpaced(result.get_num_elements(), 0.5f * i,
+                                                                                   10.0f + i));
+    }
+
+    TempFileRegister file_register;
+    auto results_file_path = file_register.get_unique_path("test_result-%%%%-%%%%.h5");
+    ASSERT_TRUE(mio::save_result(std::vector<mio::TimeSeries<float>>{result}, {0}, results_file_path));
+
+    auto results_from_file = mio::read_result(results_file_path, 2);
+    ASSERT_TRUE(results_from_file);
+    auto& groups = results_from_file.value()[0].get_groups();
+    auto& totals = results_from_file.value()[0].get_totals();
+    ASSERT_EQ(groups.get_num_time_points(), 3);
+    for (Eigen::Index i = 0; i < 3; ++i) {
+        EXPECT_EQ(groups.get_time(i), double(result.get_time(i)));
+        for (Eigen::Index j = 0; j < result.get_num_elements(); ++j) {
+            EXPECT_EQ(groups[i][j], double(result[i][j]));
+        }
+        for (Eigen::Index j = 0; j < totals.get_num_elements(); ++j) {
+            EXPECT_FLOAT_EQ(float(totals[i][j]), result[i][j] + result[i][j + totals.get_num_elements()]);
+        }
+    }
+}
+
+TEST(TestSaveResult, ensembleWriter)
+{
+    const auto n_compart = (Eigen::Index)mio::InfectionState::Count;
+    auto make_result     = [n_compart](double offset) {
+        mio::TimeSeries<double> result(n_compart * 2);
+        for (int i = 0; i < 4; ++i) {
+            result.add_time_point(i * 0.5, mio::TimeSeries<double>::Vector::LinSpaced(result.get_num_elements(),
+                                                                                      offset + i, offset + 2 * i));
+        }
+        return result;
+    };
+    auto runs = std::vector<std::vector<mio::TimeSeries<double>>>{{make_result(0.0), make_result(1.0)},
+                                                                  {make_result(2.0), make_result(3.0)},
+                                                                  {make_result(4.0), make_result(5.0)}};
+
+    TempFileRegister file_register;
+    auto results_file_path = file_register.get_unique_path("test_result-%%%%-%%%%.h5");
+    mio::ResultEnsembleWriter writer(results_file_path, {3, 7});
+    for (auto& run : runs) {
+        ASSERT_TRUE(writer.add_run(run));
+    }
+    EXPECT_EQ(writer.get_num_runs(), 3);
+
+    //number of time points must not change between runs
+    auto short_result = make_result(0.0);
+    short_result.remove_last_time_point();
+    EXPECT_FALSE(writer.add_run(std::vector<mio::TimeSeries<double>>{short_result, short_result}));
+    EXPECT_EQ(writer.get_num_runs(), 3);
+
+    //mismatch in a later node must not leave a partial run in the file
+    EXPECT_FALSE(writer.add_run(std::vector<mio::TimeSeries<double>>{make_result(0.0), short_result}));
+    EXPECT_EQ(writer.get_num_runs(), 3);
+
+    //single node
+    auto node_from_file = mio::read_result_ensemble_node(results_file_path, 7, 2);
+    ASSERT_TRUE(node_from_file);
+    ASSERT_EQ(node_from_file.value().size(), runs.size());
+    for (size_t run = 0; run < runs.size(); ++run) {
+        EXPECT_EQ(node_from_file.value()[run].get_groups().get_last_value(), runs[run][1].get_last_value());
+    }
+    EXPECT_FALSE(mio::read_result_ensemble_node(results_file_path, 5, 2));
+
+    auto results_from_file = mio::read_result_ensemble(results_file_path, 2);
+    ASSERT_TRUE(results_from_file);
+    ASSERT_EQ(results_from_file.value().size(), runs.size());
+    for (size_t run = 0; run < runs.size(); ++run) {
+        ASSERT_EQ(results_from_file.value()[run].size(), 2);
+        for (size_t node = 0; node < 2; ++node) {
+            auto& expected = runs[run][node];
+            auto& groups   = results_from_file.value()[run][node].get_groups();
+            auto& totals   = results_from_file.value()[run][node].get_totals();
+            ASSERT_EQ(groups.get_num_time_points(), expected.get_num_time_points());
+            for (Eigen::Index i = 0; i < expected.get_num_time_points(); ++i) {
+                EXPECT_EQ(groups.get_time(i), expected.get_time(i));
+                EXPECT_EQ(totals.get_time(i), expected.get_time(i));
+                for (Eigen::Index j = 0; j < expected.get_num_elements(); ++j) {
+                    EXPECT_EQ(groups[i][j], expected[i][j]);
+                }
+                for (Eigen::Index j = 0; j < n_compart; ++j) {
+                    EXPECT_DOUBLE_EQ(totals[i][j], expected[i][j] + expected[i][j + n_compart]);
+                }
+            }
+        }
+    }
+}
+
+TEST(TestSaveResult, ensemblePipeline)
+{
+    mio::SecirModel model(2);
+    for (auto i = mio::AgeGroup(0); i < mio::AgeGroup(2); ++i) {
+        model.populations[{i, mio::InfectionState::Exposed}]  = 100;
+        model.populations[{i, mio::InfectionState::Infected}] = 50;
+        model.populations.set_difference_from_group_total<mio::AgeGroup>({i, mio::InfectionState::Susceptible},
+                                                                         10000);
+    }
+    model.parameters.get<mio::ContactPatterns>().get_cont_freq_mat()[0].get_baseline().setConstant(5.0);
+    mio::set_params_distributions_normal(model, 0.0, 3.0, 0.2);
+
+    auto graph = mio::Graph<mio::SecirModel, mio::MigrationParameters>();
+    graph.add_node(3, model);
+    graph.add_node(7, model);
+    graph.add_edge(0, 1, mio::MigrationParameters(Eigen::VectorXd::Constant(Eigen::Index(2 * 8), 0.1)));
+
+    TempFileRegister file_register;
+    auto result_dir = file_register.get_unique_path("test_ensemble-%%%%-%%%%");
+    ASSERT_TRUE(mio::create_directory(result_dir));
+
+    auto options        = mio::EnsembleOptions{};
+    options.tmax        = 3.0;
+    options.num_runs    = 4;
+    options.num_threads = 2;
+    options.seeds       = {1, 2, 3};
+    options.percentiles = {0.25, 0.75};
+    ASSERT_TRUE(mio::run_ensemble(graph, options, result_dir));
+
+    //all runs in a single file
+    auto runs = mio::read_result_ensemble(result_dir + "/Results_runs.h5", 2);
+    ASSERT_TRUE(runs);
+    ASSERT_EQ(runs.value().size(), 4);
+    for (auto& run : runs.value()) {
+        ASSERT_EQ(run.size(), 2);
+        EXPECT_EQ(run[0].get_totals().get_num_time_points(), 4);
+    }
+    auto runs_sum = mio::read_result_ensemble(result_dir + "/Results_runs_sum.h5", 2);
+    ASSERT_TRUE(runs_sum);
+    ASSERT_EQ(runs_sum.value().size(), 4);
+    ASSERT_EQ(runs_sum.value()[0].size(), 1);
+    auto last = runs.value()[0][0].get_totals().get_num_time_points() - 1;
+    EXPECT_FLOAT_EQ(float(runs_sum.value()[0][0].get_totals().get_last_value()[0]),
+                    float(runs.value()[0][0].get_totals()[last][0] + runs.value()[0][1].get_totals()[last][0]));
+
+    //percentiles of results and parameters
+    auto p25 = mio::read_result(result_dir + "/p25/Results.h5", 2);
+    auto p75 = mio::read_result(result_dir + "/p75/Results.h5", 2);
+    ASSERT_TRUE(p25);
+    ASSERT_TRUE(p75);
+    ASSERT_EQ(p25.value().size(), 2);
+    for (Eigen::Index j = 0; j < p25.value()[0].get_totals().get_num_elements(); ++j) {
+        EXPECT_LE(p25.value()[0].get_totals().get_last_value()[j], p75.value()[0].get_totals().get_last_value()[j]);
+    }
+    //percentiles are read from the file one node at a time, same as from all runs in memory
+    auto ensemble_groups = std::vector<std::vector<mio::TimeSeries<double>>>();
+    for (auto& run : runs.value()) {
+        ensemble_groups.push_back({run[0].get_groups(), run[1].get_groups()});
+    }
+    auto expected_p25 = mio::ensemble_percentile(ensemble_groups, 0.25);
+    for (size_t node = 0; node < 2; ++node) {
+        auto& groups = p25.value()[node].get_groups();
+        ASSERT_EQ(groups.get_num_time_points(), expected_p25[node].get_num_time_points());
+        for (Eigen::Index j = 0; j < groups.get_num_elements(); ++j) {
+            EXPECT_FLOAT_EQ(float(groups.get_last_value()[j]), float(expected_p25[node].get_last_value()[j]));
+        }
+    }
+    EXPECT_TRUE(mio::read_result(result_dir + "/p25/Results_sum.h5", 2));
+    EXPECT_TRUE(boost::filesystem::exists(result_dir + "/p25/GraphNode0.json"));
+    EXPECT_TRUE(boost::filesystem::exists(result_dir + "/p25/GraphNode1.json"));
+    EXPECT_FALSE(boost::filesystem::exists(result_dir + "/p25/GraphEdges_node0.json"));
+}
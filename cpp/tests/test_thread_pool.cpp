@@ -0,0 +1,76 @@
+/* 
+* Copyright (C) 2020-2021 German Aerospace Center (DLR-SC)
+*
+* Authors: Daniel Abele
+*
+* Contact: Martin J. Kuehn <Martin.Kuehn@DLR.de>
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "memilio/utils/thread_pool.h"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(TestThreadPool, runsEachIndexOnce)
+{
+    mio::ThreadPool pool(4);
+    EXPECT_EQ(pool.get_num_threads(), 4);
+    std::vector<int> counts(4, 0);
+    std::vector<std::thread::id> ids(4);
+    //the same threads execute repeated tasks
+    for (int i = 0; i < 100; ++i) {
+        pool.run([&](int thread_idx) {
+            ++counts[thread_idx];
+            if (i == 0) {
+                ids[thread_idx] = std::this_thread::get_id();
+            }
+            else {
+                EXPECT_EQ(ids[thread_idx], std::this_thread::get_id());
+            }
+        });
+    }
+    EXPECT_THAT(counts, testing::Each(100));
+    EXPECT_EQ(ids[0], std::this_thread::get_id());
+}
+
+TEST(TestThreadPool, singleThread)
+{
+    mio::ThreadPool pool(1);
+    std::thread::id id;
+    pool.run([&](int thread_idx) {
+        EXPECT_EQ(thread_idx, 0);
+        id = std::this_thread::get_id();
+    });
+    EXPECT_EQ(id, std::this_thread::get_id());
+}
+
+TEST(TestThreadPool, rethrowsException)
+{
+    mio::ThreadPool pool(3);
+    EXPECT_THROW(pool.run([](int thread_idx) {
+        if (thread_idx == 2) {
+            throw std::runtime_error("error");
+        }
+    }),
+                 std::runtime_error);
+
+    //pool can still be used after an exception
+    std::vector<int> counts(3, 0);
+    pool.run([&](int thread_idx) {
+        ++counts[thread_idx];
+    });
+    EXPECT_THAT(counts, testing::Each(1));
+}
@@ -320,3 +320,69 @@ TYPED_TEST(TestTimeSeries, create)
         }
     }
 }
+
+TYPED_TEST(TestTimeSeries, removePoints)
+{
+    mio::TimeSeries<TypeParam> ts(1);
+    for (int i = 0; i < 6; ++i) {
+        ts.add_time_point(TypeParam(i), mio::TimeSeries<TypeParam>::Vector::Constant(1, TypeParam(i + 0.5)));
+    }
+
+    ts.remove_time_point(0); //front
+    ts.remove_last_time_point(); //back
+    ts.remove_time_point(1); //middle, front side is shorter
+    ts.remove_time_point(1); //middle, back side is shorter
+    ASSERT_EQ(ts.get_num_time_points(), 2);
+    ASSERT_EQ(ts.get_time(0), TypeParam(1.0));
+    ASSERT_EQ(ts.get_time(1), TypeParam(4.0));
+    ASSERT_EQ(ts[0][0], TypeParam(1.5));
+    ASSERT_EQ(ts[1][0], TypeParam(4.5));
+    ASSERT_THAT(ts.get_times(), testing::ElementsAre(TypeParam(1.0), TypeParam(4.0)));
+    ASSERT_EQ(print_wrap(*ts.begin()), print_wrap(ts[0]));
+    ASSERT_EQ(ts.end() - ts.begin(), 2);
+
+    auto data_range = mio::make_range(ts.data(), ts.data() + 4);
+    ASSERT_THAT(data_range, testing::ElementsAre(TypeParam(1.0), TypeParam(1.5), TypeParam(4.0), TypeParam(4.5)));
+
+    ts.add_time_point(5.0, mio::TimeSeries<TypeParam>::Vector::Constant(1, TypeParam(5.5)));
+    ASSERT_EQ(ts.get_num_time_points(), 3);
+    ASSERT_EQ(ts.get_last_time(), TypeParam(5.0));
+    ASSERT_EQ(ts.get_time(0), TypeParam(1.0));
+
+    auto ts_copy = ts;
+    ASSERT_EQ(ts_copy.get_num_time_points(), 3);
+    ASSERT_THAT(ts_copy.get_times(), testing::ElementsAre(TypeParam(1.0), TypeParam(4.0), TypeParam(5.0)));
+    ASSERT_EQ(print_wrap(ts_copy[2]), print_wrap(ts[2]));
+}
+
+TYPED_TEST(TestTimeSeries, queue)
+{
+    //add at the back and remove at the front, capacity does not grow if the size is bounded
+    mio::TimeSeries<TypeParam> ts(1);
+    for (int i = 0; i < 1000; ++i) {
+        ts.add_time_point(TypeParam(i), mio::TimeSeries<TypeParam>::Vector::Constant(1, TypeParam(i)));
+        if (ts.get_num_time_points() > 3) {
+            ts.remove_time_point(0);
+        }
+        ASSERT_EQ(ts.get_last_time(), TypeParam(i));
+        ASSERT_EQ(ts.get_time(0), TypeParam(std::max(0, i - 2)));
+        ASSERT_EQ(ts[0][0], TypeParam(std::max(0, i - 2)));
+    }
+    ASSERT_LE(ts.get_capacity(), 8);
+}
+
+TYPED_TEST(TestTimeSeries, cast)
+{
+    mio::TimeSeries<TypeParam> ts(2);
+    ts.add_time_point(0.0, mio::TimeSeries<TypeParam>::Vector::Constant(2, TypeParam(0.5)));
+    ts.add_time_point(1.0, mio::TimeSeries<TypeParam>::Vector::Constant(2, TypeParam(1.5)));
+    ts.remove_time_point(0);
+    ts.add_time_point(2.0, mio::TimeSeries<TypeParam>::Vector::Constant(2, TypeParam(2.5)));
+
+    auto ts_float = ts.template cast<float>();
+    static_assert(std::is_same<decltype(ts_float), mio::TimeSeries<float>>::value, "wrong type");
+    ASSERT_EQ(ts_float.get_num_elements(), 2);
+    ASSERT_THAT(ts_float.get_times(), testing::ElementsAre(1.0f, 2.0f));
+    ASSERT_EQ(print_wrap(ts_float[0]), print_wrap(Eigen::VectorXf::Constant(2, 1.5f)));
+    ASSERT_EQ(print_wrap(ts_float[1]), print_wrap(Eigen::VectorXf::Constant(2, 2.5f)));
+}
@@ -233,6 +233,17 @@ public:
     void add_list( const std::string& name, Iter b, Iter e);
     /**@}*/
 
+    /**
+     * add contiguous array of numbers to the tuple.
+     * Stored in the same way as a list.
+     * @tparam T the type of the numbers.
+     * @param name name of the array.
+     * @param data pointer to the first number.
+     * @param n number of numbers.
+     */
+    template <class T>
+    void add_array(const std::string& name, const T* data, size_t n);
+
     /**
      * retrieve element from the tuple.
      * @tparam T the type of value to be deserialized.
@@ -271,6 +282,17 @@ public:
     IOResult<std::vector<T>> expect_list(const std::string& name, Tag<T> tag);
     /**@}*/
 
+    /**
+     * retrieve contiguous array of numbers from the tuple.
+     * @tparam T the type of the numbers.
+     * @param name name of the array.
+     * @param data pointer to the storage of the numbers.
+     * @param n expected number of numbers.
+     * @return success if the array has the expected size, error otherwise.
+     */
+    template <class T>
+    IOResult<void> expect_array(const std::string& name, T* data, size_t n);
+
     /**
      * The tuple that data is stored in.
      */
@@ -613,6 +635,23 @@ IOResult<std::vector<T>> PickleObject::expect_list(const std::string &name, Tag<
     return success(std::move(v));
 }
 
+template <class T>
+void PickleObject::add_array(const std::string& name, const T* data, size_t n)
+{
+    add_list(name, data, data + n);
+}
+
+template <class T>
+IOResult<void> PickleObject::expect_array(const std::string& name, T* data, size_t n)
+{
+    BOOST_OUTCOME_TRY(v, expect_list(name, Tag<T>{}));
+    if (v.size() != n) {
+        return failure(StatusCode::InvalidValue, "Array " + name + " has the wrong number of elements.");
+    }
+    std::copy(v.begin(), v.end(), data);
+    return success();
+}
+
 } // namespace epi
 
 #endif
@@ -127,8 +127,11 @@ PYBIND11_MODULE(_simulation_secir, m)
 
     m.def("interpolate_ensemble_results", &mio::interpolate_ensemble_results<mio::TimeSeries<double>>);
 
-    m.def("ensemble_mean", &mio::ensemble_mean);
-    m.def("ensemble_percentile", &mio::ensemble_percentile);
+    m.def("ensemble_mean", static_cast<std::vector<mio::TimeSeries<double>> (*)(
+                               const std::vector<std::vector<mio::TimeSeries<double>>>&)>(&mio::ensemble_mean));
+    m.def("ensemble_percentile", static_cast<std::vector<mio::TimeSeries<double>> (*)(
+                                     const std::vector<std::vector<mio::TimeSeries<double>>>&, double)>(
+                                     &mio::ensemble_percentile));
 
     py::enum_<mio::InfectionState>(m, "InfectionState")
         .value("Susceptible", mio::InfectionState::Susceptible)
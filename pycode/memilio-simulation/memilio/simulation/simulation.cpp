@@ -25,6 +25,7 @@
 #include "memilio/utils/uncertain_value.h"
 #include "memilio/epidemiology/regions.h"
 #include "memilio/epidemiology/uncertain_matrix.h"
+#include "memilio/math/integrator.h"
 
 namespace py = pybind11;
 
@@ -92,6 +93,18 @@ PYBIND11_MODULE(_simulation, m)
             return Eigen::Ref<mio::TimeSeries<double>::Matrix>(m);
         });
 
+    py::class_<mio::IntegratorStats>(m, "IntegratorStats")
+        .def(py::init<>())
+        .def_readonly("num_rhs_evaluations", &mio::IntegratorStats::num_rhs_evaluations)
+        .def_readonly("num_accepted_steps", &mio::IntegratorStats::num_accepted_steps)
+        .def_readonly("num_rejected_steps", &mio::IntegratorStats::num_rejected_steps)
+        .def_readonly("dt_min", &mio::IntegratorStats::dt_min)
+        .def_readonly("dt_max", &mio::IntegratorStats::dt_max)
+        .def_readonly("elapsed_time", &mio::IntegratorStats::elapsed_time)
+        .def_readonly("dt_histogram", &mio::IntegratorStats::dt_histogram)
+        .def_static("get_dt_histogram_lower_bound", &mio::IntegratorStats::get_dt_histogram_lower_bound, py::arg("bin"))
+        .def(py::self += py::self);
+
     py::class_<mio::ParameterDistribution>(m, "ParameterDistribution")
         .def_property("lower_bound", &mio::ParameterDistribution::get_lower_bound,
                       &mio::ParameterDistribution::set_lower_bound)
@@ -232,6 +232,9 @@ void bind_Simulation(pybind11::module& m, std::string const& name)
                                pybind11::return_value_policy::reference_internal)
         .def_property_readonly("model", pybind11::overload_cast<>(&Simulation::get_model, pybind11::const_),
                                pybind11::return_value_policy::reference_internal)
+        .def_property_readonly("integrator_stats", &Simulation::get_integrator_stats,
+                               pybind11::return_value_policy::reference_internal)
+        .def("reset_integrator_stats", &Simulation::reset_integrator_stats)
         .def("advance", &Simulation::advance, pybind11::arg("tmax"));
 }
 
@@ -334,7 +337,10 @@ void bind_MigrationGraph(pybind11::module& m, std::string const& name)
         .def(
             "get_out_edge",
             [](const G& self, size_t node_idx, size_t edge_idx) -> auto& { return self.out_edges(node_idx)[edge_idx]; },
-            pybind11::return_value_policy::reference_internal);
+            pybind11::return_value_policy::reference_internal)
+        .def("get_integrator_stats", [](const G& self) {
+            return mio::get_integrator_stats(self);
+        });
 }
 
 /*
@@ -67,6 +67,11 @@ class Test_Migration(unittest.TestCase):
         self.assertGreaterEqual(sim.graph.get_node(
             0).property.result.get_num_time_points(), 3)
 
+        stats = sim.graph.get_integrator_stats()
+        self.assertEqual(stats.num_accepted_steps,
+                         sim.graph.get_node(0).property.integrator_stats.num_accepted_steps +
+                         sim.graph.get_node(1).property.integrator_stats.num_accepted_steps)
+
 
 if __name__ == '__main__':
     unittest.main()
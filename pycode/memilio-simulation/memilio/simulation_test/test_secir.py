@@ -82,6 +82,17 @@ class Test_secir_integration(unittest.TestCase):
         self.assertAlmostEqual(result.get_time(1), 0.1)
         self.assertAlmostEqual(result.get_last_time(), 100.)
 
+    def test_integrator_stats(self):
+        sim = SecirSimulation(self.model, t0=0., dt=0.1)
+        sim.advance(tmax=10.)
+        stats = sim.integrator_stats
+        self.assertGreater(stats.num_accepted_steps, 0)
+        self.assertGreater(stats.num_rhs_evaluations, stats.num_accepted_steps)
+        self.assertEqual(sum(stats.dt_histogram), stats.num_accepted_steps)
+        self.assertLessEqual(stats.dt_min, stats.dt_max)
+        sim.reset_integrator_stats()
+        self.assertEqual(sim.integrator_stats.num_accepted_steps, 0)
+
 
 if __name__ == '__main__':
     unittest.main()